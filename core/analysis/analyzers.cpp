@@ -21,6 +21,10 @@
 /// @author Vasiliy Nabatchikov
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+#include <mutex>
+
+#include "utils/object_pool.hpp"
 #include "utils/register.hpp"
 
 // list of statically loaded scorers via init()
@@ -48,6 +52,66 @@ class analyzer_register:
   }
 };
 
+// maximum number of idle instances retained per (name, args) pair
+const size_t ANALYZER_POOL_SIZE = 16;
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief adapter for unbounded_object_pool<...> over a registered factory
+//////////////////////////////////////////////////////////////////////////////
+struct analyzer_factory {
+  typedef irs::analysis::analyzer::ptr ptr;
+  typedef ptr(*factory_f)(const irs::string_ref& args);
+
+  static ptr make(factory_f factory, const irs::string_ref& args) {
+    return factory(args);
+  }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+/// @brief process-wide cache of analyzer pools keyed by (name, args)
+///        pools are never removed so that released instances may always
+///        reference their originating pool
+//////////////////////////////////////////////////////////////////////////////
+class analyzer_pools {
+ public:
+  typedef irs::unbounded_object_pool<analyzer_factory> pool_t;
+
+  static analyzer_pools& instance() {
+    static analyzer_pools pools;
+    return pools;
+  }
+
+  void clear() {
+    SCOPED_LOCK(mutex_);
+
+    for (auto& entry: pools_) {
+      entry.second->clear();
+    }
+  }
+
+  pool_t& pool(const irs::string_ref& name, const irs::string_ref& args) {
+    auto key = std::make_pair(
+      std::string(name.c_str(), name.size()),
+      std::string(args.c_str(), args.size())
+    );
+    SCOPED_LOCK(mutex_);
+    auto& pool = pools_[std::move(key)];
+
+    if (!pool) {
+      pool = irs::memory::make_unique<pool_t>(ANALYZER_POOL_SIZE);
+    }
+
+    return *pool;
+  }
+
+ private:
+  std::mutex mutex_;
+  std::map<
+    std::pair<std::string, std::string>,
+    std::unique_ptr<pool_t>
+  > pools_;
+};
+
 NS_END
 
 NS_ROOT
@@ -60,6 +124,30 @@ NS_BEGIN(analysis)
   return factory ? factory(args) : nullptr;
 }
 
+/*static*/ analyzer::ptr analyzers::get(
+  const string_ref& name, const string_ref& args, bool pooled
+) {
+  if (!pooled) {
+    return get(name, args);
+  }
+
+  auto* factory = analyzer_register::instance().get(name);
+
+  if (!factory) {
+    return nullptr;
+  }
+
+  auto analyzer =
+    analyzer_pools::instance().pool(name, args).emplace(factory, args);
+
+  // factory failed to instantiate an analyzer for the specified arguments
+  return analyzer.get() ? analyzer : nullptr;
+}
+
+/*static*/ void analyzers::clear_pool() {
+  analyzer_pools::instance().clear();
+}
+
 /*static*/ void analyzers::init() {
   #ifndef IRESEARCH_DLL
     REGISTER_ANALYZER(irs::analysis::delimited_token_stream);
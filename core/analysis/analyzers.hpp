@@ -75,6 +75,23 @@ class IRESEARCH_API analyzers {
   ////////////////////////////////////////////////////////////////////////////////
   static analyzer::ptr get(const string_ref& name, const string_ref& args);
 
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief find an analyzer by name, or nullptr if not found
+  ///        if 'pooled' then the instance is taken from a process-wide pool
+  ///        keyed by (name, args) and is returned into the pool once the last
+  ///        reference to it is released, otherwise same as get(name, args)
+  ///        NOTE: a pooled instance must be reset(...) before each use
+  ////////////////////////////////////////////////////////////////////////////////
+  static analyzer::ptr get(
+    const string_ref& name, const string_ref& args, bool pooled
+  );
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief drop all cached analyzer instances, instances currently in use are
+  ///        not returned into the pool upon release
+  ////////////////////////////////////////////////////////////////////////////////
+  static void clear_pool();
+
   ////////////////////////////////////////////////////////////////////////////////
   /// @brief for static lib reference all known scorers in lib
   ///        for shared lib NOOP
@@ -74,6 +74,9 @@ NS_BEGIN(analysis)
 // -----------------------------------------------------------------------------
 
 struct text_token_stream::state_t {
+  bool ascii; // 'data' is tokenized by the ASCII fast path
+  std::string ascii_data; // data processed by the ASCII fast path
+  size_t ascii_pos; // current position in 'ascii_data'
   std::shared_ptr<BreakIterator> break_iterator;
   UnicodeString data;
   Locale locale;
@@ -81,7 +84,7 @@ struct text_token_stream::state_t {
   std::shared_ptr<sb_stemmer> stemmer;
   std::string tmp_buf; // used by processTerm(...)
   std::shared_ptr<Transliterator> transliterator;
-  state_t(): locale("C") {
+  state_t(): ascii(false), ascii_pos(0), locale("C") {
     // NOTE: use of the default constructor for Locale() or
     //       use of Locale::createFromName(nullptr)
     //       causes a memory leak with Boost 1.58, as detected by valgrind
@@ -300,38 +303,139 @@ irs::analysis::analyzer::ptr construct(
   return construct(cache_key, locale, std::move(ignored_words));
 }
 
-bool process_term(
-  irs::analysis::text_token_stream::bytes_term& term,
-  const std::unordered_set<std::string>& ignored_words,
-  irs::analysis::text_token_stream::state_t& state,
-  UnicodeString const& data
-) {
-  // ...........................................................................
-  // normalize unicode
-  // ...........................................................................
-  UnicodeString word;
-  UErrorCode err = U_ZERO_ERROR; // a value that passes the U_SUCCESS() test
+// -----------------------------------------------------------------------------
+// --SECTION--                                                   ASCII fast path
+// -----------------------------------------------------------------------------
 
-  state.normalizer->normalize(data, word, err);
+////////////////////////////////////////////////////////////////////////////////
+/// @brief word break classes of ASCII characters (see Unicode UAX #29)
+////////////////////////////////////////////////////////////////////////////////
+enum ascii_class : irs::byte_type {
+  AC_OTHER, // whitespace, punctuation, control characters
+  AC_LETTER, // ALetter
+  AC_DIGIT, // Numeric
+  AC_MID_NUM_LET, // MidNumLet/Single_Quote, joins letters and digits
+  AC_MID_NUM, // MidNum, joins digits
+  AC_UNSUPPORTED // non-ASCII or handled differently by ICU versions
+};
 
-  if (!U_SUCCESS(err)) {
-    word = data; // use non-normalized value if normalization failure
+struct ascii_classes {
+  ascii_class value[256];
+
+  ascii_classes() {
+    for (size_t i = 0; i < 128; ++i) {
+      value[i] = AC_OTHER;
+    }
+
+    for (size_t i = 128; i < 256; ++i) {
+      value[i] = AC_UNSUPPORTED;
+    }
+
+    for (auto c = 'a'; c <= 'z'; ++c) {
+      value[irs::byte_type(c)] = AC_LETTER;
+      value[irs::byte_type(c - 'a' + 'A')] = AC_LETTER;
+    }
+
+    for (auto c = '0'; c <= '9'; ++c) {
+      value[irs::byte_type(c)] = AC_DIGIT;
+    }
+
+    value[irs::byte_type('.')] = AC_MID_NUM_LET;
+    value[irs::byte_type('\'')] = AC_MID_NUM_LET;
+    value[irs::byte_type(',')] = AC_MID_NUM;
+    value[irs::byte_type(';')] = AC_MID_NUM;
+    value[irs::byte_type(':')] = AC_UNSUPPORTED; // MidLetter depends on ICU version
+    value[irs::byte_type('_')] = AC_UNSUPPORTED; // ExtendNumLet
+    value[irs::byte_type('@')] = AC_UNSUPPORTED; // ICU specific rules
   }
 
-  // ...........................................................................
-  // case-convert unicode
-  // ...........................................................................
-  word.toLower(state.locale); // inplace case-conversion
+  ascii_class operator()(char c) const NOEXCEPT {
+    return value[irs::byte_type(c)];
+  }
+};
 
-  // ...........................................................................
-  // collate value, e.g. remove accents
-  // ...........................................................................
-  state.transliterator->transliterate(word); // inplace translitiration
+const ascii_classes ASCII_CLASSES;
 
-  std::string& word_utf8 = state.tmp_buf;
+////////////////////////////////////////////////////////////////////////////////
+/// @returns true if the ASCII fast path produces the same terms as ICU for
+///          the specified data and language, i.e. case conversion is not
+///          locale-specific and word breaks follow the basic UAX #29 rules
+////////////////////////////////////////////////////////////////////////////////
+bool ascii_supported(const irs::string_ref& data, const std::string& language) {
+  // languages with locale-specific case conversion of ASCII letters
+  if (language == "tr" || language == "az" || language == "lt") {
+    return false;
+  }
+
+  for (auto c: data) {
+    if (AC_UNSUPPORTED == ASCII_CLASSES(c)) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief finds the next word in 'data' starting at 'pos' and lower-cases it
+///        into 'word', 'pos' is set to the end of the word
+/// @returns offset of the word start or data.size() if there are no more words
+////////////////////////////////////////////////////////////////////////////////
+size_t next_ascii_word(const std::string& data, size_t& pos, std::string& word) {
+  const auto size = data.size();
+
+  // skip characters not starting a word (UBRK_WORD_NONE)
+  while (pos < size && AC_LETTER != ASCII_CLASSES(data[pos])
+         && AC_DIGIT != ASCII_CLASSES(data[pos])) {
+    ++pos;
+  }
+
+  const auto start = pos;
+
+  word.clear();
+
+  while (pos < size) {
+    const auto c = data[pos];
+    const auto cls = ASCII_CLASSES(c);
+
+    if (AC_LETTER == cls) {
+      word.push_back(char(c | 0x20)); // lower case
+    } else if (AC_DIGIT == cls) {
+      word.push_back(c);
+    } else if (AC_MID_NUM_LET == cls || AC_MID_NUM == cls) {
+      // a separator joins two letters (WB6/WB7) or two digits (WB11/WB12)
+      if (pos + 1 >= size) {
+        break;
+      }
 
-  word_utf8.clear();
-  word.toUTF8String(word_utf8);
+      const auto prev = ASCII_CLASSES(data[pos - 1]);
+      const auto next = ASCII_CLASSES(data[pos + 1]);
+
+      if (!(prev == next
+            && (AC_DIGIT == prev || (AC_LETTER == prev && AC_MID_NUM_LET == cls)))) {
+        break;
+      }
+
+      word.push_back(c);
+    } else {
+      break;
+    }
+
+    ++pos;
+  }
+
+  return start;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief filters ignored words and stems the normalized word in state.tmp_buf
+////////////////////////////////////////////////////////////////////////////////
+bool process_normalized_term(
+  irs::analysis::text_token_stream::bytes_term& term,
+  const std::unordered_set<std::string>& ignored_words,
+  irs::analysis::text_token_stream::state_t& state
+) {
+  std::string& word_utf8 = state.tmp_buf;
 
   // ...........................................................................
   // skip ignored tokens
@@ -366,6 +470,40 @@ bool process_term(
   return true;
 }
 
+bool process_term(
+  irs::analysis::text_token_stream::bytes_term& term,
+  const std::unordered_set<std::string>& ignored_words,
+  irs::analysis::text_token_stream::state_t& state,
+  UnicodeString const& data
+) {
+  // ...........................................................................
+  // normalize unicode
+  // ...........................................................................
+  UnicodeString word;
+  UErrorCode err = U_ZERO_ERROR; // a value that passes the U_SUCCESS() test
+
+  state.normalizer->normalize(data, word, err);
+
+  if (!U_SUCCESS(err)) {
+    word = data; // use non-normalized value if normalization failure
+  }
+
+  // ...........................................................................
+  // case-convert unicode
+  // ...........................................................................
+  word.toLower(state.locale); // inplace case-conversion
+
+  // ...........................................................................
+  // collate value, e.g. remove accents
+  // ...........................................................................
+  state.transliterator->transliterate(word); // inplace translitiration
+
+  state.tmp_buf.clear();
+  word.toUTF8String(state.tmp_buf);
+
+  return process_normalized_term(term, ignored_words, state);
+}
+
 NS_END
 
 NS_ROOT
@@ -515,6 +653,19 @@ bool text_token_stream::reset(const string_ref& data) {
     );
   }
 
+  // ...........................................................................
+  // plain ASCII text does not require normalization, its case conversion and
+  // word breaks are simple enough to be done without ICU
+  // ...........................................................................
+  state_->ascii = locale_.utf8 && ascii_supported(data, locale_.language);
+
+  if (state_->ascii) {
+    state_->ascii_data.assign(data.c_str(), data.size());
+    state_->ascii_pos = 0;
+
+    return true;
+  }
+
   // ...........................................................................
   // convert encoding to UTF8 for use with ICU
   // ...........................................................................
@@ -548,6 +699,24 @@ bool text_token_stream::reset(const string_ref& data) {
 }
 
 bool text_token_stream::next() {
+  if (state_->ascii) {
+    auto& data = state_->ascii_data;
+    auto& pos = state_->ascii_pos;
+
+    while (pos < data.size()) {
+      const auto start = next_ascii_word(data, pos, state_->tmp_buf);
+
+      // offsets in UTF-16 code units are equal to the ASCII ones
+      if (start < pos && process_normalized_term(term_, ignored_words_, *state_)) {
+        offs_.start = uint32_t(start);
+        offs_.end = uint32_t(pos);
+        return true;
+      }
+    }
+
+    return false;
+  }
+
   // ...........................................................................
   // find boundaries of the next word
   // ...........................................................................
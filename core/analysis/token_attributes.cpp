@@ -80,6 +80,18 @@ document::document() NOEXCEPT:
 REGISTER_ATTRIBUTE(iresearch::frequency);
 DEFINE_ATTRIBUTE_TYPE(frequency);
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                                         block_max
+// -----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(block_max);
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                         doc_block
+// -----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(doc_block);
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                granularity_prefix
 // -----------------------------------------------------------------------------
@@ -97,12 +109,86 @@ DEFINE_FACTORY_DEFAULT(norm);
 
 const document INVALID_DOCUMENT;
 
+NS_LOCAL
+
+// quantized norms are stored as a single byte with the most significant
+// bit clear, while single byte 'zvfloat' values always have it set
+inline bool is_quantized(const irs::bytes_ref& value) NOEXCEPT {
+  return 1 == value.size() && 0 == (value[0] & 0x80);
+}
+
+NS_END // LOCAL
+
+/*static*/ const byte_type norm::NOT_QUANTIZED;
+
+/*static*/ bool norm::encode(float_t value, byte_type& code) NOEXCEPT {
+  static_assert(sizeof(float_t) == sizeof(uint32_t), "float_t is not 32-bit");
+
+  if (!(value > 0.f)) {
+    return false; // negative, zero or NaN
+  }
+
+  union {
+    float_t in;
+    uint32_t out;
+  } conv;
+
+  conv.in = value;
+
+  // round to the nearest representable value
+  const uint32_t bits = (conv.out + (UINT32_C(1) << 19)) >> 20;
+  const uint32_t base = (127 - 12) << 3;
+
+  if (bits < base || bits - base >= 0x80) {
+    return false;
+  }
+
+  code = static_cast<byte_type>(bits - base);
+  return true;
+}
+
+/*static*/ bool norm::read_dense(
+    const columnstore_reader::column_reader& column,
+    size_t docs_count,
+    std::vector<byte_type>& codes) {
+  byte_type default_code;
+  const bool encoded = encode(DEFAULT(), default_code);
+  assert(encoded);
+  UNUSED(encoded);
+
+  codes.assign(type_limits<type_t::doc_id_t>::min() + docs_count, default_code);
+
+  bool quantized = false;
+
+  column.visit([&codes, &quantized](doc_id_t doc, const bytes_ref& value) {
+    if (doc >= codes.size()) {
+      return false; // corrupted column
+    }
+
+    if (is_quantized(value)) {
+      codes[doc] = value[0];
+      quantized = true;
+    } else {
+      codes[doc] = NOT_QUANTIZED;
+    }
+
+    return true;
+  });
+
+  if (!quantized) {
+    codes.clear();
+  }
+
+  return quantized;
+}
+
 norm::norm() NOEXCEPT {
   reset();
 }
 
 void norm::reset() {
   column_ = [](doc_id_t, bytes_ref&){ return false; };
+  dense_ = nullptr;
   doc_ = &INVALID_DOCUMENT;
 }
 
@@ -118,16 +204,21 @@ bool norm::reset(const sub_reader& reader, field_id column, const document& doc)
   }
 
   column_ = column_reader->values();
+  dense_ = reader.norms(column);
   doc_ = &doc;
   return true;
 }
 
-float_t norm::read() const {
+float_t norm::read_column(doc_id_t doc) const {
   bytes_ref value;
-  if (!column_(doc_->value, value)) {
+  if (!column_(doc, value)) {
     return DEFAULT();
   }
 
+  if (is_quantized(value)) {
+    return decode(value[0]);
+  }
+
   // TODO: create set of helpers to decode float from buffer directly
   bytes_ref_input in(value);
   return read_zvfloat(in);
@@ -116,6 +116,58 @@ struct IRESEARCH_API frequency : basic_attribute<uint64_t> {
   frequency() = default;
 }; // frequency
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class block_max
+/// @brief upper bounds of the term frequency within the blocks of a postings
+///        list, allows to skip the blocks of documents which can't get a
+///        competitive score without decoding them, provided by the postings
+///        iterators only if requested among the features
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API block_max : attribute {
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves to the block containing the first document not less than
+  ///        'target' without changing the position of the iterator, must be
+  ///        called with non-decreasing targets
+  /// @param max_freq [out] max term frequency within the block
+  /// @returns the last document of the block, eof() for the last block
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<doc_id_t(doc_id_t target, uint64_t& max_freq)> shallow_seek_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  block_max() = default;
+
+  uint64_t max_freq{}; // max term frequency within the whole postings list
+  shallow_seek_f shallow_seek;
+}; // block_max
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class doc_block
+/// @brief gives access to the decoded block of a postings list, allows to
+///        consume the documents without a call per document, provided on
+///        request by the postings iterators without positions
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API doc_block : attribute {
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves the iterator by up to 'count' documents of the current
+  ///        block, the next block is decoded if the current one is exhausted,
+  ///        the iterator is positioned on the last of the returned documents
+  /// @param docs [out] ids of the documents
+  /// @param freqs [out] term frequencies of the documents, nullptr if the
+  ///                    frequencies aren't requested
+  /// @returns number of documents, 0 if there are no more documents
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<size_t(
+    size_t count, const doc_id_t*& docs, const uint64_t*& freqs
+  )> next_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  doc_block() = default;
+
+  next_f next;
+}; // doc_block
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class granularity_prefix
 /// @brief indexed tokens are prefixed with one byte indicating granularity
@@ -141,10 +193,84 @@ struct IRESEARCH_API norm : stored_attribute {
     return 1.f;
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief quantizes a positive 'value' into a single byte with a 3-bit
+  ///        mantissa and a 4-bit exponent (the most significant bit is always
+  ///        clear), i.e. values within [2^-12 .. 2^4) are representable
+  /// @returns false if the value is out of the representable range
+  //////////////////////////////////////////////////////////////////////////////
+  static bool encode(float_t value, byte_type& code) NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns a value quantized by 'encode(...)'
+  //////////////////////////////////////////////////////////////////////////////
+  FORCE_INLINE static float_t decode(byte_type code) NOEXCEPT {
+    static_assert(sizeof(float_t) == sizeof(uint32_t), "float_t is not 32-bit");
+    assert(code < 0x80);
+
+    // the code is the exponent and the 3 most significant bits of
+    // the mantissa of an ieee754 value, the exponent is rebased by 12
+    union {
+      float_t out;
+      uint32_t in;
+    } conv;
+
+    conv.in = (uint32_t(code) + ((127 - 12) << 3)) << 20;
+    return conv.out;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief fills 'codes' with the norms of a segment column one byte per
+  ///        document, the documents without a stored norm get the code of
+  ///        DEFAULT(), the documents with a norm not quantized by the writer
+  ///        get 'NOT_QUANTIZED'
+  /// @returns false if none of the norms of the column is quantized
+  //////////////////////////////////////////////////////////////////////////////
+  static bool read_dense(
+    const columnstore_reader::column_reader& column,
+    size_t docs_count,
+    std::vector<byte_type>& codes
+  );
+
+  static const byte_type NOT_QUANTIZED = 0xFF;
+
   norm() NOEXCEPT;
 
   bool reset(const sub_reader& segment, field_id column, const document& doc);
-  float_t read() const;
+  float_t read() const { return read(doc_->value); }
+
+  // norm of an arbitrary document of the segment
+  FORCE_INLINE float_t read(doc_id_t doc) const {
+    if (dense_) {
+      const auto code = dense_[doc];
+
+      if (code != NOT_QUANTIZED) {
+        return decode(code);
+      }
+    }
+
+    return read_column(doc);
+  }
+
+  // norms of the specified documents of the segment
+  void read(const doc_id_t* docs, size_t count, float_t* values) const {
+    if (!dense_) {
+      for (size_t i = 0; i < count; ++i) {
+        values[i] = read_column(docs[i]);
+      }
+
+      return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+      const auto code = dense_[docs[i]];
+
+      values[i] = code != NOT_QUANTIZED
+        ? decode(code)
+        : read_column(docs[i]);
+    }
+  }
+
   bool empty() const;
 
   void clear() {
@@ -153,8 +279,10 @@ struct IRESEARCH_API norm : stored_attribute {
 
  private:
   void reset();
+  float_t read_column(doc_id_t doc) const;
 
   columnstore_reader::values_reader_f column_;
+  const byte_type* dense_; // one byte per document if available
   const document* doc_;
 }; // norm
 
@@ -27,6 +27,8 @@
 #include "index/index_meta.hpp"
 
 #include "formats/formats.hpp"
+#include "store/directory.hpp"
+#include "utils/async_utils.hpp"
 
 NS_ROOT
 
@@ -44,7 +46,8 @@ void validate_footer(iresearch::index_input& in) {
   }
 
   const int32_t alg_id = in.read_int();
-  if (alg_id != 0) {
+  if (alg_id != format_utils::FOOTER_CRC32
+      && alg_id != format_utils::FOOTER_CRC32C) {
     // invalid algorithm
     throw iresearch::index_error();
   }
@@ -60,7 +63,7 @@ void write_header(index_output& out, const string_ref& format, int32_t ver) {
 
 void write_footer(index_output& out) {
   out.write_int(FOOTER_MAGIC);
-  out.write_int(0);
+  out.write_int(out.checksum_type());
   out.write_long(out.checksum());
 }
 
@@ -95,5 +98,70 @@ int64_t read_checksum( index_input& in ) {
   return in.read_long();
 }
 
+int32_t checksum_type(index_input& in) {
+  const auto length = in.length();
+
+  if (length < FOOTER_LEN) {
+    // no space for footer
+    throw index_error();
+  }
+
+  const auto ptr = in.file_pointer();
+
+  in.seek(length - FOOTER_LEN + sizeof(int32_t)); // skip footer magic
+  const int32_t type = in.read_int();
+  in.seek(ptr);
+
+  return type;
+}
+
+int64_t check_checksum(const index_input& in) {
+  auto clone = in.dup();
+
+  if (!clone) {
+    throw io_error();
+  }
+
+  clone->seek(0); // the source may be positioned past the last byte
+
+  const auto type = checksum_type(*clone);
+
+  footer_checksum_input check_in(std::move(clone), footer_checksum(type));
+  check_in.seek(check_in.length() - FOOTER_LEN);
+  return check_footer(check_in);
+}
+
+void check_checksums(
+    const directory& dir,
+    const segment_meta& meta,
+    async_utils::thread_pool* pool /*= nullptr*/) {
+  async_utils::task_group tasks(pool);
+
+  for (auto& file : meta.files) {
+    tasks.run([&dir, &file]()->void {
+      auto in = dir.open(file);
+
+      if (!in) {
+        throw detailed_io_error("Failed to open file, path: ") << file;
+      }
+
+      if (in->length() < FOOTER_LEN) {
+        // no space for footer
+        throw index_error();
+      }
+
+      in->seek(in->length() - FOOTER_LEN);
+
+      if (FOOTER_MAGIC != in->read_int()) {
+        return; // data follows the footer, e.g. column meta
+      }
+
+      check_checksum(*in);
+    });
+  }
+
+  tasks.wait();
+}
+
 NS_END
 NS_END
@@ -30,8 +30,23 @@
 
 #include "index/field_meta.hpp"
 
+#include "utils/crc.hpp"
+
+MSVC_ONLY(__pragma(warning(push)))
+MSVC_ONLY(__pragma(warning(disable:4244)))
+MSVC_ONLY(__pragma(warning(disable:4245)))
+#include <boost/crc.hpp>
+MSVC_ONLY(__pragma(warning(pop)))
+
 NS_ROOT
 
+class directory;
+struct segment_meta;
+
+NS_BEGIN(async_utils)
+class thread_pool;
+NS_END
+
 void IRESEARCH_API validate_footer(iresearch::index_input& in);
 
 template<typename Type, typename Reader, typename Visitor>
@@ -58,6 +73,11 @@ Iterator write_all(Writer& writer, Iterator begin, Iterator end) {
   return begin;
 }
 
+template<>
+struct checksum_traits<::boost::crc_32_type> {
+  static const int32_t TYPE = index_output::CRC32;
+};
+
 NS_BEGIN(format_utils)
 
 const int32_t FORMAT_MAGIC = 0x3fd76c17;
@@ -66,12 +86,68 @@ const int32_t FOOTER_MAGIC = -FORMAT_MAGIC;
 
 const uint32_t FOOTER_LEN = 2 * sizeof( int32_t ) + sizeof( int64_t );
 
+// checksum algorithm identifiers stored in the footer
+const int32_t FOOTER_CRC32 = index_output::CRC32; // boost::crc_32_type, written by older versions
+const int32_t FOOTER_CRC32C = index_output::CRC32C; // crc32c, computed by the built-in directories
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class footer_checksum
+/// @brief checksum of an index file computed by the algorithm denoted by the
+///        footer of the file
+////////////////////////////////////////////////////////////////////////////////
+class footer_checksum {
+ public:
+  typedef uint32_t value_type;
+
+  explicit footer_checksum(int32_t type = FOOTER_CRC32C) NOEXCEPT
+    : type_(type) {
+  }
+
+  void process_byte(byte_type b) {
+    process_bytes(&b, 1);
+  }
+
+  void process_bytes(const void* buffer, size_t size) {
+    if (FOOTER_CRC32C == type_) {
+      crc32c_.process_bytes(buffer, size);
+    } else {
+      crc32_.process_bytes(buffer, size);
+    }
+  }
+
+  value_type checksum() const {
+    return FOOTER_CRC32C == type_ ? crc32c_.checksum() : crc32_.checksum();
+  }
+
+  void reset() {
+    crc32c_.reset();
+    crc32_.reset();
+  }
+
+ private:
+  ::boost::crc_32_type crc32_;
+  irs::crc32c crc32c_;
+  int32_t type_;
+}; // footer_checksum
+
+typedef checksum_index_input<footer_checksum> footer_checksum_input;
+
 void IRESEARCH_API write_header(index_output& out, const string_ref& format, int32_t ver);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the footer of the file denoting the algorithm of
+///        'out.checksum()' as reported by 'out.checksum_type()'
+////////////////////////////////////////////////////////////////////////////////
 void IRESEARCH_API write_footer(index_output& out);
 
 int64_t IRESEARCH_API read_checksum(index_input& in);
 
+////////////////////////////////////////////////////////////////////////////////
+/// @returns checksum algorithm stored in the footer at the end of 'in'
+/// @note position of 'in' is preserved
+////////////////////////////////////////////////////////////////////////////////
+int32_t IRESEARCH_API checksum_type(index_input& in);
+
 int32_t IRESEARCH_API check_header(
   index_input& in, const string_ref& format, int32_t min_ver, int32_t max_ver
 );
@@ -102,6 +178,23 @@ int64_t check_checksum(const index_input& in) {
   return check_footer(check_in);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief verifies the checksum of the whole file using the algorithm denoted
+///        by its footer
+////////////////////////////////////////////////////////////////////////////////
+int64_t IRESEARCH_API check_checksum(const index_input& in);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief verifies checksums of the segment files ending with a footer,
+///        files are verified concurrently on 'pool' if specified
+/// @note throws index_error on checksum mismatch
+////////////////////////////////////////////////////////////////////////////////
+void IRESEARCH_API check_checksums(
+  const directory& dir,
+  const segment_meta& meta,
+  async_utils::thread_pool* pool = nullptr
+);
+
 NS_END
 NS_END
 
@@ -86,6 +86,20 @@ field_reader::~field_reader() {}
 document_mask_writer::~document_mask_writer() {}
 document_mask_reader::~document_mask_reader() {}
 
+void document_mask_writer::write(const document_mask& mask) {
+  mask.visit([this](doc_id_t doc)->bool {
+    write(doc);
+    return true;
+  });
+}
+
+void document_mask_reader::read(document_mask& mask, uint32_t count) {
+  for (doc_id_t doc; count; --count) {
+    read(doc);
+    mask.insert(doc);
+  }
+}
+
 segment_meta_writer::~segment_meta_writer() {}
 segment_meta_reader::~segment_meta_reader() {}
 
@@ -28,6 +28,7 @@
 #include "store/data_output.hpp"
 #include "store/directory.hpp"
 
+#include "index/document_mask.hpp"
 #include "index/index_meta.hpp"
 #include "index/iterators.hpp"
 
@@ -48,7 +49,6 @@ struct reader_state;
 struct index_output;
 struct data_input;
 struct index_input;
-typedef std::unordered_set<doc_id_t> document_mask;
 
 /* -------------------------------------------------------------------
  * postings_writer
@@ -306,12 +306,30 @@ struct IRESEARCH_API columnstore_reader {
   DECLARE_PTR(columnstore_reader);
 
   typedef std::function<bool(doc_id_t, bytes_ref&)> values_reader_f;
-  typedef std::function<bool(doc_id_t, const bytes_ref&)> values_visitor_f;  
+  typedef std::function<bool(doc_id_t, const bytes_ref&)> values_visitor_f;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief summary of the values of a column data block, allows to skip the
+  ///        block without reading its data
+  //////////////////////////////////////////////////////////////////////////////
+  struct block_summary {
+    doc_id_t min_key; // first key of the block
+    doc_id_t max_key; // last key of the block
+    bytes_ref min; // byte-wise min value, 'nil' if unknown
+    bytes_ref max; // byte-wise max value, 'nil' if unknown
+    int64_t min_long; // min value written with 'write_zvlong(...)'
+    int64_t max_long; // max value written with 'write_zvlong(...)'
+    bool has_long; // every value of the block is written with 'write_zvlong(...)'
+  }; // block_summary
+
+  typedef std::function<bool(const block_summary&)> blocks_visitor_f;
 
   struct column_reader {
     virtual ~column_reader() = default;
 
-    // returns corresponding column reader
+    // returns corresponding column reader, a returned value stays valid
+    // until the next call of the same reader, distinct copies of a reader
+    // may be used concurrently
     virtual columnstore_reader::values_reader_f values() const = 0;
 
     // returns corresponding column iterator
@@ -319,6 +337,10 @@ struct IRESEARCH_API columnstore_reader {
 
     virtual bool visit(const columnstore_reader::values_visitor_f& reader) const = 0;
 
+    // visits the summaries of the column data blocks in order of keys,
+    // returns false if the column has no summaries or the visitor returned false
+    virtual bool visit_blocks(const columnstore_reader::blocks_visitor_f& visitor) const = 0;
+
     virtual size_t size() const = 0;
   };
 
@@ -360,6 +382,10 @@ struct IRESEARCH_API document_mask_writer {
   virtual void prepare(directory& dir, const segment_meta& meta) = 0;
   virtual void begin(uint32_t count) = 0;
   virtual void write(const doc_id_t& mask) = 0;
+
+  // writes all doc_ids of 'mask', 'mask.size()' must be passed to begin()
+  virtual void write(const document_mask& mask);
+
   virtual void end() = 0;
 };
 
@@ -385,6 +411,10 @@ struct IRESEARCH_API document_mask_reader {
 
   virtual uint32_t begin() = 0;
   virtual void read(doc_id_t& mask) = 0;
+
+  // reads all 'count' doc_ids returned by begin() into 'mask'
+  virtual void read(document_mask& mask, uint32_t count);
+
   virtual void end() = 0;
 };
 
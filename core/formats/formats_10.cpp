@@ -41,6 +41,7 @@
 #include "utils/timer_utils.hpp"
 #include "utils/std.hpp"
 #include "utils/bit_packing.hpp"
+#include "utils/numeric_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "utils/object_pool.hpp"
 #include "formats.hpp"
@@ -108,7 +109,7 @@ inline void prepare_output(
   format_utils::write_header(*out, format, version);
 }
 
-inline void prepare_input(
+inline int32_t prepare_input(
     std::string& str,
     index_input::ptr& in,
     const reader_state& state,
@@ -128,7 +129,7 @@ inline void prepare_input(
     throw detailed_io_error(ss.str());
   }
 
-  format_utils::check_header(*in, format, min_ver, max_ver);
+  return format_utils::check_header(*in, format, min_ver, max_ver);
 }
 
 FORCE_INLINE void skip_positions(index_input& in) {
@@ -155,6 +156,7 @@ struct skip_state {
   uint64_t pos_ptr{}; // pointer to the positions of the first document in a document block
   uint64_t pay_ptr{}; // pointer to the payloads of the first document in a document block
   size_t pend_pos{}; // positions to skip before new document block
+  uint64_t max_freq{}; // max frequency within the skipped documents
   doc_id_t doc{ type_limits<type_t::doc_id_t>::invalid() }; // last document in a previous block 
   uint32_t pay_pos{}; // payload size to skip before in new document block 
 }; // skip_state
@@ -185,7 +187,8 @@ class doc_iterator : public iresearch::doc_iterator {
 
   doc_iterator() NOEXCEPT
     : skip_levels_(1),
-      skip_(postings_writer::BLOCK_SIZE, postings_writer::SKIP_N) {
+      skip_(postings_writer::BLOCK_SIZE, postings_writer::SKIP_N),
+      shallow_skip_(postings_writer::BLOCK_SIZE, postings_writer::SKIP_N) {
     std::fill(docs_, docs_ + postings_writer::BLOCK_SIZE, type_limits<type_t::doc_id_t>::invalid());
   }
 
@@ -195,9 +198,14 @@ class doc_iterator : public iresearch::doc_iterator {
       const irs::attribute_view& attrs,
       const index_input* doc_in,
       const index_input* pos_in,
-      const index_input* pay_in) {
+      const index_input* pay_in,
+      int32_t version,
+      bool bounds,
+      bool blocks) {
     features_ = field; // set field features
     enabled_ = enabled; // set enabled features
+    skip_max_freq_ = features_.freq()
+      && version >= postings_writer::FORMAT_BLOCK_MAX;
 
     // add mandatory attributes
     attrs_.emplace(doc_);
@@ -219,11 +227,30 @@ class doc_iterator : public iresearch::doc_iterator {
         }
       }
 
+      doc_in_->prefetch(term_state_.doc_start, MAX_BLOCK_BYTES);
       doc_in_->seek(term_state_.doc_start);
       assert(!doc_in_->eof());
     }
 
     prepare_attributes(enabled, attrs, pos_in, pay_in);
+
+    // per-block frequency bounds
+    if (bounds && enabled.freq()) {
+      block_max_.max_freq = term_state_.max_freq;
+      block_max_.shallow_seek = [this](doc_id_t target, uint64_t& max_freq) {
+        return shallow_seek(target, max_freq);
+      };
+      attrs_.emplace(block_max_);
+    }
+
+    // positions are advanced per document
+    if (blocks && !enabled.position()) {
+      block_.next = [this](
+          size_t count, const doc_id_t*& docs, const uint64_t*& freqs) {
+        return next_block(count, docs, freqs);
+      };
+      attrs_.emplace(block_);
+    }
   }
 
   virtual doc_id_t seek(doc_id_t target) override {
@@ -270,6 +297,34 @@ class doc_iterator : public iresearch::doc_iterator {
     return true;
   }
 
+  // same as next() but moves by up to 'count' documents of the current block
+  size_t next_block(
+      size_t count, const doc_id_t*& docs, const uint64_t*& freqs) {
+    assert(count);
+
+    if (begin_ == end_) {
+      cur_pos_ += relative_pos();
+
+      if (cur_pos_ == term_state_.docs_count) {
+        doc_.value = type_limits<type_t::doc_id_t>::eof();
+        begin_ = end_ = docs_; // seal the iterator
+        return 0;
+      }
+
+      refill();
+    }
+
+    count = std::min(count, size_t(end_ - begin_));
+    docs = begin_;
+    freqs = enabled_.freq() ? doc_freq_ : nullptr;
+    begin_ += count;
+    doc_freq_ += count;
+    doc_.value = begin_[-1];
+    freq_.value = doc_freq_[-1];
+
+    return count;
+  }
+
 #if defined(_MSC_VER)
   #pragma warning( default : 4706 )
 #elif defined (__GNUC__)
@@ -295,6 +350,8 @@ class doc_iterator : public iresearch::doc_iterator {
 
   void seek_to_block(doc_id_t target);
 
+  doc_id_t shallow_seek(doc_id_t target, uint64_t& max_freq);
+
   // returns current position in the document block 'docs_'
   size_t relative_pos() NOEXCEPT {
     assert(begin_ >= docs_);
@@ -315,6 +372,9 @@ class doc_iterator : public iresearch::doc_iterator {
         state.pay_ptr += in.read_vlong();
       }
     }
+    if (skip_max_freq_) {
+      state.max_freq = in.read_vlong();
+    }
     return state.doc;
   }
 
@@ -328,9 +388,7 @@ class doc_iterator : public iresearch::doc_iterator {
         }
       }
     } else {
-      for (uint64_t i = 0; i < size; ++i) {
-        docs_[i] = doc_in_->read_vlong();
-      }
+      doc_in_->read_vlongs(docs_, size);
     }
   }
 
@@ -386,6 +444,8 @@ class doc_iterator : public iresearch::doc_iterator {
   std::vector<skip_state> skip_levels_;
   skip_reader skip_;
   skip_context* skip_ctx_; // pointer to used skip context, will be used by skip reader
+  skip_reader shallow_skip_; // skip reader used by 'shallow_seek'
+  skip_state shallow_state_; // last skip read by 'shallow_skip_' at level 0
   irs::attribute_view attrs_;
   uint64_t enc_buf_[postings_writer::BLOCK_SIZE]; // buffer for encoding
   doc_id_t docs_[postings_writer::BLOCK_SIZE]; // doc values
@@ -397,10 +457,18 @@ class doc_iterator : public iresearch::doc_iterator {
   uint64_t term_freq_{}; // total term frequency
   document doc_;
   frequency freq_;
+  block_max block_max_;
+  doc_block block_;
   index_input::ptr doc_in_;
   version10::term_meta term_state_;
   features features_; // field features
   features enabled_; // enabled iterator features
+  bool skip_max_freq_{}; // skips contain max frequency of the skipped documents
+
+  // upper bound of the size of a block of encoded documents,
+  // used as a prefetch hint before reading a block
+  static const size_t MAX_BLOCK_BYTES
+    = 2 * postings_writer::BLOCK_SIZE * sizeof(uint32_t);
 }; // doc_iterator 
 
 void doc_iterator::seek_to_block(doc_id_t target) {
@@ -454,6 +522,7 @@ void doc_iterator::seek_to_block(doc_id_t target) {
 
     const size_t skipped = skip_.seek(target);
     if (skipped > (cur_pos_ + relative_pos())) {
+      doc_in_->prefetch(last.doc_ptr, MAX_BLOCK_BYTES);
       doc_in_->seek(last.doc_ptr);
       doc_.value = last.doc;
       cur_pos_ = skipped;
@@ -463,6 +532,47 @@ void doc_iterator::seek_to_block(doc_id_t target) {
   }
 }
 
+doc_id_t doc_iterator::shallow_seek(doc_id_t target, uint64_t& max_freq) {
+  // no per-block bounds, use the bound of the whole postings list
+  if (!skip_max_freq_ || term_state_.docs_count <= postings_writer::BLOCK_SIZE) {
+    max_freq = term_state_.max_freq;
+    return type_limits<type_t::doc_id_t>::eof();
+  }
+
+  // init skip reader in lazy fashion
+  if (!shallow_skip_) {
+    index_input::ptr skip_in = doc_in_->dup();
+    skip_in->seek(term_state_.doc_start + term_state_.e_skip_start);
+
+    shallow_skip_.prepare(
+      std::move(skip_in),
+      [this](size_t level, index_input& in) {
+        skip_state tmp;
+        auto& state = level ? tmp : shallow_state_;
+
+        if (in.eof()) {
+          // stream exhausted
+          return (state.doc = type_limits<type_t::doc_id_t>::eof());
+        }
+
+        return read_skip(state, in);
+    });
+  }
+
+  if (shallow_state_.doc < target) {
+    shallow_skip_.seek(target);
+  }
+
+  if (type_limits<type_t::doc_id_t>::eof(shallow_state_.doc)) {
+    // documents following the last skip
+    max_freq = term_state_.max_freq;
+  } else {
+    max_freq = shallow_state_.max_freq;
+  }
+
+  return shallow_state_.doc;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// @class mask_doc_iterator
 ///////////////////////////////////////////////////////////////////////////////
@@ -482,7 +592,7 @@ class mask_doc_iterator final: public DocIterator {
 
   virtual bool next() override {
     while (doc_iterator_t::next()) {
-      if (mask_.find(this->value()) == mask_.end()) {
+      if (!mask_.contains(this->value())) {
         return true;
       }
     }
@@ -493,7 +603,7 @@ class mask_doc_iterator final: public DocIterator {
   virtual doc_id_t seek(doc_id_t target) override {
     const auto doc = doc_iterator_t::seek(target);
 
-    if (mask_.find(doc) == mask_.end()) {
+    if (!mask_.contains(doc)) {
       return doc;
     }
 
@@ -1313,7 +1423,10 @@ void index_meta_reader::read(
     throw detailed_io_error(ss.str());
   }
 
-  checksum_index_input<boost::crc_32_type> check_in(std::move(in));
+  const auto checksum_type = format_utils::checksum_type(*in);
+  format_utils::footer_checksum_input check_in(
+    std::move(in), format_utils::footer_checksum(checksum_type)
+  );
 
   // check header
   format_utils::check_header(
@@ -1404,7 +1517,10 @@ void segment_meta_reader::read(
     throw detailed_io_error(ss.str());
   }
 
-  checksum_index_input<boost::crc_32_type> check_in(std::move(in));
+  const auto checksum_type = format_utils::checksum_type(*in);
+  format_utils::footer_checksum_input check_in(
+    std::move(in), format_utils::footer_checksum(checksum_type)
+  );
 
   format_utils::check_header(
     check_in,
@@ -1455,8 +1571,15 @@ std::string document_mask_writer::filename(const segment_meta& meta) const {
   return file_name<document_mask_writer>(meta);
 }
 
+// returns number of words of the serialized mask of a segment with
+// 'docs_count' documents, i.e. the words covering doc_ids [0, docs_count]
+inline size_t document_mask_words(uint64_t docs_count) NOEXCEPT {
+  return size_t(docs_count / bits_required<document_mask::word_t>()) + 1;
+}
+
 void document_mask_writer::prepare(directory& dir, const segment_meta& meta) {
   auto filename = file_name<document_mask_writer>(meta);
+  docs_count_ = meta.docs_count;
 
   out_ = dir.create(filename);
 
@@ -1472,14 +1595,56 @@ void document_mask_writer::prepare(directory& dir, const segment_meta& meta) {
 void document_mask_writer::begin(uint32_t count) {
   format_utils::write_header(*out_, FORMAT_NAME, FORMAT_MAX);
   out_->write_vint(count);
+  mask_.clear();
 }
 
 void document_mask_writer::write(const doc_id_t& mask) {
-  out_->write_vlong(mask);
+  mask_.insert(mask);
+}
+
+void document_mask_writer::write(const document_mask& mask) {
+  if (mask_.empty()) {
+    mask_ = mask; // common case, whole mask at once
+    return;
+  }
+
+  iresearch::document_mask_writer::write(mask);
 }
 
 void document_mask_writer::end() {
+  const auto words = document_mask_words(docs_count_);
+
+  if (mask_.words() > words) {
+    throw index_error(); // doc_ids outside of the segment
+  }
+
+  out_->write_vlong(words);
+
+  // pad to word boundary so that words can be used directly from a mapping
+  while (out_->file_pointer() % sizeof(document_mask::word_t)) {
+    out_->write_byte(0);
+  }
+
+  if (!numeric_utils::is_big_endian()) {
+    out_->write_bytes(
+      reinterpret_cast<const byte_type*>(mask_.data()),
+      mask_.words() * sizeof(document_mask::word_t)
+    );
+  } else {
+    for (auto* word = mask_.data(), *end = word + mask_.words(); word != end; ++word) {
+      for (size_t i = 0; i < sizeof(document_mask::word_t); ++i) {
+        out_->write_byte(static_cast<byte_type>(*word >> (8 * i)));
+      }
+    }
+  }
+
+  // words following the last masked document
+  for (auto i = mask_.words(); i < words; ++i) {
+    out_->write_long(0);
+  }
+
   format_utils::write_footer(*out_);
+  mask_.clear();
 }
 
 // ----------------------------------------------------------------------------
@@ -1498,9 +1663,10 @@ bool document_mask_reader::prepare(
 
   // possible that the file does not exist since document_mask is optional
   if (dir.exists(exists, in_name) && !exists) {
-    checksum_index_input<boost::crc_32_type> empty_in;
+    format_utils::footer_checksum_input empty_in;
 
     in_.swap(empty_in);
+    docs_count_ = meta.docs_count;
 
     if (!seen) {
       IR_FRMT_ERROR("Failed to open file, path: %s", in_name.c_str());
@@ -1516,7 +1682,7 @@ bool document_mask_reader::prepare(
   auto in = dir.open(in_name);
 
   if (!in) {
-    checksum_index_input<boost::crc_32_type> empty_in;
+    format_utils::footer_checksum_input empty_in;
 
     IR_FRMT_ERROR("Failed to open file, path: %s", in_name.c_str());
     in_.swap(empty_in);
@@ -1524,9 +1690,13 @@ bool document_mask_reader::prepare(
     return false;
   }
 
-  checksum_index_input<boost::crc_32_type> check_in(std::move(in));
+  const auto checksum_type = format_utils::checksum_type(*in);
+  format_utils::footer_checksum_input check_in(
+    std::move(in), format_utils::footer_checksum(checksum_type)
+  );
 
   in_.swap(check_in);
+  docs_count_ = meta.docs_count;
 
   if (seen) {
     *seen = true;
@@ -1536,21 +1706,103 @@ bool document_mask_reader::prepare(
 }
 
 uint32_t document_mask_reader::begin() {
-  format_utils::check_header(
+  version_ = format_utils::check_header(
     in_,
     document_mask_writer::FORMAT_NAME,
     document_mask_writer::FORMAT_MIN,
     document_mask_writer::FORMAT_MAX
   );
 
-  return in_.read_vint();
+  const auto count = in_.read_vint();
+
+  docs_.clear();
+  mask_.clear();
+
+  if (version_ < document_mask_writer::FORMAT_BITSET) {
+    return count; // doc_ids are read one by one
+  }
+
+  const auto words = in_.read_vlong();
+
+  while (in_.file_pointer() % sizeof(document_mask::word_t)) {
+    in_.read_byte(); // padding
+  }
+
+  const auto size = words * sizeof(document_mask::word_t);
+
+  // the number of words is defined by the segment, check it before allocating
+  if (words != document_mask_words(docs_count_)
+      || in_.length() < in_.file_pointer() + size + format_utils::FOOTER_LEN) {
+    throw index_error(); // corrupted index
+  }
+
+  auto* data = mask_.reset(words);
+
+  if (size != in_.read_bytes(reinterpret_cast<byte_type*>(data), size)) {
+    throw index_error(); // corrupted index
+  }
+
+  if (numeric_utils::is_big_endian()) {
+    for (auto* word = data, *end = word + words; word != end; ++word) {
+      auto* bytes = reinterpret_cast<const byte_type*>(word);
+      document_mask::word_t value = 0;
+
+      for (size_t i = 0; i < sizeof(document_mask::word_t); ++i) {
+        value |= document_mask::word_t(bytes[i]) << (8 * i);
+      }
+
+      *word = value;
+    }
+  }
+
+  mask_.recount();
+
+  if (mask_.size() != count) {
+    throw index_error(); // corrupted index
+  }
+
+  return count;
 }
 
 void document_mask_reader::read(doc_id_t& doc_id) {
-  auto id = in_.read_vlong();
+  if (version_ < document_mask_writer::FORMAT_BITSET) {
+    auto id = in_.read_vlong();
+
+    static_assert(sizeof(doc_id_t) == sizeof(decltype(id)), "sizeof(doc_id) != sizeof(decltype(id))");
+    doc_id = id;
 
-  static_assert(sizeof(doc_id_t) == sizeof(decltype(id)), "sizeof(doc_id) != sizeof(decltype(id))");
-  doc_id = id;
+    return;
+  }
+
+  if (docs_.empty()) {
+    // materialize doc_ids for one by one access
+    docs_.reserve(mask_.size());
+    mask_.visit([this](doc_id_t doc)->bool {
+      docs_.emplace_back(doc);
+      return true;
+    });
+    std::reverse(docs_.begin(), docs_.end());
+    mask_.clear();
+  }
+
+  if (docs_.empty()) {
+    throw index_error(); // read past the end of the mask
+  }
+
+  doc_id = docs_.back();
+  docs_.pop_back();
+}
+
+void document_mask_reader::read(document_mask& mask, uint32_t count) {
+  if (version_ < document_mask_writer::FORMAT_BITSET
+      || mask_.size() != count
+      || !mask.empty()) {
+    iresearch::document_mask_reader::read(mask, count);
+    return;
+  }
+
+  mask = std::move(mask_); // whole mask at once
+  mask_.clear();
 }
 
 void document_mask_reader::end() {
@@ -1634,7 +1886,7 @@ class meta_reader final : public iresearch::column_meta_reader {
   virtual bool read(column_meta& column) override;
 
  private:
-  checksum_index_input<boost::crc_32_type> in_;
+  format_utils::footer_checksum_input in_;
   field_id count_{0};
 }; // meta_writer
 
@@ -1656,7 +1908,8 @@ bool meta_reader::prepare(
   count = in->read_int();
   in->seek(0);
 
-  checksum_index_input<boost::crc_32_type> check_in(std::move(in));
+  // the footer is followed by the number of columns and never verified
+  format_utils::footer_checksum_input check_in(std::move(in));
 
   format_utils::check_header(
     check_in, 
@@ -1700,12 +1953,87 @@ bool meta_reader::read(column_meta& column) {
 // |Last block #1 key|Block #1 offset| <-- Columnstore blocks index
 // |Last block #2 key|Block #2 offset|
 // ...
+// |Block #0 summary|
+// |Block #1 summary| <-- Columnstore blocks summaries (since FORMAT_SUMMARY)
+// ...
 // |Bloom filter offset| <- not implemented yet 
 // |Footer|
 
 const size_t INDEX_BLOCK_SIZE = 1024;
 const size_t MAX_DATA_BLOCK_SIZE = 4096;
 
+// blocks having longer values have no byte-wise bounds
+const size_t MAX_SUMMARY_VALUE_SIZE = 64;
+
+enum BlockSummaryProperty : byte_type {
+  BSP_NONE = 0,
+  BSP_BYTES = 1, // byte-wise bounds
+  BSP_LONG = 2 // bounds of the values written with 'write_zvlong(...)'
+}; // BlockSummaryProperty
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_summary
+/// @brief accumulates bounds of the values of a column data block
+////////////////////////////////////////////////////////////////////////////////
+class block_summary {
+ public:
+  void update(const bytes_ref& value) {
+    if (props_ & BSP_BYTES) {
+      if (value.size() > MAX_SUMMARY_VALUE_SIZE) {
+        props_ &= ~BSP_BYTES;
+      } else if (empty_) {
+        min_ = value;
+        max_ = value;
+      } else if (value < min_) {
+        min_ = value;
+      } else if (max_ < value) {
+        max_ = value;
+      }
+    }
+
+    int64_t number;
+
+    if ((props_ & BSP_LONG) && decode_zvlong(value, number)) {
+      min_long_ = empty_ ? number : std::min(min_long_, number);
+      max_long_ = empty_ ? number : std::max(max_long_, number);
+    } else {
+      props_ &= ~BSP_LONG;
+    }
+
+    empty_ = false;
+  }
+
+  void write(data_output& out, doc_id_t min_key, doc_id_t max_key) const {
+    assert(!empty_ && min_key <= max_key);
+    out.write_byte(props_);
+    out.write_vlong(min_key);
+    out.write_vlong(max_key - min_key);
+
+    if (props_ & BSP_BYTES) {
+      write_string(out, min_);
+      write_string(out, max_);
+    }
+
+    if (props_ & BSP_LONG) {
+      write_zvlong(out, min_long_);
+      write_zvlong(out, max_long_);
+    }
+  }
+
+  void reset() NOEXCEPT {
+    props_ = BSP_BYTES | BSP_LONG;
+    empty_ = true;
+  }
+
+ private:
+  bstring min_;
+  bstring max_;
+  int64_t min_long_{};
+  int64_t max_long_{};
+  byte_type props_{ BSP_BYTES | BSP_LONG };
+  bool empty_{ true };
+}; // block_summary
+
 // By default we treat columns as a variable length sparse columns
 enum ColumnProperty : uint32_t {
   CP_SPARSE = 0,
@@ -1900,7 +2228,8 @@ class index_block {
 class writer final : public iresearch::columnstore_writer {
  public:
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_SUMMARY = 1; // blocks summaries
+  static const int32_t FORMAT_MAX = FORMAT_SUMMARY;
 
   static const string_ref FORMAT_NAME;
   static const string_ref FORMAT_EXT;
@@ -1927,6 +2256,11 @@ class writer final : public iresearch::columnstore_writer {
 
       // commit previous key and offset unless the 'reset' method has been called
       if (max_ != pending_key_) {
+        assert(offset <= block_buf_.size());
+        summary_.update(bytes_ref(
+          block_buf_.c_str() + offset, block_buf_.size() - offset
+        ));
+
         // will trigger 'flush_block' if offset >= MAX_DATA_BLOCK_SIZE
         offset = offsets_[size_t(block_index_.push_back(pending_key_, offset))];
         max_ = pending_key_;
@@ -1958,6 +2292,8 @@ class writer final : public iresearch::columnstore_writer {
       out.write_vlong(avg_block_count_); // avg number of elements per block
       out.write_vlong(column_index_.total()); // total number of index blocks
       blocks_index_.file >> out; // column blocks index
+      out.write_vlong(column_index_.total()); // total number of blocks summaries
+      blocks_summary_.file >> out; // column blocks summaries
     }
 
     void flush() {
@@ -1971,6 +2307,7 @@ class writer final : public iresearch::columnstore_writer {
       // finish column blocks index
       column_index_.flush(blocks_index_.stream, ctx_->buf_);
       blocks_index_.stream.flush();
+      blocks_summary_.stream.flush();
     }
 
     virtual void close() override {
@@ -2023,6 +2360,10 @@ class writer final : public iresearch::columnstore_writer {
       props_ &= block_props;
       // reset buffer stream after flush
       block_buf_.reset();
+
+      // number of summaries is equal to the number of blocks
+      summary_.write(blocks_summary_.stream, min_, max_);
+      summary_.reset();
     }
 
     writer* ctx_; // writer context
@@ -2031,6 +2372,8 @@ class writer final : public iresearch::columnstore_writer {
     index_block<INDEX_BLOCK_SIZE> block_index_; // current block index (per document key/offset)
     index_block<INDEX_BLOCK_SIZE> column_index_; // column block index (per block key/offset)
     memory_output blocks_index_; // blocks index
+    memory_output blocks_summary_; // blocks summaries
+    block_summary summary_; // summary of the current block
     bytes_output block_buf_{ 2*MAX_DATA_BLOCK_SIZE }; // data buffer
     doc_id_t min_{ type_limits<type_t::doc_id_t>::eof() }; // min key
     doc_id_t max_{ type_limits<type_t::doc_id_t>::eof() }; // max key
@@ -2139,36 +2482,189 @@ bool writer::flush() {
   return true;
 }
 
-template<typename Block, typename Allocator>
-class block_cache : irs::util::noncopyable {
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       Block cache
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_cache
+/// @brief process-wide cache of the decoded column blocks bounded by the total
+///        size of the cached blocks, uses CLOCK eviction policy
+/// @note evicted blocks stay in memory until they're unpinned by the readers
+////////////////////////////////////////////////////////////////////////////////
+class block_cache
+    : public std::enable_shared_from_this<block_cache>,
+      util::noncopyable {
  public:
-  block_cache(const Allocator& alloc = Allocator())
-    : cache_(alloc) {
+  typedef std::shared_ptr<const void> block_ptr;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @class slot
+  /// @brief cache entry of a particular column block
+  //////////////////////////////////////////////////////////////////////////////
+  class slot : private atomic_base<block_ptr>, util::noncopyable {
+   public:
+    slot() = default;
+
+    slot(slot&& other) NOEXCEPT {
+      assert(!other.block_); // column index is never moved after use
+      UNUSED(other);
+    }
+
+    ~slot() {
+      if (cache_) {
+        cache_->remove(*this);
+      }
+    }
+
+    template<typename Block>
+    std::shared_ptr<const Block> get() const {
+      block_ptr block = atomic_load(&block_);
+
+      if (block) {
+        referenced_.store(true, std::memory_order_relaxed);
+      }
+
+      return std::static_pointer_cast<const Block>(block);
+    }
+
+   private:
+    friend class block_cache;
+
+    static const size_t NPOS = integer_traits<size_t>::const_max;
+
+    block_ptr block_;
+    std::shared_ptr<block_cache> cache_; // cache the slot was ever put into
+    mutable std::atomic<bool> referenced_{ false };
+    size_t size_{}; // size of the cached block
+    size_t pos_{ NPOS }; // position in the clock ring
+  }; // slot
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @note every slot ever put into the cache keeps it alive, i.e. readers
+  ///       destroyed after the static one (e.g. during exit) are still safe
+  //////////////////////////////////////////////////////////////////////////////
+  static block_cache& instance() {
+    static const std::shared_ptr<block_cache> cache(new block_cache());
+    return *cache;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief caches the specified 'block' of 'size' bytes in a given 'slot'
+  ///        unless the slot is already filled
+  /// @returns the block held by the slot
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename Block>
+  std::shared_ptr<const Block> put(
+      slot& slot, std::shared_ptr<const Block>&& block, size_t size) {
+    SCOPED_LOCK(mutex_);
+
+    if (slot::NPOS != slot.pos_) {
+      // already cached by another thread
+      return std::static_pointer_cast<const Block>(slot.block_);
+    }
+
+    if (size > limit_) {
+      return std::move(block); // don't flush the whole cache for a single block
+    }
+
+    evict(size);
+
+    if (!slot.cache_) {
+      slot.cache_ = shared_from_this();
+    }
+
+    slot.size_ = size;
+    slot.pos_ = ring_.size();
+    slot.referenced_.store(false, std::memory_order_relaxed);
+    ring_.push_back(&slot);
+    size_ += size;
+
+    block_ptr cached = block;
+    slot.atomic_store(&slot.block_, cached);
+
+    return std::move(block);
   }
-  block_cache(block_cache&& rhs) 
-    : cache_(std::move(rhs.cache_)) {
+
+  void remove(slot& slot) {
+    SCOPED_LOCK(mutex_);
+
+    if (slot::NPOS != slot.pos_) {
+      unlink(slot);
+    }
   }
 
-  template<typename... Args>
-  Block& emplace_back(Args&&... args) {
-    cache_.emplace_back(std::forward<Args>(args)...);
-    return cache_.back();
+  void limit(size_t limit) {
+    SCOPED_LOCK(mutex_);
+    limit_ = limit;
+    evict(0);
   }
 
-  void pop_back() {
-    cache_.pop_back();
+  size_t limit() const {
+    SCOPED_LOCK(mutex_);
+    return limit_;
   }
 
+  size_t size() const {
+    SCOPED_LOCK(mutex_);
+    return size_;
+  }
+
+  void hit() NOEXCEPT { hits_.fetch_add(1, std::memory_order_relaxed); }
+  void miss() NOEXCEPT { misses_.fetch_add(1, std::memory_order_relaxed); }
+
+  uint64_t hits() const NOEXCEPT { return hits_.load(); }
+  uint64_t misses() const NOEXCEPT { return misses_.load(); }
+  uint64_t evictions() const NOEXCEPT { return evictions_.load(); }
+
  private:
-  std::deque<Block, Allocator> cache_; // pointers remain valid
-}; // block_cache
+  block_cache() NOEXCEPT
+    : limit_(version10::columnstore_cache::DEFAULT_LIMIT),
+      hits_(0), misses_(0), evictions_(0) {
+  }
 
-template<typename Block, typename Allocator>
-struct block_cache_traits {
-  typedef Block block_t;
-  typedef typename std::allocator_traits<Allocator>::template rebind_alloc<block_t> allocator_t;
-  typedef block_cache<Block, allocator_t> cache_t;
-};
+  // evicts blocks until 'size' more bytes fit into the cache
+  void evict(size_t size) {
+    while (!ring_.empty() && size_ + size > limit_) {
+      if (hand_ >= ring_.size()) {
+        hand_ = 0;
+      }
+
+      auto& slot = *ring_[hand_];
+
+      if (slot.referenced_.exchange(false, std::memory_order_relaxed)) {
+        ++hand_; // give recently used block a second chance
+        continue;
+      }
+
+      unlink(slot); // last block in the ring takes the place of the evicted one
+      evictions_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+  void unlink(slot& slot) {
+    assert(slot.pos_ < ring_.size() && &slot == ring_[slot.pos_]);
+
+    ring_.back()->pos_ = slot.pos_;
+    ring_[slot.pos_] = ring_.back();
+    ring_.pop_back();
+
+    size_ -= slot.size_;
+    slot.pos_ = slot::NPOS;
+
+    block_ptr empty;
+    slot.atomic_store(&slot.block_, empty); // readers may still pin the block
+  }
+
+  mutable std::mutex mutex_;
+  std::vector<slot*> ring_; // cached slots
+  size_t hand_{}; // clock hand
+  size_t size_{}; // total size of the cached blocks
+  size_t limit_; // max total size of the cached blocks
+  std::atomic<uint64_t> hits_;
+  std::atomic<uint64_t> misses_;
+  std::atomic<uint64_t> evictions_;
+}; // block_cache
 
 // -----------------------------------------------------------------------------
 // --SECTION--                                                            Blocks
@@ -2254,6 +2750,11 @@ class sparse_block : util::noncopyable {
     const bstring* data_{};
   }; // iterator
 
+  // memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
   bool load(index_input& in, decompressor& decomp, bstring& buf) {
     const size_t size = in.read_vlong(); // total number of entries in a block
     assert(size);
@@ -2436,6 +2937,11 @@ class dense_block : util::noncopyable {
     doc_id_t base_{};
   }; // iterator
 
+  // memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
   bool load(index_input& in, decompressor& decomp, bstring& buf) {
     const size_t size = in.read_vlong(); // total number of entries in a block
     assert(size);
@@ -2601,6 +3107,11 @@ class dense_fixed_length_block : util::noncopyable {
     const bstring* data_{};
   }; // iterator
 
+  // memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this) + data_.capacity();
+  }
+
   bool load(index_input& in, decompressor& decomp, bstring& buf) {
     size_ = in.read_vlong(); // total number of entries in a block
     assert(size_);
@@ -2734,6 +3245,11 @@ class sparse_mask_block : util::noncopyable {
     );
   }
 
+  // memory occupied by the block
+  size_t memory() const NOEXCEPT {
+    return sizeof(*this);
+  }
+
   bool load(index_input& in, decompressor& /*decomp*/, bstring& buf) {
     size_ = in.read_vlong(); // total number of entries in a block
     assert(size_);
@@ -2790,12 +3306,7 @@ class sparse_mask_block : util::noncopyable {
 // doesn't store any data
 struct dense_mask_block;
 
-template<typename Allocator = std::allocator<sparse_block>>
-class read_context
-  : public block_cache_traits<sparse_block, Allocator>::cache_t,
-    public block_cache_traits<dense_block, Allocator>::cache_t,
-    public block_cache_traits<dense_fixed_length_block, Allocator>::cache_t,
-    public block_cache_traits<sparse_mask_block, Allocator>::cache_t {
+class read_context {
  public:
   DECLARE_SPTR(read_context);
 
@@ -2811,55 +3322,36 @@ class read_context
     return std::make_shared<read_context>(std::move(clone));
   }
 
-  read_context(index_input::ptr&& in = index_input::ptr(), const Allocator& alloc = Allocator())
-    : block_cache_traits<sparse_block, Allocator>::cache_t(typename block_cache_traits<sparse_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_block, Allocator>::cache_t(typename block_cache_traits<dense_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<dense_fixed_length_block, Allocator>::cache_t(typename block_cache_traits<dense_fixed_length_block, Allocator>::allocator_t(alloc)),
-      block_cache_traits<sparse_mask_block, Allocator>::cache_t(typename block_cache_traits<sparse_mask_block, Allocator>::allocator_t(alloc)),
-      buf_(INDEX_BLOCK_SIZE*sizeof(uint64_t), 0),
+  read_context(index_input::ptr&& in = index_input::ptr())
+    : buf_(INDEX_BLOCK_SIZE*sizeof(uint64_t), 0),
       stream_(std::move(in)) {
   }
 
-  template<typename Block, typename... Args>
-  Block* emplace_back(uint64_t offset, Args&&... args) {
-    auto& block = emplace_block<Block>(
-      std::forward<Args>(args)...
-    ); // add cache entry
-
-    if (!load(block, offset)) {
-      // unable to load block
-      pop_back<Block>();
-      return nullptr;
-    }
-
-    return &block;
-  }
-
   template<typename Block>
   bool load(Block& block, uint64_t offset) {
     stream_->seek(offset); // seek to the offset
     return block.load(*stream_, decomp_, buf_);
   }
 
+  // loads block from the data previously read via 'read(...)'
   template<typename Block>
-  void pop_back() {
-    typename block_cache_traits<Block, Allocator>::cache_t& cache = *this;
-    cache.pop_back();
+  bool load(Block& block, const bytes_ref& data) {
+    bytes_ref_input in(data);
+    return block.load(in, decomp_, buf_);
   }
 
- private:
-  template<typename Block, typename... Args>
-  Block& emplace_block(Args&&... args) {
-    typename block_cache_traits<Block, Allocator>::cache_t& cache = *this;
-    return cache.emplace_back(std::forward<Args>(args)...);
+  // reads the whole batch at once, throws 'io_error' on failure
+  void read(read_request* requests, size_t count) {
+    stream_->read_batch(requests, count);
   }
 
+ private:
   decompressor decomp_; // decompressor
   bstring buf_; // temporary buffer for decoding/unpacking
   index_input::ptr stream_;
 }; // read_context
 
-typedef read_context<> read_context_t;
+typedef read_context read_context_t;
 
 class context_provider : private util::noncopyable {
  public:
@@ -2867,86 +3359,156 @@ class context_provider : private util::noncopyable {
     : pool_(std::max(size_t(1), max_pool_size)) {
   }
 
-  void prepare(index_input::ptr&& stream) NOEXCEPT {
+  // 'offsets' denote sorted start offsets of all blocks in the stream
+  // followed by the end offset of the last one
+  void prepare(
+      index_input::ptr&& stream,
+      std::vector<uint64_t>&& offsets
+  ) NOEXCEPT {
     stream_ = std::move(stream);
+    offsets_ = std::move(offsets);
   }
 
   bounded_object_pool<read_context_t>::ptr get_context() const {
     return pool_.emplace(*stream_);
   }
 
+  // returns size of the block starting at the specified offset in bytes
+  size_t block_size(uint64_t offset) const NOEXCEPT {
+    const auto next = std::upper_bound(offsets_.begin(), offsets_.end(), offset);
+    assert(next != offsets_.end());
+
+    return next == offsets_.end() ? 0 : size_t(*next - offset);
+  }
+
  private:
   mutable bounded_object_pool<read_context_t> pool_;
   index_input::ptr stream_;
+  std::vector<uint64_t> offsets_; // blocks offsets, used for batched reads
 }; // context_provider
 
 // in case of success caches block pointed
 // by 'ref' and retuns a pointer to cached
 // instance, nullptr otherwise
+// returned block stays valid while pinned
+// by the caller even if evicted from cache
 template<typename BlockRef>
-const typename BlockRef::block_t* load_block(
+std::shared_ptr<const typename BlockRef::block_t> load_block(
     const context_provider& ctxs,
-    BlockRef& ref) {
+    const BlockRef& ref) {
   typedef typename BlockRef::block_t block_t;
 
-  const auto* cached = ref.pblock.load();
+  auto& cache = block_cache::instance();
+  auto cached = ref.pblock.template get<block_t>();
 
-  if (!cached) {
-    auto ctx = ctxs.get_context();
+  if (cached) {
+    cache.hit();
+    return cached;
+  }
 
-    if (!ctx) {
-      // unable to get context
-      return nullptr;
-    }
+  cache.miss();
 
-    // load block
-    const auto* block = ctx->template emplace_back<block_t>(ref.offset);
+  auto ctx = ctxs.get_context();
 
-    if (!block) {
-      // failed to load block
-      return nullptr;
-    }
+  if (!ctx) {
+    // unable to get context
+    return nullptr;
+  }
 
-    // mark block as loaded
-    if (ref.pblock.compare_exchange_strong(cached, block)) {
-      cached = block;
-    } else {
-      // already cached by another thread
-      ctx->template pop_back<block_t>();
-    }
+  auto block = std::make_shared<block_t>();
+
+  if (!ctx->load(*block, ref.offset)) {
+    // failed to load block
+    return nullptr;
   }
 
-  return cached;
+  const auto size = block->memory();
+
+  // already cached block is returned if any
+  return cache.put(
+    ref.pblock, std::shared_ptr<const block_t>(std::move(block)), size
+  );
 }
 
-// in case of success caches block pointed
-// by 'ref' in the specified 'block' and
-// retuns a pointer to cached instance,
-// nullptr otherwise
-template<typename BlockRef>
-const typename BlockRef::block_t* load_block(
+// passes every block in [begin;end) to the specified visitor, blocks
+// missing in cache are read via a single batched read per
+// 'MAX_BATCH_BLOCKS' blocks and aren't cached after all, since bulk
+// visitation is used by merges which touch each block exactly once
+template<typename Iterator>
+bool visit_values(
     const context_provider& ctxs,
-    const BlockRef& ref,
-    typename BlockRef::block_t& block) {
-  const auto* cached = ref.pblock.load();
+    Iterator begin, Iterator end,
+    const columnstore_reader::values_visitor_f& visitor) {
+  typedef typename std::iterator_traits<Iterator>::value_type::block_t block_t;
 
-  if (!cached) {
-    auto ctx = ctxs.get_context();
+  static const size_t MAX_BATCH_BLOCKS = 16;
+  static const size_t MAX_BATCH_BYTES = 1024*1024;
 
-    if (!ctx) {
-      // unable to get context
-      return nullptr;
+  auto ctx = ctxs.get_context();
+
+  if (!ctx) {
+    // unable to get context
+    return false;
+  }
+
+  std::shared_ptr<const block_t> cached[MAX_BATCH_BLOCKS];
+  read_request requests[MAX_BATCH_BLOCKS];
+  bstring buf;
+  block_t block;
+
+  while (begin != end) {
+    size_t count = 0; // number of blocks in a batch
+    size_t reads = 0; // number of blocks to read
+    size_t total = 0; // number of bytes to read
+
+    for (auto it = begin;
+         it != end && count < MAX_BATCH_BLOCKS && total < MAX_BATCH_BYTES;
+         ++it, ++count) {
+      cached[count] = it->pblock.template get<block_t>();
+
+      if (!cached[count]) {
+        auto& req = requests[reads++];
+        req.offset = it->offset;
+        req.size = ctxs.block_size(it->offset);
+        total += req.size;
+      }
     }
 
-    if (!ctx->load(block, ref.offset)) {
-      // unable to load block
-      return nullptr;
+    if (reads) {
+      buf.resize(total);
+
+      auto* data = &buf[0];
+      for (auto* req = requests, *req_end = requests + reads; req != req_end; ++req) {
+        req->buf = data;
+        data += req->size;
+      }
+
+      ctx->read(requests, reads);
     }
 
-    cached = &block;
+    for (size_t i = 0, read = 0; i < count; ++i, ++begin) {
+      const block_t* pblock = cached[i].get();
+
+      if (!pblock) {
+        const auto& req = requests[read++];
+
+        if (!ctx->load(block, bytes_ref(req.buf, req.size))) {
+          // unable to load block
+          return false;
+        }
+
+        pblock = &block;
+      }
+
+      if (!pblock->visit(visitor)) {
+        return false;
+      }
+
+      cached[i] = nullptr; // unpin block
+    }
   }
 
-  return cached;
+  return true;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -2964,6 +3526,10 @@ class column
 
   virtual ~column() { }
 
+  // appends offsets of the blocks stored by the column, the offsets bound
+  // the blocks of every column in batched reads
+  virtual void block_offsets(std::vector<uint64_t>& offsets) const = 0;
+
   virtual bool read(data_input& in, uint64_t* /*buf*/) {
     count_ = in.read_vlong();
     max_ = in.read_vlong();
@@ -2975,6 +3541,58 @@ class column
     return true;
   }
 
+  bool read_summaries(data_input& in) {
+    std::vector<summary> summaries(in.read_vlong());
+
+    for (auto& summary : summaries) {
+      summary.props = in.read_byte();
+      summary.min_key = in.read_vlong();
+      summary.max_key = summary.min_key + in.read_vlong();
+
+      if (summary.props & BSP_BYTES) {
+        summary.min = read_string<bstring>(in);
+        summary.max = read_string<bstring>(in);
+      }
+
+      if (summary.props & BSP_LONG) {
+        summary.min_long = read_zvlong(in);
+        summary.max_long = read_zvlong(in);
+      }
+    }
+
+    summaries_ = std::move(summaries);
+    has_summaries_ = true;
+    return true;
+  }
+
+  virtual bool visit_blocks(
+      const columnstore_reader::blocks_visitor_f& visitor
+  ) const override {
+    if (!has_summaries_) {
+      return false;
+    }
+
+    columnstore_reader::block_summary block;
+
+    for (auto& summary : summaries_) {
+      const bool has_bytes = 0 != (summary.props & BSP_BYTES);
+
+      block.min_key = summary.min_key;
+      block.max_key = summary.max_key;
+      block.min = has_bytes ? bytes_ref(summary.min) : bytes_ref::nil;
+      block.max = has_bytes ? bytes_ref(summary.max) : bytes_ref::nil;
+      block.min_long = summary.min_long;
+      block.max_long = summary.max_long;
+      block.has_long = 0 != (summary.props & BSP_LONG);
+
+      if (!visitor(block)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   doc_id_t max() const NOEXCEPT { return max_; }
   virtual size_t size() const NOEXCEPT override { return count_; }
   bool empty() const NOEXCEPT { return 0 == size(); }
@@ -2983,6 +3601,18 @@ class column
   ColumnProperty props() const NOEXCEPT { return props_; }
 
  private:
+  struct summary {
+    doc_id_t min_key;
+    doc_id_t max_key;
+    bstring min;
+    bstring max;
+    int64_t min_long{};
+    int64_t max_long{};
+    byte_type props;
+  }; // summary
+
+  std::vector<summary> summaries_; // blocks summaries
+  bool has_summaries_{}; // written since FORMAT_SUMMARY
   doc_id_t max_{ type_limits<type_t::doc_id_t>::eof() };
   size_t count_{};
   size_t avg_block_size_{};
@@ -3046,7 +3676,7 @@ class column_iterator final : public irs::columnstore_iterator {
       return false;
     }
 
-    const auto* cached = load_block(*column_->ctxs_, *begin_);
+    auto cached = load_block(*column_->ctxs_, *begin_);
 
     if (!cached) {
       // unable to load block, seal the iterator
@@ -3057,6 +3687,7 @@ class column_iterator final : public irs::columnstore_iterator {
 
     if (block_ != *cached) {
       block_.reset(*cached);
+      cached_ = std::move(cached); // pin the block while iterating over it
     }
 
     seek_origin_ = begin_++;
@@ -3065,6 +3696,7 @@ class column_iterator final : public irs::columnstore_iterator {
   }
 
   block_iterator_t block_;
+  std::shared_ptr<const block_t> cached_; // block referenced by 'block_'
   const typename column_t::block_ref* begin_;
   const typename column_t::block_ref* seek_origin_;
   const typename column_t::block_ref* end_;
@@ -3081,8 +3713,13 @@ if (column.empty()) {
     return columnstore_reader::empty_reader();
   }
 
-  return [&column](doc_id_t key, bytes_ref& value) {
-    return column.value(key, value);
+  // the value stays valid until the next call of the same reader since
+  // the reader keeps the last accessed block in memory, every copy of
+  // the reader pins its own block, i.e. copies may be used concurrently
+  block_cache::block_ptr pinned;
+
+  return [&column, pinned](doc_id_t key, bytes_ref& value) mutable {
+    return column.value(key, value, pinned);
   };
 }
 
@@ -3162,7 +3799,10 @@ class sparse_column final : public column {
     return true;
   }
 
-  bool value(doc_id_t key, bytes_ref& value) const {
+  bool value(
+      doc_id_t key,
+      bytes_ref& value,
+      block_cache::block_ptr& pinned) const {
     // find the right block
     const auto rbegin = refs_.rbegin(); // upper bound
     const auto rend = refs_.rend();
@@ -3176,7 +3816,7 @@ class sparse_column final : public column {
       return false;
     }
 
-    const auto* cached = load_block(*ctxs_, *it);
+    auto cached = load_block(*ctxs_, *it);
 
     if (!cached) {
       // unable to load block
@@ -3184,28 +3824,24 @@ class sparse_column final : public column {
     }
 
     assert(cached);
-    return cached->value(key, value);
+    const auto found = cached->value(key, value);
+    pinned = std::move(cached);
+
+    return found;
   };
 
   virtual bool visit(
       const columnstore_reader::values_visitor_f& visitor
   ) const override {
-    block_t block; // don't cache new blocks
-    for (auto begin = refs_.begin(), end = refs_.end()-1; begin != end; ++begin) { // -1 for upper bound
-      const auto* cached = load_block(*ctxs_, *begin, block);
-
-      if (!cached) {
-        // unable to load block
-        return false;
-      }
-
-      assert(cached);
+    return visit_values(
+      *ctxs_, refs_.begin(), refs_.end() - 1, visitor // -1 for upper bound
+    );
+  }
 
-      if (!cached->visit(visitor)) {
-        return false;
-      }
+  virtual void block_offsets(std::vector<uint64_t>& offsets) const override {
+    for (auto begin = refs_.begin(), end = refs_.end()-1; begin != end; ++begin) { // -1 for upper bound
+      offsets.push_back(begin->offset);
     }
-    return true;
   }
 
   virtual columnstore_iterator::ptr iterator() const override {
@@ -3233,13 +3869,14 @@ class sparse_column final : public column {
     block_ref() = default;
 
     block_ref(block_ref&& other) NOEXCEPT
-      : key(std::move(other.key)), offset(std::move(other.offset)) {
-      pblock = other.pblock.exchange(nullptr); // no std::move(...) for std::atomic<...>
+      : key(std::move(other.key)),
+        offset(std::move(other.offset)),
+        pblock(std::move(other.pblock)) {
     }
 
     doc_id_t key; // min key in a block
     uint64_t offset; // block offset
-    mutable std::atomic<const block_t*> pblock; // pointer to cached block
+    mutable block_cache::slot pblock; // cached block
   }; // block_ref
 
   typedef std::vector<block_ref> refs_t;
@@ -3361,7 +3998,10 @@ class dense_fixed_length_column final : public column {
     return true;
   }
 
-  bool value(doc_id_t key, bytes_ref& value) const {
+  bool value(
+      doc_id_t key,
+      bytes_ref& value,
+      block_cache::block_ptr& pinned) const {
     if ((key -= min_) >= this->size()) {
       return false;
     }
@@ -3369,9 +4009,7 @@ class dense_fixed_length_column final : public column {
     const auto block_idx = key / this->avg_block_count();
     assert(block_idx < refs_.size());
 
-    auto& ref = const_cast<block_ref&>(refs_[block_idx]);
-
-    const auto* cached = load_block(*ctxs_, ref);
+    auto cached = load_block(*ctxs_, refs_[block_idx]);
 
     if (!cached) {
       // unable to load block
@@ -3379,29 +4017,22 @@ class dense_fixed_length_column final : public column {
     }
 
     assert(cached);
-    return cached->value(key -= block_idx*this->avg_block_count(), value);
+    const auto found = cached->value(key -= block_idx*this->avg_block_count(), value);
+    pinned = std::move(cached);
+
+    return found;
   }
 
   virtual bool visit(
       const columnstore_reader::values_visitor_f& visitor
   ) const override {
-    block_t block; // don't cache new blocks
-    for (auto& ref : refs_) {
-      const auto* cached = load_block(*ctxs_, ref, block);
-
-      if (!cached) {
-        // unable to load block
-        return false;
-      }
-
-      assert(cached);
+    return visit_values(*ctxs_, refs_.begin(), refs_.end(), visitor);
+  }
 
-      if (!cached->visit(visitor)) {
-        return false;
-      }
+  virtual void block_offsets(std::vector<uint64_t>& offsets) const override {
+    for (auto& ref : refs_) {
+      offsets.push_back(ref.offset);
     }
-
-    return true;
   }
 
   virtual columnstore_iterator::ptr iterator() const override {
@@ -3429,12 +4060,12 @@ class dense_fixed_length_column final : public column {
     block_ref() = default;
 
     block_ref(block_ref&& other) NOEXCEPT
-      : offset(std::move(other.offset)) {
-      pblock = other.pblock.exchange(nullptr); // no std::move(...) for std::atomic<...>
+      : offset(std::move(other.offset)),
+        pblock(std::move(other.pblock)) {
     }
 
     uint64_t offset; // need to store base offset since blocks may not be located sequentially
-    mutable std::atomic<const block_t*> pblock;
+    mutable block_cache::slot pblock; // cached block
   }; // block_ref
 
   typedef std::vector<block_ref> refs_t;
@@ -3509,10 +4140,10 @@ class dense_fixed_length_column<dense_mask_block> final : public column {
         return false;
       }
 
-      // skip offsets, they point to "garbage" data
+      // offsets point to "garbage" data, keep them as bounds only
       encode::avg::visit_block_packed(
         in, INDEX_BLOCK_SIZE, buf,
-        [](uint64_t ) {}
+        [this](uint64_t offset) { offsets_.push_back(offset); }
       );
 
       blocks_count -= INDEX_BLOCK_SIZE;
@@ -3529,10 +4160,10 @@ class dense_fixed_length_column<dense_mask_block> final : public column {
         return false;
       }
 
-      // skip offsets, they point to "garbage" data
+      // offsets point to "garbage" data, keep them as bounds only
       encode::avg::visit_block_packed_tail(
         in, blocks_count, buf,
-        [](uint64_t ) { }
+        [this](uint64_t offset) { offsets_.push_back(offset); }
       );
     }
 
@@ -3542,7 +4173,10 @@ class dense_fixed_length_column<dense_mask_block> final : public column {
     return true;
   }
 
-  bool value(doc_id_t key, bytes_ref& value) const NOEXCEPT {
+  bool value(
+      doc_id_t key,
+      bytes_ref& value,
+      block_cache::block_ptr& /*pinned*/) const NOEXCEPT {
     value = bytes_ref::nil;
     return key > min_ && key <= this->max();
   }
@@ -3561,6 +4195,10 @@ class dense_fixed_length_column<dense_mask_block> final : public column {
     return true;
   }
 
+  virtual void block_offsets(std::vector<uint64_t>& offsets) const override {
+    offsets.insert(offsets.end(), offsets_.begin(), offsets_.end());
+  }
+
   virtual columnstore_iterator::ptr iterator() const override;
 
   virtual columnstore_reader::values_reader_f values() const override {
@@ -3607,6 +4245,7 @@ class dense_fixed_length_column<dense_mask_block> final : public column {
     doc_id_t max_{ type_limits<type_t::doc_id_t>::invalid() };
   }; // column_iterator
 
+  std::vector<uint64_t> offsets_; // offsets of the blocks never read
   doc_id_t min_{}; // min key (less than any key in column)
 }; // dense_fixed_length_column
 
@@ -3691,7 +4330,7 @@ bool reader::prepare(
   }
 
   // check header
-  format_utils::check_header(
+  const auto version = format_utils::check_header(
     *stream,
     writer::FORMAT_NAME,
     writer::FORMAT_MIN,
@@ -3707,9 +4346,11 @@ bool reader::prepare(
 
   // seek to data start
   stream->seek(stream->length() - format_utils::FOOTER_LEN - sizeof(uint64_t));
-  stream->seek(stream->read_long()); // seek to blocks index
+  const auto blocks_index = stream->read_long();
+  stream->seek(blocks_index); // seek to blocks index
 
   uint64_t buf[INDEX_BLOCK_SIZE]; // temporary buffer for bit packing
+  std::vector<uint64_t> offsets;
   std::vector<column::ptr> columns;
   columns.reserve(stream->read_vlong());
   for (size_t i = 0, size = columns.capacity(); i < size; ++i) {
@@ -3725,11 +4366,22 @@ bool reader::prepare(
       return false;
     }
 
+    // read blocks summaries
+    if (version >= writer::FORMAT_SUMMARY && !column->read_summaries(*stream)) {
+      IR_FRMT_ERROR("Unable to load blocks summaries for column id=" IR_SIZE_T_SPECIFIER, i);
+      return false;
+    }
+
+    column->block_offsets(offsets);
     columns.emplace_back(std::move(column));
   }
 
+  // data blocks are followed by the blocks index
+  offsets.push_back(blocks_index);
+  std::sort(offsets.begin(), offsets.end());
+
   // noexcept
-  context_provider::prepare(std::move(stream));
+  context_provider::prepare(std::move(stream), std::move(offsets));
   columns_ = std::move(columns);
 
   if (seen) {
@@ -3747,6 +4399,31 @@ const reader::column_reader* reader::column(field_id field) const {
 
 NS_END // columns
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                columnstore_cache
+// ----------------------------------------------------------------------------
+
+/*static*/ void columnstore_cache::limit(size_t bytes) {
+  columns::block_cache::instance().limit(bytes);
+}
+
+/*static*/ size_t columnstore_cache::limit() {
+  return columns::block_cache::instance().limit();
+}
+
+/*static*/ columnstore_cache::stats columnstore_cache::statistics() {
+  const auto& cache = columns::block_cache::instance();
+
+  stats stats;
+  stats.hits = cache.hits();
+  stats.misses = cache.misses();
+  stats.evictions = cache.evictions();
+  stats.size = cache.size();
+  stats.limit = cache.limit();
+
+  return stats;
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                                  postings_writer
 // ----------------------------------------------------------------------------
@@ -3937,6 +4614,7 @@ irs::postings_writer::state postings_writer::write(doc_iterator& docs) {
     ++meta->docs_count;
     if (tfreq) {
       (*tfreq) += freq->value;
+      meta->max_freq = std::max(meta->max_freq, freq->value);
     }
 
     end_doc();
@@ -3981,6 +4659,8 @@ void postings_writer::begin_term() {
 
   doc.last = type_limits<type_t::doc_id_t>::min(); // for proper delta of 1st id
   doc.block_last = type_limits<type_t::doc_id_t>::invalid();
+  doc.block_max_freq = 0;
+  std::fill_n(doc.skip_max_freq, MAX_SKIP_LEVELS, 0);
   skip_.reset();
 }
 
@@ -3997,6 +4677,7 @@ void postings_writer::begin_doc(doc_id_t id, const frequency* freq) {
   doc.doc(id - doc.last);
   if (freq) {
     doc.freq(freq->value);
+    doc.block_max_freq = std::max(doc.block_max_freq, freq->value);
   }
 
   doc.next(id);
@@ -4202,6 +4883,26 @@ void postings_writer::write_skip(size_t level, index_output& out) {
       pay_->skip_ptr[level] = pay_ptr;
     }
   }
+
+  if (features_.freq()) {
+    // max frequency of the documents covered by the skip, level 0 is always
+    // written first, so the block maximum is propagated to the upper levels
+    uint64_t max_freq;
+
+    if (0 == level) {
+      max_freq = doc.block_max_freq;
+      doc.block_max_freq = 0;
+
+      for (size_t i = 1; i < MAX_SKIP_LEVELS; ++i) {
+        doc.skip_max_freq[i] = std::max(doc.skip_max_freq[i], max_freq);
+      }
+    } else {
+      max_freq = doc.skip_max_freq[level];
+      doc.skip_max_freq[level] = 0;
+    }
+
+    out.write_vlong(max_freq);
+  }
 }
 
 void postings_writer::encode(
@@ -4217,6 +4918,10 @@ void postings_writer::encode(
   if (meta.freq != integer_traits<uint64_t>::const_max) {
     assert(meta.freq >= meta.docs_count);
     out.write_vlong(meta.freq - meta.docs_count);
+
+    if (meta.docs_count > 1) {
+      out.write_vlong(meta.max_freq);
+    }
   }
 
   out.write_vlong(meta.doc_start - last_state.doc_start);
@@ -4263,7 +4968,7 @@ bool postings_reader::prepare(
   std::string buf;
  
   /* prepare document input */
-  detail::prepare_input( 
+  version_ = detail::prepare_input(
     buf, doc_in_, state,
     postings_writer::DOC_EXT, 
     postings_writer::DOC_FORMAT_NAME, 
@@ -4278,6 +4983,9 @@ bool postings_reader::prepare(
    * some forms of corruption. */
   format_utils::read_checksum(*doc_in_);
 
+  // postings are read in small pieces scattered across the file
+  doc_in_->advise(IOAdvice::RANDOM);
+
   if (features.check<position>()) {
     /* prepare positions input */
     detail::prepare_input(
@@ -4294,6 +5002,7 @@ bool postings_reader::prepare(
      * error detection which could recognize
      * some forms of corruption. */
     format_utils::read_checksum(*pos_in_);
+    pos_in_->advise(IOAdvice::RANDOM);
 
     if (features.check<payload>() || features.check<offset>()) {
       /* prepare positions input */
@@ -4311,11 +5020,12 @@ bool postings_reader::prepare(
        * error detection which could recognize
        * some forms of corruption. */
       format_utils::read_checksum(*pay_in_);
+      pay_in_->advise(IOAdvice::RANDOM);
     }
   }
 
   /* check postings format */
-  format_utils::check_header(in,
+  terms_version_ = format_utils::check_header(in,
     postings_writer::TERMS_FORMAT_NAME, 
     postings_writer::TERMS_FORMAT_MIN, 
     postings_writer::TERMS_FORMAT_MAX
@@ -4347,6 +5057,14 @@ void postings_reader::decode(
   term_meta.docs_count = in.read_vlong();
   if (term_freq) {
     term_freq->value = term_meta.docs_count + in.read_vlong();
+
+    if (term_meta.docs_count > 1
+        && terms_version_ >= postings_writer::TERMS_FORMAT_BLOCK_MAX) {
+      term_meta.max_freq = in.read_vlong();
+    } else {
+      // total frequency is exact for a singleton and an upper bound otherwise
+      term_meta.max_freq = term_freq->value;
+    }
   }
 
   term_meta.doc_start += in.read_vlong();
@@ -4386,7 +5104,8 @@ doc_iterator::ptr postings_reader::iterator(
 
   it->prepare(
     features, enabled, attrs,
-    doc_in_.get(), pos_in_.get(), pay_in_.get() 
+    doc_in_.get(), pos_in_.get(), pay_in_.get(),
+    version_, req.check<block_max>(), req.check<doc_block>()
   );
 
   return MOVE_WORKAROUND_MSVC2013(it);
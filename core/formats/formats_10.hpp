@@ -26,6 +26,7 @@
 
 #include "formats.hpp"
 #include "skip_list.hpp"
+#include "format_utils.hpp"
 
 #include "formats_10_attributes.hpp"
 
@@ -174,18 +175,22 @@ class document_mask_writer final: public iresearch::document_mask_writer {
   static const string_ref FORMAT_NAME;
 
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_BITSET = 1; // 8-byte aligned little-endian words
+  static const int32_t FORMAT_MAX = FORMAT_BITSET;
 
   virtual ~document_mask_writer();
   virtual std::string filename(const segment_meta& meta) const override;
   virtual void prepare(directory& dir, const segment_meta& meta) override;
   virtual void begin(uint32_t count) override;
   virtual void write(const doc_id_t& mask) override;
+  virtual void write(const document_mask& mask) override;
   virtual void end() override;
 
 private:
   friend document_mask_reader;
+  document_mask mask_; // doc_ids written since begin()
   index_output::ptr out_;
+  uint64_t docs_count_{}; // number of documents in the segment
 };
 
 /* -------------------------------------------------------------------
@@ -204,10 +209,15 @@ public:
 
   virtual uint32_t begin() override;
   virtual void read(iresearch::doc_id_t& mask) override;
+  virtual void read(document_mask& mask, uint32_t count) override;
   virtual void end() override;
 
 private:
-  checksum_index_input<::boost::crc_32_type> in_;
+  std::vector<doc_id_t> docs_; // doc_ids of 'mask_' not read yet (reversed)
+  document_mask mask_; // doc_ids read by begin() (FORMAT_BITSET)
+  format_utils::footer_checksum_input in_;
+  uint64_t docs_count_{}; // number of documents in the segment
+  int32_t version_;
 };
 
 /* -------------------------------------------------------------------
@@ -224,7 +234,8 @@ class IRESEARCH_PLUGIN postings_writer final: public iresearch::postings_writer
  public:
   static const string_ref TERMS_FORMAT_NAME;
   static const int32_t TERMS_FORMAT_MIN = 0;
-  static const int32_t TERMS_FORMAT_MAX = TERMS_FORMAT_MIN;
+  static const int32_t TERMS_FORMAT_BLOCK_MAX = 1; // max term frequency per term
+  static const int32_t TERMS_FORMAT_MAX = TERMS_FORMAT_BLOCK_MAX;
 
   static const string_ref DOC_FORMAT_NAME;
   static const string_ref DOC_EXT;
@@ -234,7 +245,8 @@ class IRESEARCH_PLUGIN postings_writer final: public iresearch::postings_writer
   static const string_ref PAY_EXT;
 
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_BLOCK_MAX = 1; // max term frequency per skip
+  static const int32_t FORMAT_MAX = FORMAT_BLOCK_MAX;
 
   static const uint32_t MAX_SKIP_LEVELS = 10;
   static const uint32_t BLOCK_SIZE = 128;
@@ -287,14 +299,17 @@ class IRESEARCH_PLUGIN postings_writer final: public iresearch::postings_writer
       stream::reset();
       last = type_limits<type_t::doc_id_t>::invalid();
       block_last = 0;
+      block_max_freq = 0;
       size = 0;
     }
 
     doc_id_t deltas[BLOCK_SIZE]{}; // document deltas
     doc_id_t skip_doc[MAX_SKIP_LEVELS]{};
+    uint64_t skip_max_freq[MAX_SKIP_LEVELS]{}; // max frequency since the last skip of a level
     std::unique_ptr<uint64_t[]> freqs; /* document frequencies */
     doc_id_t last{ type_limits<type_t::doc_id_t>::invalid() }; // last buffered document id
     doc_id_t block_last{}; // last document id in a block
+    uint64_t block_max_freq{}; // max frequency within a block
     uint32_t size{};            /* number of buffered elements */
   }; // doc_stream
 
@@ -398,9 +413,41 @@ class IRESEARCH_PLUGIN postings_reader final: public iresearch::postings_reader
   index_input::ptr doc_in_;
   index_input::ptr pos_in_;
   index_input::ptr pay_in_;
+  int32_t version_{}; // version of the postings (.doc) format
+  int32_t terms_version_{}; // version of the term metadata format
   IRESEARCH_API_PRIVATE_VARIABLES_END
 };
 
+/* -------------------------------------------------------------------
+ * columnstore_cache
+ * ------------------------------------------------------------------*/
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief process-wide cache of the decoded column blocks shared by all
+///        columnstore readers, the least recently used blocks are evicted
+///        once the total size of the cached blocks exceeds the limit
+////////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_PLUGIN columnstore_cache {
+  static const size_t DEFAULT_LIMIT = 256 * (1 << 20); // 256 MiB
+
+  struct stats {
+    uint64_t hits; // number of block lookups served from the cache
+    uint64_t misses; // number of blocks loaded from the underlying storage
+    uint64_t evictions; // number of blocks evicted from the cache
+    size_t size; // total size of the cached blocks in bytes
+    size_t limit; // max total size of the cached blocks in bytes
+  };
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief sets the max total size of the cached blocks in bytes,
+  ///        evicts the excessive blocks immediately
+  //////////////////////////////////////////////////////////////////////////////
+  static void limit(size_t bytes);
+  static size_t limit();
+
+  static stats statistics();
+};
+
 /* -------------------------------------------------------------------
  * format
  * ------------------------------------------------------------------*/
@@ -43,7 +43,6 @@
 #include "utils/attributes.hpp"
 #include "utils/string.hpp"
 #include "utils/log.hpp"
-#include "utils/fst_matcher.hpp"
 
 #if defined(_MSC_VER)
   // NOOP
@@ -63,14 +62,6 @@
   #pragma GCC diagnostic pop
 #endif
 
-#if defined(_MSC_VER)
-  #pragma warning(disable : 4291)
-#elif defined (__GNUC__)
-  // NOOP
-#endif
-
-#include <fst/matcher.h>
-
 #if defined(_MSC_VER)
   #pragma warning(disable : 4244)
   #pragma warning(disable : 4245)
@@ -194,7 +185,7 @@ inline void prepare_output(
   format_utils::write_header(*out, format, version);
 }
 
-inline void prepare_input(
+inline int32_t prepare_input(
     std::string& str,
     index_input::ptr& in,
     const reader_state& state,
@@ -215,7 +206,7 @@ inline void prepare_input(
     throw detailed_io_error(ss.str());
   }
 
-  format_utils::check_header(*in, format, min_ver, max_ver);
+  return format_utils::check_header(*in, format, min_ver, max_ver);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -463,14 +454,10 @@ class term_iterator : public iresearch::seek_term_iterator {
   index_input& terms_input() const;
 
  private:
-  typedef term_reader::fst_t fst_t;
-  typedef fst::SortedMatcher<fst_t> sorted_matcher_t;
-  typedef fst::explicit_matcher<sorted_matcher_t> matcher_t; // avoid implicit loops
-
   friend class block_iterator;
 
   struct arc {
-    typedef fst_byte_builder::stateid_t stateid_t;
+    typedef compact_fst::stateid_t stateid_t;
 
     arc() : block{} { }
 
@@ -527,7 +514,7 @@ class term_iterator : public iresearch::seek_term_iterator {
   }
 
   const term_reader* owner_;
-  matcher_t matcher_;
+  compact_fst::cursor fst_; // reads fst directly from the term index
   irs::attribute_view attrs_;
   seek_state_t sstate_;
   block_stack_t block_stack_;
@@ -874,7 +861,7 @@ void block_iterator::reset() {
 
 term_iterator::term_iterator(const term_reader* owner)
   : owner_(owner),
-    matcher_(*owner->fst_, fst::MATCH_INPUT),
+    fst_(owner->fst_),
     attrs_(2), // version10::term_meta + frequency
     cur_block_(nullptr) {
   assert(owner_);
@@ -898,8 +885,7 @@ bool term_iterator::next() {
   if (!cur_block_) {
     if (term_.empty()) {
       /* iterator at the beginning */
-      const auto& fst = *owner_->fst_;
-      cur_block_ = push_block(fst.Final(fst.Start()), 0);
+      cur_block_ = push_block(fst_.final(owner_->fst_.start()), 0);
       cur_block_->load();
     } else {
       // seek to the term with the specified state was called from
@@ -1010,14 +996,8 @@ ptrdiff_t term_iterator::seek_cached(
 }
 
 SeekResult term_iterator::seek_equal(const bytes_ref& term) {
-  assert(owner_->fst_);
-
-  typedef fst_t::Weight weight_t;
-
-  const auto& fst = *owner_->fst_;
-
   size_t prefix = 0; // number of current symbol to process
-  arc::stateid_t state = fst.Start(); // start state
+  arc::stateid_t state = owner_->fst_.start(); // start state
   weight_.Clear(); // clear aggregated fst output
 
   if (cur_block_) {
@@ -1030,26 +1010,25 @@ SeekResult term_iterator::seek_equal(const bytes_ref& term) {
       return SeekResult::FOUND;
     }
   } else {
-    cur_block_ = push_block(fst.Final(state), prefix);
+    cur_block_ = push_block(fst_.final(state), prefix);
   }
 
   term_.oversize(term.size());
   term_.reset(prefix); /* reset to common seek prefix */
   sstate_.resize(prefix); /* remove invalid cached arcs */
 
-  bool found = fst_byte_builder::final != state;
+  bool found = compact_fst::FINAL != state;
   while (found && prefix < term.size()) {
-    matcher_.SetState(state);
-    if (found = matcher_.Find(term[prefix])) {
-      const auto& arc = matcher_.Value();
-      term_ += byte_type(arc.ilabel);
+    if (found = fst_.find(state, term[prefix])) {
+      const auto& arc = fst_.value();
+      term_ += arc.ilabel;
       fst_utils::append(weight_, arc.weight);
       ++prefix;
 
-      const auto weight = fst.Final(state = arc.nextstate);
-      if (weight_t::One() != weight && weight_t::Zero() != weight) {
+      const auto weight = fst_.final(state = arc.nextstate);
+      if (byte_weight::One() != weight && byte_weight::Zero() != weight) {
         cur_block_ = push_block(fst::Times(weight_, weight), prefix);
-      } else if (fst_byte_builder::final == state) {
+      } else if (compact_fst::FINAL == state) {
         cur_block_ = push_block(std::move(weight_), prefix);
         found = false;
       }
@@ -1150,7 +1129,7 @@ term_reader::term_reader(term_reader&& rhs) NOEXCEPT
     doc_freq_(rhs.doc_freq_),
     term_freq_(rhs.term_freq_),
     field_(std::move(rhs.field_)),
-    fst_(rhs.fst_),
+    fst_(std::move(rhs.fst_)),
     owner_(rhs.owner_) {
   min_term_ref_ = min_term_;
   max_term_ref_ = max_term_;
@@ -1160,24 +1139,21 @@ term_reader::term_reader(term_reader&& rhs) NOEXCEPT
   rhs.doc_count_ = 0;
   rhs.doc_freq_ = 0;
   rhs.term_freq_ = 0;
-  rhs.fst_ = nullptr;
   rhs.owner_ = nullptr;
 }
 
-term_reader::~term_reader() {
-  delete fst_;
-}
+term_reader::~term_reader() { }
 
 seek_term_iterator::ptr term_reader::iterator() const {
   return seek_term_iterator::make<detail::term_iterator>( this );
 }
   
 bool term_reader::prepare(
-    std::istream& in, 
+    index_input& meta_in,
+    int32_t version,
     const feature_map_t& feature_map,
     field_reader& owner) {
   // read field metadata
-  index_input& meta_in = *static_cast<input_buf*>(in.rdbuf());
   field_.name = read_string<std::string>(meta_in);
 
   if (!read_field_features(meta_in, feature_map, field_.features)) {
@@ -1199,8 +1175,24 @@ bool term_reader::prepare(
   }
 
   // read fst
-  fst_ = fst_t::Read(in, fst::FstReadOptions());
-  assert(fst_);
+  if (version < field_writer::FORMAT_COMPACT_FST) {
+    // legacy OpenFST encoding, convert into compact representation
+    input_buf isb(&meta_in);
+    std::istream in(&isb); // wrap stream to be OpenFST compliant
+    std::unique_ptr<vector_byte_fst> fst(
+      vector_byte_fst::Read(in, fst::FstReadOptions())
+    );
+
+    if (!fst) {
+      IR_FRMT_ERROR("Failed to read fst for field: %s", field_.name.c_str());
+      return false;
+    }
+
+    fst_.reset(*fst);
+  } else if (!fst_.read(meta_in)) {
+    IR_FRMT_ERROR("Failed to read fst for field: %s", field_.name.c_str());
+    return false;
+  }
 
   owner_ = &owner;
   return true;
@@ -1619,9 +1611,7 @@ void field_writer::end_field(
   }
 
   // write fst
-  output_buf isb(index_out.get()); // wrap stream to be OpenFST compliant
-  std::ostream os(&isb);
-  fst.Write(os, fst::FstWriteOptions());
+  write_compact_fst(*index_out, fst);
 
   stack.clear();
   ++fields_count;
@@ -1670,21 +1660,26 @@ bool field_reader::prepare(
   state.meta = &meta;
 
   // check index header 
-  index_input::ptr index_in;
-  detail::prepare_input(
-    str, index_in, state,
+  const auto version = detail::prepare_input(
+    str, index_in_, state,
     field_writer::TERMS_INDEX_EXT,
     field_writer::FORMAT_TERMS_INDEX,
     field_writer::FORMAT_MIN,
     field_writer::FORMAT_MAX
   );
 
+  auto& index_in = index_in_;
+
+  // the term index of a field is loaded on the first access, preload it
+  // in the background instead of faulting it in page by page
+  index_in->advise(IOAdvice::WILLNEED);
+
   if (!detail::read_segment_features(*index_in, feature_map, features)) {
     return false;
   }
 
   // check index checksum
-  format_utils::check_checksum<boost::crc_32_type>(*index_in);
+  format_utils::check_checksum(*index_in);
  
   // read total number of indexed fields
   size_t fields_count{ 0 };
@@ -1699,9 +1694,6 @@ bool field_reader::prepare(
     index_in->seek(ptr);
   }
 
-  input_buf isb(index_in.get());
-  std::istream input(&isb); // wrap stream to be OpenFST compliant
-
   // read terms for each indexed field
   fields_.reserve(fields_count);
   name_to_field_.reserve(fields_count);
@@ -1709,7 +1701,7 @@ bool field_reader::prepare(
     fields_.emplace_back();
     auto& field = fields_.back();
 
-    if (!field.prepare(input, feature_map, *this)) {
+    if (!field.prepare(*index_in, version, feature_map, *this)) {
       fields_.pop_back(); // remove inconsistent field
       return false;
     }
@@ -1748,6 +1740,9 @@ bool field_reader::prepare(
     field_writer::FORMAT_MAX
   );
 
+  // term blocks are read on demand by the seeks of the term dictionary
+  terms_in_->advise(IOAdvice::RANDOM);
+
   // prepare postings reader
   if (!pr_->prepare(*terms_in_, state, features)) {
     return false;
@@ -43,6 +43,7 @@
   #pragma GCC diagnostic ignored "-Wunused-local-typedefs"
 #endif
 
+#include "utils/compact_fst.hpp"
 #include "utils/fst_utils.hpp"
 
 #if defined(_MSC_VER)
@@ -239,7 +240,8 @@ class term_reader : public iresearch::term_reader,
   virtual ~term_reader();
 
   bool prepare(
-    std::istream& in,
+    index_input& in,
+    int32_t version,
     const feature_map_t& features,
     field_reader& owner
   );
@@ -255,7 +257,6 @@ class term_reader : public iresearch::term_reader,
   }
 
  private:
-  typedef fst::VectorFst<byte_arc> fst_t;
   friend class term_iterator;
 
   irs::attribute_view attrs_;
@@ -269,7 +270,7 @@ class term_reader : public iresearch::term_reader,
   uint64_t term_freq_;
   frequency freq_; // total term freq
   field_meta field_;
-  fst_t* fst_; // TODO: use compact fst here!!!
+  compact_fst fst_; // term index, read from 'owner_->index_in_' on demand
   field_reader* owner_;
 }; // term_reader
 
@@ -281,7 +282,8 @@ NS_END // detail
 class field_writer final : public iresearch::field_writer {
  public:
   static const int32_t FORMAT_MIN = 0;
-  static const int32_t FORMAT_MAX = FORMAT_MIN;
+  static const int32_t FORMAT_COMPACT_FST = 1; // term index stored as compact_fst
+  static const int32_t FORMAT_MAX = FORMAT_COMPACT_FST;
   static const uint32_t DEFAULT_MIN_BLOCK_SIZE = 25;
   static const uint32_t DEFAULT_MAX_BLOCK_SIZE = 48;
 
@@ -382,6 +384,7 @@ class field_reader final : public iresearch::field_reader {
   std::vector<const detail::term_reader*> fields_mask_;
   iresearch::postings_reader::ptr pr_;
   iresearch::index_input::ptr terms_in_;
+  iresearch::index_input::ptr index_in_; // backs term index of every field
 }; // field_reader
 
 NS_END // burst_trie
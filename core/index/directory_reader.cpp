@@ -186,6 +186,13 @@ class directory_reader_impl :
     const composite_reader::ptr& cached = nullptr
   );
 
+  // create a directory reader over the already opened segment readers
+  static composite_reader::ptr open(
+    const directory& dir,
+    index_meta&& meta,
+    std::vector<segment_reader>&& readers
+  );
+
  private:
   typedef std::unordered_set<index_file_refs::ref_t> segment_file_refs_t;
   typedef std::vector<segment_file_refs_t> reader_file_refs_t;
@@ -229,6 +236,13 @@ directory_reader& directory_reader::operator=(
   return directory_reader_impl::open(dir, codec.get());
 }
 
+/*static*/ directory_reader directory_reader::open(
+    const directory& dir,
+    index_meta&& meta,
+    std::vector<segment_reader>&& readers) {
+  return directory_reader_impl::open(dir, std::move(meta), std::move(readers));
+}
+
 directory_reader directory_reader::reopen(
     format::ptr codec /*= nullptr*/) const {
   // make a copy
@@ -349,4 +363,55 @@ directory_reader_impl::directory_reader_impl(
   return reader;
 }
 
+/*static*/ composite_reader::ptr directory_reader_impl::open(
+    const directory& dir,
+    index_meta&& meta,
+    std::vector<segment_reader>&& readers) {
+  assert(meta.size() == readers.size());
+
+  ctxs_t ctxs(meta.size());
+  uint64_t docs_max = 0; // overall number of documents (with deleted)
+  uint64_t docs_count = 0; // number of live documents
+  reader_file_refs_t file_refs(ctxs.size() + 1); // +1 for index_meta file refs
+  segment_file_refs_t tmp_file_refs;
+  auto visitor = [&tmp_file_refs](index_file_refs::ref_t&& ref)->bool {
+    tmp_file_refs.emplace(std::move(ref));
+    return true;
+  };
+
+  for (size_t i = 0, size = meta.size(); i < size; ++i) {
+    auto& ctx = ctxs[i];
+
+    ctx.reader = std::move(readers[i]);
+
+    if (!ctx.reader) {
+      throw index_error();
+    }
+
+    ctx.base = static_cast<doc_id_t>(docs_max);
+    docs_max += ctx.reader.docs_count();
+    docs_count += ctx.reader.live_docs_count();
+    ctx.max = doc_id_t(type_limits<type_t::doc_id_t>::min() + docs_max - 1);
+    directory_utils::reference(const_cast<directory&>(dir), meta.segment(i).meta, visitor, true);
+    file_refs[i].swap(tmp_file_refs);
+  }
+
+  // there is no index_meta file for segments not committed yet
+  directory_utils::reference(const_cast<directory&>(dir), meta, visitor, true);
+  file_refs.back().swap(tmp_file_refs); // use last position for storing index_meta refs
+
+  PTR_NAMED(
+    directory_reader_impl,
+    reader,
+    dir,
+    std::move(file_refs),
+    std::move(meta),
+    std::move(ctxs),
+    docs_count,
+    docs_max
+  );
+
+  return reader;
+}
+
 NS_END
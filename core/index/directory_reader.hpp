@@ -30,6 +30,9 @@
 
 NS_ROOT
 
+class index_writer;
+class segment_reader;
+
 ////////////////////////////////////////////////////////////////////////////////
 /// @brief interface for an index reader over a directory of segments
 ////////////////////////////////////////////////////////////////////////////////
@@ -113,7 +116,20 @@ class IRESEARCH_API directory_reader final
   impl_ptr impl_;
   IRESEARCH_API_PRIVATE_VARIABLES_END
 
+  friend class index_writer;
+
   directory_reader(impl_ptr&& impl) NOEXCEPT;
+
+  ////////////////////////////////////////////////////////////////////////////////
+  /// @brief create an index reader over the already opened segment readers,
+  ///        e.g. segments flushed but not yet committed by an index_writer
+  ///        'readers' correspond to the segments of 'meta' in the same order
+  ////////////////////////////////////////////////////////////////////////////////
+  static directory_reader open(
+    const directory& dir,
+    index_meta&& meta,
+    std::vector<segment_reader>&& readers
+  );
 }; // directory_reader
 
 NS_END
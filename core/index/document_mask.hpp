@@ -0,0 +1,184 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_DOCUMENT_MASK_H
+#define IRESEARCH_DOCUMENT_MASK_H
+
+#include "shared.hpp"
+#include "utils/bit_utils.hpp"
+#include "utils/math_utils.hpp"
+
+#include <vector>
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class document_mask
+/// @brief a dense set of masked (i.e. removed) doc_ids of a segment,
+///        bit 'i' of the underlying words is set if doc_id 'i' is masked
+//////////////////////////////////////////////////////////////////////////////
+class document_mask {
+ public:
+  typedef uint64_t word_t;
+
+  CONSTEXPR static size_t word(doc_id_t doc) NOEXCEPT {
+    return doc / bits_required<word_t>();
+  }
+
+  CONSTEXPR static word_t bit(doc_id_t doc) NOEXCEPT {
+    return word_t(1) << (doc % bits_required<word_t>());
+  }
+
+  document_mask() NOEXCEPT: size_(0) { }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief masks the specified document
+  /// @returns true if the document was not masked before
+  ////////////////////////////////////////////////////////////////////////////
+  bool insert(doc_id_t doc) {
+    const auto i = word(doc);
+
+    if (i >= words_.size()) {
+      words_.resize(i + 1, 0);
+    }
+
+    auto& value = words_[i];
+    const auto mask = bit(doc);
+
+    if (value & mask) {
+      return false;
+    }
+
+    value |= mask;
+    ++size_;
+
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the specified document is masked
+  ////////////////////////////////////////////////////////////////////////////
+  bool contains(doc_id_t doc) const NOEXCEPT {
+    const auto i = word(doc);
+
+    return i < words_.size() && 0 != (words_[i] & bit(doc));
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @returns the first document >= 'doc' that is not masked
+  ////////////////////////////////////////////////////////////////////////////
+  doc_id_t next_live(doc_id_t doc) const NOEXCEPT {
+    auto i = word(doc);
+
+    if (i >= words_.size()) {
+      return doc;
+    }
+
+    // skip bits below 'doc' within the first word
+    auto live = ~words_[i] & ~(bit(doc) - 1);
+
+    while (!live) {
+      if (++i == words_.size()) {
+        return doc_id_t(i * bits_required<word_t>());
+      }
+
+      live = ~words_[i];
+    }
+
+    return doc_id_t(
+      i * bits_required<word_t>() + math::math_traits<word_t>::ctz(live)
+    );
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief calls 'visitor' for every masked document in ascending order
+  /// @returns false if visitor has returned false, true otherwise
+  ////////////////////////////////////////////////////////////////////////////
+  template<typename Visitor>
+  bool visit(const Visitor& visitor) const {
+    for (size_t i = 0, count = words_.size(); i < count; ++i) {
+      for (auto value = words_[i]; value; value &= value - 1) {
+        const auto doc = doc_id_t(
+          i * bits_required<word_t>() + math::math_traits<word_t>::ctz(value)
+        );
+
+        if (!visitor(doc)) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief ensures 'docs' doc_ids can be masked without reallocation
+  ////////////////////////////////////////////////////////////////////////////
+  void reserve(size_t docs) {
+    words_.reserve(word(doc_id_t(docs)) + 1);
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief replaces content with the specified 'count' words, used for bulk
+  ///        loading of the serialized masks
+  /// @returns pointer to the words to be filled, recount() must follow
+  ////////////////////////////////////////////////////////////////////////////
+  word_t* reset(size_t count) {
+    words_.assign(count, 0);
+    size_ = 0;
+
+    return words_.data();
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief recalculates number of masked documents after reset(...)
+  ////////////////////////////////////////////////////////////////////////////
+  void recount() NOEXCEPT {
+    size_ = 0;
+
+    for (auto value: words_) {
+      size_ += math::math_traits<word_t>::pop(value);
+    }
+  }
+
+  void clear() NOEXCEPT {
+    words_.clear();
+    size_ = 0;
+  }
+
+  const word_t* data() const NOEXCEPT { return words_.data(); }
+  size_t words() const NOEXCEPT { return words_.size(); }
+
+  size_t size() const NOEXCEPT { return size_; } // number of masked documents
+  bool empty() const NOEXCEPT { return 0 == size_; }
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::vector<word_t> words_;
+  size_t size_; // number of bits set in words_
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // document_mask
+
+NS_END
+
+#endif
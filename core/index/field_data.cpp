@@ -256,13 +256,12 @@ class term_iterator : public irs::term_iterator {
  public:
   void reset(const field_data& field, const bytes_ref*& min, const bytes_ref*& max) {
     // refill postings
-    postings_.clear();
-    postings_.insert(field.terms_.begin(), field.terms_.end());
+    field.terms_.sort(postings_);
 
     max = min = &irs::bytes_ref::nil;
     if (!postings_.empty()) {
-      min = &(postings_.begin()->first);
-      max = &((--postings_.end())->first);
+      min = &(postings_.front()->first);
+      max = &(postings_.back()->first);
     }
 
     // set field
@@ -290,7 +289,7 @@ class term_iterator : public irs::term_iterator {
     REGISTER_TIMER_DETAILED();
     assert(itr_ != postings_.end());
 
-    const irs::posting& posting = itr_->second;
+    const irs::posting& posting = (*itr_)->second;
 
     // where the term's data starts
     auto ptr = field_->int_writer_->parent().seek(posting.int_start);
@@ -322,7 +321,7 @@ class term_iterator : public irs::term_iterator {
     }
 
     itr_increment_ = true;
-    term_ = itr_->first;
+    term_ = (*itr_)->first;
 
     return true;
   }
@@ -332,20 +331,10 @@ class term_iterator : public irs::term_iterator {
   }
 
  private:
-  struct utf8_less_t {
-    bool operator()(const bytes_ref& lhs, const bytes_ref& rhs) const {
-      return utf8_less(lhs.c_str(), lhs.size(), rhs.c_str(), rhs.size());
-    }
-  };
+  typedef std::vector<const postings::value_type*> terms_t;
 
-  typedef std::map<
-    bytes_ref,
-    std::reference_wrapper<const posting>,
-    utf8_less_t
-  > map_t;
-
-  map_t postings_;
-  map_t::iterator itr_{ postings_.end() };
+  terms_t postings_; // ordered by term
+  terms_t::const_iterator itr_{ postings_.end() };
   irs::bytes_ref term_;
   const field_data* field_;
   mutable detail::doc_iterator doc_itr_;
@@ -730,6 +719,18 @@ void fields_data::flush(field_writer& fw, flush_state& state) {
   }
 }
 
+size_t fields_data::memory() const NOEXCEPT {
+  // pools are reused between segments, count only the occupied part
+  auto memory = byte_writer_.pool_offset()
+    + int_writer_.pool_offset() * sizeof(int_block_pool::value_type);
+
+  for (auto& entry : fields_) {
+    memory += entry.second.terms().memory();
+  }
+
+  return memory;
+}
+
 void fields_data::reset() {
   byte_writer_ = byte_pool_.begin(); // reset position pointer to start of pool
   features_.clear();
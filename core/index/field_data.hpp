@@ -75,6 +75,8 @@ class IRESEARCH_API field_data : util::noncopyable {
 
   float_t boost() const { return boost_; }
 
+  const postings& terms() const { return terms_; }
+
   const field_meta& meta() const { return meta_; }
 
   data_output& norms(columnstore_writer& writer);
@@ -135,6 +137,10 @@ class IRESEARCH_API fields_data: util::noncopyable {
     return *this;
   }
   const flags& features() { return features_; }
+
+  // returns approximate number of bytes occupied by the inverted data
+  size_t memory() const NOEXCEPT;
+
   void flush(field_writer& fw, flush_state& state);
   void reset();
 
@@ -111,6 +111,10 @@ struct IRESEARCH_API sub_reader : index_reader {
   virtual const columnstore_reader::column_reader* column_reader(field_id field) const = 0;
 
   const columnstore_reader::column_reader* column_reader(const string_ref& field) const;
+
+  // returns norms of the specified column one byte per document (see 'norm'),
+  // nullptr if the norms aren't quantized or the reader doesn't cache them
+  virtual const byte_type* norms(field_id /*field*/) const { return nullptr; }
 }; // sub_reader
 
 NS_END
@@ -22,21 +22,30 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "shared.hpp"
+#include "directory_reader.hpp"
 #include "file_names.hpp"
 #include "merge_writer.hpp"
 #include "formats/format_utils.hpp"
 #include "utils/directory_utils.hpp"
 #include "utils/index_utils.hpp"
+#include "utils/log.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "index_writer.hpp"
 
+#include <algorithm>
+#include <chrono>
 #include <list>
+#include <thread>
 
 NS_LOCAL
 
 const size_t NON_UPDATE_RECORD = iresearch::integer_traits<size_t>::const_max; // non-update
 
+// max number of bytes a segment writer buffers before accounting them in the
+// memory shared by all writers, avoids contention on the shared counter
+const size_t MEMORY_BATCH = 64 * 1024;
+
 // append file refs for files from the specified segments description
 template<typename T, typename M>
 void append_segments_refs(
@@ -66,7 +75,7 @@ const std::string& write_document_mask(
   const auto& file = *meta.files.emplace(mask_writer->filename(meta)).first; // new/expected filename
   mask_writer->prepare(dir, meta);
   mask_writer->begin((uint32_t)docs_mask.size());
-  write_all(*mask_writer, docs_mask.begin(), docs_mask.end());
+  mask_writer->write(docs_mask);
   mask_writer->end();
   return file;
 }
@@ -80,6 +89,346 @@ std::string write_segment_meta(
   return writer->filename(meta);
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class throttled_directory
+/// @brief limits the overall rate at which data is written to all outputs
+///        created via the directory, used for background merges
+//////////////////////////////////////////////////////////////////////////////
+class throttled_directory final : public iresearch::directory {
+ public:
+  typedef std::chrono::steady_clock clock_t;
+
+  throttled_directory(iresearch::directory& impl, size_t bytes_per_sec)
+    : impl_(impl), bytes_per_sec_(bytes_per_sec), next_(clock_t::now()) {
+    assert(bytes_per_sec_);
+  }
+
+  // blocks the caller until writing of 'bytes' fits the bandwidth
+  void acquire(size_t bytes) {
+    const auto cost = std::chrono::duration_cast<clock_t::duration>(
+      std::chrono::duration<double>(double(bytes) / bytes_per_sec_)
+    );
+    clock_t::time_point start;
+
+    {
+      SCOPED_LOCK(mutex_);
+      start = std::max(clock_t::now(), next_);
+      next_ = start + cost;
+    }
+
+    std::this_thread::sleep_until(start);
+  }
+
+  using iresearch::directory::attributes;
+  virtual iresearch::attribute_store& attributes() NOEXCEPT override {
+    return impl_.attributes();
+  }
+
+  virtual void close() NOEXCEPT override {
+    impl_.close();
+  }
+
+  virtual iresearch::index_output::ptr create(
+      const std::string& name) NOEXCEPT override {
+    auto out = impl_.create(name);
+
+    if (!out) {
+      return nullptr;
+    }
+
+    try {
+      return iresearch::index_output::make<throttled_output>(std::move(out), *this);
+    } catch (...) {
+      IR_EXCEPTION();
+    }
+
+    return nullptr;
+  }
+
+  virtual bool exists(
+      bool& result, const std::string& name) const NOEXCEPT override {
+    return impl_.exists(result, name);
+  }
+
+  virtual bool length(
+      uint64_t& result, const std::string& name) const NOEXCEPT override {
+    return impl_.length(result, name);
+  }
+
+  virtual iresearch::index_lock::ptr make_lock(
+      const std::string& name) NOEXCEPT override {
+    return impl_.make_lock(name);
+  }
+
+  virtual bool mtime(
+      std::time_t& result, const std::string& name) const NOEXCEPT override {
+    return impl_.mtime(result, name);
+  }
+
+  virtual iresearch::index_input::ptr open(
+      const std::string& name) const NOEXCEPT override {
+    return impl_.open(name);
+  }
+
+  virtual bool remove(const std::string& name) NOEXCEPT override {
+    return impl_.remove(name);
+  }
+
+  virtual bool rename(
+      const std::string& src, const std::string& dst) NOEXCEPT override {
+    return impl_.rename(src, dst);
+  }
+
+  virtual bool sync(const std::string& name) NOEXCEPT override {
+    return impl_.sync(name);
+  }
+
+  virtual bool visit(const visitor_f& visitor) const override {
+    return impl_.visit(visitor);
+  }
+
+ private:
+  class throttled_output final : public iresearch::index_output {
+   public:
+    static const size_t CHUNK_SIZE = 64 * 1024; // bytes written between waits
+
+    throttled_output(
+        iresearch::index_output::ptr&& impl, throttled_directory& dir) NOEXCEPT
+      : dir_(dir), impl_(std::move(impl)), pending_(0) {
+    }
+
+    virtual void close() override {
+      impl_->close();
+      dir_.acquire(pending_);
+      pending_ = 0;
+    }
+
+    virtual void flush() override {
+      impl_->flush();
+    }
+
+    virtual size_t file_pointer() const override {
+      return impl_->file_pointer();
+    }
+
+    virtual int64_t checksum() const override {
+      return impl_->checksum();
+    }
+
+    virtual int32_t checksum_type() const override {
+      return impl_->checksum_type();
+    }
+
+    virtual void write_byte(iresearch::byte_type b) override {
+      impl_->write_byte(b);
+      written(1);
+    }
+
+    virtual void write_bytes(const iresearch::byte_type* b, size_t len) override {
+      impl_->write_bytes(b, len);
+      written(len);
+    }
+
+   private:
+    void written(size_t len) {
+      pending_ += len;
+
+      if (pending_ >= CHUNK_SIZE) {
+        dir_.acquire(pending_);
+        pending_ = 0;
+      }
+    }
+
+    throttled_directory& dir_;
+    iresearch::index_output::ptr impl_;
+    size_t pending_; // bytes written since last wait
+  }; // throttled_output
+
+  iresearch::directory& impl_;
+  const size_t bytes_per_sec_;
+  std::mutex mutex_;
+  clock_t::time_point next_; // earliest time the next write may start
+}; // throttled_directory
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class merge_source_directory
+/// @brief opens inputs of the segments being merged, a merge reads every file
+///        front to back once regardless of the access pattern advised by the
+///        format, the data is no longer needed once the merge is over
+//////////////////////////////////////////////////////////////////////////////
+class merge_source_directory final : public iresearch::directory {
+ public:
+  explicit merge_source_directory(iresearch::directory& impl) NOEXCEPT
+    : impl_(impl) {
+  }
+
+  using iresearch::directory::attributes;
+  virtual iresearch::attribute_store& attributes() NOEXCEPT override {
+    return impl_.attributes();
+  }
+
+  virtual void close() NOEXCEPT override {
+    impl_.close();
+  }
+
+  virtual iresearch::index_output::ptr create(
+      const std::string& name) NOEXCEPT override {
+    return impl_.create(name);
+  }
+
+  virtual bool exists(
+      bool& result, const std::string& name) const NOEXCEPT override {
+    return impl_.exists(result, name);
+  }
+
+  virtual bool length(
+      uint64_t& result, const std::string& name) const NOEXCEPT override {
+    return impl_.length(result, name);
+  }
+
+  virtual iresearch::index_lock::ptr make_lock(
+      const std::string& name) NOEXCEPT override {
+    return impl_.make_lock(name);
+  }
+
+  virtual bool mtime(
+      std::time_t& result, const std::string& name) const NOEXCEPT override {
+    return impl_.mtime(result, name);
+  }
+
+  virtual iresearch::index_input::ptr open(
+      const std::string& name) const NOEXCEPT override {
+    auto in = impl_.open(name);
+
+    if (!in) {
+      return nullptr;
+    }
+
+    try {
+      in->advise(iresearch::IOAdvice::SEQUENTIAL);
+
+      return iresearch::index_input::make<merge_source_input>(std::move(in), true);
+    } catch (...) {
+      IR_EXCEPTION();
+    }
+
+    return nullptr;
+  }
+
+  virtual bool remove(const std::string& name) NOEXCEPT override {
+    return impl_.remove(name);
+  }
+
+  virtual bool rename(
+      const std::string& src, const std::string& dst) NOEXCEPT override {
+    return impl_.rename(src, dst);
+  }
+
+  virtual bool sync(const std::string& name) NOEXCEPT override {
+    return impl_.sync(name);
+  }
+
+  virtual bool visit(const visitor_f& visitor) const override {
+    return impl_.visit(visitor);
+  }
+
+ private:
+  class merge_source_input final : public iresearch::index_input {
+   public:
+    merge_source_input(iresearch::index_input::ptr&& impl, bool owner) NOEXCEPT
+      : impl_(std::move(impl)), owner_(owner) {
+    }
+
+    virtual ~merge_source_input() {
+      if (owner_) {
+        impl_->advise(iresearch::IOAdvice::DONTNEED); // all copies are gone
+      }
+    }
+
+    virtual ptr dup() const NOEXCEPT override {
+      return wrap(impl_->dup());
+    }
+
+    virtual ptr reopen() const NOEXCEPT override {
+      return wrap(impl_->reopen());
+    }
+
+    virtual void seek(size_t pos) override {
+      impl_->seek(pos);
+    }
+
+    virtual void advise(iresearch::IOAdvice) NOEXCEPT override {
+      // keep sequential access advised on open
+    }
+
+    virtual void prefetch(size_t, size_t) NOEXCEPT override {
+      // read-ahead of the sequential access covers the requested data
+    }
+
+    virtual void read_batch(
+        iresearch::read_request* requests, size_t count
+    ) override {
+      impl_->read_batch(requests, count);
+    }
+
+    virtual iresearch::byte_type read_byte() override {
+      return impl_->read_byte();
+    }
+
+    virtual size_t read_bytes(iresearch::byte_type* b, size_t count) override {
+      return impl_->read_bytes(b, count);
+    }
+
+    virtual uint32_t read_vint() override {
+      return impl_->read_vint();
+    }
+
+    virtual uint64_t read_vlong() override {
+      return impl_->read_vlong();
+    }
+
+    virtual void read_vints(uint32_t* b, size_t count) override {
+      impl_->read_vints(b, count);
+    }
+
+    virtual void read_vlongs(uint64_t* b, size_t count) override {
+      impl_->read_vlongs(b, count);
+    }
+
+    virtual size_t file_pointer() const override {
+      return impl_->file_pointer();
+    }
+
+    virtual size_t length() const override {
+      return impl_->length();
+    }
+
+    virtual bool eof() const override {
+      return impl_->eof();
+    }
+
+   private:
+    static ptr wrap(ptr&& impl) NOEXCEPT {
+      if (!impl) {
+        return nullptr;
+      }
+
+      try {
+        return index_input::make<merge_source_input>(std::move(impl), false);
+      } catch (...) {
+        IR_EXCEPTION();
+      }
+
+      return nullptr;
+    }
+
+    iresearch::index_input::ptr impl_;
+    bool owner_; // opened by the directory, outlives its copies
+  }; // merge_source_input
+
+  iresearch::directory& impl_;
+}; // merge_source_directory
+
 NS_END // NS_LOCAL
 
 NS_ROOT
@@ -89,16 +438,49 @@ NS_ROOT
 // ----------------------------------------------------------------------------
 
 const std::string index_writer::WRITE_LOCK_NAME = "write.lock";
+const std::string index_writer::COMMIT_PHASE_FLUSH = "index_writer::commit:flush";
+const std::string index_writer::COMMIT_PHASE_DOCUMENT_MASK = "index_writer::commit:document_mask";
+const std::string index_writer::COMMIT_PHASE_SEGMENT_META = "index_writer::commit:segment_meta";
+const std::string index_writer::COMMIT_PHASE_CONSOLIDATE = "index_writer::commit:consolidate";
+const std::string index_writer::COMMIT_PHASE_SYNC = "index_writer::commit:sync";
 
 index_writer::flush_context::flush_context():
   generation_(0),
+  flush_failed_(false),
+  exclusive_(false),
+  memory_(0),
   writers_pool_(THREAD_COUNT) {
 }
 
+bool index_writer::flush_context::admitted() const NOEXCEPT {
+  for (auto& slot: admitted_) {
+    if (slot.count.load()) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+void index_writer::flush_context::leave(size_t slot) NOEXCEPT {
+  assert(slot < ADMISSION_SLOTS);
+
+  // the flush waiting for the context is notified by the last operation,
+  // 'exclusive_' is set before the flush checks the counters
+  if (1 == admitted_[slot].count.fetch_sub(1) && exclusive_.load()) {
+    SCOPED_LOCK(admission_mutex_);
+    admission_cond_.notify_all();
+  }
+}
+
 void index_writer::flush_context::reset() {
+  wait_for_flush(); // background flushes add to flushed_segments_
   consolidation_policies_.clear();
   generation_.store(0);
   dir_->clear_refs();
+  flush_failed_ = false;
+  flushed_segments_.clear();
+  memory_.store(0);
   modification_queries_.clear();
   pending_segments_.clear();
   segment_mask_.clear();
@@ -108,23 +490,68 @@ void index_writer::flush_context::reset() {
   });
 }
 
+void index_writer::flush_context::wait_for_flush() {
+  if (flush_tasks_) {
+    flush_tasks_->wait(); // flush tasks do not throw
+  }
+}
+
 index_writer::index_writer( 
     index_lock::ptr&& lock,
     directory& dir,
     format::ptr codec,
     index_meta&& meta,
-    committed_state_t&& committed_state
-) NOEXCEPT:
+    committed_state_t&& committed_state,
+    const options& opts
+):
     codec_(codec),
+    merge_stop_(false),
     committed_state_(std::move(committed_state)),
     dir_(dir),
     flush_context_pool_(2), // 2 because just swap them due to common commit lock
     meta_(std::move(meta)),
+    memory_max_(opts.memory_max),
+    memory_batch_(opts.memory_max
+      ? (std::min)(MEMORY_BATCH, opts.memory_max / (2 * THREAD_COUNT)) // keep the total accurate enough for the limit
+      : MEMORY_BATCH),
+    norm_encoding_(opts.norm_encoding),
+    segment_memory_max_(opts.segment_memory_max),
+    sort_(opts.sort),
     writer_(codec->get_index_meta_writer()),
     write_lock_(std::move(lock)) {
   assert(codec);
   flush_context_.store(&flush_context_pool_[0]);
 
+  if (opts.commit_threads) {
+    // keep all threads alive between commits
+    commit_pool_ = memory::make_unique<async_utils::thread_pool>(
+      opts.commit_threads, opts.commit_threads
+    );
+  }
+
+  if (opts.merge_threads) {
+    merge_pool_ = memory::make_unique<async_utils::thread_pool>(
+      opts.merge_threads, opts.merge_threads
+    );
+    merge_tasks_ = memory::make_unique<async_utils::task_group>(merge_pool_.get());
+
+    if (opts.merge_bytes_per_sec) {
+      merge_dir_ = memory::make_unique<throttled_directory>(
+        dir, opts.merge_bytes_per_sec
+      );
+    }
+  }
+
+  if (opts.flush_threads) {
+    flush_pool_ = memory::make_unique<async_utils::thread_pool>(
+      opts.flush_threads, opts.flush_threads
+    );
+
+    for (auto& ctx: flush_context_pool_) {
+      ctx.flush_tasks_ = memory::make_unique<async_utils::task_group>(flush_pool_.get());
+    }
+  }
+
   // setup round-robin chain
   for (size_t i = 0, count = flush_context_pool_.size() - 1; i < count; ++i) {
     flush_context_pool_[i].dir_ = memory::make_unique<ref_tracking_directory>(dir);
@@ -169,7 +596,11 @@ void index_writer::clear() {
   meta_.segments_.clear(); // noexcept op (clear after finish(), to match reset of pending_state_ inside finish(), allows recovery on clear() failure)
 }
 
-index_writer::ptr index_writer::make(directory& dir, format::ptr codec, OPEN_MODE mode) {
+index_writer::ptr index_writer::make(
+    directory& dir,
+    format::ptr codec,
+    OPEN_MODE mode,
+    const options& opts /*= options()*/) {
   // lock the directory
   auto lock = dir.make_lock(WRITE_LOCK_NAME);
 
@@ -228,7 +659,8 @@ index_writer::ptr index_writer::make(directory& dir, format::ptr codec, OPEN_MOD
     std::move(lock), 
     dir, codec,
     std::move(meta),
-    std::move(comitted_state)
+    std::move(comitted_state),
+    opts
   );
 
   directory_utils::remove_all_unreferenced(dir); // remove non-index files from directory
@@ -241,6 +673,18 @@ index_writer::~index_writer() {
 }
 
 void index_writer::close() {
+  for (auto& ctx: flush_context_pool_) {
+    ctx.wait_for_flush(); // flushed files are referenced via the context
+  }
+
+  if (merge_tasks_) {
+    merge_stop_ = true; // abandon merges not started yet
+    merge_tasks_->wait(); // merge tasks do not throw
+
+    SCOPED_LOCK(merge_lock_);
+    merged_segments_.clear(); // release refs to merged files
+  }
+
   {
     SCOPED_LOCK(commit_lock_); // cached_segment_readers_ read/modified during flush()
     cached_segment_readers_.clear();
@@ -263,25 +707,41 @@ uint64_t index_writer::buffered_docs() const {
   return docs_in_ram;
 }
 
+size_t index_writer::buffered_memory() const {
+  // segment writers are not visited since they're modified concurrently,
+  // their memory is accounted by the inserting threads instead
+  auto ctx = const_cast<index_writer*>(this)->get_flush_context();
+
+  return ctx->memory_.load();
+}
+
 segment_reader index_writer::get_segment_reader(
   const segment_meta& meta
 ) {
   REGISTER_TIMER_DETAILED();
-  auto it = cached_segment_readers_.find(meta.name);
+  segment_reader reader;
 
-  if (it == cached_segment_readers_.end()) {
-    it = cached_segment_readers_.emplace(
-      meta.name, segment_reader::open(dir_, meta)
-    ).first;
-  } else {
-    it->second = it->second.reopen(meta);
+  {
+    SCOPED_LOCK(cached_segment_readers_lock_);
+    auto it = cached_segment_readers_.find(meta.name);
+
+    if (it != cached_segment_readers_.end()) {
+      reader = it->second;
+    }
   }
 
-  if (!it->second) {
-    cached_segment_readers_.erase(it);
+  // open/reopen outside of the lock, segments are distinct between tasks
+  reader = reader ? reader.reopen(meta) : segment_reader::open(dir_, meta);
+
+  SCOPED_LOCK(cached_segment_readers_lock_);
+
+  if (reader) {
+    cached_segment_readers_[meta.name] = reader;
+  } else {
+    cached_segment_readers_.erase(meta.name);
   }
 
-  return it->second;
+  return reader;
 }
 
 bool index_writer::add_document_mask_modified_records(
@@ -301,6 +761,10 @@ bool index_writer::add_document_mask_modified_records(
   }
 
   for (auto& mod : modification_queries) {
+    if (!mod.filter) {
+      continue; // skip invalid modification queries
+    }
+
     auto prepared = mod.filter->prepare(rdr);
 
     for (auto docItr = prepared->execute(rdr); docItr->next();) {
@@ -309,7 +773,7 @@ bool index_writer::add_document_mask_modified_records(
       // if indexed doc_id was not add()ed after the request for modification
       // and doc_id not already masked then mark query as seen and segment as modified
       if (mod.generation >= min_doc_id_generation &&
-          docs_mask.insert(doc).second) {
+          docs_mask.insert(doc)) {
         mod.seen = true;
         modified = true;
       }
@@ -321,14 +785,14 @@ bool index_writer::add_document_mask_modified_records(
 
 bool index_writer::add_document_mask_modified_records(
   modification_requests_t& modification_queries,
-  segment_writer& writer,
+  document_mask& docs_mask,
+  const segment_writer::update_contexts& doc_id_generation,
   const segment_meta& meta
 ) {
   if (modification_queries.empty()) {
     return false; // nothing new to flush
   }
 
-  auto& doc_id_generation = writer.docs_context();
   bool modified = false;
   auto rdr = get_segment_reader(meta);
 
@@ -358,7 +822,7 @@ bool index_writer::add_document_mask_modified_records(
       }
 
       // if not already masked
-      if (writer.remove(doc)) {
+      if (docs_mask.insert((type_limits<type_t::doc_id_t>::min)() + doc)) {
         // if not an update modification (i.e. a remove modification) or
         // if non-update-value record or update-value record whose query was seen
         // for every update request a replacement 'update-value' is optimistically inserted
@@ -377,14 +841,14 @@ bool index_writer::add_document_mask_modified_records(
 
 /* static */ bool index_writer::add_document_mask_unused_updates(
     modification_requests_t& modification_queries,
-    segment_writer& writer,
+    document_mask& docs_mask,
+    const segment_writer::update_contexts& doc_id_generation,
     const segment_meta& meta
 ) {
   if (modification_queries.empty()) {
     return false; // nothing new to add
   }
 
-  auto& doc_id_generation = writer.docs_context();
   bool modified = false;
 
   // the implementation generates doc_ids sequentially
@@ -400,7 +864,7 @@ bool index_writer::add_document_mask_modified_records(
     // if it's an update record placeholder who's query did not match any records
     if (doc_ctx.update_id != NON_UPDATE_RECORD
         && !modification_queries[doc_ctx.update_id].seen) {
-      modified |= writer.remove(doc);
+      modified |= docs_mask.insert((type_limits<type_t::doc_id_t>::min)() + doc);
     }
 
     ++doc;
@@ -463,7 +927,7 @@ bool index_writer::add_segment_mask_consolidated_records(
   segment.meta.codec = codec_;
   segment.meta.name = file_name(meta_.increment()); // increment active meta, not fn arg
 
-  merge_writer merge_writer(dir, segment.meta.name);
+  merge_writer merge_writer(dir, segment.meta.name, &sort_);
 
   for (auto& merge_candidate: merge_candidates) {
     merge_writer.add(merge_candidate);
@@ -478,9 +942,257 @@ bool index_writer::add_segment_mask_consolidated_records(
   return true;
 }
 
+void index_writer::schedule_consolidation(
+    const consolidation_policy_t& policy,
+    const std::shared_ptr<index_meta>& committed_meta
+) {
+  REGISTER_TIMER_DETAILED();
+  std::unordered_map<string_ref, const segment_meta*> segment_candidates;
+  auto ctx = get_flush_context(); // segment_mask_ is not modified without commit_lock_
+
+  for (auto& segment: meta_) {
+    if (ctx->segment_mask_.end() == ctx->segment_mask_.find(segment.meta.name)) {
+      segment_candidates.emplace(segment.meta.name, &(segment.meta));
+    }
+  }
+
+  auto acceptor = policy(dir_, *committed_meta);
+  auto merge = std::make_shared<merge_context>();
+  const index_meta::index_segment_t* merge_candidate_default = nullptr;
+  SCOPED_LOCK(merge_lock_);
+
+  // consider only committed segments still unmodified in the current meta
+  // that are not being merged already
+  for (auto& segment: *committed_meta) {
+    auto itr = segment_candidates.find(segment.meta.name);
+
+    if (segment_candidates.end() == itr
+        || segment.meta.version != itr->second->version
+        || merging_segments_.end() != merging_segments_.find(segment.meta.name)) {
+      continue;
+    }
+
+    if (!acceptor(segment.meta)) {
+      merge_candidate_default = &segment; // pick the last non-merged segment as default
+      continue;
+    }
+
+    merge->candidates.emplace_back(segment);
+  }
+
+  if (merge->candidates.empty()) {
+    return; // nothing to merge
+  }
+
+  merge->candidates_masks.resize(merge->candidates.size());
+
+  for (size_t i = 0, count = merge->candidates.size(); i < count; ++i) {
+    index_utils::read_document_mask(
+      merge->candidates_masks[i], dir_, merge->candidates[i].meta
+    );
+  }
+
+  if (merge->candidates.size() < 2) {
+    if (!merge_candidate_default) {
+      if (merge->candidates_masks[0].empty()) {
+        return; // no reason to consolidate a segment without any masked documents
+      }
+    } else { // if only one merge candidate and another segment available then merge with other
+      merge->candidates.emplace_back(*merge_candidate_default);
+      merge->candidates_masks.emplace_back();
+      index_utils::read_document_mask(
+        merge->candidates_masks.back(), dir_, merge_candidate_default->meta
+      );
+    }
+  }
+
+  // retain files of candidates while merging
+  for (auto& candidate: merge->candidates) {
+    append_segments_refs(merge->refs, dir_, candidate.meta);
+    merge->refs.emplace_back(directory_utils::reference(dir_, candidate.filename, true));
+  }
+
+  merge->segment.meta.codec = codec_;
+  merge->segment.meta.name = file_name(meta_.increment());
+
+  for (auto& candidate: merge->candidates) {
+    merging_segments_.emplace(candidate.meta.name);
+  }
+
+  merge_tasks_->run([this, merge]()->void {
+    this->merge(merge);
+  });
+}
+
+void index_writer::merge(const std::shared_ptr<merge_context>& ctx) NOEXCEPT {
+  auto& merge = *ctx;
+  bool merged = false;
+
+  if (!merge_stop_) {
+    try {
+      REGISTER_TIMER_DETAILED();
+      ref_tracking_directory dir(merge_dir_ ? *merge_dir_ : dir_);
+      merge_source_directory source_dir(dir_); // must outlive the readers
+      std::vector<segment_reader> readers;
+
+      readers.reserve(merge.candidates.size());
+
+      for (auto& candidate: merge.candidates) {
+        readers.emplace_back(segment_reader::open(source_dir, candidate.meta));
+
+        if (!readers.back()) {
+          throw index_error(); // failed to open segment
+        }
+      }
+
+      merge_writer merge_writer(dir, merge.segment.meta.name, &sort_);
+
+      for (auto& reader: readers) {
+        merge_writer.add(reader);
+      }
+
+      if (merge_writer.flush(merge.segment.filename, merge.segment.meta)) {
+        if (merge_writer.sorted()) {
+          for (size_t i = 0, count = readers.size(); i < count; ++i) {
+            merge.doc_id_maps.emplace_back(merge_writer.doc_id_map(i));
+          }
+        }
+
+        dir.visit_refs([&merge](const index_file_refs::ref_t& ref)->bool {
+          merge.refs.emplace_back(ref);
+          return true;
+        });
+        merged = true;
+      }
+    } catch (...) {
+      IR_EXCEPTION(); // merge failure, candidates will be merged again later
+    }
+  }
+
+  SCOPED_LOCK(merge_lock_);
+
+  if (merged) {
+    try {
+      merged_segments_.emplace_back(ctx);
+      return;
+    } catch (...) {
+      IR_EXCEPTION();
+    }
+  }
+
+  for (auto& candidate: merge.candidates) {
+    merging_segments_.erase(candidate.meta.name);
+  }
+}
+
+bool index_writer::add_merged_segment(
+    flush_context& ctx, merge_context& merge
+) {
+  REGISTER_TIMER_DETAILED();
+  std::unordered_map<string_ref, const segment_meta*> segments;
+  document_mask docs_mask;
+  auto base = (type_limits<type_t::doc_id_t>::min)();
+
+  for (auto& segment: meta_) {
+    segments.emplace(segment.meta.name, &(segment.meta));
+  }
+
+  for (size_t i = 0, count = merge.candidates.size(); i < count; ++i) {
+    auto& candidate = merge.candidates[i].meta;
+    auto& candidate_mask = merge.candidates_masks[i];
+    auto itr = segments.find(candidate.name);
+
+    // all documents of the candidate were removed or it was consolidated
+    if (segments.end() == itr
+        || ctx.segment_mask_.end() != ctx.segment_mask_.find(candidate.name)) {
+      return false;
+    }
+
+    auto& meta = *(itr->second);
+
+    // documents were removed from candidate while merging, map them to
+    // merged doc_ids, i.e. live docs of the candidates in order of merge
+    if (meta.version != candidate.version) {
+      document_mask mask;
+
+      index_utils::read_document_mask(mask, dir_, meta);
+
+      // merged segment was reordered by 'sort_', doc_ids were recorded
+      if (!merge.doc_id_maps.empty()) {
+        auto& doc_id_map = merge.doc_id_maps[i];
+
+        mask.visit([&doc_id_map, &docs_mask](doc_id_t src)->bool {
+          // documents in 'candidate_mask' are mapped to eof()
+          if (src < doc_id_map.size()
+              && !type_limits<type_t::doc_id_t>::eof(doc_id_map[src])) {
+            docs_mask.insert(doc_id_map[src]);
+          }
+
+          return true;
+        });
+      } else {
+        auto doc = base;
+
+        for (doc_id_t src = (type_limits<type_t::doc_id_t>::min)(),
+             end = src + candidate.docs_count; src < end; ++src) {
+          if (candidate_mask.contains(src)) {
+            continue; // document not present in merged segment
+          }
+
+          if (mask.contains(src)) {
+            docs_mask.insert(doc);
+          }
+
+          ++doc;
+        }
+      }
+    }
+
+    base += doc_id_t(candidate.docs_count - candidate_mask.size());
+  }
+
+  auto& dir = *(ctx.dir_);
+  auto& segment = merge.segment;
+
+  if (!docs_mask.empty()) {
+    write_document_mask(dir, segment.meta, docs_mask);
+    segment.filename = write_segment_meta(dir, segment.meta); // write with new mask
+  }
+
+  for (auto& candidate: merge.candidates) {
+    ctx.segment_mask_.emplace(segments.find(candidate.meta.name)->first); // ref to name in meta_
+  }
+
+  // add a policy to hold references to the files of merged segment till the
+  // end of commit, see consolidate(...)
+  auto refs = std::make_shared<file_refs_t>(std::move(merge.refs));
+  consolidation_policy_t refs_holder = [refs](const directory&, const index_meta&)->consolidation_acceptor_t {
+    return [](const segment_meta&)->bool { return false; };
+  };
+
+  ctx.consolidation_policies_.emplace_back(std::move(refs_holder));
+
+  // 0 == merged segments existed before start of tx (all removes apply)
+  ctx.pending_segments_.emplace_back(std::move(segment), 0);
+
+  return true;
+}
+
+void index_writer::wait_for_consolidation() {
+  if (merge_tasks_) {
+    merge_tasks_->wait(); // merge tasks do not throw
+  }
+}
+
 void index_writer::consolidate(
   const consolidation_policy_t& policy, bool immediate
 ) {
+  if (immediate && merge_pool_) {
+    SCOPED_LOCK(commit_lock_); // ensure meta_ segments are not modified by concurrent consolidate()/commit()
+    schedule_consolidation(policy, committed_state_.first);
+    return;
+  }
+
   if (immediate) {
     REGISTER_TIMER_DETAILED();
     auto meta = committed_state_.first;
@@ -563,7 +1275,7 @@ void index_writer::consolidate(
 bool index_writer::import(const index_reader& reader) {
   auto ctx = get_flush_context();
   auto merge_segment_name = file_name(meta_.increment());
-  merge_writer merge_writer(*(ctx->dir_), merge_segment_name);
+  merge_writer merge_writer(*(ctx->dir_), merge_segment_name, &sort_);
 
   for (auto itr = reader.begin(), end = reader.end(); itr != end; ++itr) {
     merge_writer.add(*itr);
@@ -586,54 +1298,57 @@ bool index_writer::import(const index_reader& reader) {
 }
 
 index_writer::flush_context::ptr index_writer::get_flush_context(bool shared /*= true*/) {
-  auto* ctx = flush_context_.load(); // get current ctx
-
   if (!shared) {
-    for(;;) {
-      async_utils::read_write_mutex::write_mutex mutex(ctx->flush_mutex_);
-      SCOPED_LOCK_NAMED(mutex, lock); // lock ctx exchange (write-lock)
+    for (auto* ctx = flush_context_.load();; ctx = flush_context_.load()) {
+      // wait for the previous flush of the context to finish
+      auto expected = false;
+
+      if (!ctx->exclusive_.compare_exchange_strong(expected, true)) {
+        std::this_thread::yield();
+        continue;
+      }
 
-      // aquire the current flush_context and its lock
+      // operations entering the context after the exchange switch to the
+      // next context, wait for the ones already admitted
       if (!flush_context_.compare_exchange_strong(ctx, ctx->next_context_)) {
-        ctx = flush_context_.load(); // it might have changed
+        ctx->exclusive_.store(false); // it might have changed
         continue;
       }
 
-      lock.release();
+      SCOPED_LOCK_NAMED(ctx->admission_mutex_, lock);
+
+      while (ctx->admitted()) {
+        ctx->admission_cond_.wait_for(lock, std::chrono::milliseconds(1000));
+      }
 
       return flush_context::ptr(ctx, false);
     }
   }
 
-  for(;;) {
-    async_utils::read_write_mutex::read_mutex mutex(ctx->flush_mutex_);
-    TRY_SCOPED_LOCK_NAMED(mutex, lock); // lock current ctx (read-lock)
+  // threads are likely to be counted in different slots
+  // and do not contend on the same counter
+  const auto slot =
+    std::hash<std::thread::id>()(std::this_thread::get_id())
+    % flush_context::ADMISSION_SLOTS;
 
-    if (!lock) {
-      std::this_thread::yield(); // allow flushing thread to finish exchange
-      ctx = flush_context_.load(); // it might have changed
-      continue;
-    }
+  for (auto* ctx = flush_context_.load();; ctx = flush_context_.load()) {
+    auto& count = ctx->admitted_[slot].count;
 
-    // at this point flush_context_ might have already changed
-    // get active ctx, since initial_ctx is locked it will never be swapped with current until unlocked
-    auto* flush_ctx = flush_context_.load();
+    ++count; // admit before checking, see flush above
 
-    // primary_flush_context_ has changed
-    if (ctx != flush_ctx) {
-      ctx = flush_ctx;
-      continue;
+    // the context is current and not held by a flush
+    if (ctx == flush_context_.load() && !ctx->exclusive_.load()) {
+      return flush_context::ptr(ctx, true, slot);
     }
 
-    lock.release();
-
-    return flush_context::ptr(ctx, true);
+    ctx->leave(slot);
+    std::this_thread::yield(); // allow flushing thread to finish exchange
   }
 }
 
 index_writer::flush_context::segment_writers_t::ptr index_writer::get_segment_context(
     flush_context& ctx) {
-  auto writer = ctx.writers_pool_.emplace(*(ctx.dir_));
+  auto writer = ctx.writers_pool_.emplace(*(ctx.dir_), norm_encoding_, &sort_);
 
   if (!writer->initialized()) {
     writer->reset(segment_meta(file_name(meta_.increment()), codec_));
@@ -642,6 +1357,230 @@ index_writer::flush_context::segment_writers_t::ptr index_writer::get_segment_co
   return writer;
 }
 
+void index_writer::flush_if_needed(
+    flush_context& ctx,
+    flush_context::segment_writers_t::ptr& writer,
+    bool next) {
+  if (!memory_max_ && !segment_memory_max_) {
+    return; // memory is not accounted without the limits
+  }
+
+  const auto writer_memory = writer->memory();
+  const auto accounted = writer->memory_accounted();
+  size_t total = 0; // unknown unless accounted below
+
+  // the memory of a writer changes only while it is held by the inserting
+  // thread, it's accounted in the shared total in batches
+  if (writer_memory >= accounted + memory_batch_ || writer_memory < accounted) {
+    total = (ctx.memory_ += writer_memory - accounted);
+    writer->memory_accounted(writer_memory);
+  }
+
+  // flush writers holding at least their share of the limit,
+  // the largest writer always qualifies
+  const bool flush =
+    (segment_memory_max_ && writer_memory >= segment_memory_max_)
+    || (memory_max_ && total >= memory_max_
+        && writer_memory * ctx.writers_pool_.size() >= memory_max_);
+
+  if (!flush) {
+    return;
+  }
+
+  ctx.memory_ -= writer->memory_accounted(); // the writer is reset by flush_segment(...)
+
+  if (ctx.flush_tasks_) {
+    // the task retains the writer until the end of the flush, the inserting
+    // thread continues with another writer
+    auto task_writer = make_move_on_copy(std::move(writer));
+
+    ctx.flush_tasks_->run([this, &ctx, task_writer]() mutable ->void {
+      flush_segment(ctx, *(task_writer.value()));
+      task_writer.value().reset(); // return writer to the pool
+    });
+  } else {
+    flush_segment(ctx, *writer);
+    writer.reset(); // return writer to the pool
+  }
+
+  if (next) {
+    writer = get_segment_context(ctx); // starts a new segment
+  }
+}
+
+void index_writer::flush_segment(
+    flush_context& ctx, segment_writer& writer) NOEXCEPT {
+  REGISTER_TIMER_DETAILED();
+
+  try {
+    flushed_segment flushed(
+      index_meta::index_segment_t(segment_meta(writer.name(), codec_))
+    );
+
+    if (writer.flush(flushed.segment.filename, flushed.segment.meta)) {
+      writer.release(flushed.docs_context, flushed.docs_mask);
+      writer.reset(); // next get_segment_context(...) starts a new segment
+
+      SCOPED_LOCK(ctx.mutex_); // lock due to context modification
+      ctx.flushed_segments_.emplace_back(std::move(flushed));
+
+      return;
+    }
+
+    IR_FRMT_ERROR("Failed to flush segment '%s' in: %s", writer.name().c_str(), __FUNCTION__);
+  } catch (...) {
+    IR_EXCEPTION();
+  }
+
+  writer.reset(); // buffered documents are lost, reported by next commit()
+
+  SCOPED_LOCK(ctx.mutex_); // lock due to context modification
+  ctx.flush_failed_ = true;
+}
+
+directory_reader index_writer::reader() {
+  REGISTER_TIMER_DETAILED();
+  assert(write_lock_);
+  SCOPED_LOCK(commit_lock_); // guard for meta_ and cached_segment_readers_
+  auto ctx = get_flush_context(); // retain context until the end of reader()
+  auto& dir = *(ctx->dir_);
+  size_t queries_count;
+
+  {
+    SCOPED_LOCK(ctx->mutex_);
+    queries_count = ctx->modification_queries_.size();
+  }
+
+  // flush documents buffered by the segment writers, the replacements of the
+  // updates requested before this point are in the writers visited below
+  ctx->writers_pool_.visit([this, &ctx](segment_writer& writer)->bool {
+    if (writer.initialized() && writer.docs_cached()) {
+      ctx->memory_ -= writer.memory_accounted(); // the writer is reset by flush_segment(...)
+      flush_segment(*ctx, writer);
+    }
+
+    return true;
+  });
+
+  SCOPED_LOCK(ctx->mutex_); // ensure there are no active struct update operations
+  auto& queries = ctx->modification_queries_;
+
+  // apply only the modifications requested before the flush above, restore
+  // the state of the modification requests for the next commit afterwards
+  std::vector<std::shared_ptr<const filter>> filters(queries.size());
+  std::vector<bool> seen(queries.size());
+
+  for (size_t i = 0, count = queries.size(); i < count; ++i) {
+    seen[i] = queries[i].seen;
+
+    if (i >= queries_count) {
+      filters[i].swap(queries[i].filter);
+    }
+  }
+
+  auto restore = make_finally([&queries, &filters, &seen]()->void {
+    for (size_t i = 0, count = queries.size(); i < count; ++i) {
+      queries[i].seen = seen[i];
+
+      if (filters[i]) {
+        queries[i].filter.swap(filters[i]);
+      }
+    }
+  });
+
+  index_meta meta; // invalid generation, i.e. never equal to a committed one
+  std::vector<document_mask> docs_masks;
+  std::vector<bool> modified;
+
+  // existing segments and complete segments pending commit (import)
+  auto add_segment = [this, &dir, &queries, &meta, &docs_masks, &modified](
+      const index_meta::index_segment_t& segment, size_t generation)->void {
+    document_mask docs_mask;
+
+    index_utils::read_document_mask(docs_mask, dir, segment.meta);
+
+    const bool masked = add_document_mask_modified_records(
+      queries, docs_mask, segment.meta, generation
+    );
+
+    // segment is removed upon commit
+    if (docs_mask.size() == segment.meta.docs_count) {
+      return;
+    }
+
+    meta.segments_.emplace_back(segment);
+    docs_masks.emplace_back(std::move(docs_mask));
+    modified.push_back(masked);
+  };
+
+  for (auto& segment: meta_) {
+    if (ctx->segment_mask_.end() == ctx->segment_mask_.find(segment.meta.name)) {
+      add_segment(segment, 0);
+    }
+  }
+
+  for (auto& pending_segment: ctx->pending_segments_) {
+    add_segment(pending_segment.segment, pending_segment.generation);
+  }
+
+  // segments flushed since the last commit, requires modification requests
+  // seen by the existing/pending segments above
+  const auto flushed_offset = meta.size();
+
+  for (auto& flushed: ctx->flushed_segments_) {
+    document_mask docs_mask(flushed.docs_mask);
+
+    add_document_mask_modified_records(
+      queries, docs_mask, flushed.docs_context, flushed.segment.meta
+    );
+    meta.segments_.emplace_back(flushed.segment);
+    docs_masks.emplace_back(std::move(docs_mask));
+    modified.push_back(true);
+  }
+
+  for (size_t i = flushed_offset, count = meta.size(); i < count; ++i) {
+    auto& flushed = ctx->flushed_segments_[i - flushed_offset];
+
+    add_document_mask_unused_updates(
+      queries, docs_masks[i], flushed.docs_context, flushed.segment.meta
+    );
+  }
+
+  index_meta::index_segments_t segments;
+  std::vector<segment_reader> readers;
+
+  segments.reserve(meta.size());
+  readers.reserve(meta.size());
+
+  for (size_t i = 0, count = meta.size(); i < count; ++i) {
+    auto& segment = meta.segments_[i];
+    auto& docs_mask = docs_masks[i];
+
+    // segment is removed upon commit
+    if (docs_mask.size() == segment.meta.docs_count) {
+      continue;
+    }
+
+    auto rdr = get_segment_reader(segment.meta);
+
+    if (!rdr) {
+      throw index_error(); // failed to open segment
+    }
+
+    // masks of the segments not committed yet are kept in memory only
+    if (modified[i] && !docs_mask.empty()) {
+      rdr = rdr.masked(std::move(docs_mask));
+    }
+
+    segments.emplace_back(std::move(segment));
+    readers.emplace_back(std::move(rdr));
+  }
+
+  meta.segments_.swap(segments);
+
+  return directory_reader::open(dir_, std::move(meta), std::move(readers));
+}
+
 void index_writer::remove(const filter& filter) {
   auto ctx = get_flush_context();
   SCOPED_LOCK(ctx->mutex_); // lock due to context modification
@@ -666,134 +1605,301 @@ void index_writer::remove(filter::ptr&& filter) {
 
 index_writer::pending_context_t index_writer::flush_all() {
   REGISTER_TIMER_DETAILED();
+
+  // state of a segment in the upcoming commit
+  struct flush_segment_context {
+    enum class source { EXISTING, PENDING, FLUSHED, WRITER } type;
+    size_t generation; // min doc generation of modifications (PENDING)
+    segment_writer* writer; // segment writer (WRITER)
+    bool flushed; // segment writer flushed successfully (WRITER)
+    bool masked; // all documents are masked, i.e. segment to be removed
+    std::string mask_file; // name of the newly written document mask (EXISTING)
+    segment_writer::update_contexts docs_context; // generations of the documents (FLUSHED, WRITER)
+    document_mask docs_mask; // masked documents (FLUSHED, WRITER)
+
+    flush_segment_context(source v_type, size_t v_generation, segment_writer* v_writer)
+      : type(v_type), generation(v_generation), writer(v_writer),
+        flushed(false), masked(false) {
+    }
+
+    // segment of the documents inserted since the last commit
+    bool buffered() const NOEXCEPT {
+      return source::FLUSHED == type || source::WRITER == type;
+    }
+  };
+
   bool modified = !type_limits<type_t::index_gen_t>::valid(meta_.last_gen_);
   index_meta::index_segments_t segments;
-  std::unordered_set<string_ref> to_sync;
+  std::vector<flush_segment_context> segment_ctxs;
+  std::unordered_set<std::string> to_sync;
 
   auto ctx = get_flush_context(false);
   auto& dir = *(ctx->dir_);
+  ctx->wait_for_flush(); // flushes due to the memory limits modify the context
   SCOPED_LOCK(ctx->mutex_); // ensure there are no active struct update operations
 
-  // update document_mask for existing (i.e. sealed) segments
-  for (auto& existing_segment: meta_) {
-    // skip already masked segments
-    if (ctx->segment_mask_.end() != ctx->segment_mask_.find(existing_segment.meta.name)) {
-      continue;
-    }
+  // segments flushed successfully are committed regardless of a failed flush,
+  // the failure is reported once the commit is complete
+  const bool flush_failed = ctx->flush_failed_;
 
-    segments.emplace_back(existing_segment);
+  // segments merged in background replace their candidates
+  if (merge_tasks_) {
+    std::vector<std::shared_ptr<merge_context>> merged_segments;
 
-    auto& segment = segments.back();
-    document_mask docs_mask;
+    {
+      SCOPED_LOCK(merge_lock_);
+      merged_segments.swap(merged_segments_);
+    }
 
-    index_utils::read_document_mask(docs_mask, dir, segment.meta);
+    auto release = make_finally([this, &merged_segments]()->void {
+      SCOPED_LOCK(merge_lock_);
 
-    // write docs_mask if masks added, if all docs are masked then mask segment
-    if (add_document_mask_modified_records(ctx->modification_queries_, docs_mask, segment.meta)) {
-      // mask empty segments
-      if (docs_mask.size() == segment.meta.docs_count) {
-        segments.pop_back();
-        modified = true; // removal of one fo the existing segments
-        continue;
+      for (auto& merge: merged_segments) {
+        for (auto& candidate: merge->candidates) {
+          merging_segments_.erase(candidate.meta.name);
+        }
+      }
+    });
+
+    for (auto& merge: merged_segments) {
+      // candidates are kept as is if the merge result can't be registered
+      if (!add_merged_segment(*ctx, *merge)) {
+        IR_FRMT_WARN(
+          "Discarding merged segment '%s' since its candidates were modified, in: %s",
+          merge->segment.meta.name.c_str(), __FUNCTION__
+        );
       }
+    }
+  }
 
-      to_sync.emplace(write_document_mask(dir, segment.meta, docs_mask));
-      segment.filename = write_segment_meta(dir, segment.meta); // write with new mask
+  // existing (i.e. sealed) segments, skip already masked segments
+  for (auto& existing_segment: meta_) {
+    if (ctx->segment_mask_.end() == ctx->segment_mask_.find(existing_segment.meta.name)) {
+      segments.emplace_back(existing_segment);
+      segment_ctxs.emplace_back(flush_segment_context::source::EXISTING, 0, nullptr);
     }
   }
 
-  // add pending complete segments
+  // pending complete segments
   for (auto& pending_segment: ctx->pending_segments_) {
     segments.emplace_back(std::move(pending_segment.segment));
-
-    auto& segment = segments.back();
-    document_mask docs_mask;
-
-    // flush document_mask after regular flush() so remove_query can traverse
-    add_document_mask_modified_records(
-      ctx->modification_queries_, docs_mask, segment.meta, pending_segment.generation
+    segment_ctxs.emplace_back(
+      flush_segment_context::source::PENDING, pending_segment.generation, nullptr
     );
+  }
 
-    // remove empty segments
-    if (docs_mask.size() == segment.meta.docs_count) {
-      segments.pop_back();
-      continue;
+  // segments flushed due to the memory limits
+  for (auto& flushed_segment: ctx->flushed_segments_) {
+    segments.emplace_back(std::move(flushed_segment.segment));
+    segment_ctxs.emplace_back(flush_segment_context::source::FLUSHED, 0, nullptr);
+    segment_ctxs.back().docs_context = std::move(flushed_segment.docs_context);
+    segment_ctxs.back().docs_mask = std::move(flushed_segment.docs_mask);
+  }
+
+  // segment writers, write-locked flush context guarantees no concurrent use
+  ctx->writers_pool_.visit([this, &segments, &segment_ctxs](segment_writer& writer)->bool {
+    if (writer.initialized()) {
+      segments.emplace_back(segment_meta(writer.name(), codec_));
+      segment_ctxs.emplace_back(flush_segment_context::source::WRITER, 0, &writer);
     }
 
-    // write non-empty document mask
-    if (!docs_mask.empty()) {
-      write_document_mask(dir, segment.meta, docs_mask);
-      segment.filename = write_segment_meta(dir, segment.meta); // write with new mask
+    return true;
+  }, true);
+
+  // 'segments' and 'segment_ctxs' are not resized below, i.e. references
+  // remain valid while tasks are running
+  async_utils::task_group tasks(commit_pool_.get());
+
+  // flush segment writers and update document_mask for existing and pending
+  // segments, only marks modification requests as seen
+  {
+    timer_utils::scoped_timer timer(timer_utils::get_stat(COMMIT_PHASE_FLUSH));
+
+    for (size_t i = 0, count = segments.size(); i < count; ++i) {
+      auto& segment = segments[i];
+      auto& segment_ctx = segment_ctxs[i];
+
+      switch (segment_ctx.type) {
+       case flush_segment_context::source::EXISTING:
+        tasks.run([this, &ctx, &dir, &segment, &segment_ctx]()->void {
+          document_mask docs_mask;
+
+          index_utils::read_document_mask(docs_mask, dir, segment.meta);
+
+          // write docs_mask if masks added, if all docs are masked then mask segment
+          if (add_document_mask_modified_records(ctx->modification_queries_, docs_mask, segment.meta)) {
+            // mask empty segments
+            if (docs_mask.size() == segment.meta.docs_count) {
+              segment_ctx.masked = true;
+              return;
+            }
+
+            segment_ctx.mask_file = write_document_mask(dir, segment.meta, docs_mask);
+            segment.filename = write_segment_meta(dir, segment.meta); // write with new mask
+          }
+        });
+        break;
+       case flush_segment_context::source::PENDING:
+        tasks.run([this, &ctx, &dir, &segment, &segment_ctx]()->void {
+          document_mask docs_mask;
+
+          // segments merged in background may already have a mask
+          index_utils::read_document_mask(docs_mask, dir, segment.meta);
+
+          // flush document_mask after regular flush() so remove_query can traverse
+          const bool modified = add_document_mask_modified_records(
+            ctx->modification_queries_, docs_mask, segment.meta, segment_ctx.generation
+          );
+
+          // remove empty segments
+          if (docs_mask.size() == segment.meta.docs_count) {
+            segment_ctx.masked = true;
+            return;
+          }
+
+          // write modified document mask
+          if (modified) {
+            write_document_mask(dir, segment.meta, docs_mask);
+            segment.filename = write_segment_meta(dir, segment.meta); // write with new mask
+          }
+        });
+        break;
+       case flush_segment_context::source::FLUSHED:
+        break; // already flushed, document masks are applied below
+       case flush_segment_context::source::WRITER:
+        tasks.run([&segment, &segment_ctx]()->void {
+          auto& writer = *(segment_ctx.writer);
+
+          segment_ctx.flushed = writer.flush(segment.filename, segment.meta);
+
+          if (segment_ctx.flushed) {
+            writer.release(segment_ctx.docs_context, segment_ctx.docs_mask);
+          }
+        });
+        break;
+      }
     }
 
-    // add files from segment to list of files to sync
-    to_sync.insert(segment.meta.files.begin(), segment.meta.files.end());
+    tasks.wait();
+  }
+
+  for (auto& segment_ctx: segment_ctxs) {
+    if (flush_segment_context::source::WRITER == segment_ctx.type
+        && !segment_ctx.flushed) {
+      return pending_context_t();
+    }
   }
 
+  // flush document_mask after regular flush() so remove_query can traverse,
+  // requires modification requests seen by existing/pending segments above,
+  // not parallelized: an update replacing a document inserted by another
+  // update is seen only if the other update has been seen already, i.e. the
+  // segments are processed one by one in a deterministic order
   {
-    struct flush_context {
-      size_t segment_offset;
-      segment_writer& writer;
-      flush_context(
-        size_t v_segment_offset, segment_writer& v_writer
-      ): segment_offset(v_segment_offset), writer(v_writer) {}
-      flush_context& operator=(const flush_context&) = delete; // because of reference
-    };
+    timer_utils::scoped_timer timer(timer_utils::get_stat(COMMIT_PHASE_DOCUMENT_MASK));
+
+    for (size_t i = 0, count = segments.size(); i < count; ++i) {
+      auto& segment_ctx = segment_ctxs[i];
 
-    std::vector<flush_context> segment_ctxs;
-    auto flush = [this, &ctx, &segments, &segment_ctxs](segment_writer& writer) {
-      if (!writer.initialized()) {
-        return true;
+      if (!segment_ctx.buffered()) {
+        continue;
       }
 
-      segment_ctxs.emplace_back(segments.size(), writer);
-      segments.emplace_back(segment_meta(writer.name(), codec_));
+      add_document_mask_modified_records(
+        ctx->modification_queries_,
+        segment_ctx.docs_mask,
+        segment_ctx.docs_context,
+        segments[i].meta
+      );
+    }
+  }
 
-      auto& segment = segments.back();
+  // write docs_mask if !empty(), if all docs are masked then remove segment altogether
+  {
+    timer_utils::scoped_timer timer(timer_utils::get_stat(COMMIT_PHASE_SEGMENT_META));
 
-      if (!writer.flush(segment.filename, segment.meta)) {
-        return false;
+    for (size_t i = 0, count = segments.size(); i < count; ++i) {
+      auto& segment_ctx = segment_ctxs[i];
+
+      if (!segment_ctx.buffered()) {
+        continue;
       }
 
-      // flush document_mask after regular flush() so remove_query can traverse
-      add_document_mask_modified_records(
-        ctx->modification_queries_, writer, segment.meta
-      );
+      auto& segment = segments[i];
 
-      return true;
-    };
+      tasks.run([&ctx, &dir, &segment, &segment_ctx]()->void {
+        auto& docs_mask = segment_ctx.docs_mask;
 
-    if (!ctx->writers_pool_.visit(flush)) {
-      return pending_context_t();
+        // if have a writer with potential update-replacement records then check if they were seen
+        add_document_mask_unused_updates(
+          ctx->modification_queries_,
+          docs_mask,
+          segment_ctx.docs_context,
+          segment.meta
+        );
+
+        // mask empty segments
+        if (docs_mask.size() == segment.meta.docs_count) {
+          segment_ctx.masked = true;
+          return;
+        }
+
+        // write non-empty document mask
+        if (!docs_mask.empty()) {
+          write_document_mask(dir, segment.meta, docs_mask);
+          segment.filename = write_segment_meta(dir, segment.meta); // write with new mask
+        }
+      });
     }
 
-    // write docs_mask if !empty(), if all docs are masked then remove segment altogether
-    for (auto& segment_ctx: segment_ctxs) {
-      auto& segment = segments[segment_ctx.segment_offset];
-      auto& writer = segment_ctx.writer;
+    tasks.wait();
+  }
 
-      // if have a writer with potential update-replacement records then check if they were seen
-      add_document_mask_unused_updates(
-        ctx->modification_queries_, writer, segment.meta
-      );
+  // collect results of the flush tasks
+  {
+    index_meta::index_segments_t flushed_segments;
 
-      auto& docs_mask = writer.docs_mask();
+    flushed_segments.reserve(segments.size());
 
-      // mask empty segments
-      if (docs_mask.size() == segment.meta.docs_count) {
-        ctx->segment_mask_.emplace(writer.name()); // ref to writer name will not change
-        continue;
-      }
+    for (size_t i = 0, count = segments.size(); i < count; ++i) {
+      auto& segment = segments[i];
+      auto& segment_ctx = segment_ctxs[i];
+
+      switch (segment_ctx.type) {
+       case flush_segment_context::source::EXISTING:
+        if (segment_ctx.masked) {
+          modified = true; // removal of one of the existing segments
+          continue;
+        }
 
-      // write non-empty document mask
-      if (!docs_mask.empty()) {
-        write_document_mask(dir, segment.meta, docs_mask);
-        segment.filename = write_segment_meta(dir, segment.meta); // write with new mask
+        if (!segment_ctx.mask_file.empty()) {
+          to_sync.emplace(std::move(segment_ctx.mask_file));
+        }
+        break;
+       case flush_segment_context::source::PENDING:
+       case flush_segment_context::source::FLUSHED:
+        if (segment_ctx.masked) {
+          continue;
+        }
+
+        // add files from segment to list of files to sync
+        to_sync.insert(segment.meta.files.begin(), segment.meta.files.end());
+        break;
+       case flush_segment_context::source::WRITER:
+        if (segment_ctx.masked) {
+          ctx->segment_mask_.emplace(segment_ctx.writer->name()); // ref to writer name will not change
+          break; // masked segment is filtered out below
+        }
+
+        // add files from segment to list of files to sync
+        to_sync.insert(segment.meta.files.begin(), segment.meta.files.end());
+        break;
       }
 
-      // add files from segment to list of files to sync
-      to_sync.insert(segment.meta.files.begin(), segment.meta.files.end());
+      flushed_segments.emplace_back(std::move(segment));
     }
+
+    segments.swap(flushed_segments);
   }
 
   auto pending_meta = memory::make_unique<index_meta>();
@@ -814,32 +1920,37 @@ index_writer::pending_context_t index_writer::flush_all() {
     }
   }
 
-  // add segments generated by deferred merge policies to meta
-  for (auto& policy: ctx->consolidation_policies_) {
-    segments.clear();
-    segments.emplace_back();
+  // add segments generated by deferred merge policies to meta,
+  // background merges are scheduled after the commit, see finish()
+  if (!merge_tasks_) {
+    timer_utils::scoped_timer timer(timer_utils::get_stat(COMMIT_PHASE_CONSOLIDATE));
 
-    auto acceptor = (*(policy.policy))(*(ctx->dir_), *pending_meta);
-    auto& segment = segments.back();
-    flush_context::segment_mask_t segment_mask;
+    for (auto& policy: ctx->consolidation_policies_) {
+      segments.clear();
+      segments.emplace_back();
 
-    // remove empty segments
-    if (!add_segment_mask_consolidated_records(segment, *(ctx->dir_), segment_mask, pending_meta->segments_, acceptor) ||
-        !segment.meta.docs_count) {
-      continue;
-    }
+      auto acceptor = (*(policy.policy))(*(ctx->dir_), *pending_meta);
+      auto& segment = segments.back();
+      flush_context::segment_mask_t segment_mask;
 
-    // add files from segment to list of files to sync
-    to_sync.insert(segment.meta.files.begin(), segment.meta.files.end());
+      // remove empty segments
+      if (!add_segment_mask_consolidated_records(segment, *(ctx->dir_), segment_mask, pending_meta->segments_, acceptor) ||
+          !segment.meta.docs_count) {
+        continue;
+      }
 
-    // retain list of only non-masked segments
-    pending_meta->segments_.swap(segments);
+      // add files from segment to list of files to sync
+      to_sync.insert(segment.meta.files.begin(), segment.meta.files.end());
 
-    for (auto& segment: segments) {
-      if (segment_mask.end() == segment_mask.find(segment.meta.name)) {
-        pending_meta->segments_.emplace_back(std::move(segment));
-      } else {
-        cached_segment_readers_.erase(segment.meta.name); // no longer required
+      // retain list of only non-masked segments
+      pending_meta->segments_.swap(segments);
+
+      for (auto& segment: segments) {
+        if (segment_mask.end() == segment_mask.find(segment.meta.name)) {
+          pending_meta->segments_.emplace_back(std::move(segment));
+        } else {
+          cached_segment_readers_.erase(segment.meta.name); // no longer required
+        }
       }
     }
   }
@@ -880,11 +1991,13 @@ index_writer::pending_context_t index_writer::flush_all() {
 
   // only flush a new index version upon a new index or a metadata change
   if (!modified) {
-    return pending_context_t();
+    pending_context.flush_failed = flush_failed;
+    return pending_context;
   }
 
   pending_meta->seg_counter_.store(meta_.counter()); // ensure counter() >= max(seg#)
   pending_context.ctx = std::move(ctx); // retain flush context reference
+  pending_context.flush_failed = flush_failed;
   pending_context.meta = std::move(pending_meta); // retain meta pending flush
   segments = pending_context.meta->segments_; // create copy
   meta_.segments_.swap(segments); // noexcept op
@@ -963,6 +2076,10 @@ bool index_writer::start() {
   auto to_commit = flush_all(); // index metadata to commit
 
   if (!to_commit) {
+    if (to_commit.flush_failed) {
+      throw index_error(); // documents buffered by the failed flush are lost
+    }
+
     return true; // nothing to commit
   }
 
@@ -977,6 +2094,8 @@ bool index_writer::start() {
       meta_.update_generation(*(to_commit.meta));
     });
 
+    timer_utils::scoped_timer timer(timer_utils::get_stat(COMMIT_PHASE_SYNC));
+
     // sync files
     for (auto& file: to_commit.to_sync) {
       if (!to_commit.ctx->dir_->sync(file)) {
@@ -995,6 +2114,7 @@ bool index_writer::start() {
   // set to_commit as active flush context containing pending meta
   pending_state_.ctx = std::move(to_commit.ctx);
   pending_state_.meta = std::move(to_commit.meta);
+  pending_state_.flush_failed = to_commit.flush_failed;
 
   return true;
 }
@@ -1028,7 +2148,27 @@ void index_writer::finish() {
 
   committed_state.first = std::move(pending_state_.meta);
   committed_state_ = std::move(committed_state);
+
+  // apply deferred merge policies to the committed segments in background
+  if (merge_tasks_) {
+    timer_utils::scoped_timer timer(timer_utils::get_stat(COMMIT_PHASE_CONSOLIDATE));
+
+    for (auto& policy: ctx.consolidation_policies_) {
+      try {
+        schedule_consolidation(*(policy.policy), committed_state_.first);
+      } catch (...) {
+        IR_EXCEPTION(); // transaction already finished, merge will be retried later
+      }
+    }
+  }
+
+  const bool flush_failed = pending_state_.flush_failed;
+
   pending_state_.reset(); // flush is complete, release referecne to flush_context
+
+  if (flush_failed) {
+    throw index_error(); // documents buffered by the failed flush are lost
+  }
 }
 
 void index_writer::commit() {
@@ -28,6 +28,7 @@
 #include "field_meta.hpp"
 #include "segment_reader.hpp"
 #include "segment_writer.hpp"
+#include "merge_writer.hpp"
 
 #include "formats/formats.hpp"
 #include "search/filter.hpp"
@@ -230,6 +231,93 @@ class IRESEARCH_API index_writer : util::noncopyable {
     const directory& dir, const index_meta& meta
   )> consolidation_policy_t;
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief options the writer should use after creation
+  ////////////////////////////////////////////////////////////////////////////
+  struct options {
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief number of threads used during commit for flushing segments,
+    ///        applying document masks to the committed segments and writing
+    ///        segment metadata, document masks of the buffered segments are
+    ///        applied on the committing thread
+    ///        0 == perform all commit work on the committing thread
+    /// @note time spent in each commit phase is reported via
+    ///       timer_utils::visit(...) under the 'COMMIT_PHASE_*' keys
+    //////////////////////////////////////////////////////////////////////////
+    size_t commit_threads;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief max number of consolidations running concurrently in background
+    ///        0 == consolidate synchronously within consolidate()/commit()
+    /// @note with background consolidation enabled immediate policies are
+    ///       applied to the committed segments not being merged already,
+    ///       deferred policies are applied right after the commit, results
+    ///       are added to the index by the first commit after completion
+    //////////////////////////////////////////////////////////////////////////
+    size_t merge_threads;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief max number of bytes per second written by all background
+    ///        consolidations, 0 == unlimited
+    //////////////////////////////////////////////////////////////////////////
+    size_t merge_bytes_per_sec;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief encoding of the norms of the segments written by the writer,
+    ///        the segments with different encodings can be merged
+    //////////////////////////////////////////////////////////////////////////
+    segment_writer::norm_encoding norm_encoding;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief max number of bytes buffered by a single segment writer,
+    ///        a writer crossing the limit is flushed into a new segment
+    ///        without a commit, 0 == unlimited
+    /// @note flushed segments become visible only after the next commit()
+    //////////////////////////////////////////////////////////////////////////
+    size_t segment_memory_max;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief max number of bytes buffered by all segment writers together,
+    ///        once crossed writers holding at least their share of the limit
+    ///        are flushed into new segments without a commit, 0 == unlimited
+    //////////////////////////////////////////////////////////////////////////
+    size_t memory_max;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief number of threads used for flushing segment writers crossing
+    ///        the memory limits, 0 == flush on the inserting thread
+    //////////////////////////////////////////////////////////////////////////
+    size_t flush_threads;
+
+    //////////////////////////////////////////////////////////////////////////
+    /// @brief stored columns the documents of the flushed, merged and
+    ///        imported segments are ordered by (first column is the primary
+    ///        key), empty == order of insertion
+    /// @note queries ordered by the same columns may stop reading a segment
+    ///       after the first 'k' documents
+    //////////////////////////////////////////////////////////////////////////
+    sort_columns sort;
+
+    options()
+      : commit_threads(0),
+        merge_threads(0),
+        merge_bytes_per_sec(0),
+        norm_encoding(segment_writer::norm_encoding::FLOAT),
+        segment_memory_max(0),
+        memory_max(0),
+        flush_threads(0) {
+    }
+  }; // options
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief timer_utils keys of the commit phases
+  ////////////////////////////////////////////////////////////////////////////
+  static const std::string COMMIT_PHASE_FLUSH; // flush of segment writers
+  static const std::string COMMIT_PHASE_DOCUMENT_MASK; // removals/updates
+  static const std::string COMMIT_PHASE_SEGMENT_META; // masks + segment meta
+  static const std::string COMMIT_PHASE_CONSOLIDATE; // deferred merges
+  static const std::string COMMIT_PHASE_SYNC; // sync of modified files
+
   ////////////////////////////////////////////////////////////////////////////
   /// @brief name of the lock for index repository 
   ////////////////////////////////////////////////////////////////////////////
@@ -240,11 +328,13 @@ class IRESEARCH_API index_writer : util::noncopyable {
   /// @param dir directory where index will be should reside
   /// @param codec format that will be used for creating new index segments
   /// @param mode specifies how to open a writer
+  /// @param opts options the writer should use
   ////////////////////////////////////////////////////////////////////////////
   static index_writer::ptr make(
     directory& dir,
     format::ptr codec,
-    OPEN_MODE mode);
+    OPEN_MODE mode,
+    const options& opts = options());
 
   ////////////////////////////////////////////////////////////////////////////
   /// @brief destructor 
@@ -256,6 +346,12 @@ class IRESEARCH_API index_writer : util::noncopyable {
   ////////////////////////////////////////////////////////////////////////////
   uint64_t buffered_docs() const;
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// @returns approximate number of bytes buffered by all segment writers,
+  ///          accounted in batches and only if a memory limit is set
+  ////////////////////////////////////////////////////////////////////////////
+  size_t buffered_memory() const;
+
   ////////////////////////////////////////////////////////////////////////////
   /// @brief Clears the existing index repository by staring an empty index.
   ///        Previously opened readers still remain valid.
@@ -275,10 +371,11 @@ class IRESEARCH_API index_writer : util::noncopyable {
     auto ctx = get_flush_context(); // retain lock until end of insert(...)
     auto writer = get_segment_context(*ctx);
 
-    document doc(*writer);
-
     bool has_next = true;
+    bool valid;
     do {
+      document doc(*writer); // 'writer' might be replaced after a flush
+
       writer->begin(make_update_context(*ctx));
       try {
         has_next = func(doc);
@@ -287,9 +384,12 @@ class IRESEARCH_API index_writer : util::noncopyable {
         writer->rollback();
         throw;
       }
+
+      valid = writer->valid();
+      flush_if_needed(*ctx, writer, has_next);
     } while (has_next);
 
-    return writer->valid();
+    return valid;
   }
 
   ////////////////////////////////////////////////////////////////////////////
@@ -308,7 +408,10 @@ class IRESEARCH_API index_writer : util::noncopyable {
 
     writer->begin(make_update_context(*ctx, filter));
 
-    return update(*ctx, *writer, func);
+    const auto valid = update(*ctx, *writer, func);
+    flush_if_needed(*ctx, writer, false);
+
+    return valid;
   }
 
   ////////////////////////////////////////////////////////////////////////////
@@ -326,7 +429,10 @@ class IRESEARCH_API index_writer : util::noncopyable {
 
     writer->begin(make_update_context(*ctx, std::move(filter)));
 
-    return update(*ctx, *writer, func);
+    const auto valid = update(*ctx, *writer, func);
+    flush_if_needed(*ctx, writer, false);
+
+    return valid;
   }
 
   ////////////////////////////////////////////////////////////////////////////
@@ -344,7 +450,10 @@ class IRESEARCH_API index_writer : util::noncopyable {
 
     writer->begin(make_update_context(*ctx, filter));
 
-    return update(*ctx, *writer, func);
+    const auto valid = update(*ctx, *writer, func);
+    flush_if_needed(*ctx, writer, false);
+
+    return valid;
   }
 
   ////////////////////////////////////////////////////////////////////////////
@@ -414,9 +523,17 @@ class IRESEARCH_API index_writer : util::noncopyable {
   ////////////////////////////////////////////////////////////////////////////
   bool import(const index_reader& reader);
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief waits for completion of all consolidations running in background
+  /// @note merged segments become visible only after the next commit()
+  ////////////////////////////////////////////////////////////////////////////
+  void wait_for_consolidation();
+
   ////////////////////////////////////////////////////////////////////////////
   /// @brief begins the two-phase transaction
   /// @returns true if transaction has been sucessflully started
+  /// @note throws index_error if a flush due to the memory limits has failed
+  ///       and there is nothing else to commit
   ////////////////////////////////////////////////////////////////////////////
   bool begin();
 
@@ -430,9 +547,24 @@ class IRESEARCH_API index_writer : util::noncopyable {
   ///
   /// Note that if begin() has been already called commit() is 
   /// relatively lightweight operation 
+  ///
+  /// Note that if a flush due to the memory limits has failed since the last
+  /// commit the documents buffered by it are lost, the rest of the changes
+  /// are committed and index_error is thrown afterwards
   ////////////////////////////////////////////////////////////////////////////
   void commit();
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief opens a near-real-time reader over the committed segments and the
+  ///        segments flushed since the last commit, documents buffered by the
+  ///        segment writers are flushed into new segments first, removals and
+  ///        updates requested before the call are applied via in-memory masks
+  /// @note nothing is committed, i.e. the changes are not durable, readers of
+  ///       unchanged segments are reused between calls
+  /// @note reopen() of the returned reader switches to the last commit
+  ////////////////////////////////////////////////////////////////////////////
+  directory_reader reader();
+
   ////////////////////////////////////////////////////////////////////////////
   /// @brief closes writer object 
   ////////////////////////////////////////////////////////////////////////////
@@ -467,7 +599,7 @@ class IRESEARCH_API index_writer : util::noncopyable {
     std::shared_ptr<const iresearch::filter> filter; // keep a handle to the filter for the case when this object has ownership
     const size_t generation;
     const bool update; // this is an update modification (as opposed to remove)
-    bool seen;
+    std::atomic<bool> seen; // may be set concurrently by parallel commit
     modification_context(const iresearch::filter& match_filter, size_t gen, bool isUpdate)
       : filter(&match_filter, [](const iresearch::filter*)->void{}), generation(gen), update(isUpdate), seen(false) {}
     modification_context(const std::shared_ptr<iresearch::filter>& match_filter, size_t gen, bool isUpdate)
@@ -475,7 +607,7 @@ class IRESEARCH_API index_writer : util::noncopyable {
     modification_context(iresearch::filter::ptr&& match_filter, size_t gen, bool isUpdate)
       : filter(std::move(match_filter)), generation(gen), update(isUpdate), seen(false) {}
     modification_context(modification_context&& other) NOEXCEPT
-      : filter(std::move(other.filter)), generation(other.generation), update(other.update), seen(other.seen) {}
+      : filter(std::move(other.filter)), generation(other.generation), update(other.update), seen(other.seen.load()) {}
     modification_context& operator=(const modification_context& other) = delete; // no default constructor
   }; // modification_context
 
@@ -490,6 +622,25 @@ class IRESEARCH_API index_writer : util::noncopyable {
     const index_meta::index_segment_t segment;
   }; // import_context
 
+  // state of a consolidation running in background
+  struct merge_context {
+    index_meta::index_segments_t candidates; // committed segments in order of merge
+    std::vector<document_mask> candidates_masks; // masked documents of 'candidates'
+    file_refs_t refs; // refs to files of candidates and the merged segment
+    index_meta::index_segment_t segment; // merged segment
+    std::vector<merge_writer::doc_id_map_t> doc_id_maps; // doc_ids of 'candidates' in 'segment' (reordered by 'sort_' only)
+  }; // merge_context
+
+  // segment of a writer flushed due to the memory limits
+  struct flushed_segment {
+    index_meta::index_segment_t segment;
+    segment_writer::update_contexts docs_context; // generations of the documents
+    document_mask docs_mask; // documents removed before the flush (e.g. rollback)
+
+    explicit flushed_segment(index_meta::index_segment_t&& v_segment)
+      : segment(std::move(v_segment)) {}
+  }; // flushed_segment
+
   typedef std::unordered_map<std::string, segment_reader> cached_readers_t;
   typedef std::pair<std::shared_ptr<index_meta>, file_refs_t> committed_state_t;
   typedef std::vector<consolidation_context> consolidation_requests_t;
@@ -497,18 +648,22 @@ class IRESEARCH_API index_writer : util::noncopyable {
 
   struct IRESEARCH_API flush_context {
     typedef std::vector<import_context> imported_segments_t;
+    typedef std::vector<flushed_segment> flushed_segments_t;
     typedef std::unordered_set<string_ref> segment_mask_t;
     typedef bounded_object_pool<segment_writer> segment_writers_t;
 
     // do not use std::shared_ptr to avoid unnecessary heap allocatons
     class ptr : util::noncopyable {
      public:
-      explicit ptr(flush_context* ctx = nullptr, bool shared = false) NOEXCEPT
-        : ctx(ctx), shared(shared) {
+      explicit ptr(
+          flush_context* ctx = nullptr,
+          bool shared = false,
+          size_t slot = 0) NOEXCEPT
+        : ctx(ctx), slot(slot), shared(shared) {
       }
 
       ptr(ptr&& rhs) NOEXCEPT
-        : ctx(rhs.ctx), shared(rhs.shared) {
+        : ctx(rhs.ctx), slot(rhs.slot), shared(rhs.shared) {
         rhs.ctx = nullptr; // take ownership
       }
 
@@ -516,6 +671,7 @@ class IRESEARCH_API index_writer : util::noncopyable {
         if (this != &rhs) {
           ctx = rhs.ctx;
           rhs.ctx = nullptr; // take ownership
+          slot = rhs.slot;
           shared = rhs.shared;
         }
         return *this;
@@ -532,13 +688,10 @@ class IRESEARCH_API index_writer : util::noncopyable {
         }
 
         if (!shared) {
-          async_utils::read_write_mutex::write_mutex mutex(ctx->flush_mutex_);
-          ADOPT_SCOPED_LOCK_NAMED(mutex, lock);
-
           ctx->reset(); // reset context and make ready for reuse
+          ctx->exclusive_.store(false); // admit new operations
         } else {
-          async_utils::read_write_mutex::read_mutex mutex(ctx->flush_mutex_);
-          ADOPT_SCOPED_LOCK_NAMED(mutex, lock);
+          ctx->leave(slot);
         }
 
         ctx = nullptr;
@@ -550,13 +703,33 @@ class IRESEARCH_API index_writer : util::noncopyable {
 
      private:
       flush_context* ctx;
+      size_t slot; // admission slot (shared)
       bool shared;
     }; // ptr
 
+    // number of admission slots, operations of different threads are likely
+    // to be counted in different slots
+    static const size_t ADMISSION_SLOTS = 64;
+
+    // counter of admitted operations occupying a cache line of its own,
+    // avoids false sharing of the counters between threads
+    struct alignas(64) admission_slot {
+      std::atomic<size_t> count;
+
+      admission_slot(): count(0) {}
+    }; // admission_slot
+
     consolidation_requests_t consolidation_policies_; // sequential list of segment merge policies to apply at the end of commit to all segments
     std::atomic<size_t> generation_; // current modification/update generation
     ref_tracking_directory::ptr dir_; // ref tracking directory used by this context (tracks all/only refs for this context)
-    async_utils::read_write_mutex flush_mutex_; // guard for the current context during flush (write) operations vs update (read)
+    bool flush_failed_; // a flush due to the memory limits has failed, guarded by mutex_
+    admission_slot admitted_[ADMISSION_SLOTS]; // number of operations (insert/update/remove) in progress within the context per slot
+    std::condition_variable admission_cond_; // signalled when the last operation leaves the context held exclusively
+    std::mutex admission_mutex_; // guard for admission_cond_
+    std::atomic<bool> exclusive_; // context is held by a flush (commit/clear), no new operations are admitted
+    std::unique_ptr<async_utils::task_group> flush_tasks_; // flushes due to the memory limits running in background (nullptr == flush on the inserting thread)
+    flushed_segments_t flushed_segments_; // segments flushed due to the memory limits to be added during next commit, guarded by mutex_
+    std::atomic<size_t> memory_; // number of bytes accounted by the segment writers
     modification_requests_t modification_queries_; // sequential list of modification requests (remove/update)
     std::mutex mutex_; // guard for the current context during struct update operations, e.g. modification_queries_, pending_segments_
     flush_context* next_context_; // the next context to switch to
@@ -565,24 +738,30 @@ class IRESEARCH_API index_writer : util::noncopyable {
     segment_writers_t writers_pool_; // per thread segment writers
 
     flush_context();
+    bool admitted() const NOEXCEPT; // there are operations in progress within the context
+    void leave(size_t slot) NOEXCEPT; // finishes operation admitted in the specified slot
     void reset();
+    void wait_for_flush(); // waits for completion of flushes running in background
   }; // flush_context
 
   struct pending_context_t {
     flush_context::ptr ctx; // reference to flush context held until end of commit
     index_meta::ptr meta; // index meta of next commit
     std::vector<string_ref> to_sync; // file names to be synced during next commit
+    bool flush_failed{}; // a flush due to the memory limits has failed
     pending_context_t() {}
     pending_context_t(pending_context_t&& other) NOEXCEPT
-      : ctx(std::move(other.ctx)), meta(std::move(other.meta)), to_sync(std::move(other.to_sync)) {}
+      : ctx(std::move(other.ctx)), meta(std::move(other.meta)), to_sync(std::move(other.to_sync)),
+        flush_failed(other.flush_failed) {}
     operator bool() const { return ctx && meta; }
   }; // pending_context_t
 
   struct pending_state_t {
     flush_context::ptr ctx; // reference to flush context held until end of commit
     index_meta::ptr meta; // index meta of next commit
+    bool flush_failed{}; // a flush due to the memory limits has failed
     operator bool() const { return ctx && meta; }
-    void reset() { ctx.reset(), meta.reset(); }
+    void reset() { ctx.reset(), meta.reset(), flush_failed = false; }
   }; // pending_state_t
 
   index_writer(
@@ -590,12 +769,14 @@ class IRESEARCH_API index_writer : util::noncopyable {
     directory& dir, 
     format::ptr codec,
     index_meta&& meta, 
-    committed_state_t&& committed_state
-  ) NOEXCEPT;
+    committed_state_t&& committed_state,
+    const options& opts
+  );
 
   // on open failure returns an empty pointer
   // function access controlled by commit_lock_ since only used in
-  // flush_all(...) and defragment(...)
+  // flush_all(...) and defragment(...), cache access is additionally guarded
+  // by cached_segment_readers_lock_ for use from parallel commit tasks
   segment_reader get_segment_reader(const segment_meta& meta);
 
   bool add_document_mask_modified_records(
@@ -607,13 +788,15 @@ class IRESEARCH_API index_writer : util::noncopyable {
 
   bool add_document_mask_modified_records(
     modification_requests_t& requests, 
-    segment_writer& writer,
+    document_mask& docs_mask,
+    const segment_writer::update_contexts& docs_context,
     const segment_meta& meta
   ); // return if any new records were added (modification_queries_ modified)
 
   static bool add_document_mask_unused_updates(
     modification_requests_t& requests, 
-    segment_writer& writer,
+    document_mask& docs_mask,
+    const segment_writer::update_contexts& docs_context,
     const segment_meta& meta
   ); // return if any new records were added (modification_queries_ modified)
 
@@ -625,8 +808,36 @@ class IRESEARCH_API index_writer : util::noncopyable {
     const consolidation_acceptor_t& acceptor // functr dictating which segments to consider
   ); // return if any new records were added (pending_segments_/segment_mask_ modified)
 
+  // selects committed segments accepted by policy and merges them in
+  // background, requires commit_lock_
+  void schedule_consolidation(
+    const consolidation_policy_t& policy,
+    const std::shared_ptr<index_meta>& committed_meta
+  );
+
+  // merges candidates and adds result to merged_segments_ (background task)
+  void merge(const std::shared_ptr<merge_context>& ctx) NOEXCEPT;
+
+  // adds a segment merged in background instead of its candidates,
+  // documents removed from the candidates since the start of the merge are
+  // masked in the merged segment, returns false if candidates no longer exist
+  bool add_merged_segment(flush_context& ctx, merge_context& merge);
+
   pending_context_t flush_all();
 
+  // accounts memory of the document just added to 'writer', if the memory
+  // limits are crossed flushes 'writer' and replaces it with another writer
+  // if 'next' documents are to follow
+  void flush_if_needed(
+    flush_context& ctx,
+    flush_context::segment_writers_t::ptr& writer,
+    bool next
+  );
+
+  // flushes 'writer' into a new segment to be added during next commit and
+  // resets it, failures are reported via ctx.flush_failed_
+  void flush_segment(flush_context& ctx, segment_writer& writer) NOEXCEPT;
+
   flush_context::ptr get_flush_context(bool shared = true);
   index_writer::flush_context::segment_writers_t::ptr get_segment_context(flush_context& ctx);
 
@@ -668,14 +879,29 @@ class IRESEARCH_API index_writer : util::noncopyable {
 
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
   cached_readers_t cached_segment_readers_; // readers by segment name
+  std::mutex cached_segment_readers_lock_; // guard for cached_segment_readers_ during parallel commit
   format::ptr codec_;
+  std::unique_ptr<async_utils::thread_pool> commit_pool_; // threads used for parallel commit (nullptr == commit on caller thread)
   std::mutex commit_lock_; // guard for cached_segment_readers_, commit_pool_, meta_ (modification during commit()/defragment())
+  std::unique_ptr<async_utils::thread_pool> flush_pool_; // threads used for flushes due to the memory limits (nullptr == flush on the inserting thread)
+  directory::ptr merge_dir_; // bandwidth limited directory used by background merges (nullptr == use dir_)
+  std::mutex merge_lock_; // guard for merged_segments_, merging_segments_
+  std::vector<std::shared_ptr<merge_context>> merged_segments_; // merges completed in background awaiting next commit
+  std::unordered_set<std::string> merging_segments_; // names of segments being merged in background
+  std::unique_ptr<async_utils::thread_pool> merge_pool_; // threads used for background merges (nullptr == consolidate synchronously)
+  std::atomic<bool> merge_stop_; // background merges should be abandoned (writer is closing)
+  std::unique_ptr<async_utils::task_group> merge_tasks_; // background merges in progress
   committed_state_t committed_state_; // last successfully committed state
   directory& dir_; // directory used for initialization of readers
   std::vector<flush_context> flush_context_pool_; // collection of contexts that collect data to be flushed, 2 because just swap them
   std::atomic<flush_context*> flush_context_; // currently active context accumulating data to be processed during the next flush
   index_meta meta_; // latest/active state of index metadata
+  size_t memory_max_; // max number of bytes buffered by all segment writers (0 == unlimited)
+  size_t memory_batch_; // number of bytes a segment writer buffers before accounting them in flush_context::memory_
+  segment_writer::norm_encoding norm_encoding_; // encoding of the norms of the new segments
   pending_state_t pending_state_; // current state awaiting commit completion
+  size_t segment_memory_max_; // max number of bytes buffered by a segment writer (0 == unlimited)
+  sort_columns sort_; // order of documents in new segments (empty == order of insertion)
   index_meta_writer::ptr writer_;
   index_lock::ptr write_lock_; // exclusive write lock for directory
   IRESEARCH_API_PRIVATE_VARIABLES_END
@@ -144,6 +144,29 @@ term_iterator::ptr term_iterator::empty() {
   return memory::make_managed<irs::term_iterator, false>(&instance);
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                               doc_iterator_arena
+// ----------------------------------------------------------------------------
+
+NS_LOCAL
+
+thread_local doc_iterator_arena* CURRENT_ARENA = nullptr;
+
+NS_END
+
+doc_iterator_arena::scope::scope(doc_iterator_arena& arena) NOEXCEPT
+  : prev_(CURRENT_ARENA) {
+  CURRENT_ARENA = &arena;
+}
+
+doc_iterator_arena::scope::~scope() {
+  CURRENT_ARENA = prev_;
+}
+
+/*static*/ doc_iterator_arena* doc_iterator_arena::current() NOEXCEPT {
+  return CURRENT_ARENA;
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                                seek_doc_iterator 
 // ----------------------------------------------------------------------------
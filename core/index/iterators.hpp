@@ -30,6 +30,7 @@
 #include "utils/iterator.hpp"
 #include "utils/integer.hpp"
 #include "utils/memory.hpp"
+#include "utils/memory_pool.hpp"
 
 NS_ROOT
 
@@ -37,6 +38,59 @@ NS_ROOT
 // --SECTION--                                                    doc iterators 
 // ----------------------------------------------------------------------------
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class doc_iterator_arena
+/// @brief query-scoped storage for doc iterators, 'doc_iterator::make(...)'
+///        places iterators into the arena installed on the calling thread by
+///        a 'doc_iterator_arena::scope' instead of the heap, memory of the
+///        released iterators is reused by the subsequent ones
+/// @note the arena must outlive every iterator created within its scope and
+///       is not thread-safe, i.e. the iterators must be released by the
+///       thread owning the arena
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API doc_iterator_arena : private util::noncopyable {
+ public:
+  typedef memory::memory_multi_size_pool<> pool_t;
+
+  template<typename T>
+  struct allocator {
+    typedef memory::memory_pool_multi_size_allocator<T, pool_t> type;
+  };
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @class scope
+  /// @brief installs the arena for the calling thread until destroyed
+  ////////////////////////////////////////////////////////////////////////////
+  class IRESEARCH_API scope : private util::noncopyable {
+   public:
+    explicit scope(doc_iterator_arena& arena) NOEXCEPT;
+    ~scope();
+
+   private:
+    doc_iterator_arena* prev_;
+  }; // scope
+
+  // arena installed on the calling thread, nullptr if none
+  static doc_iterator_arena* current() NOEXCEPT;
+
+  doc_iterator_arena() = default;
+
+  template<typename T, typename... Args>
+  std::shared_ptr<T> make(Args&&... args) {
+    typedef typename allocator<T>::type allocator_t;
+
+    // object and its control block share a single slot
+    return std::allocate_shared<T>(
+      allocator_t(pool_), std::forward<Args>(args)...
+    );
+  }
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  pool_t pool_{ 4 }; // iterators of the same type are few per query
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // doc_iterator_arena
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class doc_iterator 
 /// @brief base iterator for document collections. 
@@ -49,7 +103,26 @@ struct IRESEARCH_API doc_iterator
     : iterator<doc_id_t>,
       util::const_attribute_view_provider {
   DECLARE_SPTR(doc_iterator);
-  DECLARE_FACTORY(doc_iterator);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief creates an iterator in the arena installed on the calling thread,
+  ///        on the heap if there is none
+  //////////////////////////////////////////////////////////////////////////////
+  template<typename T, typename... Args>
+  static ptr make(Args&&... args) {
+    typedef typename std::enable_if<
+      std::is_base_of<doc_iterator, T>::value, T
+    >::type type;
+
+    auto* arena = doc_iterator_arena::current();
+
+    if (arena) {
+      return arena->make<type>(std::forward<Args>(args)...);
+    }
+
+    // creates shared_ptr with a single heap allocation
+    return std::make_shared<type>(std::forward<Args>(args)...);
+  }
 
   static doc_iterator::ptr empty();
 
@@ -21,10 +21,13 @@
 /// @author Vasiliy Nabatchikov
 ////////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <deque>
+#include <numeric>
 #include <unordered_map>
 
 #include "merge_writer.hpp"
+#include "analysis/token_attributes.hpp"
 #include "index/field_meta.hpp"
 #include "index/index_meta.hpp"
 #include "index/segment_reader.hpp"
@@ -40,7 +43,7 @@ NS_LOCAL
 
 // mapping of old doc_id to new doc_id (reader doc_ids are sequential 0 based)
 // masked doc_ids have value of MASKED_DOC_ID
-typedef std::vector<irs::doc_id_t> doc_id_map_t;
+typedef irs::merge_writer::doc_id_map_t doc_id_map_t;
 
 // mapping of old field_id to new field_id
 typedef std::vector<irs::field_id> id_map_t;
@@ -204,6 +207,206 @@ bool compound_doc_iterator::next() {
   return false;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class sorting_doc_iterator
+/// @brief buffers postings of a term (doc_ids remapped out of order by a
+///        segment sort) and replays them in the order of the new doc_ids
+//////////////////////////////////////////////////////////////////////////////
+class sorting_doc_iterator : public irs::doc_iterator {
+ public:
+  sorting_doc_iterator()
+    : attrs_(2) { // frequency + position
+    pos_.reset(irs::memory::make_unique<pos_iterator>(*this));
+  }
+
+  void reset(irs::doc_iterator& it);
+
+  virtual const irs::attribute_view& attributes() const NOEXCEPT override {
+    return attrs_;
+  }
+
+  virtual bool next() override {
+    if (next_ >= docs_.size()) {
+      doc_ = irs::type_limits<irs::type_t::doc_id_t>::eof();
+      return false;
+    }
+
+    auto& doc = docs_[next_++];
+
+    doc_ = doc.value;
+    freq_.value = doc.freq;
+    static_cast<pos_iterator*>(pos_.get())->reset(doc.begin, doc.end);
+
+    return true;
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    irs::seek(*this, target);
+    return value();
+  }
+
+  virtual irs::doc_id_t value() const override {
+    return doc_;
+  }
+
+ private:
+  struct doc_t {
+    irs::doc_id_t value;
+    uint64_t freq;
+    size_t begin; // first position of the document in 'positions_'
+    size_t end; // past the last position of the document in 'positions_'
+  };
+
+  struct position_t {
+    uint32_t value;
+    uint32_t start; // offset start
+    uint32_t end; // offset end
+    size_t payload_begin; // offset of the payload in 'payloads_'
+    size_t payload_size;
+  };
+
+  class pos_iterator final : public irs::position::impl {
+   public:
+    explicit pos_iterator(const sorting_doc_iterator& owner)
+      : irs::position::impl(2), // offset + payload
+        owner_(owner) {
+    }
+
+    void reset(bool has_offs, bool has_pay) {
+      attrs_.clear();
+
+      if (has_offs) {
+        attrs_.emplace(offs_);
+      }
+
+      if (has_pay) {
+        attrs_.emplace(pay_);
+      }
+    }
+
+    void reset(size_t begin, size_t end) NOEXCEPT {
+      next_ = begin;
+      end_ = end;
+      clear();
+    }
+
+    virtual void clear() override {
+      value_ = irs::position::INVALID;
+      offs_.clear();
+      pay_.clear();
+    }
+
+    virtual uint32_t value() const override {
+      return value_;
+    }
+
+    virtual bool next() override {
+      if (next_ >= end_) {
+        value_ = irs::position::INVALID;
+        return false;
+      }
+
+      auto& pos = owner_.positions_[next_++];
+
+      value_ = pos.value;
+      offs_.start = pos.start;
+      offs_.end = pos.end;
+      pay_.value = irs::bytes_ref(
+        owner_.payloads_.c_str() + pos.payload_begin, pos.payload_size
+      );
+
+      return true;
+    }
+
+   private:
+    const sorting_doc_iterator& owner_;
+    irs::offset offs_;
+    irs::payload pay_;
+    size_t next_{};
+    size_t end_{};
+    uint32_t value_{ irs::position::INVALID };
+  }; // pos_iterator
+
+  irs::attribute_view attrs_;
+  std::vector<doc_t> docs_;
+  std::vector<position_t> positions_;
+  irs::bstring payloads_;
+  irs::frequency freq_;
+  irs::position pos_;
+  irs::doc_id_t doc_{ irs::type_limits<irs::type_t::doc_id_t>::invalid() };
+  size_t next_{}; // next document in 'docs_'
+}; // sorting_doc_iterator
+
+void sorting_doc_iterator::reset(irs::doc_iterator& it) {
+  docs_.clear();
+  positions_.clear();
+  payloads_.clear();
+
+  auto& attrs = it.attributes();
+  auto& freq = attrs.get<irs::frequency>();
+  auto& pos = freq
+    ? attrs.get<irs::position>()
+    : irs::attribute_view::ref<irs::position>::nil;
+  // attribute values are reset once 'it' is exhausted
+  const bool has_freq = bool(freq);
+  const bool has_pos = bool(pos);
+  bool has_offs = false;
+  bool has_pay = false;
+
+  while (it.next()) {
+    const auto begin = positions_.size();
+
+    if (pos) {
+      // position attributes are volatile across segments
+      auto& pos_attrs = pos->attributes();
+      const auto* offs = pos_attrs.get<irs::offset>().get();
+      const auto* pay = pos_attrs.get<irs::payload>().get();
+
+      has_offs |= nullptr != offs;
+      has_pay |= nullptr != pay;
+
+      while (pos->next()) {
+        position_t entry{ pos->value(), 0, 0, payloads_.size(), 0 };
+
+        if (offs) {
+          entry.start = offs->start;
+          entry.end = offs->end;
+        }
+
+        if (pay) {
+          entry.payload_size = pay->value.size();
+          payloads_.append(pay->value.c_str(), pay->value.size());
+        }
+
+        positions_.emplace_back(entry);
+      }
+    }
+
+    docs_.emplace_back(doc_t{
+      it.value(), freq ? freq->value : 0, begin, positions_.size()
+    });
+  }
+
+  std::sort(
+    docs_.begin(), docs_.end(),
+    [](const doc_t& lhs, const doc_t& rhs) { return lhs.value < rhs.value; }
+  );
+
+  attrs_.clear();
+
+  if (has_freq) {
+    attrs_.emplace(freq_);
+  }
+
+  if (has_pos) {
+    static_cast<pos_iterator*>(pos_.get())->reset(has_offs, has_pay);
+    attrs_.emplace(pos_);
+  }
+
+  doc_ = irs::type_limits<irs::type_t::doc_id_t>::invalid();
+  next_ = 0;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @struct compound_iterator
 //////////////////////////////////////////////////////////////////////////////
@@ -315,8 +518,11 @@ class compound_iterator {
 //////////////////////////////////////////////////////////////////////////////
 class compound_term_iterator : public irs::term_iterator {
  public:
-  compound_term_iterator()
+  explicit compound_term_iterator(bool sorted)
     : doc_itr_(std::make_shared<compound_doc_iterator>()) {
+    if (sorted) {
+      sorting_itr_ = std::make_shared<sorting_doc_iterator>();
+    }
   }
 
   void reset(const irs::field_meta& meta) NOEXCEPT {
@@ -355,6 +561,7 @@ class compound_term_iterator : public irs::term_iterator {
   std::vector<size_t> term_iterator_mask_; // valid iterators for current term
   std::vector<term_iterator_t> term_iterators_; // all term iterators
   irs::doc_iterator::ptr doc_itr_;
+  irs::doc_iterator::ptr sorting_itr_; // set if doc_ids are remapped out of order
 }; // compound_term_iterator
 
 void compound_term_iterator::add(
@@ -412,6 +619,12 @@ irs::doc_iterator::ptr compound_term_iterator::postings(const irs::flags& /*feat
     doc_itr.add(term_itr.first->postings(meta().features), *(term_itr.second));
   }
 
+  if (sorting_itr_) {
+    static_cast<sorting_doc_iterator&>(*sorting_itr_).reset(doc_itr);
+
+    return sorting_itr_;
+  }
+
   return doc_itr_;
 }
 
@@ -421,6 +634,10 @@ irs::doc_iterator::ptr compound_term_iterator::postings(const irs::flags& /*feat
 //////////////////////////////////////////////////////////////////////////////
 class compound_field_iterator : public irs::basic_term_reader {
  public:
+  explicit compound_field_iterator(bool sorted)
+    : term_itr_(sorted) {
+  }
+
   void add(const irs::sub_reader& reader, const doc_id_map_t& doc_id_map);
   bool next();
   size_t size() const { return field_iterators_.size(); }
@@ -601,6 +818,120 @@ irs::doc_id_t compute_doc_ids(
   return next_id;
 }
 
+//////////////////////////////////////////////////////////////////////////////
+/// @brief reassigns doc_ids computed by 'compute_doc_ids' in the order of the
+///        values of the 'sort' columns, ties keep the original order
+/// @param reordered [out] doc_ids have been changed
+/// @return success
+//////////////////////////////////////////////////////////////////////////////
+template<typename Readers>
+bool sort_doc_ids(
+    Readers& readers,
+    const irs::sort_columns& sort,
+    bool& reordered) {
+  typedef std::pair<size_t, size_t> value_t; // offset + size in 'data'
+  static const size_t NO_VALUE = irs::integer_traits<size_t>::const_max;
+  const auto min = irs::type_limits<irs::type_t::doc_id_t>::min();
+  const size_t columns = sort.size();
+  std::vector<irs::doc_id_t*> docs; // 'doc_id_map' entries of live documents
+  std::vector<value_t> values; // 'columns' values per live document
+  irs::bstring data;
+
+  for (auto& entry : readers) {
+    auto& reader = *entry.first;
+    auto& doc_id_map = entry.second;
+
+    for (auto& doc : doc_id_map) {
+      if (MASKED_DOC_ID != doc) {
+        // 'doc' is sequential among live documents of all readers
+        assert(doc - min == docs.size());
+        docs.emplace_back(&doc);
+      }
+    }
+
+    values.resize(docs.size() * columns, value_t(NO_VALUE, 0));
+
+    for (size_t i = 0; i < columns; ++i) {
+      const auto* column = reader.column_reader(sort[i].name);
+
+      if (!column) {
+        continue; // no values in the segment
+      }
+
+      auto visitor = [&](irs::doc_id_t doc, const irs::bytes_ref& in) {
+        const auto mapped_doc = doc < doc_id_map.size()
+          ? doc_id_map[doc]
+          : MASKED_DOC_ID;
+
+        if (MASKED_DOC_ID != mapped_doc) {
+          values[(mapped_doc - min) * columns + i] = value_t(data.size(), in.size());
+          data.append(in.c_str(), in.size());
+        }
+
+        return true;
+      };
+
+      if (!column->visit(visitor)) {
+        IR_FRMT_ERROR(
+          "Failed to read values of sort column '%s' in merge_writer",
+          sort[i].name.c_str()
+        );
+        return false;
+      }
+    }
+  }
+
+  auto less = [&](size_t lhs, size_t rhs)->bool {
+    for (size_t i = 0; i < columns; ++i) {
+      auto& lhs_value = values[lhs * columns + i];
+      auto& rhs_value = values[rhs * columns + i];
+
+      if (NO_VALUE == lhs_value.first || NO_VALUE == rhs_value.first) {
+        if (lhs_value.first == rhs_value.first) {
+          continue; // both missing
+        }
+
+        return NO_VALUE == rhs_value.first; // missing values go last
+      }
+
+      const irs::bytes_ref lhs_ref(data.c_str() + lhs_value.first, lhs_value.second);
+      const irs::bytes_ref rhs_ref(data.c_str() + rhs_value.first, rhs_value.second);
+      auto& column_less = sort[i].less;
+
+      if (column_less) {
+        if (column_less(lhs_ref, rhs_ref)) {
+          return true;
+        }
+
+        if (column_less(rhs_ref, lhs_ref)) {
+          return false;
+        }
+      } else {
+        const auto res = compare(lhs_ref, rhs_ref);
+
+        if (res) {
+          return res < 0;
+        }
+      }
+    }
+
+    return false;
+  };
+
+  std::vector<size_t> order(docs.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), less);
+
+  reordered = false;
+
+  for (size_t i = 0, count = order.size(); i < count; ++i) {
+    reordered |= order[i] != i;
+    *docs[order[i]] = min + i;
+  }
+
+  return true;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 /// @brief computes fields_type and fields_count
 //////////////////////////////////////////////////////////////////////////////
@@ -636,7 +967,8 @@ bool compute_field_meta(
 //////////////////////////////////////////////////////////////////////////////
 class columnstore {
  public:
-  columnstore(irs::directory& dir, const irs::segment_meta& meta) {
+  columnstore(irs::directory& dir, const irs::segment_meta& meta, bool sorted)
+    : sorted_(sorted) {
     auto writer = meta.codec->get_columnstore_writer();
 
     if (!writer->prepare(dir, meta)) {
@@ -668,6 +1000,13 @@ class columnstore {
 
         empty_ = false;
 
+        if (sorted_) {
+          // doc_ids arrive out of order, defer writing until column is complete
+          buffered_.emplace_back(value_t{ mapped_doc, buffer_.size(), in.size() });
+          buffer_.append(in.c_str(), in.size());
+          return true;
+        }
+
         auto& out = column_.second(mapped_doc);
         out.write_bytes(in.c_str(), in.size());
         return true;
@@ -675,6 +1014,8 @@ class columnstore {
   }
 
   void reset() {
+    write_buffered();
+
     if (!empty_) {
       column_ = writer_->push_column();
       empty_ = true;
@@ -690,14 +1031,46 @@ class columnstore {
   bool empty() const { return empty_; }
 
   // @return was anything actually flushed
-  bool flush() { return writer_->flush(); }
+  bool flush() {
+    write_buffered();
+    return writer_->flush();
+  }
 
   // returns current column identifier
   irs::field_id id() const { return column_.first; }
 
  private:
+  struct value_t {
+    irs::doc_id_t doc;
+    size_t offset; // offset of the value in 'buffer_'
+    size_t size;
+  };
+
+  // writes values buffered for the current column in order of doc_ids
+  void write_buffered() {
+    if (buffered_.empty()) {
+      return;
+    }
+
+    std::sort(
+      buffered_.begin(), buffered_.end(),
+      [](const value_t& lhs, const value_t& rhs) { return lhs.doc < rhs.doc; }
+    );
+
+    for (auto& value : buffered_) {
+      auto& out = column_.second(value.doc);
+      out.write_bytes(buffer_.c_str() + value.offset, value.size);
+    }
+
+    buffered_.clear();
+    buffer_.clear();
+  }
+
   irs::columnstore_writer::ptr writer_;
   irs::columnstore_writer::column_t column_{};
+  std::vector<value_t> buffered_; // values of the current column (sorted only)
+  irs::bstring buffer_;
+  bool sorted_;
   bool empty_{ false };
 }; // columnstore
 
@@ -807,8 +1180,12 @@ NS_END // LOCAL
 
 NS_ROOT
 
-merge_writer::merge_writer(directory& dir, const string_ref& name) NOEXCEPT
-  : dir_(dir), name_(name) {
+merge_writer::merge_writer(
+    directory& dir,
+    const string_ref& name,
+    const sort_columns* sort /*= nullptr*/
+) NOEXCEPT
+  : dir_(dir), name_(name), sort_(sort) {
 }
 
 void merge_writer::add(const sub_reader& reader) {
@@ -821,13 +1198,14 @@ bool merge_writer::flush(std::string& filename, segment_meta& meta) {
   typedef std::pair<const irs::sub_reader*, doc_id_map_t> reader_t;
 
   std::unordered_map<irs::string_ref, const irs::field_meta*> field_metas;
-  compound_field_iterator fields_itr;
-  compound_column_iterator_t columns_itr;
   irs::flags fields_features;
   doc_id_t next_id = type_limits<type_t::doc_id_t>::min(); // next valid doc_id
   std::deque<reader_t> readers; // a container that does not copy when growing (iterators store pointers)
+  bool reordered = false;
 
-  // collect field meta and field term data
+  doc_id_maps_.clear();
+
+  // collect field meta and compute doc_id maps
   for (auto& reader: readers_) {
     readers.emplace_back(reader, doc_id_map_t());
 
@@ -842,9 +1220,19 @@ bool merge_writer::flush(std::string& filename, segment_meta& meta) {
     if (!irs::type_limits<irs::type_t::doc_id_t>::valid(next_id)) {
       return false; // failed to compute next doc_id
     }
+  }
 
-    fields_itr.add(*reader, doc_id_map);
-    columns_itr.add(*reader, doc_id_map);
+  if (sort_ && !sort_->empty() && !sort_doc_ids(readers, *sort_, reordered)) {
+    return false; // failed to sort doc_ids
+  }
+
+  compound_field_iterator fields_itr(reordered);
+  compound_column_iterator_t columns_itr;
+
+  // collect field term data
+  for (auto& reader: readers) {
+    fields_itr.add(*reader.first, reader.second);
+    columns_itr.add(*reader.first, reader.second);
   }
 
   meta.docs_count = next_id - type_limits<type_t::doc_id_t>::min(); // total number of doc_ids
@@ -854,7 +1242,7 @@ bool merge_writer::flush(std::string& filename, segment_meta& meta) {
   //...........................................................................
 
   tracking_directory track_dir(dir_); // track writer created files
-  columnstore cs(track_dir, meta);
+  columnstore cs(track_dir, meta, reordered);
 
   if (!cs) {
     return false; // flush failure
@@ -888,6 +1276,12 @@ bool merge_writer::flush(std::string& filename, segment_meta& meta) {
   // ...........................................................................
   // finish/cleanup
   // ...........................................................................
+  if (reordered) {
+    for (auto& reader: readers) {
+      doc_id_maps_.emplace_back(std::move(reader.second));
+    }
+  }
+
   readers_.clear();
 
   return true;
@@ -24,8 +24,10 @@
 #ifndef IRESEARCH_MERGE_WRITER_H
 #define IRESEARCH_MERGE_WRITER_H
 
+#include <functional>
 #include <vector>
 
+#include "types.hpp"
 #include "utils/memory.hpp"
 #include "utils/noncopyable.hpp"
 #include "utils/string.hpp"
@@ -38,18 +40,57 @@ typedef std::shared_ptr<format> format_ptr;
 struct segment_meta;
 struct sub_reader;
 
+////////////////////////////////////////////////////////////////////////////////
+/// @struct sort_column
+/// @brief a stored column the documents of a segment are ordered by,
+///        documents without a value in the column are placed last
+////////////////////////////////////////////////////////////////////////////////
+struct sort_column {
+  typedef std::function<bool(const bytes_ref& lhs, const bytes_ref& rhs)> less_f;
+
+  sort_column(const string_ref& name, const less_f& less = less_f())
+    : name(name), less(less) {
+  }
+
+  std::string name;
+  less_f less; // byte-wise ascending order of column values if not set
+}; // sort_column
+
+typedef std::vector<sort_column> sort_columns;
+
 class IRESEARCH_API merge_writer: public util::noncopyable {
  public:
   DECLARE_PTR(merge_writer);
-  merge_writer(directory& dir, const string_ref& seg_name) NOEXCEPT;
+
+  // mapping of reader doc_ids to merged segment doc_ids (masked doc_ids: eof)
+  typedef std::vector<doc_id_t> doc_id_map_t;
+
+  merge_writer(
+    directory& dir,
+    const string_ref& seg_name,
+    const sort_columns* sort = nullptr
+  ) NOEXCEPT;
   void add(const sub_reader& reader);
   bool flush(std::string& filename, segment_meta& meta); // return merge successful
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @return doc_id mapping of the 'i'th added reader, available only after a
+  ///         successful flush() of a segment that was reordered by 'sort'
+  //////////////////////////////////////////////////////////////////////////////
+  const doc_id_map_t& doc_id_map(size_t i) const { return doc_id_maps_[i]; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @return the documents of the last flushed segment were reordered by 'sort'
+  //////////////////////////////////////////////////////////////////////////////
+  bool sorted() const NOEXCEPT { return !doc_id_maps_.empty(); }
+
  private:
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
   directory& dir_;
   string_ref name_;
+  const sort_columns* sort_;
   std::vector<const iresearch::sub_reader*> readers_;
+  std::vector<doc_id_map_t> doc_id_maps_;
   IRESEARCH_API_PRIVATE_VARIABLES_END
 };
 
@@ -21,11 +21,106 @@
 /// @author Vasiliy Nabatchikov
 ////////////////////////////////////////////////////////////////////////////////
 
-#include "utils/map_utils.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "postings.hpp"
 
+#include <algorithm>
+#include <cstring>
+
+NS_LOCAL
+
+using namespace irs;
+
+const size_t MIN_CAPACITY = 32; // initial number of slots
+const size_t RADIX_THRESHOLD = 32; // sort smaller ranges by comparison
+
+typedef const postings::value_type* term_t;
+
+// compares the terms starting at 'depth', the preceding bytes are equal
+inline bool less_from(term_t lhs, term_t rhs, size_t depth) {
+  const auto& lhs_term = lhs->first;
+  const auto& rhs_term = rhs->first;
+  const auto lhs_size = lhs_term.size() - depth;
+  const auto rhs_size = rhs_term.size() - depth;
+  const auto res = std::memcmp(
+    lhs_term.c_str() + depth, rhs_term.c_str() + depth,
+    std::min(lhs_size, rhs_size)
+  );
+
+  return res ? res < 0 : lhs_size < rhs_size;
+}
+
+// sorts the terms of [begin, end) sharing the first 'depth' bytes,
+// 'buf' must have at least 'end - begin' elements
+void radix_sort(term_t* begin, term_t* end, term_t* buf, size_t depth) {
+  for (;;) {
+    const size_t size = std::distance(begin, end);
+
+    if (size < RADIX_THRESHOLD) {
+      std::sort(begin, end, [depth](term_t lhs, term_t rhs) {
+        return less_from(lhs, rhs, depth);
+      });
+      return;
+    }
+
+    // bucket 0 is the term ending at 'depth' (at most one, the terms are
+    // unique), bucket 'b + 1' are the terms with the byte 'b' at 'depth'
+    size_t offsets[257 + 1]{};
+
+    for (auto* it = begin; it != end; ++it) {
+      const auto& term = (*it)->first;
+      ++offsets[1 + (term.size() > depth ? 1 + term[depth] : 0)];
+    }
+
+    // common prefix, nothing to distribute
+    if (offsets[1 + 0] == 0) {
+      const auto* max = std::max_element(offsets + 2, offsets + 258);
+
+      if (*max == size) {
+        ++depth;
+        continue;
+      }
+    }
+
+    for (size_t i = 1; i < 258; ++i) {
+      offsets[i] += offsets[i - 1];
+    }
+
+    size_t positions[257];
+    std::memcpy(positions, offsets, sizeof positions);
+
+    for (auto* it = begin; it != end; ++it) {
+      const auto& term = (*it)->first;
+      buf[positions[term.size() > depth ? 1 + term[depth] : 0]++] = *it;
+    }
+
+    std::copy(buf, buf + size, begin);
+
+    // sort the buckets by the following bytes, the largest bucket is sorted
+    // by the loop so the recursion depth is logarithmic
+    size_t largest = 1;
+
+    for (size_t i = 2; i < 257; ++i) {
+      if (offsets[i + 1] - offsets[i] > offsets[largest + 1] - offsets[largest]) {
+        largest = i;
+      }
+    }
+
+    for (size_t i = 1; i < 257; ++i) {
+      if (i != largest && offsets[i + 1] - offsets[i] > 1) {
+        radix_sort(begin + offsets[i], begin + offsets[i + 1], buf, depth + 1);
+      }
+    }
+
+    end = begin + offsets[largest + 1];
+    begin += offsets[largest];
+    ++depth;
+  }
+}
+
+NS_END // LOCAL
+
 NS_ROOT
 
 // -----------------------------------------------------------------------------
@@ -36,6 +131,30 @@ postings::postings(writer_t& writer):
   writer_(writer) {
 }
 
+void postings::clear() {
+  entries_.clear();
+  std::fill(slots_.begin(), slots_.end(), slot{ 0, 0 });
+}
+
+void postings::rehash(size_t capacity) {
+  assert(capacity && 0 == (capacity & (capacity - 1))); // power of 2
+  std::vector<slot> slots(capacity, slot{ 0, 0 });
+  const size_t mask = capacity - 1;
+
+  for (size_t i = 0, size = entries_.size(); i < size; ++i) {
+    const auto hash = entries_[i].first.hash();
+    auto pos = hash & mask;
+
+    while (slots[pos].id) {
+      pos = (pos + 1) & mask;
+    }
+
+    slots[pos] = slot{ uint32_t(i + 1), uint32_t(hash) };
+  }
+
+  slots_.swap(slots);
+}
+
 postings::emplace_result postings::emplace(const bytes_ref& term) {
   REGISTER_TIMER_DETAILED();
   auto& parent = writer_.parent();
@@ -46,7 +165,24 @@ postings::emplace_result postings::emplace(const bytes_ref& term) {
   if (writer_t::container::block_type::SIZE < max_term_len) {
     // TODO: maybe move big terms it to a separate storage
     // reject terms that do not fit in a block
-    return std::make_pair(map_.end(), false);
+    return std::make_pair(entries_.end(), false);
+  }
+
+  // keep the load factor below 1/2
+  if (2 * (entries_.size() + 1) > slots_.size()) {
+    rehash((std::max)(MIN_CAPACITY, 2 * slots_.size()));
+  }
+
+  const size_t hash = std::hash<irs::bytes_ref>()(term);
+  const size_t mask = slots_.size() - 1;
+  auto pos = hash & mask;
+
+  for (; slots_[pos].id; pos = (pos + 1) & mask) {
+    const auto& slot = slots_[pos];
+
+    if (slot.hash == uint32_t(hash) && entries_[slot.id - 1].first == term) {
+      return std::make_pair(entries_.begin() + (slot.id - 1), false);
+    }
   }
 
   const auto slice_end = writer_.pool_offset() + max_term_len;
@@ -60,25 +196,35 @@ postings::emplace_result postings::emplace(const bytes_ref& term) {
   }
 
   assert(size() < type_limits<type_t::doc_id_t>::eof()); // not larger then the static flag
+  assert(size() < integer_traits<uint32_t>::const_max); // fits the slot
 
-  auto generator = [&term, this](const hashed_bytes_ref& key, const posting&) {
-    // for new terms also write out their value
-    writer_.write(term.c_str(), term.size());
-
-    // reuse hash but point ref at data in pool
-    return hashed_bytes_ref(
-      key.hash(),
-      (writer_.position() - term.size()).buffer(), term.size()
-    );
-  };
-
-  // replace original reference to 'term' provided by the caller
-  // with a reference to the cached copy in 'writer_'
-  return map_utils::try_emplace_update_key(
-    map_,                                     // container
-    generator,                                // key generator
-    make_hashed_ref(term, std::hash<irs::bytes_ref>()) // key
+  // new terms are written out to the pool, the entry points at the copy
+  writer_.write(term.c_str(), term.size());
+
+  entries_.emplace_back(
+    std::piecewise_construct,
+    std::forward_as_tuple(
+      hash, (writer_.position() - term.size()).buffer(), term.size()
+    ),
+    std::forward_as_tuple()
   );
+  slots_[pos] = slot{ uint32_t(entries_.size()), uint32_t(hash) };
+
+  return std::make_pair(entries_.end() - 1, true);
+}
+
+void postings::sort(std::vector<const value_type*>& terms) const {
+  REGISTER_TIMER_DETAILED();
+  terms.resize(entries_.size());
+
+  for (size_t i = 0, size = entries_.size(); i < size; ++i) {
+    terms[i] = &entries_[i];
+  }
+
+  if (!terms.empty()) {
+    std::vector<const value_type*> buf(terms.size());
+    radix_sort(&terms[0], &terms[0] + terms.size(), &buf[0], 0);
+  }
 }
 
 NS_END
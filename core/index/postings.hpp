@@ -24,7 +24,7 @@
 #ifndef IRESEARCH_POSTINGS_H
 #define IRESEARCH_POSTINGS_H
 
-#include <unordered_map>
+#include <vector>
 
 #include "shared.hpp"
 #include "utils/block_pool.hpp"
@@ -52,30 +52,59 @@ struct posting {
   uint32_t offs = 0;
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class postings
+/// @brief in-memory term dictionary of a field, the terms are stored in
+///        the byte pool, the term entries are kept contiguously in the order
+///        of insertion and are looked up via an open-addressing hash table
+///        of term identifiers, i.e. there are no per-term heap allocations
+////////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API postings: util::noncopyable {
  public:
-  typedef std::unordered_map<hashed_bytes_ref, posting> map_t;
-  typedef std::pair<map_t::iterator, bool> emplace_result;
+  typedef std::pair<hashed_bytes_ref, posting> value_type;
+  typedef std::vector<value_type> entries_t;
+  typedef entries_t::iterator iterator;
+  typedef entries_t::const_iterator const_iterator;
+  typedef std::pair<iterator, bool> emplace_result;
   typedef byte_block_pool::inserter writer_t;
 
   postings(writer_t& writer);
 
-  inline map_t::const_iterator begin() const { return map_.begin(); }
+  inline const_iterator begin() const { return entries_.begin(); }
 
-  inline void clear() { map_.clear(); }
+  void clear();
 
   // on error returns std::ptr(end(), false)
   emplace_result emplace(const bytes_ref& term);
 
-  inline bool empty() const { return map_.empty(); }
+  inline bool empty() const { return entries_.empty(); }
+
+  inline iterator end() { return entries_.end(); }
+  inline const_iterator end() const { return entries_.end(); }
 
-  inline map_t::const_iterator end() const { return map_.end(); }
+  inline size_t size() const { return entries_.size(); }
 
-  inline size_t size() const { return map_.size(); }
+  // returns number of bytes occupied by the entries and the lookup table
+  inline size_t memory() const NOEXCEPT {
+    return entries_.size() * sizeof(value_type) + slots_.size() * sizeof(slot);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief fills 'terms' with the entries ordered by term (MSD radix sort)
+  //////////////////////////////////////////////////////////////////////////////
+  void sort(std::vector<const value_type*>& terms) const;
 
  private:
+  struct slot {
+    uint32_t id; // position of the entry + 1, 0 == empty slot
+    uint32_t hash; // low bits of the term hash
+  };
+
+  void rehash(size_t capacity);
+
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
-  map_t map_;
+  entries_t entries_;
+  std::vector<slot> slots_; // size is a power of 2
   writer_t& writer_;
   IRESEARCH_API_PRIVATE_VARIABLES_END
 };
@@ -26,11 +26,14 @@
 
 #include "index/index_meta.hpp"
 
+#include "analysis/token_attributes.hpp"
 #include "formats/format_utils.hpp"
+#include "store/directory_attributes.hpp"
 #include "utils/index_utils.hpp"
 #include "utils/singleton.hpp"
 #include "utils/type_limits.hpp"
 
+#include <mutex>
 #include <unordered_map>
 
 NS_LOCAL
@@ -65,25 +68,13 @@ class mask_doc_iterator final : public irs::doc_iterator {
   }
 
   virtual bool next() override {
-    while (it_->next()) {
-      if (mask_.find(value()) == mask_.end()) {
-        return true;
-      }
-    }
-
-    return false;
+    return it_->next()
+      && !irs::type_limits<irs::type_t::doc_id_t>::eof(skip(it_->value()));
   }
 
   virtual irs::doc_id_t seek(irs::doc_id_t target) override {
-    const auto doc = it_->seek(target);
-
-    if (mask_.find(doc) == mask_.end()) {
-      return doc;
-    }
-
-    next();
-
-    return value();
+    // documents in [target, next_live(target)) are masked
+    return skip(it_->seek(mask_.next_live(target)));
   }
 
   virtual irs::doc_id_t value() const override {
@@ -95,6 +86,16 @@ class mask_doc_iterator final : public irs::doc_iterator {
   }
 
  private:
+  // skips whole words of masked documents, seeks the underlying iterator
+  // to the first live document instead of visiting every masked one
+  irs::doc_id_t skip(irs::doc_id_t doc) {
+    for (auto live = mask_.next_live(doc); live != doc; live = mask_.next_live(doc)) {
+      doc = it_->seek(live);
+    }
+
+    return doc;
+  }
+
   const irs::document_mask& mask_; // excluded document ids
   irs::doc_iterator::ptr it_;
 }; // mask_doc_iterator
@@ -117,14 +118,16 @@ class masked_docs_iterator
   virtual ~masked_docs_iterator() {}
 
   virtual bool next() override {
-    while (next_ < end_) {
+    // skip whole words of masked documents at once
+    next_ = docs_mask_.next_live(next_);
+
+    if (next_ < end_) {
       current_ = next_++;
 
-      if (docs_mask_.find(current_) == docs_mask_.end()) {
-        return true;
-      }
+      return true;
     }
 
+    next_ = end_;
     current_ = iresearch::type_limits<iresearch::type_t::doc_id_t>::eof();
 
     return false;
@@ -258,6 +261,8 @@ class segment_reader_impl : public sub_reader {
     field_id field
   ) const override;
 
+  virtual const byte_type* norms(field_id field) const override;
+
  private:
   DECLARE_SPTR(segment_reader_impl); // required for NAMED_PTR(...)
   std::vector<column_meta> columns_;
@@ -269,6 +274,11 @@ class segment_reader_impl : public sub_reader {
   std::vector<column_meta*> id_to_column_;
   uint64_t meta_version_;
   std::unordered_map<hashed_string_ref, column_meta*> name_to_column_;
+  struct norms_entry {
+    std::once_flag loaded;
+    std::vector<byte_type> values; // empty if the column has no quantized norms
+  };
+  std::unique_ptr<norms_entry[]> norms_; // per column, loaded on demand
 
   segment_reader_impl(
     const directory& dir,
@@ -277,6 +287,96 @@ class segment_reader_impl : public sub_reader {
   );
 };
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief segment reader with a document mask kept in memory, e.g. one not
+///        yet written to the directory, shares the data of the wrapped reader
+////////////////////////////////////////////////////////////////////////////////
+class masked_segment_reader_impl : public sub_reader {
+ public:
+  DECLARE_SPTR(masked_segment_reader_impl); // required for NAMED_PTR(...)
+
+  masked_segment_reader_impl(
+      const segment_reader& reader,
+      document_mask&& docs_mask)
+    : docs_mask_(std::move(docs_mask)),
+      reader_(reader) {
+  }
+
+  const segment_reader& reader() const NOEXCEPT {
+    return reader_;
+  }
+
+  virtual index_reader::reader_iterator begin() const override {
+    return index_reader::reader_iterator(new iterator_impl(this));
+  }
+
+  virtual index_reader::reader_iterator end() const override {
+    return index_reader::reader_iterator(new iterator_impl());
+  }
+
+  virtual const column_meta* column(const string_ref& name) const override {
+    return reader_.column(name);
+  }
+
+  virtual column_iterator::ptr columns() const override {
+    return reader_.columns();
+  }
+
+  using sub_reader::docs_count;
+  virtual uint64_t docs_count() const override {
+    return reader_.docs_count();
+  }
+
+  virtual docs_iterator_t::ptr docs_iterator() const override {
+    // the implementation generates doc_ids sequentially
+    return memory::make_unique<masked_docs_iterator>(
+      type_limits<type_t::doc_id_t>::min(),
+      doc_id_t(type_limits<type_t::doc_id_t>::min() + reader_.docs_count()),
+      docs_mask_
+    );
+  }
+
+  virtual doc_iterator::ptr mask(doc_iterator::ptr&& it) const override {
+    if (docs_mask_.empty()) {
+      return std::move(it);
+    }
+
+    return doc_iterator::make<mask_doc_iterator>(
+      std::move(it), docs_mask_
+    );
+  }
+
+  virtual const term_reader* field(const string_ref& name) const override {
+    return reader_.field(name);
+  }
+
+  virtual field_iterator::ptr fields() const override {
+    return reader_.fields();
+  }
+
+  virtual uint64_t live_docs_count() const NOEXCEPT override {
+    return reader_.docs_count() - docs_mask_.size();
+  }
+
+  virtual size_t size() const NOEXCEPT override {
+    return 1; // only 1 segment
+  }
+
+  using sub_reader::column_reader;
+  virtual const columnstore_reader::column_reader* column_reader(
+      field_id field) const override {
+    return reader_.column_reader(field);
+  }
+
+  virtual const byte_type* norms(field_id field) const override {
+    return reader_.norms(field);
+  }
+
+ private:
+  document_mask docs_mask_;
+  segment_reader reader_; // unmasked reader
+}; // masked_segment_reader_impl
+
 segment_reader::segment_reader(impl_ptr&& impl) NOEXCEPT
   : impl_(std::move(impl)) {
 }
@@ -319,9 +419,29 @@ template<>
   return segment_reader_impl::open(dir, meta);
 }
 
+segment_reader segment_reader::masked(document_mask&& docs_mask) const {
+  // make a copy
+  impl_ptr impl = atomic_utils::atomic_load(&impl_);
+  auto* masked_impl = dynamic_cast<masked_segment_reader_impl*>(impl.get());
+
+  PTR_NAMED(
+    masked_segment_reader_impl,
+    reader,
+    masked_impl ? masked_impl->reader() : segment_reader(std::move(impl)),
+    std::move(docs_mask)
+  );
+
+  return segment_reader(std::move(reader));
+}
+
 segment_reader segment_reader::reopen(const segment_meta& meta) const {
   // make a copy
   impl_ptr impl = atomic_utils::atomic_load(&impl_);
+  auto* masked_impl = dynamic_cast<masked_segment_reader_impl*>(impl.get());
+
+  if (masked_impl) {
+    return masked_impl->reader().reopen(meta); // in-memory mask is dropped
+  }
 
 #ifdef IRESEARCH_DEBUG
   auto& reader_impl = dynamic_cast<segment_reader_impl&>(*impl);
@@ -393,6 +513,12 @@ sub_reader::docs_iterator_t::ptr segment_reader_impl::docs_iterator() const {
 
 /*static*/ sub_reader::ptr segment_reader_impl::open(
     const directory& dir, const segment_meta& meta) {
+  auto& verification = dir.attributes().get<checksum_verification>();
+
+  if (verification) {
+    format_utils::check_checksums(dir, meta, verification->pool);
+  }
+
   PTR_NAMED(segment_reader_impl, reader, dir, meta.version, meta.docs_count);
 
   index_utils::read_document_mask(reader->docs_mask_, dir, meta);
@@ -413,6 +539,9 @@ sub_reader::docs_iterator_t::ptr segment_reader_impl::docs_iterator() const {
   if (segment_reader::has<irs::columnstore_reader>(meta)
       && columnstore_reader->prepare(dir, meta)) {
     reader->columnstore_reader_ = std::move(columnstore_reader);
+    reader->norms_.reset(
+      new norms_entry[reader->columnstore_reader_->size()]
+    );
   }
 
   // initialize columns meta
@@ -435,4 +564,23 @@ const columnstore_reader::column_reader* segment_reader_impl::column_reader(
     : nullptr;
 }
 
+const byte_type* segment_reader_impl::norms(field_id field) const {
+  if (!columnstore_reader_ || field >= columnstore_reader_->size()) {
+    return nullptr;
+  }
+
+  // the norms are read once per segment and shared by all queries
+  auto& entry = norms_[field];
+
+  std::call_once(entry.loaded, [this, field, &entry]()->void {
+    auto* column = column_reader(field);
+
+    if (column) {
+      norm::read_dense(*column, docs_count_, entry.values);
+    }
+  });
+
+  return entry.values.empty() ? nullptr : entry.values.data();
+}
+
 NS_END
@@ -51,6 +51,18 @@ class IRESEARCH_API segment_reader final
 
   explicit operator bool() const NOEXCEPT { return bool(impl_); }
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// @return readers share the same segment data and documents mask, e.g.
+  ///         a reader and its reopen(...) for an unchanged segment
+  ////////////////////////////////////////////////////////////////////////////
+  bool operator==(const segment_reader& rhs) const NOEXCEPT {
+    return impl_ == rhs.impl_;
+  }
+
+  bool operator!=(const segment_reader& rhs) const NOEXCEPT {
+    return !(*this == rhs);
+  }
+
   segment_reader& operator*() NOEXCEPT { return *this; }
   const segment_reader& operator*() const NOEXCEPT { return *this; }
   segment_reader* operator->() NOEXCEPT { return this; }
@@ -96,6 +108,13 @@ class IRESEARCH_API segment_reader final
     return impl_->live_docs_count();
   }
 
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief returns a reader over the same segment data but with 'docs_mask'
+  ///        masking documents instead of the mask read from the directory
+  /// @note reopen(...) of the returned reader drops the in-memory mask
+  ////////////////////////////////////////////////////////////////////////////
+  segment_reader masked(document_mask&& docs_mask) const;
+
   segment_reader reopen(const segment_meta& meta) const;
 
   void reset() NOEXCEPT {
@@ -112,6 +131,10 @@ class IRESEARCH_API segment_reader final
     return impl_->column_reader(field);
   }
 
+  virtual const byte_type* norms(field_id field) const override {
+    return impl_->norms(field);
+  }
+
  private:
   typedef std::shared_ptr<sub_reader> impl_ptr;
 
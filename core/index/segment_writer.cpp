@@ -25,10 +25,12 @@
 #include "segment_writer.hpp"
 #include "store/store_utils.hpp"
 #include "index_meta.hpp"
+#include "segment_reader.hpp"
 #include "analysis/token_stream.hpp"
 #include "analysis/token_attributes.hpp"
 #include "utils/log.hpp"
 #include "utils/map_utils.hpp"
+#include "utils/misc.hpp"
 #include "utils/timer_utils.hpp"
 #include "utils/type_limits.hpp"
 #include "utils/version_utils.hpp"
@@ -36,6 +38,15 @@
 #include <math.h>
 #include <set>
 
+NS_LOCAL
+
+// name of the segment holding documents in order of insertion until reordered
+std::string unsorted_segment_name(const std::string& name) {
+  return name + "_unsorted";
+}
+
+NS_END
+
 NS_ROOT
 
 segment_writer::column::column(
@@ -45,19 +56,28 @@ segment_writer::column::column(
   this->handle = columnstore.push_column();
 }
 
-segment_writer::ptr segment_writer::make(directory& dir) {
-  PTR_NAMED(segment_writer, ptr, dir);
+segment_writer::ptr segment_writer::make(
+    directory& dir,
+    norm_encoding encoding /*= norm_encoding::FLOAT*/,
+    const sort_columns* sort /*= nullptr*/) {
+  PTR_NAMED(segment_writer, ptr, dir, encoding, sort);
   return ptr;
 }
 
-segment_writer::segment_writer(directory& dir) NOEXCEPT
-  : dir_(dir), initialized_(false) {
+segment_writer::segment_writer(
+    directory& dir,
+    norm_encoding encoding,
+    const sort_columns* sort) NOEXCEPT
+  : dir_(dir),
+    norm_encoding_(encoding),
+    sort_(sort && !sort->empty() ? sort : nullptr),
+    initialized_(false) {
 }
 
 // expect 0-based doc_id
 bool segment_writer::remove(doc_id_t doc_id) {
   return doc_id < docs_cached()
-    && docs_mask_.insert(type_limits<type_t::doc_id_t>::min() + doc_id).second;
+    && docs_mask_.insert(type_limits<type_t::doc_id_t>::min() + doc_id);
 }
 
 bool segment_writer::index(
@@ -111,11 +131,18 @@ void segment_writer::finish() {
 
   // write document normalization factors (for each field marked for normalization))
   float_t value;
+  byte_type code;
   for (auto* field : norm_fields_) {
     value = field->boost() / float_t(std::sqrt(double_t(field->size())));
     if (value != norm::DEFAULT()) {
       auto& stream = field->norms(*col_writer_);
-      write_zvfloat(stream, value);
+
+      if (norm_encoding::BYTE == norm_encoding_ && norm::encode(value, code)) {
+        stream.write_byte(code);
+      } else {
+        // values out of the quantized range are stored as is
+        write_zvfloat(stream, value);
+      }
     }
   }
 }
@@ -123,8 +150,95 @@ void segment_writer::finish() {
 bool segment_writer::flush(std::string& filename, segment_meta& meta) {
   REGISTER_TIMER_DETAILED();
 
-  // flush columnstore and columns indices
-  if (col_writer_->flush() && !columns_.empty()) {
+  try {
+    return sort_
+      ? flush_sorted(filename, meta)
+      : flush_segment(filename, meta);
+  } catch (...) {
+    // codec writers may be left in the middle of a segment,
+    // fresh ones are created by the next reset(...)
+    field_writer_.reset();
+    col_meta_writer_.reset();
+    col_writer_.reset();
+    throw;
+  }
+}
+
+bool segment_writer::flush_sorted(std::string& filename, segment_meta& meta) {
+  REGISTER_TIMER_DETAILED();
+
+  segment_meta unsorted(unsorted_segment_name(seg_name_), meta.codec);
+  std::string unsorted_filename;
+
+  // remove the intermediate segment regardless of the outcome
+  auto cleanup = make_finally([this, &unsorted, &unsorted_filename]()->void {
+    for (auto& file : unsorted.files) {
+      dir_.remove(file);
+    }
+
+    if (!unsorted_filename.empty()) {
+      dir_.remove(unsorted_filename);
+    }
+  });
+
+  return flush_segment(unsorted_filename, unsorted)
+    && sort_segment(unsorted, filename, meta);
+}
+
+bool segment_writer::sort_segment(
+    const segment_meta& unsorted,
+    std::string& filename,
+    segment_meta& meta) {
+  REGISTER_TIMER_DETAILED();
+  auto reader = segment_reader::open(dir_, unsorted);
+
+  if (!reader) {
+    IR_FRMT_ERROR("Failed to open unsorted segment '%s' in: %s", unsorted.name.c_str(), __FUNCTION__);
+
+    return false;
+  }
+
+  merge_writer merger(dir_, meta.name, sort_);
+
+  merger.add(*reader);
+
+  if (!merger.flush(filename, meta)) {
+    return false;
+  }
+
+  if (!merger.sorted()) {
+    return true; // documents already were in sort order
+  }
+
+  // remap per-document state to the new doc_ids
+  const auto& doc_id_map = merger.doc_id_map(0);
+  const auto min = type_limits<type_t::doc_id_t>::min();
+  update_contexts docs_context(docs_context_.size());
+  document_mask docs_mask;
+
+  for (size_t i = 0, count = docs_context_.size(); i < count; ++i) {
+    const auto doc = doc_id_map[min + i];
+
+    assert(!type_limits<type_t::doc_id_t>::eof(doc)); // unsorted segment has no mask
+    docs_context[doc - min] = docs_context_[i];
+
+    if (docs_mask_.contains(min + i)) {
+      docs_mask.insert(doc);
+    }
+  }
+
+  docs_context_ = std::move(docs_context);
+  docs_mask_ = std::move(docs_mask);
+
+  return true;
+}
+
+bool segment_writer::flush_segment(std::string& filename, segment_meta& meta) {
+  REGISTER_TIMER_DETAILED();
+
+  // flush columnstore and columns indices,
+  // the columnstore may contain the norms only
+  if (col_writer_->flush()) {
     static struct less_t {
       bool operator()(const column* lhs, const column* rhs) {
         return lhs->name < rhs->name;
@@ -154,7 +268,7 @@ bool segment_writer::flush(std::string& filename, segment_meta& meta) {
     flush_state state;
     state.dir = &dir_;
     state.doc_count = docs_cached();
-    state.name = seg_name_;
+    state.name = meta.name;
     state.ver = IRESEARCH_VERSION;
 
     fields_.flush(*field_writer_, state);
@@ -180,6 +294,14 @@ bool segment_writer::flush(std::string& filename, segment_meta& meta) {
   return true;
 }
 
+size_t segment_writer::memory() const NOEXCEPT {
+  // column values are written out by the columnstore in blocks,
+  // buffered column data is not accounted
+  return fields_.memory()
+    + docs_context_.size() * sizeof(update_context)
+    + docs_mask_.words() * sizeof(document_mask::word_t);
+}
+
 void segment_writer::reset() {
   initialized_ = false;
 
@@ -193,6 +315,7 @@ void segment_writer::reset() {
   docs_context_.clear();
   docs_mask_.clear();
   fields_.reset();
+  memory_accounted_ = 0;
 }
 
 void segment_writer::reset(const segment_meta& meta) {
@@ -212,7 +335,15 @@ void segment_writer::reset(const segment_meta& meta) {
     col_writer_ = meta.codec->get_columnstore_writer();
   }
 
-  col_writer_->prepare(dir_, meta);
+  if (sort_) {
+    // documents are buffered in order of insertion, reordered on flush(...)
+    col_writer_->prepare(
+      dir_, segment_meta(unsorted_segment_name(seg_name_), meta.codec)
+    );
+  } else {
+    col_writer_->prepare(dir_, meta);
+  }
+
   initialized_ = true;
 }
 
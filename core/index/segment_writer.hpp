@@ -25,6 +25,7 @@
 #define IRESEARCH_TL_DOC_WRITER_H
 
 #include "field_data.hpp"
+#include "merge_writer.hpp"
 #include "analysis/token_stream.hpp"
 #include "formats/formats.hpp"
 #include "utils/directory_utils.hpp"
@@ -36,8 +37,21 @@ struct segment_meta;
 
 class IRESEARCH_API segment_writer: util::noncopyable {
  public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief encoding of the document normalization factors
+  //////////////////////////////////////////////////////////////////////////////
+  enum class norm_encoding {
+    FLOAT, // exact variable length float
+    BYTE // single byte quantized value (see 'norm::encode'), less precise but
+         // the readers keep such norms in memory as a dense per-segment array
+  };
+
   DECLARE_PTR(segment_writer);
-  DECLARE_FACTORY_DEFAULT(directory& dir);
+  DECLARE_FACTORY_DEFAULT(
+    directory& dir,
+    norm_encoding encoding = norm_encoding::FLOAT,
+    const sort_columns* sort = nullptr // order of documents in flushed segments
+  );
 
   struct update_context {
     size_t generation;
@@ -50,7 +64,7 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   void begin(const update_context& ctx) {
     valid_ = true;
     norm_fields_.clear(); // clear norm fields
-    docs_mask_.reserve(docs_mask_.size() + 1); // reserve space for potential rollback
+    docs_mask_.reserve(docs_context_.size() + 2); // reserve space for potential rollback (doc_ids are 1-based)
     docs_context_.emplace_back(ctx);
   }
 
@@ -92,6 +106,22 @@ class IRESEARCH_API segment_writer: util::noncopyable {
 
   bool flush(std::string& filename, segment_meta& meta);
 
+  // moves out the per-document state of the flushed segment, i.e. the state
+  // required for applying the removals/updates to the segment at commit
+  void release(update_contexts& docs_context, document_mask& docs_mask) NOEXCEPT {
+    docs_context = std::move(docs_context_);
+    docs_context_.clear();
+    docs_mask = std::move(docs_mask_);
+    docs_mask_.clear();
+  }
+
+  // returns approximate number of bytes occupied by the buffered documents
+  size_t memory() const NOEXCEPT;
+
+  // number of bytes of memory() already accounted by the owner of the writer
+  size_t memory_accounted() const NOEXCEPT { return memory_accounted_; }
+  void memory_accounted(size_t memory) NOEXCEPT { memory_accounted_ = memory; }
+
   const std::string& name() const NOEXCEPT { return seg_name_; }
   size_t docs_cached() const NOEXCEPT { return docs_context_.size(); }
   const update_contexts& docs_context() const NOEXCEPT { return docs_context_; }
@@ -116,7 +146,24 @@ class IRESEARCH_API segment_writer: util::noncopyable {
     columnstore_writer::column_t handle;
   };
 
-  segment_writer(directory& dir) NOEXCEPT;
+  segment_writer(
+    directory& dir,
+    norm_encoding encoding,
+    const sort_columns* sort
+  ) NOEXCEPT;
+
+  // writes buffered documents in order of insertion as segment 'meta'
+  bool flush_segment(std::string& filename, segment_meta& meta);
+
+  // writes buffered documents ordered by 'sort_' as segment 'meta'
+  bool flush_sorted(std::string& filename, segment_meta& meta);
+
+  // reorders the flushed segment 'unsorted' by 'sort_' into segment 'meta'
+  bool sort_segment(
+    const segment_meta& unsorted,
+    std::string& filename,
+    segment_meta& meta
+  );
 
   bool index(
     const hashed_string_ref& name,
@@ -209,6 +256,9 @@ class IRESEARCH_API segment_writer: util::noncopyable {
   column_meta_writer::ptr col_meta_writer_;
   columnstore_writer::ptr col_writer_;
   tracking_directory dir_;
+  norm_encoding norm_encoding_;
+  const sort_columns* sort_; // nullptr == order of insertion
+  size_t memory_accounted_{}; // part of memory() accounted by the owner
   bool initialized_;
   bool valid_{ true }; // current state
   IRESEARCH_API_PRIVATE_VARIABLES_END
@@ -0,0 +1,284 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_BLOCK_MAX_DISJUNCTION_H
+#define IRESEARCH_BLOCK_MAX_DISJUNCTION_H
+
+#include "disjunction.hpp"
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class block_max_disjunction
+/// @brief scored disjunction which skips the documents that can't get a score
+///        preceding the 'score_threshold' set by a consumer (Block-Max WAND),
+///        every sub-iterator must provide a 'score_bound' attribute
+///-----------------------------------------------------------------------------
+///      [0] <-- begin
+///      [1]      | sorted by the current document, the accumulated bounds
+///      [2]      | of [0..pivot] don't follow the threshold
+///      [3] <-- pivot
+///      ...
+///      [n] <-- end
+///-----------------------------------------------------------------------------
+////////////////////////////////////////////////////////////////////////////////
+class block_max_disjunction : public doc_iterator_base {
+ public:
+  struct bound_iterator_adapter : score_iterator_adapter {
+    bound_iterator_adapter(score_iterator_adapter&& it) NOEXCEPT
+      : score_iterator_adapter(std::move(it)) {
+      bound = this->it->attributes().get<score_bound>().get();
+    }
+
+    bound_iterator_adapter(bound_iterator_adapter&& rhs) NOEXCEPT
+      : score_iterator_adapter(std::move(rhs)), bound(rhs.bound) {
+    }
+
+    bound_iterator_adapter& operator=(bound_iterator_adapter&& rhs) NOEXCEPT {
+      if (this != &rhs) {
+        score_iterator_adapter::operator=(std::move(rhs));
+        bound = rhs.bound;
+      }
+      return *this;
+    }
+
+    const score_bound* bound;
+  }; // bound_iterator_adapter
+
+  typedef bound_iterator_adapter doc_iterator_t;
+  typedef std::vector<doc_iterator_t> doc_iterators_t;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if the scores of all the specified iterators are bounded
+  //////////////////////////////////////////////////////////////////////////////
+  template<typename Iterators>
+  static bool bounded(const Iterators& itrs) {
+    return std::all_of(
+      itrs.begin(), itrs.end(),
+      [](const typename Iterators::value_type& it) {
+        return it->attributes().template contains<score_bound>();
+    });
+  }
+
+  block_max_disjunction(
+      doc_iterators_t&& itrs,
+      const order::prepared& ord)
+    : doc_iterator_base(ord),
+      itrs_(std::move(itrs)),
+      doc_(type_limits<type_t::doc_id_t>::invalid()) {
+    assert(!itrs_.empty());
+    assert(!ord_->empty());
+    assert(bounded(itrs_));
+
+    // estimate disjunction
+    estimate([this](){
+      return std::accumulate(
+        itrs_.begin(), itrs_.end(), cost::cost_t(0),
+        [](cost::cost_t lhs, const doc_iterator_t& rhs) {
+          return lhs + cost::extract(rhs->attributes(), 0);
+      });
+    });
+
+    // prepare score
+    prepare_score([this](byte_type* score) {
+      ord_->prepare_score(score);
+
+      // the iterators positioned on the current document go first
+      for (auto& it : itrs_) {
+        if (it->value() != doc_) {
+          break;
+        }
+
+        it.score->evaluate();
+        ord_->add(score, it.score->c_str());
+      }
+    });
+
+    bound_.resize(ord_->size());
+    block_.resize(ord_->size());
+    attrs_.emplace(threshold_);
+  }
+
+  virtual doc_id_t value() const override {
+    return doc_;
+  }
+
+  virtual bool next() override {
+    if (type_limits<type_t::doc_id_t>::eof(doc_)) {
+      return false;
+    }
+
+    return !type_limits<type_t::doc_id_t>::eof(find(doc_ + 1));
+  }
+
+  virtual doc_id_t seek(doc_id_t target) override {
+    if (target <= doc_) {
+      return doc_;
+    }
+
+    return find(target);
+  }
+
+ private:
+  // moves the iterators behind the target and restores the order
+  void advance(doc_id_t target) {
+    auto end = std::find_if(
+      itrs_.begin(), itrs_.end(),
+      [target](const doc_iterator_t& it) { return it->value() >= target; }
+    );
+
+    for (auto it = itrs_.begin(); it != end; ++it) {
+      (*it)->seek(target);
+    }
+
+    end = itrs_.erase(
+      std::remove_if(
+        itrs_.begin(), end,
+        [](const doc_iterator_t& it) {
+          return type_limits<type_t::doc_id_t>::eof(it->value());
+      }),
+      end
+    );
+
+    // the iterators following 'end' are still ordered
+    const auto less = [](const doc_iterator_t& lhs, const doc_iterator_t& rhs) {
+      return lhs->value() < rhs->value();
+    };
+
+    if (std::distance(itrs_.begin(), end) <= 2) {
+      // insert a few advanced iterators starting from the last one
+      while (end != itrs_.begin()) {
+        const auto it = --end;
+        std::rotate(it, it + 1, std::upper_bound(it + 1, itrs_.end(), *it, less));
+      }
+
+      return;
+    }
+
+    // order the advanced iterators and merge them with the rest
+    std::sort(itrs_.begin(), end, less);
+    merged_.clear();
+    merged_.reserve(itrs_.size());
+    std::merge(
+      std::make_move_iterator(itrs_.begin()), std::make_move_iterator(end),
+      std::make_move_iterator(end), std::make_move_iterator(itrs_.end()),
+      std::back_inserter(merged_), less
+    );
+    itrs_.swap(merged_);
+  }
+
+  // returns true if the accumulated score doesn't follow the threshold
+  bool competitive(const byte_type* score) const {
+    return !ord_->less(threshold_.value.c_str(), score);
+  }
+
+  doc_id_t find(doc_id_t target) {
+    for (;;) {
+      advance(target);
+
+      if (itrs_.empty()) {
+        return (doc_ = type_limits<type_t::doc_id_t>::eof());
+      }
+
+      if (threshold_.value.empty()) {
+        // no threshold, behave like a regular disjunction
+        return (doc_ = itrs_.front()->value());
+      }
+
+      assert(threshold_.value.size() == ord_->size());
+      auto* bound = &bound_[0];
+
+      // find the first iterator which could produce a competitive score
+      // together with the iterators preceding it
+      size_t pivot = 0;
+      const size_t size = itrs_.size();
+
+      ord_->prepare_score(bound);
+
+      for (; pivot < size; ++pivot) {
+        ord_->add(bound, itrs_[pivot].bound->value.c_str());
+
+        if (competitive(bound)) {
+          break;
+        }
+      }
+
+      if (pivot == size) {
+        // none of the remaining documents is competitive
+        return (doc_ = type_limits<type_t::doc_id_t>::eof());
+      }
+
+      const auto pivot_doc = itrs_[pivot]->value();
+
+      while (pivot + 1 < size && itrs_[pivot + 1]->value() == pivot_doc) {
+        ++pivot;
+      }
+
+      // check the bounds of the blocks containing the pivot document
+      auto block_end = type_limits<type_t::doc_id_t>::eof();
+      auto* block_bound = &block_[0];
+
+      ord_->prepare_score(bound);
+
+      for (size_t i = 0; i <= pivot; ++i) {
+        block_end = std::min(
+          block_end, itrs_[i].bound->shallow_seek(pivot_doc, block_bound)
+        );
+        ord_->add(bound, block_bound);
+      }
+
+      if (competitive(bound)) {
+        if (itrs_.front()->value() == pivot_doc) {
+          return (doc_ = pivot_doc);
+        }
+
+        // move the lagging iterators to the pivot document
+        target = pivot_doc;
+        continue;
+      }
+
+      // none of the documents up to the end of the blocks is competitive,
+      // but the iterators following the pivot may be
+      target = type_limits<type_t::doc_id_t>::eof(block_end)
+        ? block_end
+        : block_end + 1;
+
+      if (pivot + 1 < size) {
+        target = std::min(target, itrs_[pivot + 1]->value());
+      }
+
+      target = std::max(target, pivot_doc + 1);
+    }
+  }
+
+  doc_iterators_t itrs_;
+  doc_iterators_t merged_; // buffer for merging the advanced iterators
+  score_threshold threshold_;
+  bstring bound_; // accumulated score bound
+  bstring block_; // score bound of a single block
+  doc_id_t doc_;
+}; // block_max_disjunction
+
+NS_END // ROOT
+
+#endif // IRESEARCH_BLOCK_MAX_DISJUNCTION_H
@@ -27,6 +27,7 @@
 #include "analysis/token_attributes.hpp"
 #include "index/index_reader.hpp"
 #include "index/field_meta.hpp"
+#include "utils/math_utils.hpp"
 
 NS_ROOT
 
@@ -52,7 +53,9 @@ NS_BEGIN(bm25)
 const frequency EMPTY_FREQ;
 
 // set of features required for bm25 model
-const flags FEATURES{ frequency::type(), norm::type() };
+const flags FEATURES{
+  frequency::type(), norm::type(), block_max::type(), doc_block::type()
+};
 
 struct stats final : stored_attribute {
   DECLARE_ATTRIBUTE_TYPE();
@@ -84,10 +87,12 @@ class scorer : public iresearch::sort::scorer_base<bm25::score_t> {
       float_t k, 
       iresearch::boost::boost_t boost,
       const bm25::stats* stats,
-      const frequency* freq)
+      const frequency* freq,
+      bool reverse)
     : freq_(freq ? freq : &EMPTY_FREQ),
       num_(boost * (k + 1) * (stats ? stats->idf : 1.f)),
-      norm_const_(k) {
+      norm_const_(k),
+      reverse_(reverse) {
     assert(freq_);
   }
 
@@ -96,14 +101,58 @@ class scorer : public iresearch::sort::scorer_base<bm25::score_t> {
     score_cast(score_buf) = num_ * freq / (norm_const_ + freq);
   }
 
+  virtual bool score_block(
+      const doc_id_t* docs,
+      const uint64_t* freqs,
+      size_t count,
+      byte_type* score_buf,
+      size_t stride) override {
+    UNUSED(docs);
+
+    score_chunks(count, score_buf, stride,
+                 [this, freqs](score_t* values, size_t offset, size_t size) {
+      tf(freqs + offset, size, values);
+
+      const auto num = num_;
+      const auto norm_const = norm_const_;
+
+      for (size_t i = 0; i < size; ++i) {
+        values[i] = num * values[i] / (norm_const + values[i]);
+      }
+    });
+
+    return true;
+  }
+
+  // the score grows with the frequency and decreases with the length norm,
+  // so the score of a document with zero norm and max frequency is the upper
+  // bound for both scorers, applicable to the descending order only
+  virtual bool bound(byte_type* score_buf, uint64_t max_freq) const override {
+    if (!reverse_ || num_ < 0.f) {
+      return false;
+    }
+
+    const float_t freq = sqrt_(max_freq);
+    score_cast(score_buf) = max_freq ? num_ * freq / (norm_const_ + freq) : 0.f;
+    return true;
+  }
+
  protected:
   FORCE_INLINE float_t tf() const {
-    return float_t(std::sqrt(freq_->value));
+    return sqrt_(freq_->value);
   };
 
+  FORCE_INLINE void tf(const uint64_t* freqs, size_t size, float_t* tfs) const {
+    for (size_t i = 0; i < size; ++i) {
+      tfs[i] = sqrt_(freqs[i]);
+    }
+  }
+
+  math::sqrt_cache sqrt_;
   const frequency* freq_; // document frequency
   float_t num_; // partially precomputed numerator : boost * (k + 1) * idf
   float_t norm_const_; // 'k' factor
+  bool reverse_; // the most relevant results first
 }; // scorer
 
 class norm_scorer final : public scorer {
@@ -115,13 +164,12 @@ class norm_scorer final : public scorer {
       iresearch::boost::boost_t boost,
       const bm25::stats* stats,
       const frequency* freq,
-      const iresearch::norm* norm)
-    : scorer(k, boost, stats, freq),
-      norm_(norm) {
-    assert(norm_);
-
+      iresearch::norm&& norm,
+      bool reverse)
+    : scorer(k, boost, stats, freq, reverse),
+      norm_(std::move(norm)) {
     // if there is no norms, assume that b==0
-    if (!norm_->empty()) {
+    if (!norm_.empty()) {
       norm_const_ = stats->norm_const;
       norm_length_ = stats->norm_length;
     }
@@ -129,11 +177,36 @@ class norm_scorer final : public scorer {
 
   virtual void score(byte_type* score_buf) override {
     const float_t freq = tf();
-    score_cast(score_buf) = num_ * freq / (norm_const_ + norm_length_ * norm_->read() + freq);
+    score_cast(score_buf) = num_ * freq / (norm_const_ + norm_length_ * norm_.read() + freq);
+  }
+
+  virtual bool score_block(
+      const doc_id_t* docs,
+      const uint64_t* freqs,
+      size_t count,
+      byte_type* score_buf,
+      size_t stride) override {
+    score_chunks(count, score_buf, stride,
+                 [this, docs, freqs](score_t* values, size_t offset, size_t size) {
+      float_t norms[CHUNK_SIZE];
+      norm_.read(docs + offset, size, norms);
+
+      tf(freqs + offset, size, values);
+
+      const auto num = num_;
+      const auto norm_const = norm_const_;
+      const auto norm_length = norm_length_;
+
+      for (size_t i = 0; i < size; ++i) {
+        values[i] = num * values[i] / (norm_const + norm_length * norms[i] + values[i]);
+      }
+    });
+
+    return true;
   }
 
  private:
-  const iresearch::norm* norm_;
+  iresearch::norm norm_;
   float_t norm_length_{ 0.f }; // precomputed 'k*b/avgD' if norms presetn, '0' otherwise
 }; // norm_scorer
 
@@ -197,7 +270,7 @@ class sort final : iresearch::sort::prepared_base<bm25::score_t> {
  public:
   DECLARE_FACTORY(prepared);
 
-  sort(float_t k, float_t b, bool reverse): k_(k), b_(b) {
+  sort(float_t k, float_t b, bool reverse): k_(k), b_(b), reverse_(reverse) {
     static const std::function<bool(score_t, score_t)> greater = std::greater<score_t>();
     static const std::function<bool(score_t, score_t)> less = std::less<score_t>();
     less_ = reverse ? &greater : &less;
@@ -221,15 +294,19 @@ class sort final : iresearch::sort::prepared_base<bm25::score_t> {
       return nullptr; // if there is no frequency then all the scores will be the same (e.g. filter irs::all)
     }
 
-    auto& norm = query_attrs.get<iresearch::norm>();
+    // every scorer reads the norms on its own since a prepared query may be
+    // executed on several segments concurrently
+    iresearch::norm norm;
 
-    if (norm && norm->reset(segment, field.meta().norm, *doc_attrs.get<document>())) {
+    if (query_attrs.contains<iresearch::norm>()
+        && norm.reset(segment, field.meta().norm, *doc_attrs.get<document>())) {
       return bm25::scorer::make<bm25::norm_scorer>(      
         k_, 
         boost::extract(query_attrs),
         query_attrs.get<bm25::stats>().get(),
         doc_attrs.get<frequency>().get(),
-        &*norm
+        std::move(norm),
+        reverse_
       );
     }
 
@@ -237,7 +314,8 @@ class sort final : iresearch::sort::prepared_base<bm25::score_t> {
       k_, 
       boost::extract(query_attrs),
       query_attrs.get<bm25::stats>().get(),
-      doc_attrs.get<frequency>().get()
+      doc_attrs.get<frequency>().get(),
+      reverse_
     );
   }
 
@@ -253,6 +331,7 @@ class sort final : iresearch::sort::prepared_base<bm25::score_t> {
   const std::function<bool(score_t, score_t)>* less_;
   float_t k_;
   float_t b_;
+  bool reverse_;
 }; // sort
 
 NS_END // bm25 
@@ -25,12 +25,18 @@
 #include "boolean_filter.hpp"
 #include "conjunction.hpp"
 #include "disjunction.hpp"
+#include "block_max_disjunction.hpp"
 #include "min_match_disjunction.hpp"
 #include "exclusion.hpp"
 #include <boost/functional/hash.hpp>
 
 NS_LOCAL
 
+// min number of the clauses of a scored disjunction executed as a
+// block_max_disjunction, a single clause has nothing to pivot on while
+// already 2 clauses skip most of the documents if their bounds differ
+const size_t BLOCK_MAX_MIN_CLAUSES = 2;
+
 // first - pointer to the innermost not "not" node
 // second - collapsed negation mark
 std::pair<const irs::filter*, bool> optimize_not(const irs::Not& node) {
@@ -76,6 +82,21 @@ irs::doc_iterator::ptr make_disjunction(
     }
   }
 
+  // skip the non-competitive documents if the scores are bounded
+  if (!ord.empty() && itrs.size() >= BLOCK_MAX_MIN_CLAUSES
+      && irs::block_max_disjunction::bounded(itrs)) {
+    irs::block_max_disjunction::doc_iterators_t bounded_itrs;
+    bounded_itrs.reserve(itrs.size());
+
+    for (auto& it : itrs) {
+      bounded_itrs.emplace_back(std::move(it));
+    }
+
+    return irs::doc_iterator::make<irs::block_max_disjunction>(
+      std::move(bounded_itrs), ord
+    );
+  }
+
   return irs::make_disjunction<irs::disjunction>(
     std::move(itrs), ord, std::forward<Args>(args)...
   );
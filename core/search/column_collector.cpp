@@ -0,0 +1,522 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "column_collector.hpp"
+#include "index/index_reader.hpp"
+#include "store/store_utils.hpp"
+#include "utils/async_utils.hpp"
+#include "utils/type_limits.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+NS_LOCAL
+
+using namespace irs;
+
+// every encoded key value starts with a marker, documents without a value
+// are ranked last regardless of the direction of the key
+const byte_type VALUE_PRESENT = 0;
+const byte_type VALUE_MISSING = 1;
+
+// appends 'value' in the big-endian order, i.e. byte-wise comparable
+void append_uint64(bstring& out, uint64_t value) {
+  for (size_t shift = 64; shift;) {
+    shift -= 8;
+    out.push_back(byte_type(value >> shift));
+  }
+}
+
+void append_int64(bstring& out, int64_t value) {
+  append_uint64(out, uint64_t(value) ^ (uint64_t(1) << 63)); // flip the sign
+}
+
+// returns an unsigned value having the same order as 'value'
+uint64_t double_key(double_t value) {
+  uint64_t bits;
+
+  static_assert(sizeof(bits) == sizeof(value), "sizeof(double_t) != 8");
+  std::memcpy(&bits, &value, sizeof(bits));
+
+  // negative values are inverted, positive ones are moved above them
+  return (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+}
+
+void append_double(bstring& out, double_t value) {
+  append_uint64(out, double_key(value));
+}
+
+template<typename T>
+int compare_numbers(T lhs, T rhs) {
+  return lhs < rhs ? -1 : (rhs < lhs ? 1 : 0);
+}
+
+// compares the decoded stored values in the order of the encoding below
+int compare_values(
+    column_collector::value_type type,
+    const bytes_ref& lhs,
+    const bytes_ref& rhs) {
+  typedef column_collector::value_type value_type;
+
+  if (value_type::BYTES == type) {
+    return compare(lhs, rhs);
+  }
+
+  if (value_type::STRING == type) {
+    return compare(
+      ref_cast<byte_type>(to_string<string_ref>(lhs.c_str())),
+      ref_cast<byte_type>(to_string<string_ref>(rhs.c_str()))
+    );
+  }
+
+  bytes_ref_input lhs_in(lhs), rhs_in(rhs);
+
+  switch (type) {
+   case value_type::INT:
+    return compare_numbers(read_zvint(lhs_in), read_zvint(rhs_in));
+   case value_type::LONG:
+    return compare_numbers(read_zvlong(lhs_in), read_zvlong(rhs_in));
+   case value_type::FLOAT:
+    return compare_numbers(
+      double_key(read_zvfloat(lhs_in)), double_key(read_zvfloat(rhs_in))
+    );
+   default:
+    return compare_numbers(
+      double_key(read_zvdouble(lhs_in)), double_key(read_zvdouble(rhs_in))
+    );
+  }
+}
+
+// appends an order-preserving encoding of the stored 'value'
+void append_value(
+    bstring& out,
+    column_collector::value_type type,
+    const bytes_ref& value) {
+  typedef column_collector::value_type value_type;
+
+  if (value_type::BYTES == type || value_type::STRING == type) {
+    const auto data = value_type::STRING == type
+      ? ref_cast<byte_type>(to_string<string_ref>(value.c_str()))
+      : value;
+    const auto size = uint32_t(data.size());
+
+    out.append(reinterpret_cast<const byte_type*>(&size), sizeof(size));
+    out.append(data.c_str(), data.size());
+    return;
+  }
+
+  const uint32_t size = sizeof(uint64_t);
+  bytes_ref_input in(value);
+
+  out.append(reinterpret_cast<const byte_type*>(&size), sizeof(size));
+
+  switch (type) {
+   case value_type::INT:
+    append_int64(out, read_zvint(in));
+    break;
+   case value_type::LONG:
+    append_int64(out, read_zvlong(in));
+    break;
+   case value_type::FLOAT:
+    append_double(out, read_zvfloat(in));
+    break;
+   default:
+    append_double(out, read_zvdouble(in));
+  }
+}
+
+typedef std::vector<columnstore_reader::values_reader_f> value_readers_t;
+
+// appends the encoded value of the key 'i' of the document 'doc'
+void append_key(
+    bstring& out,
+    const column_collector::keys_t& keys,
+    const value_readers_t& readers,
+    size_t i,
+    doc_id_t doc) {
+  bytes_ref value;
+
+  if (readers[i](doc, value)) {
+    out.push_back(VALUE_PRESENT);
+    append_value(out, keys[i].type, value);
+  } else {
+    out.push_back(VALUE_MISSING);
+  }
+}
+
+// encoded value of the first key ranking first within a column block
+struct block_bound {
+  doc_id_t min_key;
+  doc_id_t max_key;
+  bstring value;
+}; // block_bound
+
+typedef std::vector<block_bound> block_bounds_t;
+
+// collects the bounds of the column blocks having summaries suitable for 'key'
+block_bounds_t prepare_bounds(
+    const columnstore_reader::column_reader& column,
+    const column_collector::key& key) {
+  typedef column_collector::value_type value_type;
+
+  block_bounds_t bounds;
+
+  if (value_type::BYTES != key.type
+      && value_type::INT != key.type
+      && value_type::LONG != key.type) {
+    return bounds; // byte-wise and numeric orders differ
+  }
+
+  column.visit_blocks(
+    [&bounds, &key](const columnstore_reader::block_summary& block) {
+      bstring value(1, VALUE_PRESENT);
+
+      if (value_type::BYTES == key.type) {
+        const auto& bound = key.reverse ? block.max : block.min;
+
+        if (bound.null()) {
+          return true; // no byte-wise bounds
+        }
+
+        append_value(value, key.type, bound);
+      } else {
+        if (!block.has_long) {
+          return true; // not every value is a number
+        }
+
+        const uint32_t size = sizeof(uint64_t);
+
+        value.append(reinterpret_cast<const byte_type*>(&size), sizeof(size));
+        append_int64(value, key.reverse ? block.max_long : block.min_long);
+      }
+
+      bounds.push_back({ block.min_key, block.max_key, std::move(value) });
+
+      return true;
+  });
+
+  return bounds;
+}
+
+NS_END // LOCAL
+
+NS_ROOT
+
+/*static*/ sort_columns column_collector::sort(const keys_t& keys) {
+  sort_columns columns;
+
+  columns.reserve(keys.size());
+
+  for (auto& key : keys) {
+    const auto type = key.type;
+    const auto reverse = key.reverse;
+
+    columns.emplace_back(
+      key.column,
+      [type, reverse](const bytes_ref& lhs, const bytes_ref& rhs) {
+        const auto res = compare_values(type, lhs, rhs);
+        return reverse ? res > 0 : res < 0;
+    });
+  }
+
+  return columns;
+}
+
+column_collector::column_collector(const keys_t& keys, size_t k)
+  : keys_(keys), k_(k) {
+  heap_.reserve(k_);
+}
+
+column_collector::column_collector(column_collector&& rhs) NOEXCEPT
+  : keys_(std::move(rhs.keys_)),
+    heap_(std::move(rhs.heap_)),
+    k_(rhs.k_),
+    hits_(rhs.hits_) {
+  rhs.hits_ = 0;
+}
+
+int column_collector::compare(
+    const byte_type*& lhs,
+    const byte_type*& rhs,
+    size_t begin,
+    size_t end) const {
+  for (size_t i = begin; i < end; ++i) {
+    const auto lhs_marker = *lhs++;
+    const auto rhs_marker = *rhs++;
+
+    if (lhs_marker != rhs_marker) {
+      return VALUE_MISSING == lhs_marker ? 1 : -1;
+    }
+
+    if (VALUE_MISSING == lhs_marker) {
+      continue; // both values are missing
+    }
+
+    uint32_t lhs_size, rhs_size;
+
+    std::memcpy(&lhs_size, lhs, sizeof(lhs_size));
+    std::memcpy(&rhs_size, rhs, sizeof(rhs_size));
+    lhs += sizeof(lhs_size);
+    rhs += sizeof(rhs_size);
+
+    int res = std::memcmp(lhs, rhs, std::min(lhs_size, rhs_size));
+
+    if (!res) {
+      res = lhs_size < rhs_size ? -1 : (lhs_size > rhs_size ? 1 : 0);
+    }
+
+    lhs += lhs_size;
+    rhs += rhs_size;
+
+    if (res) {
+      return keys_[i].reverse ? -res : res;
+    }
+  }
+
+  return 0;
+}
+
+bool column_collector::less(
+    const bytes_ref& value,
+    size_t segment,
+    doc_id_t doc,
+    const entry& rhs) const {
+  auto* lhs_value = value.c_str();
+  auto* rhs_value = rhs.value.c_str();
+  const auto res = compare(lhs_value, rhs_value, 0, keys_.size());
+
+  if (res) {
+    return res < 0;
+  }
+
+  return segment < rhs.segment || (segment == rhs.segment && doc < rhs.doc);
+}
+
+void column_collector::push(entry&& value) {
+  assert(heap_.size() < k_);
+
+  const auto less = [this](const entry& lhs, const entry& rhs) {
+    return this->less(lhs.value, lhs.segment, lhs.doc, rhs);
+  };
+
+  heap_.emplace_back(std::move(value));
+  std::push_heap(heap_.begin(), heap_.end(), less);
+}
+
+void column_collector::replace_top(
+    const bytes_ref& value,
+    size_t segment,
+    doc_id_t doc) {
+  assert(!heap_.empty());
+
+  const auto less = [this](const entry& lhs, const entry& rhs) {
+    return this->less(lhs.value, lhs.segment, lhs.doc, rhs);
+  };
+
+  // reuse the buffer of the evicted entry
+  std::pop_heap(heap_.begin(), heap_.end(), less);
+  auto& top = heap_.back();
+  top.value.assign(value.c_str(), value.size());
+  top.segment = segment;
+  top.doc = doc;
+  std::push_heap(heap_.begin(), heap_.end(), less);
+}
+
+void column_collector::collect(
+    size_t segment,
+    const sub_reader& reader,
+    doc_iterator& docs) {
+  value_readers_t readers;
+  block_bounds_t bounds;
+
+  readers.reserve(keys_.size());
+
+  for (auto& key : keys_) {
+    const auto* column = reader.column_reader(key.column);
+
+    if (column && readers.empty()) {
+      bounds = prepare_bounds(*column, key);
+    }
+
+    readers.emplace_back(
+      column ? column->values() : columnstore_reader::empty_reader()
+    );
+  }
+
+  auto block = bounds.begin();
+  bstring value;
+
+  for (bool valid = docs.next(); valid;) {
+    const auto doc = docs.value();
+
+    if (heap_.size() == k_ && k_) {
+      while (block != bounds.end() && block->max_key < doc) {
+        ++block;
+      }
+
+      if (block != bounds.end() && block->min_key <= doc) {
+        const byte_type* lhs = block->value.c_str();
+        const byte_type* rhs = heap_.front().value.c_str();
+
+        if (compare(lhs, rhs, 0, 1) > 0) {
+          // none of the values of the block ranks before the last one
+          valid = !type_limits<type_t::doc_id_t>::eof(
+            docs.seek(block->max_key + 1)
+          );
+          continue;
+        }
+      }
+    }
+
+    valid = docs.next(); // 'doc' is processed below
+    ++hits_;
+
+    if (!k_) {
+      continue;
+    }
+
+    size_t key = 0;
+
+    value.clear();
+
+    if (heap_.size() == k_) {
+      // the values of the further keys are read only for the documents
+      // not ranking after the last collected one by the preceding keys
+      const byte_type* rhs = heap_.front().value.c_str();
+      int res = 0;
+
+      while (!res && key < keys_.size()) {
+        const auto offset = value.size();
+
+        append_key(value, keys_, readers, key, doc);
+
+        const byte_type* lhs = value.c_str() + offset;
+
+        res = compare(lhs, rhs, key, key + 1);
+        ++key;
+      }
+
+      if (res > 0) {
+        continue;
+      }
+    }
+
+    for (; key < keys_.size(); ++key) {
+      append_key(value, keys_, readers, key, doc);
+    }
+
+    if (heap_.size() < k_) {
+      push(entry{ value, segment, doc });
+    } else if (less(value, segment, doc, heap_.front())) {
+      replace_top(value, segment, doc);
+    }
+  }
+}
+
+void column_collector::collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    async_utils::thread_pool* pool /*= nullptr*/) {
+  std::vector<const sub_reader*> segments;
+  segments.reserve(index.size());
+
+  for (auto& segment : index) {
+    segments.emplace_back(&segment);
+  }
+
+  if (!pool || segments.size() < 2) {
+    // iterators of a segment reuse memory released by the previous one
+    doc_iterator_arena arena;
+    doc_iterator_arena::scope scope(arena);
+
+    for (size_t i = 0, size = segments.size(); i < size; ++i) {
+      auto docs = filter.execute(*segments[i]);
+      collect(i, *segments[i], *docs);
+    }
+
+    return;
+  }
+
+  // every segment is collected into its own heap, the heaps are merged after
+  std::vector<column_collector> collectors;
+  collectors.reserve(segments.size());
+
+  for (size_t i = 0, size = segments.size(); i < size; ++i) {
+    collectors.emplace_back(keys_, k_);
+  }
+
+  {
+    async_utils::task_group tasks(pool);
+
+    for (size_t i = 0, size = segments.size(); i < size; ++i) {
+      tasks.run([&collectors, &segments, &filter, i]()->void {
+        doc_iterator_arena arena;
+        doc_iterator_arena::scope scope(arena);
+        auto docs = filter.execute(*segments[i]);
+        collectors[i].collect(i, *segments[i], *docs);
+      });
+    }
+
+    tasks.wait();
+  }
+
+  for (auto& collector : collectors) {
+    merge(std::move(collector));
+  }
+}
+
+void column_collector::merge(column_collector&& rhs) {
+  assert(k_ == rhs.k_ && keys_.size() == rhs.keys_.size());
+  hits_ += rhs.hits_;
+  rhs.hits_ = 0;
+
+  for (auto& entry : rhs.heap_) {
+    if (heap_.size() < k_) {
+      push(std::move(entry));
+    } else if (less(entry.value, entry.segment, entry.doc, heap_.front())) {
+      replace_top(entry.value, entry.segment, entry.doc);
+    }
+  }
+
+  rhs.heap_.clear();
+}
+
+column_collector::entries_t column_collector::release() {
+  const auto less = [this](const entry& lhs, const entry& rhs) {
+    return this->less(lhs.value, lhs.segment, lhs.doc, rhs);
+  };
+
+  std::sort_heap(heap_.begin(), heap_.end(), less);
+
+  entries_t entries;
+  entries.swap(heap_);
+  heap_.reserve(k_);
+
+  return entries;
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,155 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_COLUMN_COLLECTOR_H
+#define IRESEARCH_COLUMN_COLLECTOR_H
+
+#include "filter.hpp"
+#include "index/merge_writer.hpp"
+#include "utils/noncopyable.hpp"
+
+NS_ROOT
+
+NS_BEGIN(async_utils)
+class thread_pool;
+NS_END // async_utils
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class column_collector
+/// @brief collects 'k' documents ordered by the values of stored columns
+///        (e.g. a timestamp) instead of a relevance score, further keys break
+///        the ties of the preceding ones, documents without a value in a
+///        column rank last, the remaining ties are ranked by the segment and
+///        document identifier
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API column_collector : private util::noncopyable {
+ public:
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief encoding of the stored column values
+  //////////////////////////////////////////////////////////////////////////////
+  enum class value_type {
+    BYTES, // raw value, byte-wise order
+    STRING, // 'write_string(...)', byte-wise order
+    INT, // 'write_zvint(...)'
+    LONG, // 'write_zvlong(...)'
+    FLOAT, // 'write_zvfloat(...)'
+    DOUBLE // 'write_zvdouble(...)'
+  };
+
+  struct key {
+    key(const string_ref& column, value_type type, bool reverse = false)
+      : column(column), type(type), reverse(reverse) {
+    }
+
+    std::string column;
+    value_type type;
+    bool reverse; // descending order
+  }; // key
+
+  typedef std::vector<key> keys_t;
+
+  struct entry {
+    bstring value; // order-preserving encoding of the key values
+    size_t segment; // ordinal of the segment within the index
+    doc_id_t doc;
+  }; // entry
+
+  typedef std::vector<entry> entries_t;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the order of the documents by the specified keys to be used as
+  ///          index_writer::options::sort, the stored values are compared as
+  ///          decoded, e.g. signed numbers, the column blocks of the segments
+  ///          ordered by the first key cover disjoint ranges of its values,
+  ///          i.e. the blocks after the collected documents are skipped
+  //////////////////////////////////////////////////////////////////////////////
+  static sort_columns sort(const keys_t& keys);
+
+  column_collector(const keys_t& keys, size_t k);
+  column_collector(column_collector&& rhs) NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collects the documents of the specified iterator over 'segment',
+  ///        the values of the further keys are read only for the documents
+  ///        competitive by the preceding keys, the column blocks of the first
+  ///        key with no competitive values according to their summaries are
+  ///        skipped (BYTES, INT and LONG keys)
+  /// @param segment ordinal of the segment the documents belong to
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(size_t segment, const sub_reader& reader, doc_iterator& docs);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief executes the filter on every segment of the index and collects the
+  ///        matched documents, the segments are processed in parallel if a
+  ///        'pool' is specified
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    async_utils::thread_pool* pool = nullptr
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief adds the documents collected by 'rhs', 'rhs' must be created for
+  ///        the same keys and 'k'
+  //////////////////////////////////////////////////////////////////////////////
+  void merge(column_collector&& rhs);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the collected documents ordered from the first to the last, the
+  ///          documents are removed from the collector
+  //////////////////////////////////////////////////////////////////////////////
+  entries_t release();
+
+  // total number of the documents seen by the collector, the documents
+  // of the skipped column blocks are not counted
+  uint64_t hits() const NOEXCEPT { return hits_; }
+
+  size_t size() const NOEXCEPT { return heap_.size(); }
+
+ private:
+  // compares the encoded values of the keys [begin, end)
+  int compare(
+    const byte_type*& lhs,
+    const byte_type*& rhs,
+    size_t begin,
+    size_t end
+  ) const;
+  // returns true if the document ranks before 'rhs'
+  bool less(
+    const bytes_ref& value, size_t segment, doc_id_t doc, const entry& rhs
+  ) const;
+  void push(entry&& value);
+  void replace_top(const bytes_ref& value, size_t segment, doc_id_t doc);
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  keys_t keys_;
+  entries_t heap_; // the last of the collected documents goes first
+  size_t k_;
+  uint64_t hits_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // column_collector
+
+NS_END // ROOT
+
+#endif // IRESEARCH_COLUMN_COLLECTOR_H
@@ -0,0 +1,315 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "column_range_filter.hpp"
+#include "formats/empty_term_reader.hpp"
+#include "search/score_doc_iterators.hpp"
+#include "store/store_utils.hpp"
+
+#include <boost/functional/hash.hpp>
+
+NS_LOCAL
+
+// keys of the column blocks which may contain matching values
+struct key_range {
+  irs::doc_id_t min;
+  irs::doc_id_t max;
+  bool all; // every value of the blocks is within the range
+}; // key_range
+
+typedef std::vector<key_range> key_ranges_t;
+
+// collects key ranges of the column blocks intersecting [min, max]
+key_ranges_t prepare_ranges(
+    const irs::columnstore_reader::column_reader& column,
+    int64_t min,
+    int64_t max) {
+  key_ranges_t ranges;
+  bool kept = false; // preceding block is a part of ranges.back()
+
+  const auto visited = column.visit_blocks(
+    [&ranges, &kept, min, max](const irs::columnstore_reader::block_summary& block) {
+      bool all = false;
+
+      if (block.has_long) {
+        if (block.max_long < min || max < block.min_long) {
+          kept = false;
+          return true; // skip the block
+        }
+
+        all = min <= block.min_long && block.max_long <= max;
+      }
+
+      if (kept && ranges.back().all == all) {
+        ranges.back().max = block.max_key; // merge with preceding blocks
+      } else {
+        ranges.push_back({ block.min_key, block.max_key, all });
+      }
+
+      kept = true;
+      return true;
+  });
+
+  if (!visited) {
+    // column has no summaries, check every value
+    ranges.assign(1, key_range{
+      (irs::type_limits<irs::type_t::doc_id_t>::min)(),
+      irs::type_limits<irs::type_t::doc_id_t>::eof() - 1,
+      false
+    });
+  }
+
+  return ranges;
+}
+
+class column_range_iterator final : public irs::doc_iterator_base {
+ public:
+  explicit column_range_iterator(
+      const irs::sub_reader& reader,
+      const irs::attribute_store& prepared_filter_attrs,
+      irs::columnstore_iterator::ptr&& it,
+      key_ranges_t&& ranges,
+      int64_t min,
+      int64_t max,
+      const irs::order::prepared& ord,
+      uint64_t docs_count)
+    : doc_iterator_base(ord),
+      it_(std::move(it)),
+      ranges_(std::move(ranges)),
+      range_(ranges_.begin()),
+      min_(min),
+      max_(max) {
+    assert(it_);
+    // make doc_id accessible via attribute
+    attrs_.emplace(doc_);
+
+    // set estimation value
+    estimate(docs_count);
+
+    // set scorers
+    scorers_ = ord_->prepare_scorers(
+      reader,
+      irs::empty_term_reader(docs_count),
+      prepared_filter_attrs,
+      attributes() // doc_iterator attributes
+    );
+
+    prepare_score([this](irs::byte_type* score) {
+      scorers_.score(*ord_, score);
+    });
+  }
+
+  virtual bool next() override {
+    if (irs::type_limits<irs::type_t::doc_id_t>::eof(doc_.value)) {
+      return false;
+    }
+
+    if (irs::type_limits<irs::type_t::doc_id_t>::valid(doc_.value)) {
+      it_->next();
+    } else {
+      seek_range();
+    }
+
+    return find();
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    if (target <= doc_.value) {
+      return doc_.value;
+    }
+
+    it_->seek(target);
+    find();
+
+    return doc_.value;
+  }
+
+  virtual irs::doc_id_t value() const NOEXCEPT override {
+    return doc_.value;
+  }
+
+ private:
+  // positions the column iterator at the beginning of the current key range
+  void seek_range() {
+    if (range_ == ranges_.end()) {
+      it_->seek(irs::type_limits<irs::type_t::doc_id_t>::eof());
+    } else {
+      it_->seek(range_->min);
+    }
+  }
+
+  // finds the first matching document starting from the current position
+  bool find() {
+    for (;;) {
+      const auto& value = it_->value();
+
+      if (irs::type_limits<irs::type_t::doc_id_t>::eof(value.first)) {
+        break;
+      }
+
+      // skip key ranges preceding the current document
+      while (range_ != ranges_.end() && range_->max < value.first) {
+        ++range_;
+      }
+
+      if (range_ == ranges_.end()) {
+        break;
+      }
+
+      if (value.first < range_->min) {
+        // skip blocks outside of the range without loading them
+        it_->seek(range_->min);
+        continue;
+      }
+
+      int64_t number;
+
+      if (range_->all
+          || (irs::decode_zvlong(value.second, number)
+              && min_ <= number && number <= max_)) {
+        doc_.value = value.first;
+        return true;
+      }
+
+      if (!it_->next()) {
+        break;
+      }
+    }
+
+    range_ = ranges_.end();
+    doc_.value = irs::type_limits<irs::type_t::doc_id_t>::eof();
+    return false;
+  }
+
+  irs::document doc_;
+  irs::columnstore_iterator::ptr it_;
+  key_ranges_t ranges_;
+  key_ranges_t::const_iterator range_; // current key range
+  int64_t min_;
+  int64_t max_;
+  irs::order::prepared::scorers scorers_;
+}; // column_range_iterator
+
+class column_range_query final : public irs::filter::prepared {
+ public:
+  explicit column_range_query(
+    const std::string& field,
+    int64_t min,
+    int64_t max,
+    irs::attribute_store&& attrs
+  ): irs::filter::prepared(std::move(attrs)),
+     field_(field),
+     min_(min),
+     max_(max) {
+  }
+
+  virtual irs::doc_iterator::ptr execute(
+      const irs::sub_reader& rdr,
+      const irs::order::prepared& ord
+  ) const override {
+    const auto* column = rdr.column_reader(field_);
+
+    if (!column || max_ < min_) {
+      return irs::doc_iterator::empty();
+    }
+
+    auto ranges = prepare_ranges(*column, min_, max_);
+
+    if (ranges.empty()) {
+      // every block of the column is outside of the range
+      return irs::doc_iterator::empty();
+    }
+
+    return irs::doc_iterator::make<column_range_iterator>(
+      rdr,
+      attributes(), // prepared_filter attributes
+      column->iterator(),
+      std::move(ranges),
+      min_,
+      max_,
+      ord,
+      column->size()
+    );
+  }
+
+ private:
+  std::string field_;
+  int64_t min_;
+  int64_t max_;
+}; // column_range_query
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                    by_column_range implementation
+// -----------------------------------------------------------------------------
+
+DEFINE_FILTER_TYPE(by_column_range);
+DEFINE_FACTORY_DEFAULT(by_column_range);
+
+by_column_range::by_column_range() NOEXCEPT
+  : filter(by_column_range::type()) {
+}
+
+bool by_column_range::equals(const filter& rhs) const {
+  const auto& trhs = static_cast<const by_column_range&>(rhs);
+
+  return filter::equals(rhs)
+    && field_ == trhs.field_
+    && min_ == trhs.min_
+    && max_ == trhs.max_;
+}
+
+size_t by_column_range::hash() const {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, filter::hash());
+  ::boost::hash_combine(seed, field_);
+  ::boost::hash_combine(seed, min_);
+  ::boost::hash_combine(seed, max_);
+  return seed;
+}
+
+filter::prepared::ptr by_column_range::prepare(
+    const index_reader& reader,
+    const order::prepared& order,
+    boost_t filter_boost
+) const {
+  attribute_store attrs;
+
+  // skip filed-level/term-level statistics because there are no fields/terms
+  order.prepare_stats().finish(attrs, reader);
+
+  irs::boost::apply(attrs, boost() * filter_boost); // apply boost
+
+  return filter::prepared::make<column_range_query>(
+    field_, min_, max_, std::move(attrs)
+  );
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
@@ -0,0 +1,102 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_COLUMN_RANGE_FILTER_H
+#define IRESEARCH_COLUMN_RANGE_FILTER_H
+
+#include "filter.hpp"
+#include "utils/string.hpp"
+
+#include <limits>
+
+NS_ROOT
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class by_column_range
+/// @brief user-side filter matching documents having a value of the column
+///        written with 'write_zvlong(...)' within the inclusive range
+///        [min, max], column blocks are skipped based on their summaries
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API by_column_range final : public filter {
+ public:
+  DECLARE_FILTER_TYPE();
+  DECLARE_FACTORY_DEFAULT();
+
+  by_column_range() NOEXCEPT;
+
+  by_column_range& field(const std::string& field) {
+    field_ = field;
+    return *this;
+  }
+
+  by_column_range& field(std::string&& field) NOEXCEPT {
+    field_ = std::move(field);
+    return *this;
+  }
+
+  const std::string& field() const NOEXCEPT {
+    return field_;
+  }
+
+  by_column_range& (min)(int64_t value) NOEXCEPT {
+    min_ = value;
+    return *this;
+  }
+
+  int64_t (min)() const NOEXCEPT {
+    return min_;
+  }
+
+  by_column_range& (max)(int64_t value) NOEXCEPT {
+    max_ = value;
+    return *this;
+  }
+
+  int64_t (max)() const NOEXCEPT {
+    return max_;
+  }
+
+  using filter::prepare;
+
+  virtual filter::prepared::ptr prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost
+  ) const override;
+
+  virtual size_t hash() const override;
+
+ protected:
+  virtual bool equals(const filter& rhs) const override;
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::string field_;
+  int64_t min_{ (std::numeric_limits<int64_t>::min)() };
+  int64_t max_{ (std::numeric_limits<int64_t>::max)() };
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // by_column_range
+
+NS_END // ROOT
+
+#endif // IRESEARCH_COLUMN_RANGE_FILTER_H
@@ -0,0 +1,509 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "bitset_doc_iterator.hpp"
+#include "score_doc_iterators.hpp"
+#include "utils/thread_utils.hpp"
+#include "utils/type_limits.hpp"
+
+#include "filter_cache.hpp"
+
+#include <boost/functional/hash.hpp>
+
+NS_LOCAL
+
+const size_t INVALID_SEGMENT = irs::integer_traits<size_t>::const_max;
+
+size_t bitset_bytes(const irs::bitset& docs) NOEXCEPT {
+  return docs.words()*sizeof(irs::bitset::word_t);
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class bitset_iterator
+/// @brief iterator over the cached documents of a filter, documents have the
+///        default score of the specified order
+////////////////////////////////////////////////////////////////////////////////
+class bitset_iterator final : public irs::doc_iterator_base {
+ public:
+  bitset_iterator(
+      std::shared_ptr<const irs::bitset>&& docs,
+      const irs::order::prepared& ord)
+    : doc_iterator_base(ord),
+      docs_(std::move(docs)),
+      it_(*docs_) {
+    estimate(irs::cost::extract(it_.attributes()));
+
+    prepare_score([this](irs::byte_type* score) {
+      ord_->prepare_score(score);
+    });
+  }
+
+  virtual irs::doc_id_t value() const NOEXCEPT override {
+    return it_.value();
+  }
+
+  virtual bool next() NOEXCEPT override {
+    return it_.next();
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) NOEXCEPT override {
+    return it_.seek(target);
+  }
+
+ private:
+  std::shared_ptr<const irs::bitset> docs_; // the cache may drop the documents
+  irs::bitset_doc_iterator it_;
+}; // bitset_iterator
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class unscored_iterator
+/// @brief wraps an iterator of a filter prepared without scoring, documents
+///        have the default score of the specified order
+////////////////////////////////////////////////////////////////////////////////
+class unscored_iterator final : public irs::doc_iterator_base {
+ public:
+  unscored_iterator(
+      irs::doc_iterator::ptr&& it,
+      const irs::order::prepared& ord)
+    : doc_iterator_base(ord),
+      it_(std::move(it)) {
+    assert(it_);
+    estimate(irs::cost::extract(it_->attributes()));
+
+    prepare_score([this](irs::byte_type* score) {
+      ord_->prepare_score(score);
+    });
+  }
+
+  virtual irs::doc_id_t value() const override {
+    return it_->value();
+  }
+
+  virtual bool next() override {
+    return it_->next();
+  }
+
+  virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+    return it_->seek(target);
+  }
+
+ private:
+  irs::doc_iterator::ptr it_;
+}; // unscored_iterator
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      cached_query
+// -----------------------------------------------------------------------------
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class cached_query
+/// @brief filter prepared through a filter_cache, serves the cached documents
+///        of a segment if any, otherwise executes the cached prepared filter
+////////////////////////////////////////////////////////////////////////////////
+class filter_cache::cached_query final : public filter::prepared {
+ public:
+  cached_query(
+      filter_cache::ptr&& cache,
+      entry_ptr&& entry,
+      filter::prepared::ptr&& query,
+      size_t generation) NOEXCEPT
+    : cache_(std::move(cache)),
+      entry_(std::move(entry)),
+      query_(std::move(query)),
+      generation_(generation) {
+  }
+
+  virtual doc_iterator::ptr execute(
+      const sub_reader& segment,
+      const order::prepared& ord) const override {
+    auto docs = entry_
+      ? cache_->docs(*entry_, generation_, segment, *query_)
+      : docs_ptr();
+
+    if (docs) {
+      return doc_iterator::make<bitset_iterator>(std::move(docs), ord);
+    }
+
+    auto it = query_->execute(segment);
+
+    if (ord.empty()) {
+      return it;
+    }
+
+    return doc_iterator::make<unscored_iterator>(std::move(it), ord);
+  }
+
+ private:
+  filter_cache::ptr cache_;
+  entry_ptr entry_; // null if the query isn't cached
+  filter::prepared::ptr query_; // prepared without scoring
+  size_t generation_; // generation of the cache the query was prepared for
+}; // cached_query
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                      filter_cache
+// -----------------------------------------------------------------------------
+
+/*static*/ filter_cache::ptr filter_cache::make() {
+  return make(options());
+}
+
+/*static*/ filter_cache::ptr filter_cache::make(const options& opts) {
+  return ptr(new filter_cache(opts));
+}
+
+filter_cache::filter_cache(const options& opts)
+  : opts_(opts) {
+}
+
+filter::prepared::ptr filter_cache::prepare(
+    const std::shared_ptr<const irs::filter>& filter,
+    const index_reader& rdr) {
+  if (!filter) {
+    return filter::prepared::empty();
+  }
+
+  filter::prepared::ptr query;
+  size_t generation;
+  auto cached = acquire(filter, rdr, query, generation);
+
+  if (!query) {
+    // prepare outside the lock, concurrent callers may prepare the same filter
+    query = filter->prepare(rdr);
+
+    if (cached) {
+      SCOPED_LOCK(mutex_);
+
+      if (generation == generation_) {
+        if (cached->query) {
+          query = cached->query;
+        } else {
+          cached->query = query;
+        }
+      }
+    }
+  }
+
+  return filter::prepared::make<cached_query>(
+    shared_from_this(), std::move(cached), std::move(query), generation
+  );
+}
+
+filter_cache::entry_ptr filter_cache::acquire(
+    const std::shared_ptr<const irs::filter>& filter,
+    const index_reader& rdr,
+    filter::prepared::ptr& query,
+    size_t& generation) {
+  SCOPED_LOCK(mutex_);
+
+  generation = generation_;
+
+  if (!same_reader(rdr)) {
+    auto* reader = dynamic_cast<const directory_reader*>(&rdr);
+
+    if (!reader) {
+      // prepared filters are cached for directory readers only
+      return nullptr;
+    }
+
+    rebind(*reader);
+    generation = generation_;
+  }
+
+  const size_t hash = filter->hash();
+
+  for (auto range = index_.equal_range(hash); range.first != range.second; ++range.first) {
+    auto& itr = range.first->second;
+    auto& cached = *itr;
+
+    if (*cached->filter == *filter) {
+      entries_.splice(entries_.begin(), entries_, itr); // mark as recently used
+      ++cached->hits;
+      query = cached->query;
+      return cached;
+    }
+  }
+
+  auto cached = std::make_shared<entry>(filter, hash);
+  cached->docs.resize(segments_.size());
+  cached->hits = 1;
+  entries_.emplace_front(cached);
+  index_.emplace(hash, entries_.begin());
+
+  // evict least recently used filters
+  while (entries_.size() > opts_.max_filters) {
+    const auto last = std::prev(entries_.end());
+    auto& evicted = **last;
+
+    for (auto range = index_.equal_range(evicted.hash); range.first != range.second; ++range.first) {
+      if (range.first->second == last) {
+        index_.erase(range.first);
+        break;
+      }
+    }
+
+    docs_bytes_ -= drop_docs(evicted);
+    evicted.docs.clear(); // in-flight queries must not cache documents
+    entries_.pop_back();
+  }
+
+  return cached;
+}
+
+filter_cache::docs_ptr filter_cache::docs(
+    entry& e,
+    size_t generation,
+    const sub_reader& segment,
+    const filter::prepared& query) {
+  size_t idx;
+
+  {
+    SCOPED_LOCK(mutex_);
+
+    if (generation != generation_) {
+      // query was prepared for a different reader
+      return nullptr;
+    }
+
+    const auto itr = segments_.find(&segment);
+
+    if (itr == segments_.end() || itr->second >= e.docs.size()) {
+      return nullptr;
+    }
+
+    idx = itr->second;
+
+    if (e.docs[idx]) {
+      return e.docs[idx];
+    }
+
+    if (!opts_.docs_min_hits || e.hits < opts_.docs_min_hits) {
+      return nullptr;
+    }
+  }
+
+  // collect documents outside the lock
+  auto docs = std::make_shared<bitset>(
+    segment.docs_count() + type_limits<type_t::doc_id_t>::min()
+  );
+
+  for (auto it = query.execute(segment); it->next();) {
+    docs->set(it->value());
+  }
+
+  const size_t bytes = bitset_bytes(*docs);
+
+  SCOPED_LOCK(mutex_);
+
+  if (generation != generation_ || idx >= e.docs.size() || bytes > opts_.max_docs_bytes) {
+    return docs; // not cached but still valid for the query
+  }
+
+  auto& cached = e.docs[idx];
+
+  if (!cached) {
+    cached = docs;
+    docs_bytes_ += bytes;
+    evict_docs();
+  }
+
+  return docs;
+}
+
+bool filter_cache::same_reader(const index_reader& rdr) const {
+  if (!reader_) {
+    return false;
+  }
+
+  if (rdr.size() != reader_.size()) {
+    return false;
+  }
+
+  // 'reader_' keeps its segments alive, i.e. addresses can't be reused
+  size_t i = 0;
+
+  for (auto& segment : rdr) {
+    if (&segment != &reader_[i++]) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+void filter_cache::rebind(const directory_reader& reader) {
+  const size_t size = reader.size();
+
+  // find cached segments which are still present and unchanged in 'reader'
+  std::vector<size_t> remap(size, INVALID_SEGMENT);
+
+  if (reader_) {
+    for (size_t i = 0; i < size; ++i) {
+      auto* segment = dynamic_cast<const segment_reader*>(&reader[i]);
+
+      if (!segment) {
+        continue;
+      }
+
+      for (size_t j = 0, count = reader_.size(); j < count; ++j) {
+        auto* cached = dynamic_cast<const segment_reader*>(&reader_[j]);
+
+        if (cached && *segment == *cached) {
+          remap[i] = j;
+          break;
+        }
+      }
+    }
+  }
+
+  for (auto& cached : entries_) {
+    std::vector<docs_ptr> docs(size);
+
+    for (size_t i = 0; i < size; ++i) {
+      if (INVALID_SEGMENT != remap[i]) {
+        docs[i] = std::move(cached->docs[remap[i]]);
+      }
+    }
+
+    docs_bytes_ -= drop_docs(*cached); // documents of removed/changed segments
+    cached->docs = std::move(docs);
+    cached->query.reset(); // prepared for the previous reader
+  }
+
+  reader_ = reader;
+  segments_.clear();
+
+  for (size_t i = 0; i < size; ++i) {
+    segments_.emplace(&reader_[i], i);
+  }
+
+  ++generation_;
+}
+
+void filter_cache::evict_docs() NOEXCEPT {
+  // drop documents of the least recently used filters first
+  for (auto itr = entries_.rbegin(), end = entries_.rend();
+       docs_bytes_ > opts_.max_docs_bytes && itr != end;
+       ++itr) {
+    docs_bytes_ -= drop_docs(**itr);
+  }
+}
+
+size_t filter_cache::drop_docs(entry& e) NOEXCEPT {
+  size_t bytes = 0;
+
+  for (auto& docs : e.docs) {
+    if (docs) {
+      bytes += bitset_bytes(*docs);
+      docs.reset();
+    }
+  }
+
+  return bytes;
+}
+
+void filter_cache::reset(const directory_reader& reader) {
+  SCOPED_LOCK(mutex_);
+
+  if (!same_reader(reader)) {
+    rebind(reader);
+  }
+}
+
+void filter_cache::clear() {
+  SCOPED_LOCK(mutex_);
+
+  for (auto& cached : entries_) {
+    cached->docs.clear(); // in-flight queries must not cache documents
+  }
+
+  entries_.clear();
+  index_.clear();
+  docs_bytes_ = 0;
+  segments_.clear();
+  reader_.reset();
+  ++generation_;
+}
+
+size_t filter_cache::size() const {
+  SCOPED_LOCK(mutex_);
+  return entries_.size();
+}
+
+size_t filter_cache::docs_bytes() const {
+  SCOPED_LOCK(mutex_);
+  return docs_bytes_;
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                     cached_filter
+// -----------------------------------------------------------------------------
+
+DEFINE_FILTER_TYPE(cached_filter);
+DEFINE_FACTORY_DEFAULT(cached_filter);
+
+cached_filter::cached_filter() NOEXCEPT
+  : irs::filter(cached_filter::type()) {
+}
+
+filter::prepared::ptr cached_filter::prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t boost) const {
+  if (!filter_) {
+    return prepared::empty();
+  }
+
+  if (!cache_) {
+    // nothing to cache in, prepare the wrapped filter as is
+    return filter_->prepare(rdr, ord, this->boost()*boost);
+  }
+
+  return cache_->prepare(filter_, rdr);
+}
+
+size_t cached_filter::hash() const {
+  size_t seed = 0;
+  ::boost::hash_combine(seed, filter::hash());
+  if (filter_) {
+    ::boost::hash_combine<const irs::filter&>(seed, *filter_);
+  }
+  return seed;
+}
+
+bool cached_filter::equals(const irs::filter& rhs) const {
+  const cached_filter& typed_rhs = static_cast<const cached_filter&>(rhs);
+  return filter::equals(rhs)
+    && ((!empty() && !typed_rhs.empty() && *filter_ == *typed_rhs.filter_)
+       || (empty() && typed_rhs.empty()));
+}
+
+NS_END // ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                       END-OF-FILE
+// -----------------------------------------------------------------------------
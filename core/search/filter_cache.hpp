@@ -0,0 +1,220 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_FILTER_CACHE_H
+#define IRESEARCH_FILTER_CACHE_H
+
+#include "filter.hpp"
+#include "index/directory_reader.hpp"
+#include "index/segment_reader.hpp"
+#include "utils/bitset.hpp"
+#include "utils/noncopyable.hpp"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class filter_cache
+/// @brief a size bounded cache of the filters prepared against a particular
+///        directory_reader, filters are matched via filter::hash() and
+///        filter::operator==(...), the cached filters are always prepared
+///        without scoring, i.e. for the restriction clauses of the queries
+///        in addition the documents matched by a frequently used filter are
+///        cached per segment as a bitset
+/// @note the cache follows the reader passed to prepare(...), on
+///       directory_reader::reopen(...) the prepared filters are dropped while
+///       the cached documents are kept for the unchanged segments only
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API filter_cache
+    : public std::enable_shared_from_this<filter_cache>,
+      private util::noncopyable {
+ public:
+  DECLARE_SPTR(filter_cache);
+
+  struct options {
+    // max number of the cached filters
+    size_t max_filters = 64;
+
+    // max memory used by the cached documents of all filters (in bytes)
+    size_t max_docs_bytes = 64*1024*1024;
+
+    // number of prepare(...) calls of a filter before its documents
+    // are cached, 0 - never cache documents
+    size_t docs_min_hits = 2;
+  };
+
+  static ptr make();
+  static ptr make(const options& opts);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief prepares the specified filter without scoring or returns the one
+  ///        prepared earlier for an equal filter and the same reader
+  /// @note the filter is shared with the cache and must not be modified
+  ///       afterwards, readers other than directory_reader are not cached
+  //////////////////////////////////////////////////////////////////////////////
+  filter::prepared::ptr prepare(
+    const std::shared_ptr<const irs::filter>& filter,
+    const index_reader& rdr
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief rebinds the cache to the specified reader, e.g. a result of
+  ///        directory_reader::reopen(...) to release the segments of the
+  ///        previous reader before the next prepare(...)
+  //////////////////////////////////////////////////////////////////////////////
+  void reset(const directory_reader& reader);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief drops all cached filters and documents
+  //////////////////////////////////////////////////////////////////////////////
+  void clear();
+
+  // number of the cached filters
+  size_t size() const;
+
+  // memory used by the cached documents (in bytes)
+  size_t docs_bytes() const;
+
+ private:
+  class cached_query;
+
+  typedef std::shared_ptr<const bitset> docs_ptr;
+
+  struct entry {
+    entry(const std::shared_ptr<const irs::filter>& filter, size_t hash)
+      : filter(filter), hash(hash) {
+    }
+
+    std::shared_ptr<const irs::filter> filter;
+    size_t hash; // filter::hash()
+    filter::prepared::ptr query; // prepared against 'reader_' without scoring
+    std::vector<docs_ptr> docs; // per segment of 'reader_', null if not cached
+    size_t hits{}; // number of prepare(...) calls
+  }; // entry
+
+  typedef std::shared_ptr<entry> entry_ptr;
+  typedef std::list<entry_ptr> entries_t; // most recently used first
+
+  explicit filter_cache(const options& opts);
+
+  entry_ptr acquire(
+    const std::shared_ptr<const irs::filter>& filter,
+    const index_reader& rdr,
+    filter::prepared::ptr& query,
+    size_t& generation
+  );
+  docs_ptr docs(
+    entry& e,
+    size_t generation,
+    const sub_reader& segment,
+    const filter::prepared& query
+  );
+  bool same_reader(const index_reader& rdr) const;
+  void rebind(const directory_reader& reader);
+  void evict_docs() NOEXCEPT;
+  size_t drop_docs(entry& e) NOEXCEPT;
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  options opts_;
+  mutable std::mutex mutex_;
+  directory_reader reader_; // keeps the segments of the cached data alive
+  std::unordered_map<const sub_reader*, size_t> segments_; // segment -> index
+  size_t generation_{}; // incremented on every rebind
+  entries_t entries_;
+  std::unordered_multimap<size_t, entries_t::iterator> index_; // by hash
+  size_t docs_bytes_{};
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // filter_cache
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class cached_filter
+/// @brief user-side filter preparing the wrapped filter through a
+///        filter_cache, the wrapped filter doesn't contribute to the score,
+///        e.g. by_term on a tenant or a type field inside an And
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API cached_filter : public filter {
+ public:
+  DECLARE_FILTER_TYPE();
+  DECLARE_FACTORY_DEFAULT();
+
+  cached_filter() NOEXCEPT;
+
+  const filter_cache::ptr& cache() const NOEXCEPT { return cache_; }
+
+  cached_filter& cache(const filter_cache::ptr& cache) {
+    cache_ = cache;
+    return *this;
+  }
+
+  const iresearch::filter* filter() const NOEXCEPT {
+    return filter_.get();
+  }
+
+  cached_filter& filter(const std::shared_ptr<const iresearch::filter>& filter) {
+    filter_ = filter;
+    return *this;
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @note the returned filter must not be modified after the first prepare
+  //////////////////////////////////////////////////////////////////////////////
+  template<typename T>
+  T& filter() {
+    typedef typename std::enable_if <
+      std::is_base_of<iresearch::filter, T>::value, T
+    >::type type;
+
+    std::shared_ptr<iresearch::filter> filter = type::make();
+    filter_ = filter;
+    return static_cast<type&>(*filter);
+  }
+
+  void clear() { filter_.reset(); }
+  bool empty() const { return nullptr == filter_; }
+
+  using filter::prepare;
+
+  virtual filter::prepared::ptr prepare(
+    const index_reader& rdr,
+    const order::prepared& ord,
+    boost_t
+  ) const override;
+
+  virtual size_t hash() const override;
+
+ protected:
+  virtual bool equals(const iresearch::filter& rhs) const override;
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  filter_cache::ptr cache_;
+  std::shared_ptr<const iresearch::filter> filter_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // cached_filter
+
+NS_END // ROOT
+
+#endif
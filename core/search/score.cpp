@@ -46,4 +46,24 @@ score::score() NOEXCEPT
   : func_([](byte_type*){}) {
 }
 
+// ----------------------------------------------------------------------------
+// --SECTION--                                                      score_bound
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_bound);
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                                  score_threshold
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_threshold);
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                                      score_block
+// ----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(iresearch::score_block);
+
+/*static*/ const size_t score_block::SIZE;
+
 NS_END // ROOT
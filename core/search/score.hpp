@@ -29,6 +29,8 @@
 
 NS_ROOT
 
+struct doc_iterator;
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class score
 /// @brief represents a score related for the particular document
@@ -88,6 +90,73 @@ class IRESEARCH_API score : public attribute {
   IRESEARCH_API_PRIVATE_VARIABLES_END
 }; // score
 
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_bound
+/// @brief upper bounds of the document scores of an iterator, i.e. the scores
+///        which no document of the iterator (or of a block) precedes
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API score_bound : attribute {
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves to the block containing the first document not less than
+  ///        'target' without changing the position of the iterator, must be
+  ///        called with non-decreasing targets
+  /// @param score [out] bound of the scores within the block
+  /// @returns the last document of the block, eof() for the last block
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<doc_id_t(doc_id_t target, byte_type* score)> shallow_seek_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_bound() = default;
+
+  bstring value; // bound of the scores of all documents
+  shallow_seek_f shallow_seek;
+}; // score_bound
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_threshold
+/// @brief the score set by a consumer collecting the top documents, e.g. the
+///        score of the k-th best document collected so far, the iterator may
+///        skip the documents with the scores following the threshold,
+///        the threshold may only become stricter, empty value means no
+///        threshold
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API score_threshold : attribute {
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_threshold() = default;
+
+  bstring value;
+}; // score_threshold
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class score_block
+/// @brief advances an iterator through a block of documents and scores all
+///        of them in a single call instead of score::evaluate() per document
+/// @note the iterators exposing the attributes of another one, e.g. exclusion
+///       or a segment mask, produce a subset of its documents, hence the block
+///       must be used only with the iterator it belongs to, see 'owner'
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API score_block : attribute {
+  static const size_t SIZE = 128; // max number of documents in a block
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief moves the iterator by up to 'count' (at most SIZE) documents
+  /// @param docs [out] ids of the documents
+  /// @param scores [out] scores of the documents, order::prepared::size()
+  ///                     bytes per document
+  /// @returns number of documents, 0 if there are no more documents
+  //////////////////////////////////////////////////////////////////////////////
+  typedef std::function<size_t(doc_id_t* docs, byte_type* scores, size_t count)> next_f;
+
+  DECLARE_ATTRIBUTE_TYPE();
+
+  score_block() = default;
+
+  next_f next;
+  const doc_iterator* owner{}; // iterator advanced by 'next'
+}; // score_block
+
 NS_END // ROOT
 
 #endif // IRESEARCH_SCORE_H
@@ -60,6 +60,73 @@ basic_doc_iterator::basic_doc_iterator(
   prepare_score([this](byte_type* score) {
     scorers_.score(*ord_, score);
   });
+
+  // set score bounds if the postings provide frequency bounds
+  const block_max* max = it_->attributes().get<block_max>().get();
+
+  if (max && !ord_->empty()) {
+    bound_.value.resize(ord_->size());
+
+    if (scorers_.bound(*ord_, &bound_.value[0], max->max_freq)) {
+      bound_.shallow_seek = [this, max](doc_id_t target, byte_type* score) {
+        uint64_t max_freq;
+        const auto doc = max->shallow_seek(target, max_freq);
+
+        if (!scorers_.bound(*ord_, score, max_freq)) {
+          std::memcpy(score, bound_.value.c_str(), bound_.value.size());
+        }
+
+        return doc;
+      };
+
+      attrs_.emplace(bound_);
+    }
+  }
+
+  // score the blocks of documents at once if all of the scorers support it
+  const frequency* freq = it_->attributes().get<frequency>().get();
+
+  if (freq && !ord_->empty()
+      && scorers_.score_block(*ord_, nullptr, nullptr, 0, nullptr)) {
+    const doc_block* docs_block = it_->attributes().get<doc_block>().get();
+
+    if (docs_block) {
+      // documents and frequencies are taken from the decoded postings block
+      block_.next = [this, docs_block](
+          doc_id_t* docs, byte_type* scores, size_t count) {
+        const doc_id_t* block_docs;
+        const uint64_t* block_freqs;
+        const size_t size = docs_block->next(
+          std::min(count, score_block::SIZE), block_docs, block_freqs
+        );
+
+        assert(!size || block_freqs);
+        std::memcpy(docs, block_docs, size*sizeof(doc_id_t));
+        scorers_.score_block(*ord_, docs, block_freqs, size, scores);
+
+        return size;
+      };
+    } else {
+      freqs_.resize(score_block::SIZE);
+
+      block_.next = [this, freq](doc_id_t* docs, byte_type* scores, size_t count) {
+        count = std::min(count, freqs_.size());
+        size_t size = 0;
+
+        for (; size < count && it_->next(); ++size) {
+          docs[size] = it_->value();
+          freqs_[size] = freq->value;
+        }
+
+        scorers_.score_block(*ord_, docs, freqs_.data(), size, scores);
+
+        return size;
+      };
+    }
+
+    block_.owner = this;
+    attrs_.emplace(block_);
+  }
 }
 
 #if defined(_MSC_VER)
@@ -95,6 +95,9 @@ class basic_doc_iterator final : public doc_iterator_base {
   order::prepared::scorers scorers_;
   doc_iterator::ptr it_;
   const attribute_store* stats_;
+  score_bound bound_;
+  score_block block_;
+  std::vector<uint64_t> freqs_; // frequencies of the current block
 }; // basic_doc_iterator
 
 NS_END // ROOT
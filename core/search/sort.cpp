@@ -51,6 +51,15 @@ sort::collector::~collector() { }
 
 sort::scorer::~scorer() { }
 
+bool sort::scorer::bound(byte_type*, uint64_t) const {
+  return false; // scores are not bounded by default
+}
+
+bool sort::scorer::score_block(
+    const doc_id_t*, const uint64_t*, size_t, byte_type*, size_t) {
+  return false; // documents are scored one by one by default
+}
+
 sort::prepared::prepared(attribute_view&& attrs): attrs_(std::move(attrs)) {
 }
 
@@ -219,6 +228,55 @@ void order::prepared::scorers::score(
   });
 }
 
+bool order::prepared::scorers::bound(
+    const order::prepared& ord, byte_type* scr, uint64_t max_freq
+) const {
+  // buckets without a scorer keep the prepared score for every document
+  ord.prepare_score(scr);
+
+  size_t i = 0;
+  for (auto& scorer : scorers_) {
+    if (scorer && !scorer->bound(scr, max_freq)) {
+      return false;
+    }
+
+    scr += ord[i++].bucket->size();
+  }
+
+  return true;
+}
+
+bool order::prepared::scorers::score_block(
+    const order::prepared& ord,
+    const doc_id_t* docs,
+    const uint64_t* freqs,
+    size_t count,
+    byte_type* scores
+) const {
+  const auto stride = ord.size();
+  size_t i = 0;
+
+  for (auto& scorer : scorers_) {
+    auto& sort = ord[i++];
+    auto* score = scores + sort.offset;
+
+    if (scorer) {
+      if (!scorer->score_block(docs, freqs, count, score, stride)) {
+        return false;
+      }
+
+      continue;
+    }
+
+    // buckets without a scorer keep the prepared score for every document
+    for (auto* end = score + count*stride; score != end; score += stride) {
+      sort.bucket->prepare_score(score);
+    }
+  }
+
+  return true;
+}
+
 order::prepared::prepared() : size_(0) { }
 
 order::prepared::stats 
@@ -29,6 +29,8 @@
 #include "utils/attributes_provider.hpp"
 #include "utils/iterator.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 NS_ROOT
@@ -135,6 +137,30 @@ class IRESEARCH_API sort {
     /// @brief set the document score based on the stored state
     ////////////////////////////////////////////////////////////////////////////////
     virtual void score(byte_type* score_buf) = 0;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set the best score of a document with the term frequency not
+    ///        exceeding 'max_freq', i.e. the score which no such document
+    ///        precedes in the order of the sort
+    /// @returns false if the scores can't be bounded, e.g. for ascending order
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual bool bound(byte_type* score_buf, uint64_t max_freq) const;
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set the scores of a block of documents in a single call, the
+    ///        score of the i'th document is set to 'score_buf + i*stride'
+    /// @param docs ascending documents preceding or equal to the current one
+    /// @param freqs term frequencies of the documents
+    /// @returns false if the scorer can score only the current document, i.e.
+    ///          a call with 'count' == 0 tells if block scoring is supported
+    ////////////////////////////////////////////////////////////////////////////////
+    virtual bool score_block(
+      const doc_id_t* docs,
+      const uint64_t* freqs,
+      size_t count,
+      byte_type* score_buf,
+      size_t stride
+    );
   }; // scorer
 
   template <typename T>
@@ -142,9 +168,39 @@ class IRESEARCH_API sort {
    public:
     typedef T score_t;
 
+    static const size_t CHUNK_SIZE = 64;
+
     FORCE_INLINE static T& score_cast(byte_type* score_buf) {
       return *reinterpret_cast<T*>(score_buf);
     }
+
+    ////////////////////////////////////////////////////////////////////////////////
+    /// @brief set the scores of 'count' documents located 'stride' bytes apart,
+    ///        'func(values, offset, size)' computes the scores of the documents
+    ///        [offset, offset + size) into a contiguous array 'values', which
+    ///        lets the compiler vectorize the computation
+    ////////////////////////////////////////////////////////////////////////////////
+    template<typename Func>
+    static void score_chunks(
+        size_t count, byte_type* score_buf, size_t stride, const Func& func) {
+      T values[CHUNK_SIZE];
+
+      for (size_t offset = 0; offset < count; offset += CHUNK_SIZE) {
+        const size_t size = std::min(size_t(CHUNK_SIZE), count - offset);
+
+        func(values, offset, size);
+
+        if (sizeof(T) == stride) {
+          std::memcpy(score_buf, values, size*sizeof(T));
+          score_buf += size*sizeof(T);
+          continue;
+        }
+
+        for (size_t i = 0; i < size; ++i, score_buf += stride) {
+          score_cast(score_buf) = values[i];
+        }
+      }
+    }
   }; // scorer_base
 
   ////////////////////////////////////////////////////////////////////////////////
@@ -373,6 +429,28 @@ public:
 
       void score(const prepared& ord, byte_type* score) const;
 
+      ////////////////////////////////////////////////////////////////////////////////
+      /// @brief set the best score of a document with the term frequency not
+      ///        exceeding 'max_freq'
+      /// @returns false if any of the scorers can't bound its scores
+      ////////////////////////////////////////////////////////////////////////////////
+      bool bound(
+        const prepared& ord, byte_type* score, uint64_t max_freq
+      ) const;
+
+      ////////////////////////////////////////////////////////////////////////////////
+      /// @brief set the scores of a block of documents, every score occupies
+      ///        'ord.size()' bytes of 'scores'
+      /// @returns false if any of the scorers doesn't support block scoring
+      ////////////////////////////////////////////////////////////////////////////////
+      bool score_block(
+        const prepared& ord,
+        const doc_id_t* docs,
+        const uint64_t* freqs,
+        size_t count,
+        byte_type* scores
+      ) const;
+
      private:
       IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
       scorers_t scorers_;
@@ -27,6 +27,7 @@
 #include "analysis/token_attributes.hpp"
 #include "index/index_reader.hpp"
 #include "index/field_meta.hpp"
+#include "utils/math_utils.hpp"
 
 NS_ROOT
 NS_BEGIN(tfidf)
@@ -37,12 +38,14 @@ const frequency EMPTY_FREQ;
 const flags& features(bool normalize) {
   if (normalize) {
     // set of features required for tf-idf model without normalization
-    static const flags FEATURES{ frequency::type() };
+    static const flags FEATURES{ frequency::type(), block_max::type(), doc_block::type() };
     return FEATURES;
   }
 
   // set of features required for tf-idf model with normalization
-  static const flags NORM_FEATURES{ frequency::type(), norm::type() };
+  static const flags NORM_FEATURES{
+    frequency::type(), norm::type(), block_max::type(), doc_block::type()
+  };
   return NORM_FEATURES;
 }
 
@@ -104,9 +107,11 @@ class scorer : public iresearch::sort::scorer_base<tfidf::score_t> {
   scorer(
       iresearch::boost::boost_t boost,
       const tfidf::idf* idf,
-      const frequency* freq)
+      const frequency* freq,
+      bool reverse)
     : idf_(boost * (idf ? idf->value : 1.f)), 
-      freq_(freq ? freq : &EMPTY_FREQ) {
+      freq_(freq ? freq : &EMPTY_FREQ),
+      reverse_(reverse) {
     assert(freq_);
   }
 
@@ -114,14 +119,54 @@ class scorer : public iresearch::sort::scorer_base<tfidf::score_t> {
     score_cast(score_buf) = tfidf();
   }
 
+  virtual bool score_block(
+      const doc_id_t* docs,
+      const uint64_t* freqs,
+      size_t count,
+      byte_type* score_buf,
+      size_t stride) override {
+    UNUSED(docs);
+
+    score_chunks(count, score_buf, stride,
+                 [this, freqs](score_t* values, size_t offset, size_t size) {
+      tfidf(freqs + offset, size, values);
+    });
+
+    return true;
+  }
+
+  // the score grows with the frequency, applicable to the descending order only
+  virtual bool bound(byte_type* score_buf, uint64_t max_freq) const override {
+    if (!reverse_ || idf_ < 0.f) {
+      return false;
+    }
+
+    score_cast(score_buf) = idf_ * sqrt_(max_freq);
+    return true;
+  }
+
  protected:
   FORCE_INLINE float_t tfidf() const {
-   return idf_ * float_t(std::sqrt(freq_->value));
+   return idf_ * sqrt_(freq_->value);
+  }
+
+  FORCE_INLINE void tfidf(const uint64_t* freqs, size_t size, float_t* values) const {
+    for (size_t i = 0; i < size; ++i) {
+      values[i] = sqrt_(freqs[i]);
+    }
+
+    const auto idf = idf_;
+
+    for (size_t i = 0; i < size; ++i) {
+      values[i] *= idf;
+    }
   }
 
  private:
+  math::sqrt_cache sqrt_;
   float_t idf_; // precomputed : boost * idf
   const frequency* freq_;
+  bool reverse_; // the most relevant results first
 }; // scorer
 
 class norm_scorer final : public scorer {
@@ -129,28 +174,49 @@ class norm_scorer final : public scorer {
   DECLARE_FACTORY(norm_scorer);
 
   norm_scorer(
-      const iresearch::norm* norm,
+      iresearch::norm&& norm,
       iresearch::boost::boost_t boost,
       const tfidf::idf* idf,
       const frequency* freq)
-    : scorer(boost, idf, freq),
-      norm_(norm) {
-    assert(norm_);
+    : scorer(boost, idf, freq, false), // norm values aren't bounded
+      norm_(std::move(norm)) {
   }
 
   virtual void score(byte_type* score_buf) override {
-    score_cast(score_buf) = tfidf() * norm_->read();
+    score_cast(score_buf) = tfidf() * norm_.read();
+  }
+
+  virtual bool score_block(
+      const doc_id_t* docs,
+      const uint64_t* freqs,
+      size_t count,
+      byte_type* score_buf,
+      size_t stride) override {
+    score_chunks(count, score_buf, stride,
+                 [this, docs, freqs](score_t* values, size_t offset, size_t size) {
+      float_t norms[CHUNK_SIZE];
+      norm_.read(docs + offset, size, norms);
+
+      tfidf(freqs + offset, size, values);
+
+      for (size_t i = 0; i < size; ++i) {
+        values[i] *= norms[i];
+      }
+    });
+
+    return true;
   }
 
  private:
-  const iresearch::norm* norm_;
+  iresearch::norm norm_;
 }; // norm_scorer
 
 class sort final: iresearch::sort::prepared_base<tfidf::score_t> {
  public:
   DECLARE_FACTORY(prepared);
 
-  sort(bool normalize, bool reverse): normalize_(normalize) {
+  sort(bool normalize, bool reverse)
+    : normalize_(normalize), reverse_(reverse) {
     static const std::function<bool(score_t, score_t)> greater = std::greater<score_t>();
     static const std::function<bool(score_t, score_t)> less = std::less<score_t>();
     less_ = reverse ? &greater : &less;
@@ -174,11 +240,14 @@ class sort final: iresearch::sort::prepared_base<tfidf::score_t> {
       return nullptr; // if there is no frequency then all the scores will be the same (e.g. filter irs::all)
     }
 
-    auto& norm = query_attrs.get<iresearch::norm>();
+    // every scorer reads the norms on its own since a prepared query may be
+    // executed on several segments concurrently
+    iresearch::norm norm;
 
-    if (norm && norm->reset(segment, field.meta().norm, *doc_attrs.get<document>())) {
+    if (query_attrs.contains<iresearch::norm>()
+        && norm.reset(segment, field.meta().norm, *doc_attrs.get<document>())) {
       return tfidf::scorer::make<tfidf::norm_scorer>(
-        &*norm,
+        std::move(norm),
         boost::extract(query_attrs),
         query_attrs.get<tfidf::idf>().get(),
         doc_attrs.get<frequency>().get()
@@ -188,7 +257,8 @@ class sort final: iresearch::sort::prepared_base<tfidf::score_t> {
     return tfidf::scorer::make<tfidf::scorer>(
       boost::extract(query_attrs),
       query_attrs.get<tfidf::idf>().get(),
-      doc_attrs.get<frequency>().get()
+      doc_attrs.get<frequency>().get(),
+      reverse_
     );
   }
 
@@ -203,6 +273,7 @@ class sort final: iresearch::sort::prepared_base<tfidf::score_t> {
  private:
   const std::function<bool(score_t, score_t)>* less_;
   bool normalize_;
+  bool reverse_;
 }; // sort
 
 NS_END // tfidf 
@@ -0,0 +1,300 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "top_k_collector.hpp"
+#include "score.hpp"
+#include "index/index_reader.hpp"
+#include "utils/async_utils.hpp"
+
+#include <algorithm>
+
+NS_LOCAL
+
+using namespace irs;
+
+// unordered, all scores are equal
+bool less_none(const order::prepared&, const byte_type*, const byte_type*) {
+  return false;
+}
+
+// single sort, compare its scores directly
+bool less_single(
+    const order::prepared& ord,
+    const byte_type* lhs,
+    const byte_type* rhs) {
+  return ord[0].bucket->less(lhs, rhs);
+}
+
+// compound order, compare sort by sort
+bool less_compound(
+    const order::prepared& ord,
+    const byte_type* lhs,
+    const byte_type* rhs) {
+  return ord.less(lhs, rhs);
+}
+
+NS_END // LOCAL
+
+NS_ROOT
+
+top_k_collector::top_k_collector(const order::prepared& ord, size_t k)
+  : ord_(&ord), k_(k) {
+  heap_.reserve(k_);
+
+  switch (std::distance(ord.begin(), ord.end())) {
+    case 0:
+      less_ = &less_none;
+      break;
+    case 1:
+      less_ = &less_single;
+      break;
+    default:
+      less_ = &less_compound;
+  }
+}
+
+top_k_collector::top_k_collector(top_k_collector&& rhs) NOEXCEPT
+  : heap_(std::move(rhs.heap_)),
+    ord_(rhs.ord_),
+    k_(rhs.k_),
+    hits_(rhs.hits_),
+    less_(rhs.less_),
+    pruned_(rhs.pruned_) {
+  rhs.hits_ = 0;
+  rhs.pruned_ = false;
+}
+
+bool top_k_collector::less(
+    const byte_type* score,
+    size_t segment,
+    doc_id_t doc,
+    const entry& rhs) const {
+  if (less_(*ord_, score, rhs.score.c_str())) {
+    return true;
+  }
+
+  if (less_(*ord_, rhs.score.c_str(), score)) {
+    return false;
+  }
+
+  return segment < rhs.segment || (segment == rhs.segment && doc < rhs.doc);
+}
+
+void top_k_collector::push(entry&& value) {
+  assert(heap_.size() < k_);
+
+  const auto less = [this](const entry& lhs, const entry& rhs) {
+    return this->less(lhs.score.c_str(), lhs.segment, lhs.doc, rhs);
+  };
+
+  heap_.emplace_back(std::move(value));
+  std::push_heap(heap_.begin(), heap_.end(), less);
+}
+
+void top_k_collector::replace_top(
+    const bytes_ref& score,
+    size_t segment,
+    doc_id_t doc) {
+  assert(!heap_.empty());
+
+  const auto less = [this](const entry& lhs, const entry& rhs) {
+    return this->less(lhs.score.c_str(), lhs.segment, lhs.doc, rhs);
+  };
+
+  // reuse the buffer of the evicted entry
+  std::pop_heap(heap_.begin(), heap_.end(), less);
+  auto& top = heap_.back();
+  top.score.assign(score.c_str(), score.size());
+  top.segment = segment;
+  top.doc = doc;
+  std::push_heap(heap_.begin(), heap_.end(), less);
+}
+
+bool top_k_collector::collect(
+    const byte_type* score,
+    size_t segment,
+    doc_id_t doc) {
+  if (heap_.size() < k_) {
+    push(entry{ bstring(score, ord_->size()), segment, doc });
+  } else if (less(score, segment, doc, heap_.front())) {
+    replace_top(bytes_ref(score, ord_->size()), segment, doc);
+  } else {
+    return false;
+  }
+
+  return true;
+}
+
+void top_k_collector::collect(size_t segment, doc_iterator& docs) {
+  auto& attrs = docs.attributes();
+  auto* block = attrs.get<score_block>().get();
+
+  if (block && block->owner == &docs && k_) {
+    // the documents are scored a block at a time, a segment with deleted
+    // documents wraps the iterator into the mask, i.e. never gets here
+    const auto score_size = ord_->size();
+    doc_id_t ids[score_block::SIZE];
+    bstring scores(score_block::SIZE * score_size, 0);
+
+    for (size_t count; (count = block->next(ids, &scores[0], score_block::SIZE));) {
+      hits_ += count;
+
+      for (size_t i = 0; i < count; ++i) {
+        collect(scores.c_str() + i*score_size, segment, ids[i]);
+      }
+    }
+
+    return;
+  }
+
+  auto& score = irs::score::extract(attrs);
+  auto* threshold = attrs.get<score_threshold>().get();
+  bstring no_score;
+
+  if (score.empty()) {
+    // documents without scores get the default one
+    no_score.resize(ord_->size());
+    ord_->prepare_score(&no_score[0]);
+  }
+
+  // ensure we avoid COW for pre c++11 std::basic_string
+  const bytes_ref value = score.empty()
+    ? bytes_ref(no_score)
+    : bytes_ref(score.value());
+
+  const auto update_threshold = [this, threshold]() {
+    if (threshold && k_ && heap_.size() == k_) {
+      // documents not preceding the worst collected one can be skipped,
+      // the skipped ones aren't counted in 'hits_'
+      threshold->value = heap_.front().score;
+      pruned_ = true;
+    }
+  };
+
+  update_threshold();
+
+  while (docs.next()) {
+    ++hits_;
+
+    if (!k_) {
+      continue;
+    }
+
+    if (!score.empty()) {
+      score.evaluate();
+    }
+
+    if (collect(value.c_str(), segment, docs.value())) {
+      update_threshold();
+    }
+  }
+}
+
+void top_k_collector::collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    async_utils::thread_pool* pool /*= nullptr*/) {
+  std::vector<const sub_reader*> segments;
+  segments.reserve(index.size());
+
+  for (auto& segment : index) {
+    segments.emplace_back(&segment);
+  }
+
+  if (!pool || segments.size() < 2) {
+    // iterators of a segment reuse memory released by the previous one
+    doc_iterator_arena arena;
+    doc_iterator_arena::scope scope(arena);
+
+    for (size_t i = 0, size = segments.size(); i < size; ++i) {
+      auto& segment = *segments[i];
+      auto docs = segment.mask(filter.execute(segment, *ord_));
+      collect(i, *docs);
+    }
+
+    return;
+  }
+
+  // every segment is collected into its own heap, the heaps are merged after
+  std::vector<top_k_collector> collectors;
+  collectors.reserve(segments.size());
+
+  for (size_t i = 0, size = segments.size(); i < size; ++i) {
+    collectors.emplace_back(*ord_, k_);
+  }
+
+  {
+    async_utils::task_group tasks(pool);
+
+    for (size_t i = 0, size = segments.size(); i < size; ++i) {
+      tasks.run([&collectors, &segments, &filter, i]()->void {
+        doc_iterator_arena arena;
+        doc_iterator_arena::scope scope(arena);
+        auto& collector = collectors[i];
+        auto& segment = *segments[i];
+        auto docs = segment.mask(filter.execute(segment, *collector.ord_));
+        collector.collect(i, *docs);
+      });
+    }
+
+    tasks.wait();
+  }
+
+  for (auto& collector : collectors) {
+    merge(std::move(collector));
+  }
+}
+
+void top_k_collector::merge(top_k_collector&& rhs) {
+  assert(ord_ == rhs.ord_ && k_ == rhs.k_);
+  hits_ += rhs.hits_;
+  pruned_ |= rhs.pruned_;
+  rhs.hits_ = 0;
+  rhs.pruned_ = false;
+
+  for (auto& entry : rhs.heap_) {
+    if (heap_.size() < k_) {
+      push(std::move(entry));
+    } else if (less(entry.score.c_str(), entry.segment, entry.doc, heap_.front())) {
+      replace_top(entry.score, entry.segment, entry.doc);
+    }
+  }
+
+  rhs.heap_.clear();
+}
+
+top_k_collector::entries_t top_k_collector::release() {
+  const auto less = [this](const entry& lhs, const entry& rhs) {
+    return this->less(lhs.score.c_str(), lhs.segment, lhs.doc, rhs);
+  };
+
+  std::sort_heap(heap_.begin(), heap_.end(), less);
+
+  entries_t entries;
+  entries.swap(heap_);
+  heap_.reserve(k_);
+
+  return entries;
+}
+
+NS_END // ROOT
@@ -0,0 +1,132 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_TOP_K_COLLECTOR_H
+#define IRESEARCH_TOP_K_COLLECTOR_H
+
+#include "filter.hpp"
+#include "utils/noncopyable.hpp"
+
+NS_ROOT
+
+NS_BEGIN(async_utils)
+class thread_pool;
+NS_END // async_utils
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class top_k_collector
+/// @brief collects 'k' documents with the best scores according to a prepared
+///        order in a fixed-size heap, documents with equal scores are ranked
+///        by their segment and document identifier, so the result doesn't
+///        depend on the order the segments are collected in
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API top_k_collector : private util::noncopyable {
+ public:
+  struct entry {
+    bstring score;
+    size_t segment; // ordinal of the segment within the index
+    doc_id_t doc;
+  }; // entry
+
+  typedef std::vector<entry> entries_t;
+
+  top_k_collector(const order::prepared& ord, size_t k);
+  top_k_collector(top_k_collector&& rhs) NOEXCEPT;
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief collects all documents of the specified iterator, the documents
+  ///        are scored a block at a time if the iterator provides 'score_block',
+  ///        the 'score_threshold' of the iterator (if any) is set once the heap
+  ///        is full
+  /// @param segment ordinal of the segment the documents belong to
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(size_t segment, doc_iterator& docs);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief executes the filter on every segment of the index and collects the
+  ///        matched live documents, i.e. the ones not masked by the segment,
+  ///        the segments are processed in parallel if a 'pool' is specified
+  /// @note the filter must be prepared for the 'index' and the order of
+  ///       the collector
+  //////////////////////////////////////////////////////////////////////////////
+  void collect(
+    const index_reader& index,
+    const filter::prepared& filter,
+    async_utils::thread_pool* pool = nullptr
+  );
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief adds the documents collected by 'rhs', 'rhs' must be created for
+  ///        the same order and 'k'
+  //////////////////////////////////////////////////////////////////////////////
+  void merge(top_k_collector&& rhs);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns the collected documents ordered from the best to the worst
+  ///          score, the documents are removed from the collector
+  //////////////////////////////////////////////////////////////////////////////
+  entries_t release();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns total number of the documents seen by the collector, i.e. a lower
+  ///          bound of the number of the matched documents if pruned()
+  //////////////////////////////////////////////////////////////////////////////
+  uint64_t hits() const NOEXCEPT { return hits_; }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns true if a 'score_threshold' has been set, i.e. the iterators
+  ///          might have skipped the non-competitive documents without
+  ///          counting them in hits()
+  //////////////////////////////////////////////////////////////////////////////
+  bool pruned() const NOEXCEPT { return pruned_; }
+
+  size_t size() const NOEXCEPT { return heap_.size(); }
+
+ private:
+  // returns true if the score of 'lhs' ranks before the score of 'rhs'
+  typedef bool(*less_f)(
+    const order::prepared& ord, const byte_type* lhs, const byte_type* rhs
+  );
+
+  // returns true if the document ranks before 'rhs'
+  bool less(
+    const byte_type* score, size_t segment, doc_id_t doc, const entry& rhs
+  ) const;
+  // returns true if the document has been collected
+  bool collect(const byte_type* score, size_t segment, doc_id_t doc);
+  void push(entry&& value);
+  void replace_top(const bytes_ref& score, size_t segment, doc_id_t doc);
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  entries_t heap_; // the worst of the collected documents goes first
+  const order::prepared* ord_;
+  size_t k_;
+  uint64_t hits_{};
+  less_f less_;
+  bool pruned_{}; // a score threshold has been set
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // top_k_collector
+
+NS_END // ROOT
+
+#endif // IRESEARCH_TOP_K_COLLECTOR_H
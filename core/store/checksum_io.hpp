@@ -31,6 +31,21 @@
 
 NS_ROOT
 
+class crc32c;
+
+/* -------------------------------------------------------------------
+ * checksum_traits
+ *   index_output::checksum_type_t of the algorithm
+ * ------------------------------------------------------------------*/
+
+template<typename Checksum>
+struct checksum_traits;
+
+template<>
+struct checksum_traits<crc32c> {
+  static const int32_t TYPE = index_output::CRC32C;
+};
+
 /* -------------------------------------------------------------------
  * checksum_index_output
  *   adapter for index_output implementations that
@@ -79,6 +94,10 @@ class checksum_index_output final : public index_output {
     return crc_.checksum();
   }
 
+  virtual int32_t checksum_type() const override {
+    return checksum_traits<Checksum>::TYPE;
+  }
+
  private:
   inline void release() {
     if ( !impl_ ) {
@@ -111,6 +130,12 @@ class checksum_index_input final : public index_input {
     assert(impl_);
   }
 
+  checksum_index_input(index_input::ptr&& impl, const Checksum& crc)
+    : crc_(crc),
+      impl_(std::move(impl)) {
+    assert(impl_);
+  }
+
   virtual ~checksum_index_input() { }
 
   /* data_input */
@@ -175,6 +200,19 @@ class checksum_index_input final : public index_input {
     return impl_->eof();
   }
 
+  virtual void advise(IOAdvice advice) NOEXCEPT override {
+    impl_->advise(advice);
+  }
+
+  virtual void prefetch(size_t offset, size_t size) NOEXCEPT override {
+    impl_->prefetch(offset, size);
+  }
+
+  // batch reads bypass the stream, hence aren't accounted in the checksum
+  virtual void read_batch(read_request* requests, size_t count) override {
+    impl_->read_batch(requests, count);
+  }
+
   int64_t checksum() const {
     return crc_.checksum();
   }
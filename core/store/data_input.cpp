@@ -23,6 +23,7 @@
 
 #include "shared.hpp"
 #include "data_input.hpp"
+#include "store_utils.hpp"
 
 #include "error/error.hpp"
 #include "utils/memory.hpp"
@@ -100,12 +101,50 @@ uint64_t data_input::read_vlong() {
   return out;
 }
 
+void data_input::read_vints(uint32_t* b, size_t count) {
+  for (auto* end = b + count; b != end; ++b) {
+    *b = read_vint();
+  }
+}
+
+void data_input::read_vlongs(uint64_t* b, size_t count) {
+  for (auto* end = b + count; b != end; ++b) {
+    *b = read_vlong();
+  }
+}
+
 /* -------------------------------------------------------------------
 * index_input
 * ------------------------------------------------------------------*/
 
 index_input::~index_input() { }
 
+void index_input::read_batch(read_request* requests, size_t count) {
+  if (!count) {
+    return;
+  }
+
+  auto in = dup();
+
+  if (!in) {
+    throw detailed_io_error("Failed to duplicate input for a batch read");
+  }
+
+  for (auto* end = requests + count; requests != end; ++requests) {
+    if (!requests->size) {
+      continue;
+    }
+
+    in->seek(requests->offset);
+
+    if (in->read_bytes(requests->buf, requests->size) != requests->size) {
+      throw detailed_io_error("Failed to read ")
+              << std::to_string(requests->size) << " bytes at offset "
+              << std::to_string(requests->offset);
+    }
+  }
+}
+
 /* -------------------------------------------------------------------
 * input_buf
 * ------------------------------------------------------------------*/
@@ -187,6 +226,56 @@ size_t buffered_index_input::read_bytes(byte_type* b, size_t count) {
   return read += size;
 }
 
+uint32_t buffered_index_input::read_vint() {
+  if (remain() < vencode_traits<uint32_t>::max_size()) {
+    return data_input::read_vint(); // value may cross the buffer boundary
+  }
+
+  const auto res = irs::read_vint(begin_);
+  begin_ += std::distance(const_cast<const byte_type*>(begin_), res.second);
+  return res.first;
+}
+
+uint64_t buffered_index_input::read_vlong() {
+  if (remain() < vencode_traits<uint64_t>::max_size()) {
+    return data_input::read_vlong(); // value may cross the buffer boundary
+  }
+
+  const auto res = irs::read_vlong(begin_);
+  begin_ += std::distance(const_cast<const byte_type*>(begin_), res.second);
+  return res.first;
+}
+
+void buffered_index_input::read_vints(uint32_t* b, size_t count) {
+  while (count) {
+    const auto res = irs::read_vencoded(begin_, end_, b, count);
+    begin_ += std::distance(const_cast<const byte_type*>(begin_), res.second);
+    b += res.first;
+    count -= res.first;
+
+    if (count) {
+      // value may cross the buffer boundary, will trigger refill if needed
+      *b++ = data_input::read_vint();
+      --count;
+    }
+  }
+}
+
+void buffered_index_input::read_vlongs(uint64_t* b, size_t count) {
+  while (count) {
+    const auto res = irs::read_vencoded(begin_, end_, b, count);
+    begin_ += std::distance(const_cast<const byte_type*>(begin_), res.second);
+    b += res.first;
+    count -= res.first;
+
+    if (count) {
+      // value may cross the buffer boundary, will trigger refill if needed
+      *b++ = data_input::read_vlong();
+      --count;
+    }
+  }
+}
+
 size_t buffered_index_input::refill() {
   const auto data_start = this->file_pointer();
   const auto data_end = std::min(data_start + buf_size_, length());
@@ -53,24 +53,46 @@ struct IRESEARCH_API data_input {
 
   virtual bool eof() const = 0;
 
-  // TODO: make functions virtual and override it in subclass in 
-  // order to achieve better performance
-
   int16_t read_short();
 
   int32_t read_int();
 
-  uint32_t read_vint();
+  // implementations backed by a memory buffer should decode
+  // variable length values directly from the buffer
+
+  virtual uint32_t read_vint();
 
   int64_t read_long();
 
-  uint64_t read_vlong();
+  virtual uint64_t read_vlong();
+
+  // reads 'count' values written with 'write_vint(...)'
+  virtual void read_vints(uint32_t* b, size_t count);
+
+  // reads 'count' values written with 'write_vlong(...)'
+  virtual void read_vlongs(uint64_t* b, size_t count);
 };
 
 /* -------------------------------------------------------------------
 * index_input
 * ------------------------------------------------------------------*/
 
+// expected access pattern of a file
+enum class IOAdvice {
+  NORMAL, // no specific pattern
+  SEQUENTIAL, // read in order, aggressive read-ahead is worthwhile
+  RANDOM, // read in small scattered pieces, read-ahead is wasted
+  WILLNEED, // read soon, preload the whole file
+  DONTNEED // not read in the near future, cached data can be dropped
+};
+
+// a single positional read issued via 'index_input::read_batch(...)'
+struct read_request {
+  size_t offset; // position in the file to read from
+  byte_type* buf; // destination buffer, at least 'size' bytes
+  size_t size; // number of bytes to read
+};
+
 struct IRESEARCH_API index_input : public data_input {
  public:
   DECLARE_PTR(index_input);
@@ -81,6 +103,22 @@ struct IRESEARCH_API index_input : public data_input {
   virtual ptr reopen() const NOEXCEPT = 0; // thread-safe new low-level-fd (offset preserved)
   virtual void seek(size_t pos) = 0;
 
+  // hints the access pattern of the whole file, shared by all copies
+  // of the stream, ignored by implementations unable to make use of it
+  virtual void advise(IOAdvice advice) NOEXCEPT { UNUSED(advice); }
+
+  // hints that 'size' bytes starting at 'offset' are about to be read
+  virtual void prefetch(size_t offset, size_t size) NOEXCEPT {
+    UNUSED(offset);
+    UNUSED(size);
+  }
+
+  // reads every request of the batch and returns once all of them are
+  // complete, requests may be served out of order or concurrently,
+  // the stream position is left untouched
+  // throws 'io_error' if any of the requests can't be read completely
+  virtual void read_batch(read_request* requests, size_t count);
+
  private:
   index_input& operator=( const index_input& ) = delete;
 };
@@ -120,6 +158,14 @@ class IRESEARCH_API buffered_index_input : public index_input {
 
   virtual size_t read_bytes(byte_type* b, size_t count) final;
 
+  virtual uint32_t read_vint() final;
+
+  virtual uint64_t read_vlong() final;
+
+  virtual void read_vints(uint32_t* b, size_t count) final;
+
+  virtual void read_vlongs(uint64_t* b, size_t count) final;
+
   virtual size_t file_pointer() const final {
     return start_ + offset();
   }
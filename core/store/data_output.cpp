@@ -79,6 +79,10 @@ void data_output::write_vlong( uint64_t i ) {
 
 index_output::~index_output() {}
 
+int32_t index_output::checksum_type() const {
+  return CRC32;
+}
+
 /* -------------------------------------------------------------------
 * output_buf
 * ------------------------------------------------------------------*/
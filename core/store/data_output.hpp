@@ -74,9 +74,18 @@ struct IRESEARCH_API index_output : public data_output {
   /* deprecated */
   virtual void flush() = 0;
 
+  // algorithms computing checksum()
+  enum checksum_type_t : int32_t {
+    CRC32 = 0, // boost::crc_32_type
+    CRC32C = 1 // irs::crc32c
+  };
+
   virtual size_t file_pointer() const = 0;
 
   virtual int64_t checksum() const = 0;
+
+  // algorithm computing checksum(), CRC32 unless overridden
+  virtual int32_t checksum_type() const;
 };
 
 /* -------------------------------------------------------------------
@@ -26,6 +26,21 @@
 
 NS_ROOT
 
+// -----------------------------------------------------------------------------
+// --SECTION--                                             checksum_verification
+// -----------------------------------------------------------------------------
+
+DEFINE_ATTRIBUTE_TYPE(checksum_verification);
+DEFINE_FACTORY_DEFAULT(checksum_verification);
+
+checksum_verification::checksum_verification()
+  : pool(nullptr) { // verify on the thread opening the segment
+}
+
+void checksum_verification::clear() {
+  pool = nullptr;
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                      fd_pool_size
 // -----------------------------------------------------------------------------
@@ -30,6 +30,24 @@
 
 NS_ROOT
 
+NS_BEGIN(async_utils)
+class thread_pool;
+NS_END
+
+//////////////////////////////////////////////////////////////////////////////
+/// @class checksum_verification
+/// @brief verify checksums of the segment files whenever a segment is opened
+///        for reading, files are verified concurrently on 'pool' if set
+//////////////////////////////////////////////////////////////////////////////
+struct IRESEARCH_API checksum_verification: public stored_attribute {
+  DECLARE_ATTRIBUTE_TYPE();
+  DECLARE_FACTORY_DEFAULT();
+  async_utils::thread_pool* pool; // not owned
+
+  checksum_verification();
+  void clear();
+};
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class fd_pool_size
 /// @brief the size of file descriptor pools
@@ -29,21 +29,19 @@
 #include "utils/log.hpp"
 #include "utils/object_pool.hpp"
 #include "utils/utf8_path.hpp"
+#include "utils/async_io.hpp"
+#include "utils/crc.hpp"
 #include "utils/file_utils.hpp"
 
 #ifdef _WIN32
   #include <Windows.h> // for GetLastError()
+#else
+  #include <fcntl.h> // for posix_fadvise(...)
 #endif
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/locale/encoding.hpp>
 
-MSVC_ONLY(__pragma(warning(push)))
-MSVC_ONLY(__pragma(warning(disable:4244)))
-MSVC_ONLY(__pragma(warning(disable:4245)))
-#include <boost/crc.hpp>
-MSVC_ONLY(__pragma(warning(pop)))
-
 NS_LOCAL
 
 inline size_t buffer_size(FILE* file) NOEXCEPT {
@@ -278,6 +276,41 @@ class fs_index_input : public buffered_index_input {
 
   virtual ptr reopen() const NOEXCEPT override;
 
+  #ifdef POSIX_FADV_WILLNEED
+    virtual void advise(IOAdvice advice) NOEXCEPT override {
+      fadvise(0, 0, to_fadvise(advice)); // whole file
+    }
+
+    // the kernel reads the range in background, i.e. the subsequent
+    // reads of the range don't block on the device
+    virtual void prefetch(size_t offset, size_t size) NOEXCEPT override {
+      if (offset >= prefetch_begin_ && offset + size <= prefetch_end_) {
+        return; // already requested
+      }
+
+      // request a window past the end of the requested data, see
+      // 'mmap_index_input::prefetch(...)'
+      size = size < PREFETCH_WINDOW ? PREFETCH_WINDOW : size;
+
+      if (fadvise(offset, size, POSIX_FADV_WILLNEED)) {
+        prefetch_begin_ = offset;
+        prefetch_end_ = offset + size;
+      }
+    }
+  #endif
+
+  #ifndef _WIN32
+    virtual void read_batch(read_request* requests, size_t count) override {
+      assert(handle_->handle);
+
+      if (!async_io::read(file_no(*handle_), requests, count)) {
+        throw detailed_io_error("Failed to read a batch of ")
+                << std::to_string(count)
+                << " requests from input file, error " << std::to_string(errno);
+      }
+    }
+  #endif
+
  protected:
   virtual void seek_internal(size_t pos) override {
     if (pos >= handle_->size) {
@@ -345,6 +378,34 @@ class fs_index_input : public buffered_index_input {
 
   DECLARE_FACTORY(index_input);
 
+  #ifdef POSIX_FADV_WILLNEED
+    static const size_t PREFETCH_WINDOW = 64*1024;
+
+    static int to_fadvise(IOAdvice advice) NOEXCEPT {
+      switch (advice) {
+        case IOAdvice::SEQUENTIAL: return POSIX_FADV_SEQUENTIAL;
+        case IOAdvice::RANDOM: return POSIX_FADV_RANDOM;
+        case IOAdvice::WILLNEED: return POSIX_FADV_WILLNEED;
+        case IOAdvice::DONTNEED: return POSIX_FADV_DONTNEED;
+        default: return POSIX_FADV_NORMAL;
+      }
+    }
+
+    bool fadvise(size_t offset, size_t size, int advice) const NOEXCEPT {
+      assert(handle_->handle);
+
+      const auto error = ::posix_fadvise(
+        file_no(*handle_), off_t(offset), off_t(size), advice
+      );
+
+      if (error) {
+        IR_FRMT_WARN("Failed to advise input file, error: %d", error);
+      }
+
+      return !error;
+    }
+  #endif
+
   fs_index_input(
       file_handle::ptr&& handle,
       size_t buffer_size,
@@ -362,6 +423,8 @@ class fs_index_input : public buffered_index_input {
   file_handle::ptr handle_; /* shared file handle */
   size_t pool_size_; // size of pool for instances of pooled_fs_index_input
   size_t pos_; /* current input stream position */
+  size_t prefetch_begin_{}; // range of the last prefetch request
+  size_t prefetch_end_{};
 }; // fs_index_input
 
 DEFINE_FACTORY_DEFAULT(fs_index_input::file_handle);
@@ -484,7 +547,7 @@ attribute_store& fs_directory::attributes() NOEXCEPT {
 void fs_directory::close() NOEXCEPT { }
 
 index_output::ptr fs_directory::create(const std::string& name) NOEXCEPT {
-  typedef checksum_index_output<boost::crc_32_type> checksum_output_t;
+  typedef checksum_index_output<crc32c> checksum_output_t;
 
   try {
     utf8_path path;
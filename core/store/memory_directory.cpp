@@ -26,6 +26,7 @@
 #include "checksum_io.hpp"
 
 #include "error/error.hpp"
+#include "utils/crc.hpp"
 #include "utils/log.hpp"
 #include "utils/string.hpp"
 #include "utils/thread_utils.hpp"
@@ -36,22 +37,6 @@
 #include <cstring>
 #include <algorithm>
 
-#if defined(_MSC_VER)
-  #pragma warning(disable : 4244)
-  #pragma warning(disable : 4245)
-#elif defined (__GNUC__)
-  // NOOP
-#endif
-
-#include <boost/crc.hpp>
-
-#if defined(_MSC_VER)
-  #pragma warning(default: 4244)
-  #pragma warning(default: 4245)
-#elif defined (__GNUC__)
-  // NOOP
-#endif
-  
 NS_ROOT
 
 //////////////////////////////////////////////////////////////////////////////
@@ -288,7 +273,7 @@ bool memory_directory::exists(
 }
 
 index_output::ptr memory_directory::create(const std::string& name) NOEXCEPT {
-  typedef checksum_index_output<boost::crc_32_type> checksum_output_t;
+  typedef checksum_index_output<crc32c> checksum_output_t;
 
   try {
     async_utils::read_write_mutex::write_mutex mutex(flock_);
@@ -26,6 +26,12 @@
 #include "utils/utf8_path.hpp"
 #include "utils/mmap_utils.hpp"
 
+#ifndef _WIN32
+  #include <fcntl.h> // for posix_fadvise(...)
+#endif
+
+#include <cerrno>
+
 NS_LOCAL
 
 using irs::mmap_utils::mmap_handle;
@@ -66,9 +72,78 @@ class mmap_index_input : public irs::bytes_ref_input {
     return dup();
   }
 
+  virtual void advise(irs::IOAdvice advice) NOEXCEPT override {
+    const auto value = to_madvise(advice);
+
+    if (irs::IOAdvice::NORMAL != advice && IR_MADVISE_NORMAL == value) {
+      return; // not supported on the platform
+    }
+
+    if (!handle_->advise(value)) {
+      IR_FRMT_WARN("Failed to advise mmapped input file, error: %d", errno);
+    }
+
+  #ifdef POSIX_FADV_DONTNEED
+    if (irs::IOAdvice::DONTNEED == advice) {
+      // madvise(...) of a private mapping only unmaps the pages from the
+      // process, drop the now unmapped pages from the page cache as well
+      const auto error = ::posix_fadvise(
+        static_cast<int>(handle_->fd()), 0, 0, POSIX_FADV_DONTNEED
+      );
+
+      if (error) {
+        IR_FRMT_WARN("Failed to advise mmapped input file, error: %d", error);
+      }
+    }
+  #endif
+  }
+
+  virtual void prefetch(size_t offset, size_t size) NOEXCEPT override {
+    if (IR_MADVISE_NORMAL == IR_MADVISE_WILLNEED
+        || (offset >= prefetch_begin_ && offset + size <= prefetch_end_)) {
+      return; // not supported on the platform or already requested
+    }
+
+    // request a window past the end of the requested data, so that a stream
+    // of nearby reads (e.g. consecutive postings blocks) results in a single
+    // call, not a system call per read
+    size = size < PREFETCH_WINDOW ? PREFETCH_WINDOW : size;
+
+    if (handle_->advise(offset, size, IR_MADVISE_WILLNEED)) {
+      prefetch_begin_ = offset;
+      prefetch_end_ = offset + size;
+    }
+  }
+
+  virtual void read_batch(irs::read_request* requests, size_t count) override {
+    // let the kernel populate all of the requested pages at once
+    // instead of faulting them in one by one while copying
+    if (IR_MADVISE_NORMAL != IR_MADVISE_WILLNEED && count > 1) {
+      for (auto* req = requests, *end = requests + count; req != end; ++req) {
+        if (req->size) {
+          handle_->advise(req->offset, req->size, IR_MADVISE_WILLNEED);
+        }
+      }
+    }
+
+    bytes_ref_input::read_batch(requests, count);
+  }
+
  private:
   DECLARE_FACTORY(index_input);
 
+  static const size_t PREFETCH_WINDOW = 64*1024;
+
+  static int to_madvise(irs::IOAdvice advice) NOEXCEPT {
+    switch (advice) {
+      case irs::IOAdvice::SEQUENTIAL: return IR_MADVISE_SEQUENTIAL;
+      case irs::IOAdvice::RANDOM: return IR_MADVISE_RANDOM;
+      case irs::IOAdvice::WILLNEED: return IR_MADVISE_WILLNEED;
+      case irs::IOAdvice::DONTNEED: return IR_MADVISE_DONTNEED;
+      default: return IR_MADVISE_NORMAL;
+    }
+  }
+
   mmap_index_input(mmap_handle_ptr&& handle) NOEXCEPT
     : handle_(std::move(handle)) {
     if (handle_) {
@@ -79,12 +154,16 @@ class mmap_index_input : public irs::bytes_ref_input {
 
   mmap_index_input(const mmap_index_input& rhs) NOEXCEPT
     : bytes_ref_input(rhs),
-      handle_(rhs.handle_) {
+      handle_(rhs.handle_),
+      prefetch_begin_(rhs.prefetch_begin_),
+      prefetch_end_(rhs.prefetch_end_) {
   }
 
   mmap_index_input& operator=(const mmap_index_input&) = delete;
 
   mmap_handle_ptr handle_;
+  size_t prefetch_begin_{}; // range of the last prefetch request
+  size_t prefetch_end_{};
 }; // mmap_index_input
 
 NS_END // LOCAL
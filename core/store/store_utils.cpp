@@ -26,6 +26,11 @@
 
 #include "utils/std.hpp"
 #include "utils/memory.hpp"
+#include "utils/cpuinfo.hpp"
+
+#ifdef IRESEARCH_X86
+  #include <immintrin.h>
+#endif
 
 NS_ROOT
 
@@ -293,6 +298,78 @@ uint32_t write_block(
 
 
 NS_END // bitpack
+
+// ----------------------------------------------------------------------------
+// --SECTION--                                      delta encode/decode helpers
+// ----------------------------------------------------------------------------
+
+NS_BEGIN(delta)
+
+#ifdef IRESEARCH_X86
+
+NS_LOCAL
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief in-place inclusive prefix sum over 4 values per iteration
+/// @returns position of the first value left for the scalar code
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_TARGET("avx2")
+uint64_t* decode_avx2(uint64_t* begin, uint64_t* end) NOEXCEPT {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i carry = zero; // last decoded value in every lane
+
+  for (; end - begin >= 4; begin += 4) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+
+    // v + [0, v0, v1, v2]
+    v = _mm256_add_epi64(v, _mm256_blend_epi32(
+      _mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03
+    ));
+    // v + [0, 0, v0, v1]
+    v = _mm256_add_epi64(v, _mm256_permute2x128_si256(v, v, 0x08));
+
+    _mm256_storeu_si256(
+      reinterpret_cast<__m256i*>(begin), _mm256_add_epi64(v, carry)
+    );
+
+    // keep the permutation out of the dependency chain between iterations
+    carry = _mm256_add_epi64(
+      carry, _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3))
+    );
+  }
+
+  return begin;
+}
+
+NS_END // NS_LOCAL
+
+#endif // IRESEARCH_X86
+
+void decode(uint64_t* begin, uint64_t* end) {
+  assert(std::distance(begin, end) > 0);
+
+  auto* first = begin;
+
+#ifdef IRESEARCH_X86
+  if (cpuinfo::support_avx2()) {
+    first = decode_avx2(begin, end);
+
+    if (first != begin && first != end) {
+      *first += *(first - 1);
+    }
+  }
+#endif
+
+  if (first != end) {
+    for (auto prev = *first++; first != end; ++first) {
+      prev = (*first += prev);
+    }
+  }
+
+  assert(std::is_sorted(begin, end));
+}
+
+NS_END // delta
 NS_END // encode
 
 // ----------------------------------------------------------------------------
@@ -344,6 +421,59 @@ size_t bytes_ref_input::read_bytes( byte_type* b, size_t size) {
   //assert( pos_ + size <= data_.size() );
 }
 
+uint32_t bytes_ref_input::read_vint() {
+  if (data_.size() - pos_ < vencode_traits<uint32_t>::max_size()) {
+    return data_input::read_vint(); // value may be truncated
+  }
+
+  const auto res = irs::read_vint(data_.c_str() + pos_);
+  pos_ = std::distance(data_.c_str(), res.second);
+  return res.first;
+}
+
+uint64_t bytes_ref_input::read_vlong() {
+  if (data_.size() - pos_ < vencode_traits<uint64_t>::max_size()) {
+    return data_input::read_vlong(); // value may be truncated
+  }
+
+  const auto res = irs::read_vlong(data_.c_str() + pos_);
+  pos_ = std::distance(data_.c_str(), res.second);
+  return res.first;
+}
+
+void bytes_ref_input::read_vints(uint32_t* b, size_t count) {
+  const auto res = irs::read_vencoded(
+    data_.c_str() + pos_, data_.c_str() + data_.size(), b, count
+  );
+  pos_ = std::distance(data_.c_str(), res.second);
+
+  // read the tail value by value
+  data_input::read_vints(b + res.first, count - res.first);
+}
+
+void bytes_ref_input::read_vlongs(uint64_t* b, size_t count) {
+  const auto res = irs::read_vencoded(
+    data_.c_str() + pos_, data_.c_str() + data_.size(), b, count
+  );
+  pos_ = std::distance(data_.c_str(), res.second);
+
+  // read the tail value by value
+  data_input::read_vlongs(b + res.first, count - res.first);
+}
+
+void bytes_ref_input::read_batch(read_request* requests, size_t count) {
+  for (auto* end = requests + count; requests != end; ++requests) {
+    if (requests->offset > data_.size()
+        || requests->size > data_.size() - requests->offset) {
+      throw detailed_io_error("Failed to read ")
+              << std::to_string(requests->size) << " bytes at offset "
+              << std::to_string(requests->offset);
+    }
+
+    std::memcpy(requests->buf, data_.c_str() + requests->offset, requests->size);
+  }
+}
+
 void bytes_ref_input::read_bytes(bstring& buf, size_t size) {
   auto used = buf.size();
 
@@ -425,6 +555,46 @@ size_t bytes_input::read_bytes(byte_type* b, size_t size) {
 
 }
 
+uint32_t bytes_input::read_vint() {
+  if (this->size() - pos_ < vencode_traits<uint32_t>::max_size()) {
+    return data_input::read_vint(); // value may be truncated
+  }
+
+  const auto res = irs::read_vint(this->data_ + pos_);
+  pos_ = std::distance(this->data_, res.second);
+  return res.first;
+}
+
+uint64_t bytes_input::read_vlong() {
+  if (this->size() - pos_ < vencode_traits<uint64_t>::max_size()) {
+    return data_input::read_vlong(); // value may be truncated
+  }
+
+  const auto res = irs::read_vlong(this->data_ + pos_);
+  pos_ = std::distance(this->data_, res.second);
+  return res.first;
+}
+
+void bytes_input::read_vints(uint32_t* b, size_t count) {
+  const auto res = irs::read_vencoded(
+    this->data_ + pos_, this->data_ + this->size(), b, count
+  );
+  pos_ = std::distance(this->data_, res.second);
+
+  // read the tail value by value
+  data_input::read_vints(b + res.first, count - res.first);
+}
+
+void bytes_input::read_vlongs(uint64_t* b, size_t count) {
+  const auto res = irs::read_vencoded(
+    this->data_ + pos_, this->data_ + this->size(), b, count
+  );
+  pos_ = std::distance(this->data_, res.second);
+
+  // read the tail value by value
+  data_input::read_vlongs(b + res.first, count - res.first);
+}
+
 void bytes_input::read_from(data_input& in, size_t size) {
   if (!size) {
     /* nothing to read*/
@@ -270,6 +270,47 @@ struct vencode_traits<uint64_t>: ::detail::vencode_traits_base<size_t, 10> {
   };
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes up to 'count' variable length values from [begin, end) while
+///        the remaining bytes are enough to hold any value, runs of single
+///        byte values are decoded 8 at a time
+/// @returns number of decoded values and position after the last one
+////////////////////////////////////////////////////////////////////////////////
+template<typename T>
+inline std::pair<size_t, const byte_type*> read_vencoded(
+    const byte_type* begin,
+    const byte_type* end,
+    T* out,
+    size_t count) {
+  typedef vencode_traits<T> traits_t;
+
+  const uint64_t HIGH_BITS = UINT64_C(0x8080808080808080);
+  const size_t MIN_REMAIN = std::max(traits_t::max_size(), sizeof(uint64_t));
+  size_t read = 0;
+
+  while (read < count && size_t(std::distance(begin, end)) >= MIN_REMAIN) {
+    if (count - read >= sizeof(uint64_t)) {
+      uint64_t word;
+      std::memcpy(&word, begin, sizeof word);
+
+      if (!(word & HIGH_BITS)) {
+        for (size_t i = 0; i < sizeof(uint64_t); ++i) {
+          out[read++] = begin[i];
+        }
+
+        begin += sizeof(uint64_t);
+        continue;
+      }
+    }
+
+    const auto res = traits_t::read(begin);
+    out[read++] = res.first;
+    begin = res.second;
+  }
+
+  return std::make_pair(read, begin);
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                                               read/write helpers
 // ----------------------------------------------------------------------------
@@ -342,6 +383,27 @@ inline int64_t read_zvlong( data_input& in ) {
   return zig_zag_decode64( in.read_vlong() );
 }
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief decodes a value written by 'write_zvlong(...)' or 'write_zvint(...)'
+/// @returns false unless 'in' holds exactly one encoded value
+////////////////////////////////////////////////////////////////////////////////
+inline bool decode_zvlong(const bytes_ref& in, int64_t& value) NOEXCEPT {
+  uint64_t out = 0;
+
+  for (size_t i = 0, size = std::min(in.size(), size_t(10)); i < size; ++i) {
+    const uint64_t b = in[i];
+
+    out |= (b & 0x7F) << (7*i);
+
+    if (!(b & 0x80)) {
+      value = zig_zag_decode64(out);
+      return i + 1 == in.size();
+    }
+  }
+
+  return false;
+}
+
 inline void write_string( data_output& out, const char* s, size_t len ) {
   assert(len < integer_traits<uint32_t>::const_max);
   out.write_vint(uint32_t(len));
@@ -499,6 +561,12 @@ class IRESEARCH_API bytes_ref_input : public index_input {
   virtual size_t read_bytes(byte_type* b, size_t size) override;
   void read_bytes(bstring& buf, size_t size); // append to buf
 
+  virtual uint32_t read_vint() override;
+  virtual uint64_t read_vlong() override;
+  virtual void read_vints(uint32_t* b, size_t count) override;
+  virtual void read_vlongs(uint64_t* b, size_t count) override;
+  virtual void read_batch(read_request* requests, size_t count) override;
+
   void reset(const byte_type* data, size_t size) NOEXCEPT {
     data_ = bytes_ref(data, size);
     pos_ = 0;
@@ -561,6 +629,11 @@ class IRESEARCH_API bytes_input final: public data_input, public bytes_ref {
   virtual size_t read_bytes(byte_type* b, size_t size) override;
   void read_bytes(bstring& buf, size_t size); // append to buf
 
+  virtual uint32_t read_vint() override;
+  virtual uint64_t read_vlong() override;
+  virtual void read_vints(uint32_t* b, size_t count) override;
+  virtual void read_vlongs(uint64_t* b, size_t count) override;
+
  private:
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
   bstring buf_;
@@ -656,6 +729,12 @@ NS_END
 
 NS_BEGIN(delta)
 
+////////////////////////////////////////////////////////////////////////////////
+/// @brief same as the generic decode(...) below but uses vector instructions
+///        when they are supported by the CPU, the output is the same
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API void decode(uint64_t* begin, uint64_t* end);
+
 template<typename Iterator>
 inline void decode(Iterator begin, Iterator end) {
   assert(std::distance(begin, end) > 0);
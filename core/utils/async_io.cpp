@@ -0,0 +1,471 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "shared.hpp"
+#include "async_io.hpp"
+#include "async_utils.hpp"
+#include "log.hpp"
+#include "memory.hpp"
+#include "noncopyable.hpp"
+
+#ifndef _WIN32
+  #include <errno.h>
+  #include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(__has_include)
+  #if __has_include(<linux/io_uring.h>)
+    #include <linux/io_uring.h>
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <sys/uio.h>
+
+    #if defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter)
+      #define IRESEARCH_URING
+    #endif
+  #endif
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+NS_LOCAL
+
+using irs::read_request;
+
+#ifndef _WIN32
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads the whole request via synchronous positional reads
+///        starting 'done' bytes into the request
+////////////////////////////////////////////////////////////////////////////////
+bool pread_request(int fd, const read_request& req, size_t done) NOEXCEPT {
+  while (done < req.size) {
+    const auto read = ::pread(
+      fd, req.buf + done, req.size - done, off_t(req.offset + done)
+    );
+
+    if (read > 0) {
+      done += size_t(read);
+    } else if (!read || EINTR != errno) {
+      return false; // eof or read error
+    }
+  }
+
+  return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief serves requests via a dedicated pool of threads, since the
+///        threads mostly wait on I/O they aren't limited by CPU count
+////////////////////////////////////////////////////////////////////////////////
+bool pool_read(int fd, const read_request* requests, size_t count) NOEXCEPT {
+  static const size_t MAX_THREADS = 8;
+  static irs::async_utils::thread_pool pool(MAX_THREADS, MAX_THREADS);
+  std::atomic<bool> ok(true);
+
+  try {
+    irs::async_utils::task_group group(&pool);
+
+    // the calling thread reads the first request itself
+    for (size_t i = 1; i < count; ++i) {
+      group.run([fd, requests, i, &ok]()->void {
+        if (!pread_request(fd, requests[i], 0)) {
+          ok = false;
+        }
+      });
+    }
+
+    if (!pread_request(fd, requests[0], 0)) {
+      ok = false;
+    }
+
+    group.wait();
+  } catch (...) {
+    IR_EXCEPTION();
+    return false;
+  }
+
+  return ok;
+}
+
+#endif // _WIN32
+
+#ifdef IRESEARCH_URING
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class uring
+/// @brief minimal io_uring submission/completion ring used for batched reads,
+///        talks to the kernel directly so that no extra library is required
+////////////////////////////////////////////////////////////////////////////////
+class uring : private irs::util::noncopyable {
+ public:
+  DECLARE_PTR(uring);
+
+  static const unsigned DEPTH = 64; // max number of in-flight requests
+
+  ~uring() {
+    close();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @returns a ring or nullptr if io_uring isn't available
+  //////////////////////////////////////////////////////////////////////////////
+  static ptr make() NOEXCEPT {
+    if (UNSUPPORTED.load()) {
+      return nullptr;
+    }
+
+    ptr ring;
+
+    try {
+      ring.reset(new uring());
+    } catch (...) {
+      IR_EXCEPTION();
+      return nullptr;
+    }
+
+    const auto error = ring->open();
+
+    if (error) {
+      if (ENOSYS == error || EPERM == error) {
+        UNSUPPORTED = true; // disabled by the kernel, don't retry
+      }
+
+      IR_FRMT_WARN("Failed to setup io_uring, error: %d", error);
+
+      return nullptr;
+    }
+
+    return ring;
+  }
+
+  static bool supported() NOEXCEPT {
+    return !UNSUPPORTED.load();
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief submits the requests in chunks of at most DEPTH entries and
+  ///        waits for their completion
+  /// @returns false on failure to read the requests, 'broken' denotes
+  ///          that the ring is no longer usable, the requests are read
+  ///          without the ring in this case
+  //////////////////////////////////////////////////////////////////////////////
+  bool read(
+      int fd, const read_request* requests, size_t count, bool& broken
+  ) NOEXCEPT {
+    bool ok = true;
+
+    broken = false;
+
+    while (count) {
+      const auto chunk = std::min(size_t(sq_entries_), count);
+
+      ok &= read_chunk(fd, requests, unsigned(chunk), broken);
+      requests += chunk;
+      count -= chunk;
+
+      if (broken) {
+        return (!count || pool_read(fd, requests, count)) && ok;
+      }
+    }
+
+    return ok;
+  }
+
+ private:
+  static std::atomic<bool> UNSUPPORTED;
+
+  uring() = default;
+
+  static int setup(unsigned entries, io_uring_params& params) NOEXCEPT {
+    return int(::syscall(__NR_io_uring_setup, entries, &params));
+  }
+
+  static int enter(
+      int fd, unsigned to_submit, unsigned min_complete, unsigned flags
+  ) NOEXCEPT {
+    return int(::syscall(
+      __NR_io_uring_enter, fd, to_submit, min_complete, flags, nullptr, 0
+    ));
+  }
+
+  template<typename T>
+  static T* at(void* base, uint32_t offset) NOEXCEPT {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+  }
+
+  // @returns 0 on success, error code otherwise
+  int open() NOEXCEPT {
+    io_uring_params params{};
+
+    fd_ = setup(DEPTH, params);
+
+    if (fd_ < 0) {
+      return errno;
+    }
+
+    sq_size_ = params.sq_off.array + params.sq_entries*sizeof(unsigned);
+    cq_size_ = params.cq_off.cqes + params.cq_entries*sizeof(io_uring_cqe);
+
+    bool single_mmap = false;
+
+    #ifdef IORING_FEAT_SINGLE_MMAP
+      if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);
+        single_mmap = true;
+      }
+    #endif
+
+    sq_ptr_ = ::mmap(
+      nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      fd_, IORING_OFF_SQ_RING
+    );
+
+    if (MAP_FAILED == sq_ptr_) {
+      sq_ptr_ = nullptr;
+      return errno;
+    }
+
+    if (single_mmap) {
+      cq_ptr_ = sq_ptr_;
+    } else {
+      cq_ptr_ = ::mmap(
+        nullptr, cq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+        fd_, IORING_OFF_CQ_RING
+      );
+
+      if (MAP_FAILED == cq_ptr_) {
+        cq_ptr_ = nullptr;
+        return errno;
+      }
+    }
+
+    sqes_size_ = params.sq_entries*sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(::mmap(
+      nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+      fd_, IORING_OFF_SQES
+    ));
+
+    if (MAP_FAILED == static_cast<void*>(sqes_)) {
+      sqes_ = nullptr;
+      return errno;
+    }
+
+    sq_entries_ = params.sq_entries;
+    sq_tail_ = at<unsigned>(sq_ptr_, params.sq_off.tail);
+    sq_mask_ = *at<unsigned>(sq_ptr_, params.sq_off.ring_mask);
+    sq_array_ = at<unsigned>(sq_ptr_, params.sq_off.array);
+    cq_head_ = at<unsigned>(cq_ptr_, params.cq_off.head);
+    cq_tail_ = at<unsigned>(cq_ptr_, params.cq_off.tail);
+    cq_mask_ = *at<unsigned>(cq_ptr_, params.cq_off.ring_mask);
+    cqes_ = at<io_uring_cqe>(cq_ptr_, params.cq_off.cqes);
+
+    try {
+      iov_.resize(sq_entries_);
+    } catch (...) {
+      return ENOMEM;
+    }
+
+    return 0;
+  }
+
+  void close() NOEXCEPT {
+    if (sqes_) {
+      ::munmap(sqes_, sqes_size_);
+    }
+
+    if (cq_ptr_ && cq_ptr_ != sq_ptr_) {
+      ::munmap(cq_ptr_, cq_size_);
+    }
+
+    if (sq_ptr_) {
+      ::munmap(sq_ptr_, sq_size_);
+    }
+
+    if (fd_ >= 0) {
+      ::close(fd_);
+    }
+  }
+
+  bool read_chunk(
+      int fd, const read_request* requests, unsigned count, bool& broken
+  ) NOEXCEPT {
+    // fill submission queue, the kernel doesn't consume entries
+    // until 'io_uring_enter(...)', no need to check for free space
+    auto tail = *sq_tail_;
+
+    for (unsigned i = 0; i < count; ++i, ++tail) {
+      const auto idx = tail & sq_mask_;
+      auto& sqe = sqes_[idx];
+      auto& iov = iov_[i];
+
+      iov.iov_base = requests[i].buf;
+      iov.iov_len = requests[i].size;
+
+      std::memset(&sqe, 0, sizeof sqe);
+      sqe.opcode = IORING_OP_READV;
+      sqe.fd = fd;
+      sqe.addr = reinterpret_cast<uint64_t>(&iov);
+      sqe.len = 1;
+      sqe.off = requests[i].offset;
+      sqe.user_data = i;
+
+      sq_array_[idx] = idx;
+    }
+
+    __atomic_store_n(sq_tail_, tail, __ATOMIC_RELEASE);
+
+    bool ok = true;
+    unsigned accepted = count; // number of requests read via the ring
+    unsigned submitted = 0;
+    unsigned completed = 0;
+
+    while (completed < accepted) {
+      const auto res = enter(
+        fd_, accepted - submitted, 1, IORING_ENTER_GETEVENTS
+      );
+
+      if (res >= 0) {
+        submitted += unsigned(res);
+      } else if (EINTR != errno && EAGAIN != errno && EBUSY != errno) {
+        if (!broken) {
+          // the kernel rejected the entries, the ring is left with
+          // unsubmitted entries and has to be dropped, requests in flight
+          // are still reaped to prevent writes into released buffers
+          IR_FRMT_ERROR("Failed to submit io_uring requests, error: %d", errno);
+          broken = true;
+          accepted = submitted; // the entries are consumed in order
+        } else {
+          // completions are posted to the ring regardless of the failure
+          std::this_thread::yield();
+        }
+      }
+
+      // reap completions
+      auto head = *cq_head_;
+
+      for (; head != __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE); ++head) {
+        const auto& cqe = cqes_[head & cq_mask_];
+        const auto& req = requests[cqe.user_data];
+
+        // complete failed or partial reads synchronously
+        if (cqe.res < 0 || size_t(cqe.res) < req.size) {
+          ok &= pread_request(fd, req, cqe.res < 0 ? 0 : size_t(cqe.res));
+        }
+
+        ++completed;
+      }
+
+      __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    }
+
+    // read the requests rejected by the kernel synchronously
+    for (auto i = accepted; i < count; ++i) {
+      ok &= pread_request(fd, requests[i], 0);
+    }
+
+    return ok;
+  }
+
+  int fd_{ -1 };
+  void* sq_ptr_{};
+  void* cq_ptr_{};
+  io_uring_sqe* sqes_{};
+  size_t sq_size_{};
+  size_t cq_size_{};
+  size_t sqes_size_{};
+  unsigned sq_entries_{};
+  unsigned* sq_tail_{};
+  unsigned sq_mask_{};
+  unsigned* sq_array_{};
+  unsigned* cq_head_{};
+  unsigned* cq_tail_{};
+  unsigned cq_mask_{};
+  io_uring_cqe* cqes_{};
+  std::vector<iovec> iov_; // buffers of the submitted chunk
+}; // uring
+
+/*static*/ std::atomic<bool> uring::UNSUPPORTED(false);
+
+// each thread submits to its own ring, no synchronization required
+thread_local uring::ptr RING;
+
+#endif // IRESEARCH_URING
+
+NS_END
+
+NS_ROOT
+NS_BEGIN(async_io)
+
+bool read(int fd, const read_request* requests, size_t count) NOEXCEPT {
+  #ifdef _WIN32
+    UNUSED(fd);
+    UNUSED(requests);
+    UNUSED(count);
+
+    return false; // not implemented, use index_input::read_batch(...)
+  #else
+    if (!count) {
+      return true;
+    }
+
+    if (1 == count) {
+      return pread_request(fd, *requests, 0); // nothing to overlap with
+    }
+
+    #ifdef IRESEARCH_URING
+      if (!RING) {
+        RING = uring::make();
+      }
+
+      if (RING) {
+        bool broken;
+        const auto ok = RING->read(fd, requests, count, broken);
+
+        if (broken) {
+          RING.reset(); // will be recreated on next call
+        }
+
+        return ok;
+      }
+    #endif
+
+    return pool_read(fd, requests, count);
+  #endif // _WIN32
+}
+
+bool uring_supported() NOEXCEPT {
+  #ifdef IRESEARCH_URING
+    return uring::supported();
+  #else
+    return false;
+  #endif
+}
+
+NS_END // async_io
+NS_END
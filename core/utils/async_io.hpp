@@ -0,0 +1,55 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IRESEARCH_ASYNC_IO_H
+#define IRESEARCH_ASYNC_IO_H
+
+#include "store/data_input.hpp"
+
+NS_ROOT
+NS_BEGIN(async_io)
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief reads all of the specified requests from a file descriptor and
+///        waits for their completion, the whole batch is submitted to the
+///        kernel at once via io_uring where available, otherwise requests
+///        are served by a dedicated pool of threads doing positional reads
+/// @note the file offset of the descriptor is left untouched
+/// @returns false if any of the requests can't be read completely
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API bool read(
+  int fd,
+  const read_request* requests,
+  size_t count
+) NOEXCEPT;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns true if batches are served via io_uring on the current platform
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API bool uring_supported() NOEXCEPT;
+
+NS_END // async_io
+NS_END
+
+#endif
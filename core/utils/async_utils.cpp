@@ -408,6 +408,81 @@ void thread_pool::run() {
   }
 }
 
+task_group::task_group(thread_pool* pool /*= nullptr*/)
+  : pending_(0), pool_(pool) {
+}
+
+task_group::~task_group() {
+  std::unique_lock<decltype(lock_)> lock(lock_);
+
+  while (pending_) {
+    cond_.wait(lock);
+  }
+}
+
+void task_group::execute(const std::function<void()>& fn) NOEXCEPT {
+  try {
+    fn();
+  } catch (...) {
+    std::lock_guard<decltype(lock_)> lock(lock_);
+
+    if (!error_) {
+      error_ = std::current_exception(); // retain only the first error
+    }
+  }
+}
+
+void task_group::run(std::function<void()>&& fn) {
+  if (!pool_) {
+    execute(fn);
+
+    return;
+  }
+
+  // std::function requires a copyable functor, share the task instead
+  auto task = std::make_shared<std::function<void()>>(std::move(fn));
+
+  {
+    std::lock_guard<decltype(lock_)> lock(lock_);
+    ++pending_;
+  }
+
+  auto submitted = pool_->run([this, task]()->void {
+    execute(*task);
+
+    std::lock_guard<decltype(lock_)> lock(lock_);
+
+    if (!--pending_) {
+      cond_.notify_all();
+    }
+  });
+
+  if (!submitted) {
+    {
+      std::lock_guard<decltype(lock_)> lock(lock_);
+      --pending_;
+    }
+
+    execute(*task); // pool not active, run on the current thread
+  }
+}
+
+void task_group::wait() {
+  std::unique_lock<decltype(lock_)> lock(lock_);
+
+  while (pending_) {
+    cond_.wait(lock);
+  }
+
+  if (error_) {
+    auto error = error_;
+
+    error_ = nullptr; // allow reuse of the group
+
+    std::rethrow_exception(error);
+  }
+}
+
 NS_END
 NS_END
 
@@ -26,7 +26,9 @@
 
 #include <atomic>
 #include <condition_variable>
+#include <exception>
 #include <functional>
+#include <memory>
 #include <queue>
 #include <thread>
 
@@ -135,6 +137,36 @@ class IRESEARCH_API thread_pool {
    void run();
 };
 
+//////////////////////////////////////////////////////////////////////////////
+/// @brief a set of tasks executed on a thread_pool that can be waited on as a
+///        whole, tasks are executed on the calling thread if no pool is given
+///        or the pool is no longer accepting tasks
+//////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API task_group: private util::noncopyable {
+ public:
+  explicit task_group(thread_pool* pool = nullptr);
+  ~task_group(); // waits for completion of all tasks, discards any exception
+
+  void run(std::function<void()>&& fn);
+
+  ////////////////////////////////////////////////////////////////////////////
+  /// @brief wait for completion of all tasks submitted so far
+  /// @note rethrows the first exception thrown by any of the tasks
+  ////////////////////////////////////////////////////////////////////////////
+  void wait();
+
+ private:
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::condition_variable cond_;
+  std::exception_ptr error_; // first exception thrown by a task
+  std::mutex lock_;
+  size_t pending_; // number of tasks submitted to the pool but not finished
+  thread_pool* pool_;
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+
+  void execute(const std::function<void()>& fn) NOEXCEPT;
+};
+
 NS_END
 NS_END
 
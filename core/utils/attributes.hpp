@@ -317,18 +317,25 @@ template<
 
   attribute_map& operator=(attribute_map&& other) NOEXCEPT {
     if (this != &other) {
+      std::move(std::begin(other.slots_), std::end(other.slots_), std::begin(slots_));
+      slots_size_ = other.slots_size_;
+      size_ = other.size_;
       map_ = std::move(other.map_);
+      other.clear();
     }
 
     return *this;
   }
 
   void clear() {
+    std::fill(std::begin(slots_), std::end(slots_), slot_t());
+    slots_size_ = 0;
+    size_ = 0;
     map_.clear();
   }
 
   bool contains(const attribute::type_id& type) const NOEXCEPT {
-    return map_.find(type) != map_.end();
+    return nullptr != const_cast<attribute_map*>(this)->get(type);
   }
 
   template<typename A>
@@ -345,9 +352,10 @@ template<
 
     features.reserve(size());
 
-    for (auto& entry: map_) {
-      features.add(*entry.first);
-    }
+    visit([&features](const attribute::type_id& type, const typename ref<T>::type&) {
+      features.add(type);
+      return true;
+    });
 
     return features;
   }
@@ -395,7 +403,20 @@ template<
   }
 
   bool remove(const attribute::type_id& type) {
-    return map_.erase(&type) > 0;
+    for (auto* slot = slots_, *end = slots_ + slots_size_; slot != end; ++slot) {
+      if (slot->first == &type) {
+        *slot = slot_t(); // keep the remaining slots in place
+        --size_;
+        return true;
+      }
+    }
+
+    if (map_.erase(&type)) {
+      --size_;
+      return true;
+    }
+
+    return false;
   }
 
   template<typename A>
@@ -415,18 +436,48 @@ template<
     return visit(*this, visitor);
   }
 
-  size_t size() const NOEXCEPT { return map_.size(); }
+  size_t size() const NOEXCEPT { return size_; }
 
  protected:
   typename ref<T>::type& emplace(bool& inserted, const attribute::type_id& type) {
-    auto res = map_utils::try_emplace(map_, &type);
+    auto* value = get(type);
+
+    if (value) {
+      inserted = false;
+      return *value;
+    }
+
+    inserted = true;
+    ++size_;
 
-    inserted = res.second;
+    // reuse a slot freed by 'remove(...)'
+    for (auto* slot = slots_, *end = slots_ + slots_size_; slot != end; ++slot) {
+      if (!slot->first) {
+        slot->first = &type;
+        return slot->second;
+      }
+    }
 
-    return res.first->second;
+    if (slots_size_ < SLOTS_COUNT) {
+      auto& slot = slots_[slots_size_++];
+      slot.first = &type;
+      return slot.second;
+    }
+
+    return map_[&type];
   }
 
   typename ref<T>::type* get(const attribute::type_id& type) NOEXCEPT {
+    for (auto* slot = slots_, *end = slots_ + slots_size_; slot != end; ++slot) {
+      if (slot->first == &type) {
+        return &slot->second;
+      }
+    }
+
+    if (map_.empty()) {
+      return nullptr;
+    }
+
     auto itr = map_.find(&type);
 
     return map_.end() == itr ? nullptr : &(itr->second);
@@ -436,9 +487,9 @@ template<
       const attribute::type_id& type,
       typename ref<T>::type& fallback
   ) NOEXCEPT {
-    auto itr = map_.find(&type);
+    auto* value = get(type);
 
-    return map_.end() == itr ? fallback : itr->second;
+    return value ? *value : fallback;
   }
 
   const typename ref<T>::type& get(
@@ -449,20 +500,42 @@ template<
   }
 
  private:
+  // iterators and term readers expose a handful of attributes, so they are
+  // kept in a fixed number of inline slots looked up by a linear scan over
+  // type pointers, i.e. building an attribute set neither allocates nor
+  // hashes, the rest spill into a map
+  // slots never move once assigned, references to the values remain valid
+  // until the entry is removed
+  static const size_t SLOTS_COUNT = 8;
+
+  typedef std::pair<const attribute::type_id*, typename ref<T>::type> slot_t;
+
   // std::map<...> is 25% faster than std::unordered_map<...> as per profile_bulk_index test
   typedef std::map<const attribute::type_id*, typename ref<T>::type> map_t;
 
   IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
-  map_t map_;
+  slot_t slots_[SLOTS_COUNT];
+  size_t slots_size_{}; // number of slots ever assigned
+  size_t size_{}; // number of entries
+  map_t map_; // entries beyond SLOTS_COUNT
   IRESEARCH_API_PRIVATE_VARIABLES_END
 
   template<typename Attributes, typename Visitor>
   static bool visit(Attributes& attrs, const Visitor& visitor) {
+    for (size_t i = 0; i < attrs.slots_size_; ++i) {
+      auto& slot = attrs.slots_[i];
+
+      if (slot.first && !visitor(*slot.first, slot.second)) {
+        return false;
+      }
+    }
+
     for (auto& entry : attrs.map_) {
       if (!visitor(*entry.first, entry.second)) {
         return false;
       }
     }
+
     return true;
   }
 }; // attribute_map
@@ -23,10 +23,15 @@
 
 #include "shared.hpp"
 #include "bit_packing.hpp"
+#include "cpuinfo.hpp"
 
 #include <cassert>
 #include <cstring>
 
+#ifdef IRESEARCH_X86
+  #include <immintrin.h>
+#endif
+
 NS_LOCAL
 
 #if defined(_MSC_VER)
@@ -317,6 +322,176 @@ FORCE_INLINE uint64_t __fastpack_at(const uint64_t* in) NOEXCEPT {
 #endif
 
 MSVC_ONLY(__pragma(warning(push)))
+
+#ifdef IRESEARCH_X86
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                    AVX2 unpacking
+// -----------------------------------------------------------------------------
+
+// the horizontal layout is a little-endian bit stream, i.e. a packed 64-bit
+// block of N bits is exactly 2 consecutive packed 32-bit blocks of N bits,
+// hence both are unpacked by the same 8 lane kernel operating on 32-bit words
+const uint32_t AVX2_MAX_BITS = 32;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief loads 8 words starting at 'in', words past 'in + LEFT' are zeroed
+///        and never read
+////////////////////////////////////////////////////////////////////////////////
+template<int LEFT>
+IRESEARCH_TARGET("avx2")
+FORCE_INLINE __m256i __load_avx2(const uint32_t* in) NOEXCEPT {
+  return LEFT >= 8
+    ? _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in))
+    : _mm256_maskload_epi32(
+        reinterpret_cast<const int*>(in),
+        _mm256_cmpgt_epi32(
+          _mm256_set1_epi32(LEFT), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)
+        )
+      );
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief unpacks values [I;I+8) of a packed 32-bit block: each lane picks
+///        the low and the high word holding its value from the 8 word windows
+///        starting at the first and the second word of the group respectively,
+///        all shifts/indices are compile time constants
+/// @note never reads past the end of the packed block, i.e. 'in + N'
+////////////////////////////////////////////////////////////////////////////////
+template<int N, int I>
+IRESEARCH_TARGET("avx2")
+FORCE_INLINE __m256i __fastunpack_avx2_group(const uint32_t* in) NOEXCEPT {
+  const int FIRST = (I * N) / 32; // first word of the group
+  const int LEFT = N - FIRST; // words left in the packed block
+
+  // bit offset of value 'i' of the group relative to its first word
+  #define OFF(i) ((I * N) % 32 + (i) * N)
+  #define LO(i) (OFF(i) / 32)
+  #define SHIFT(i) (OFF(i) % 32)
+
+  static_assert(LO(7) < 8, "group of 8 values does not start in 8 words");
+
+  // for N > 29 the high word of the last value may be the 9th one, hence
+  // the second window instead of permuting the first one by LO(i) + 1
+  const __m256i lo_window = __load_avx2<LEFT>(in + FIRST);
+  const __m256i hi_window = __load_avx2<LEFT - 1>(in + FIRST + 1);
+  const __m256i index = _mm256_setr_epi32(
+    LO(0), LO(1), LO(2), LO(3), LO(4), LO(5), LO(6), LO(7)
+  );
+
+  // (lo >> shift) | (hi << (32 - shift)), where shift by 32 yields 0
+  // and the bits of 'hi' not belonging to the value are masked out
+  const __m256i lo = _mm256_srlv_epi32(
+    _mm256_permutevar8x32_epi32(lo_window, index),
+    _mm256_setr_epi32(
+      SHIFT(0), SHIFT(1), SHIFT(2), SHIFT(3),
+      SHIFT(4), SHIFT(5), SHIFT(6), SHIFT(7)
+    )
+  );
+
+  const __m256i hi = _mm256_sllv_epi32(
+    _mm256_permutevar8x32_epi32(hi_window, index),
+    _mm256_setr_epi32(
+      32 - SHIFT(0), 32 - SHIFT(1), 32 - SHIFT(2), 32 - SHIFT(3),
+      32 - SHIFT(4), 32 - SHIFT(5), 32 - SHIFT(6), 32 - SHIFT(7)
+    )
+  );
+
+  #undef SHIFT
+  #undef LO
+  #undef OFF
+
+  return _mm256_and_si256(
+    _mm256_or_si256(lo, hi), _mm256_set1_epi32(int(~0U >> (32 - N)))
+  );
+}
+
+IRESEARCH_TARGET("avx2")
+FORCE_INLINE void __store_avx2(uint32_t* out, __m256i values) NOEXCEPT {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), values);
+}
+
+IRESEARCH_TARGET("avx2")
+FORCE_INLINE void __store_avx2(uint64_t* out, __m256i values) NOEXCEPT {
+  _mm256_storeu_si256(
+    reinterpret_cast<__m256i*>(out),
+    _mm256_cvtepu32_epi64(_mm256_castsi256_si128(values))
+  );
+  _mm256_storeu_si256(
+    reinterpret_cast<__m256i*>(out + 4),
+    _mm256_cvtepu32_epi64(_mm256_extracti128_si256(values, 1))
+  );
+}
+
+template<int N, typename T>
+IRESEARCH_TARGET("avx2")
+FORCE_INLINE void __fastunpack_avx2_32(const uint32_t* in, T* out) NOEXCEPT {
+  __store_avx2(out,      __fastunpack_avx2_group<N, 0>(in));
+  __store_avx2(out + 8,  __fastunpack_avx2_group<N, 8>(in));
+  __store_avx2(out + 16, __fastunpack_avx2_group<N, 16>(in));
+  __store_avx2(out + 24, __fastunpack_avx2_group<N, 24>(in));
+}
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief AVX2 version of __fastunpack<N>(...), produces the same output
+////////////////////////////////////////////////////////////////////////////////
+template<int N>
+IRESEARCH_TARGET("avx2")
+void __fastunpack_avx2(const uint32_t* RESTRICT in, uint32_t* RESTRICT out) NOEXCEPT {
+  __fastunpack_avx2_32<N>(in, out);
+}
+
+template<int N>
+IRESEARCH_TARGET("avx2")
+void __fastunpack_avx2(const uint64_t* RESTRICT in, uint64_t* RESTRICT out) NOEXCEPT {
+  const auto* in32 = reinterpret_cast<const uint32_t*>(in);
+
+  __fastunpack_avx2_32<N>(in32, out);
+  __fastunpack_avx2_32<N>(in32 + N, out + iresearch::packed::BLOCK_SIZE_32);
+}
+
+template<typename T>
+void unpack_block_avx2(
+    const T* RESTRICT in, T* RESTRICT out, const uint32_t bit
+) NOEXCEPT {
+  switch (bit) {
+    case 1:   __fastunpack_avx2<1>(in, out); break;
+    case 2:   __fastunpack_avx2<2>(in, out); break;
+    case 3:   __fastunpack_avx2<3>(in, out); break;
+    case 4:   __fastunpack_avx2<4>(in, out); break;
+    case 5:   __fastunpack_avx2<5>(in, out); break;
+    case 6:   __fastunpack_avx2<6>(in, out); break;
+    case 7:   __fastunpack_avx2<7>(in, out); break;
+    case 8:   __fastunpack_avx2<8>(in, out); break;
+    case 9:   __fastunpack_avx2<9>(in, out); break;
+    case 10:  __fastunpack_avx2<10>(in, out); break;
+    case 11:  __fastunpack_avx2<11>(in, out); break;
+    case 12:  __fastunpack_avx2<12>(in, out); break;
+    case 13:  __fastunpack_avx2<13>(in, out); break;
+    case 14:  __fastunpack_avx2<14>(in, out); break;
+    case 15:  __fastunpack_avx2<15>(in, out); break;
+    case 16:  __fastunpack_avx2<16>(in, out); break;
+    case 17:  __fastunpack_avx2<17>(in, out); break;
+    case 18:  __fastunpack_avx2<18>(in, out); break;
+    case 19:  __fastunpack_avx2<19>(in, out); break;
+    case 20:  __fastunpack_avx2<20>(in, out); break;
+    case 21:  __fastunpack_avx2<21>(in, out); break;
+    case 22:  __fastunpack_avx2<22>(in, out); break;
+    case 23:  __fastunpack_avx2<23>(in, out); break;
+    case 24:  __fastunpack_avx2<24>(in, out); break;
+    case 25:  __fastunpack_avx2<25>(in, out); break;
+    case 26:  __fastunpack_avx2<26>(in, out); break;
+    case 27:  __fastunpack_avx2<27>(in, out); break;
+    case 28:  __fastunpack_avx2<28>(in, out); break;
+    case 29:  __fastunpack_avx2<29>(in, out); break;
+    case 30:  __fastunpack_avx2<30>(in, out); break;
+    case 31:  __fastunpack_avx2<31>(in, out); break;
+    case 32:  __fastunpack_avx2<32>(in, out); break;
+    default: assert(false); break;
+  }
+}
+
+#endif // IRESEARCH_X86
 MSVC_ONLY(__pragma(warning(disable:4715))) // not all control paths return a value
 template<int N>
 uint32_t __fastpack_at(const uint32_t* in, const size_t i) NOEXCEPT {
@@ -819,6 +994,16 @@ void pack(
 void unpack(
   uint32_t* first, uint32_t* last, const uint32_t* in, const uint32_t bit
 ) NOEXCEPT {
+#ifdef IRESEARCH_X86
+  if (bit <= AVX2_MAX_BITS && cpuinfo::support_avx2()) {
+    for (; first < last; first += BLOCK_SIZE_32, in += bit) {
+      unpack_block_avx2(in, first, bit);
+    }
+
+    return;
+  }
+#endif
+
   for (; first < last; first += BLOCK_SIZE_32, in += bit) {
     unpack_block(in, first, bit);
   }
@@ -827,6 +1012,16 @@ void unpack(
 void unpack(
   uint64_t* first, uint64_t* last, const uint64_t* in, const uint32_t bit
 ) NOEXCEPT {
+#ifdef IRESEARCH_X86
+  if (bit <= AVX2_MAX_BITS && cpuinfo::support_avx2()) {
+    for (; first < last; first += BLOCK_SIZE_64, in += bit) {
+      unpack_block_avx2(in, first, bit);
+    }
+
+    return;
+  }
+#endif
+
   for (; first < last; first += BLOCK_SIZE_64, in += bit) {
     unpack_block(in, first, bit);
   }
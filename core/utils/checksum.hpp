@@ -36,7 +36,9 @@ class buffered_checksum {
  public:
   typedef typename Checksum::value_type value_type;
 
-  static const size_t DEFAULT_BUF_SIZE = 128;
+  // large enough for the hardware accelerated implementations to process
+  // the buffered data in a few wide strides rather than byte by byte
+  static const size_t DEFAULT_BUF_SIZE = 4096;
 
   explicit buffered_checksum(size_t buf_size = DEFAULT_BUF_SIZE)
     : buf_(new byte_type[buf_size]),
@@ -45,6 +47,16 @@ class buffered_checksum {
     assert(buf_size_);
   }
 
+  explicit buffered_checksum(
+      const Checksum& impl,
+      size_t buf_size = DEFAULT_BUF_SIZE)
+    : impl_(impl),
+      buf_(new byte_type[buf_size]),
+      buf_size_(buf_size),
+      size_(0) {
+    assert(buf_size_);
+  }
+
   buffered_checksum( const buffered_checksum& rhs )
     : impl_( rhs.impl_ ),
       buf_( new byte_type[rhs.buf_size_] ),
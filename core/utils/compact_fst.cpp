@@ -0,0 +1,486 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "compact_fst.hpp"
+#include "fst.hpp"
+#include "log.hpp"
+#include "error/error.hpp"
+#include "store/store_utils.hpp"
+
+#include <map>
+
+NS_LOCAL
+
+using irs::byte_type;
+
+const byte_type FLAG_FINAL = 1; // state is final
+const byte_type FLAG_OUTPUT = 2; // final state has non-empty output
+const byte_type FLAG_ARCS = 4; // state has outgoing arcs
+const byte_type FLAG_RANGE = 8; // arc labels form a contiguous range
+
+const uint32_t MAX_WIDTH = sizeof(uint64_t);
+
+inline size_t vint_size(uint32_t value) NOEXCEPT {
+  size_t size = 1;
+
+  for (; value >= 0x80; value >>= 7) {
+    ++size;
+  }
+
+  return size;
+}
+
+inline void write_address(
+    irs::data_output& out, uint64_t address, uint32_t width) {
+  assert(width <= MAX_WIDTH);
+  byte_type buf[MAX_WIDTH];
+
+  for (uint32_t i = 0; i < width; ++i, address >>= 8) {
+    buf[i] = static_cast<byte_type>(address & 0xFF);
+  }
+
+  out.write_bytes(buf, width);
+}
+
+struct state_layout {
+  irs::vector_byte_fst::StateId id;
+  uint64_t fixed; // size of the state excluding addresses
+  uint32_t addresses; // number of addresses stored within the state
+  bool range; // arc labels form a contiguous range
+}; // state_layout
+
+NS_END
+
+NS_ROOT
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                                  compact_fst I/O
+// -----------------------------------------------------------------------------
+
+void write_compact_fst(data_output& out, const vector_byte_fst& fst) {
+  typedef vector_byte_fst::StateId state_id;
+  typedef std::map<bstring, uint64_t> output_pool;
+
+  const state_id num_states = fst.NumStates();
+
+  if (!num_states) {
+    out.write_vlong(0); // size
+    out.write_vint(1); // width
+    out.write_vlong(0); // start
+    return;
+  }
+
+  // state 0 goes first, the rest follow in the order of their ids
+  std::vector<state_layout> layout;
+  layout.reserve(num_states);
+
+  output_pool pool;
+  auto register_output = [&pool](const byte_weight& weight) {
+    pool.emplace(bstring(weight.begin(), weight.end()), 0);
+  };
+
+  for (state_id s = 0; s < num_states; ++s) {
+    const auto narcs = fst.NumArcs(s);
+    const auto& final = fst.Final(s);
+
+    if (narcs > 256) {
+      throw illegal_argument();
+    }
+
+    state_layout state{ s, 1, 0, false };
+
+    if (final != byte_weight::Zero() && !final.Empty()) {
+      register_output(final);
+      ++state.addresses;
+    }
+
+    if (narcs) {
+      int min_label = std::numeric_limits<int>::max();
+      int max_label = std::numeric_limits<int>::min();
+
+      for (fst::ArcIterator<vector_byte_fst> it(fst, s); !it.Done(); it.Next()) {
+        const auto& arc = it.Value();
+
+        if (arc.ilabel < 0 || arc.ilabel > 0xFF) {
+          throw illegal_argument();
+        }
+
+        min_label = std::min(min_label, arc.ilabel);
+        max_label = std::max(max_label, arc.ilabel);
+
+        if (!arc.weight.Empty()) {
+          register_output(arc.weight);
+        }
+      }
+
+      state.range = size_t(max_label - min_label + 1) == narcs;
+      state.fixed += 1 + (state.range ? 1 : narcs);
+      state.addresses += 2*uint32_t(narcs);
+    }
+
+    layout.emplace_back(state);
+  }
+
+  // find the narrowest address width able to address the whole fst
+  uint64_t fixed = 0, addresses = 0, pool_size = 0;
+
+  for (auto& state : layout) {
+    fixed += state.fixed;
+    addresses += state.addresses;
+  }
+
+  for (auto& entry : pool) {
+    pool_size += vint_size(uint32_t(entry.first.size())) + entry.first.size();
+  }
+
+  uint32_t width = 1;
+  uint64_t size = fixed + addresses*width + pool_size;
+
+  for (; width < MAX_WIDTH && (size - 1) >> (8*width); ++width) {
+    size += addresses;
+  }
+
+  // assign addresses
+  std::vector<uint64_t> state_addresses(num_states);
+  uint64_t address = 0;
+
+  for (auto& state : layout) {
+    state_addresses[state.id] = address;
+    address += state.fixed + state.addresses*width;
+  }
+
+  for (auto& entry : pool) {
+    entry.second = address;
+    address += vint_size(uint32_t(entry.first.size())) + entry.first.size();
+  }
+
+  assert(address == size);
+
+  auto output_address = [&pool](const byte_weight& weight) -> uint64_t {
+    if (weight.Empty()) {
+      return 0;
+    }
+
+    const auto it = pool.find(bstring(weight.begin(), weight.end()));
+    assert(it != pool.end());
+    return it->second;
+  };
+
+  // write header
+  out.write_vlong(size);
+  out.write_vint(width);
+  out.write_vlong(state_addresses[fst.Start()]);
+
+  // write states
+  std::vector<const byte_arc*> arcs;
+  byte_type labels[256];
+
+  for (auto& state : layout) {
+    const auto& final = fst.Final(state.id);
+    byte_type flags = 0;
+
+    arcs.clear();
+    for (fst::ArcIterator<vector_byte_fst> it(fst, state.id); !it.Done(); it.Next()) {
+      arcs.emplace_back(&it.Value());
+    }
+
+    std::sort(
+      arcs.begin(), arcs.end(),
+      [](const byte_arc* lhs, const byte_arc* rhs) {
+        return lhs->ilabel < rhs->ilabel;
+    });
+
+    if (final != byte_weight::Zero()) {
+      flags |= FLAG_FINAL;
+
+      if (!final.Empty()) {
+        flags |= FLAG_OUTPUT;
+      }
+    }
+
+    if (!arcs.empty()) {
+      flags |= FLAG_ARCS;
+
+      if (state.range) {
+        flags |= FLAG_RANGE;
+      }
+    }
+
+    out.write_byte(flags);
+
+    if (flags & FLAG_OUTPUT) {
+      write_address(out, output_address(final), width);
+    }
+
+    if (arcs.empty()) {
+      continue;
+    }
+
+    out.write_byte(static_cast<byte_type>(arcs.size() - 1));
+
+    const size_t nlabels = state.range ? 1 : arcs.size();
+    for (size_t i = 0; i < nlabels; ++i) {
+      labels[i] = static_cast<byte_type>(arcs[i]->ilabel);
+    }
+    out.write_bytes(labels, nlabels);
+
+    for (auto* arc : arcs) {
+      write_address(out, state_addresses[arc->nextstate], width);
+      write_address(out, output_address(arc->weight), width);
+    }
+  }
+
+  // write outputs
+  for (auto& entry : pool) {
+    out.write_vint(uint32_t(entry.first.size()));
+    out.write_bytes(entry.first.c_str(), entry.first.size());
+  }
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                       compact_fst implementation
+// -----------------------------------------------------------------------------
+
+struct compact_fst::buffer {
+  bytes_output out;
+  bytes_ref_input in;
+}; // buffer
+
+/*static*/ const compact_fst::stateid_t compact_fst::FINAL;
+
+compact_fst::compact_fst() NOEXCEPT { }
+
+compact_fst::compact_fst(compact_fst&& rhs) NOEXCEPT
+  : buf_(std::move(rhs.buf_)),
+    in_(rhs.in_),
+    offset_(rhs.offset_),
+    size_(rhs.size_),
+    start_(rhs.start_),
+    width_(rhs.width_) {
+  rhs.in_ = nullptr;
+  rhs.offset_ = 0;
+  rhs.size_ = 0;
+  rhs.start_ = 0;
+  rhs.width_ = 0;
+}
+
+compact_fst& compact_fst::operator=(compact_fst&& rhs) NOEXCEPT {
+  if (this != &rhs) {
+    buf_ = std::move(rhs.buf_);
+    in_ = rhs.in_;
+    offset_ = rhs.offset_;
+    size_ = rhs.size_;
+    start_ = rhs.start_;
+    width_ = rhs.width_;
+    rhs.in_ = nullptr;
+    rhs.offset_ = 0;
+    rhs.size_ = 0;
+    rhs.start_ = 0;
+    rhs.width_ = 0;
+  }
+
+  return *this;
+}
+
+compact_fst::~compact_fst() { }
+
+bool compact_fst::open(index_input& in) {
+  size_ = in.read_vlong();
+  width_ = in.read_vint();
+  start_ = in.read_vlong();
+
+  if (!width_ || width_ > MAX_WIDTH || (size_ && start_ >= size_)) {
+    IR_FRMT_ERROR("Invalid compact fst header in: %s", __FUNCTION__);
+    return false;
+  }
+
+  offset_ = in.file_pointer();
+
+  if (offset_ + size_ > in.length()) {
+    IR_FRMT_ERROR("Truncated compact fst in: %s", __FUNCTION__);
+    return false;
+  }
+
+  in_ = &in;
+  return true;
+}
+
+bool compact_fst::read(index_input& in) {
+  buf_.reset();
+
+  if (!open(in)) {
+    return false;
+  }
+
+  in.seek(offset_ + size_);
+  return true;
+}
+
+void compact_fst::reset(const vector_byte_fst& fst) {
+  auto buf = memory::make_unique<buffer>();
+
+  write_compact_fst(buf->out, fst);
+  buf->in.reset(buf->out);
+
+  if (!open(buf->in)) {
+    // must not happen for freshly encoded data
+    throw illegal_state();
+  }
+
+  buf_ = std::move(buf);
+}
+
+// -----------------------------------------------------------------------------
+// --SECTION--                                            cursor implementation
+// -----------------------------------------------------------------------------
+
+index_input& compact_fst::cursor::input() {
+  if (!in_) {
+    assert(fst_->in_);
+    in_ = fst_->in_->reopen();
+
+    if (!in_) {
+      // implementation returned wrong pointer
+      IR_FRMT_FATAL("Failed to reopen compact fst input in: %s", __FUNCTION__);
+
+      throw detailed_io_error("Failed to reopen compact fst input");
+    }
+  }
+
+  return *in_;
+}
+
+uint64_t compact_fst::cursor::read_address() {
+  const auto width = fst_->width_;
+  byte_type buf[MAX_WIDTH];
+
+#ifdef IRESEARCH_DEBUG
+  const auto read = in_->read_bytes(buf, width);
+  assert(read == width);
+  UNUSED(read);
+#else
+  in_->read_bytes(buf, width);
+#endif // IRESEARCH_DEBUG
+
+  uint64_t address = 0;
+  for (auto i = width; i; --i) {
+    address = (address << 8) | buf[i - 1];
+  }
+
+  return address;
+}
+
+void compact_fst::cursor::read_weight(uint64_t address, byte_weight& weight) {
+  weight.Clear();
+
+  if (!address) {
+    return; // empty output
+  }
+
+  assert(address < fst_->size_);
+  in_->seek(fst_->offset_ + address);
+
+  for (auto size = in_->read_vint(); size; --size) {
+    weight.PushBack(in_->read_byte());
+  }
+}
+
+byte_weight compact_fst::cursor::final(stateid_t state) {
+  assert(state < fst_->size_);
+  auto& in = input();
+
+  in.seek(fst_->offset_ + state);
+
+  const auto flags = in.read_byte();
+
+  if (!(flags & FLAG_FINAL)) {
+    return byte_weight::Zero();
+  }
+
+  byte_weight weight;
+
+  if (flags & FLAG_OUTPUT) {
+    read_weight(read_address(), weight);
+  }
+
+  return weight;
+}
+
+bool compact_fst::cursor::find(stateid_t state, byte_type label) {
+  assert(state < fst_->size_);
+  auto& in = input();
+  const auto width = fst_->width_;
+
+  in.seek(fst_->offset_ + state);
+
+  const auto flags = in.read_byte();
+
+  if (!(flags & FLAG_ARCS)) {
+    return false;
+  }
+
+  uint64_t pos = state + 1;
+
+  if (flags & FLAG_OUTPUT) {
+    pos += width;
+    in.seek(fst_->offset_ + pos);
+  }
+
+  const size_t narcs = size_t(in.read_byte()) + 1;
+  size_t idx;
+
+  if (flags & FLAG_RANGE) {
+    idx = size_t(label) - in.read_byte(); // wraps around for smaller labels
+    pos += 2; // number of arcs + first label
+
+    if (idx >= narcs) {
+      return false;
+    }
+  } else {
+#ifdef IRESEARCH_DEBUG
+    const auto read = in.read_bytes(buf_, narcs);
+    assert(read == narcs);
+    UNUSED(read);
+#else
+    in.read_bytes(buf_, narcs);
+#endif // IRESEARCH_DEBUG
+
+    const auto* it = std::lower_bound(buf_, buf_ + narcs, label);
+
+    if (it == buf_ + narcs || *it != label) {
+      return false;
+    }
+
+    idx = size_t(std::distance(static_cast<const byte_type*>(buf_), it));
+    pos += 1 + narcs; // number of arcs + labels
+  }
+
+  in.seek(fst_->offset_ + pos + idx*2*width);
+  arc_.ilabel = label;
+  arc_.nextstate = read_address();
+  read_weight(read_address(), arc_.weight);
+
+  return true;
+}
+
+NS_END
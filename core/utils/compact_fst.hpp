@@ -0,0 +1,149 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef IRESEARCH_COMPACT_FST_H
+#define IRESEARCH_COMPACT_FST_H
+
+#include "shared.hpp"
+#include "fst_decl.hpp"
+#include "fst_string_weight.h"
+#include "noncopyable.hpp"
+#include "store/data_input.hpp"
+#include "store/data_output.hpp"
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @brief writes the specified 'fst' to 'out' in a compact read-only format
+///        which is queried by 'compact_fst' directly from the stream:
+///          vlong - total size of the encoded states and outputs in bytes
+///          vint  - width of addresses in bytes
+///          vlong - address of the start state
+///          states followed by the pool of the distinct non-empty outputs,
+///          where state/output is addressed by its offset, 'fst' state 0 is
+///          always located at address 0
+///        state layout:
+///          byte  - flags
+///          addr  - final output (if not empty)
+///          byte  - number of arcs - 1 (if any arcs)
+///          bytes - sorted arc labels, or the first label only if the labels
+///                  form a contiguous range
+///          {addr, addr} - target state & output for every arc, address 0
+///                         denotes an empty output
+////////////////////////////////////////////////////////////////////////////////
+IRESEARCH_API void write_compact_fst(
+  data_output& out, const vector_byte_fst& fst
+);
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class compact_fst
+/// @brief read-only FST written by 'write_compact_fst', the states are never
+///        loaded into memory but read from the underlying stream on demand
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API compact_fst : util::noncopyable {
+ public:
+  typedef uint64_t stateid_t;
+
+  static const stateid_t FINAL = 0; // final state without outgoing arcs
+
+  struct arc {
+    byte_weight weight;
+    stateid_t nextstate;
+    byte_type ilabel;
+  }; // arc
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @class cursor
+  /// @brief reads the states of a 'compact_fst' using its own copy of the
+  ///        stream, i.e. a cursor must not be shared between threads
+  //////////////////////////////////////////////////////////////////////////////
+  class IRESEARCH_API cursor : util::noncopyable {
+   public:
+    explicit cursor(const compact_fst& fst) NOEXCEPT
+      : fst_(&fst) {
+    }
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @returns final output of the specified state, Zero() for the states
+    ///          that are not final
+    ////////////////////////////////////////////////////////////////////////////
+    byte_weight final(stateid_t state);
+
+    ////////////////////////////////////////////////////////////////////////////
+    /// @brief finds an outgoing arc of the specified state by its label
+    /// @returns true if the arc has been found, it's then accessible via value()
+    ////////////////////////////////////////////////////////////////////////////
+    bool find(stateid_t state, byte_type label);
+
+    const arc& value() const NOEXCEPT { return arc_; }
+
+   private:
+    index_input& input();
+    uint64_t read_address();
+    void read_weight(uint64_t address, byte_weight& weight);
+
+    const compact_fst* fst_;
+    index_input::ptr in_;
+    arc arc_;
+    byte_type buf_[256]; // labels of the current state
+  }; // cursor
+
+  compact_fst() NOEXCEPT;
+  compact_fst(compact_fst&& rhs) NOEXCEPT;
+  compact_fst& operator=(compact_fst&& rhs) NOEXCEPT;
+  ~compact_fst();
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief opens an fst located at the current position of 'in' and moves
+  ///        'in' to the end of the fst, 'in' must outlive the fst
+  //////////////////////////////////////////////////////////////////////////////
+  bool read(index_input& in);
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief encodes the specified 'fst' and keeps the encoded data in memory
+  //////////////////////////////////////////////////////////////////////////////
+  void reset(const vector_byte_fst& fst);
+
+  stateid_t start() const NOEXCEPT { return start_; }
+
+  // size of the encoded states and outputs in bytes
+  uint64_t size() const NOEXCEPT { return size_; }
+
+ private:
+  struct buffer;
+
+  bool open(index_input& in);
+
+  IRESEARCH_API_PRIVATE_VARIABLES_BEGIN
+  std::unique_ptr<buffer> buf_; // encoded fst (if not backed by a file)
+  const index_input* in_{}; // stream holding the encoded fst
+  uint64_t offset_{}; // offset of the address 0 within 'in_'
+  uint64_t size_{};
+  stateid_t start_{};
+  uint32_t width_{}; // width of addresses in bytes
+  IRESEARCH_API_PRIVATE_VARIABLES_END
+}; // compact_fst
+
+NS_END
+
+#endif
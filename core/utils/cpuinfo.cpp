@@ -22,20 +22,73 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include "cpuinfo.hpp"
+#include "bit_utils.hpp"
+
+#if defined(IRESEARCH_X86) && defined(__GNUC__)
+  #include <cpuid.h>
+#endif
 
+NS_LOCAL
+
+#ifdef IRESEARCH_X86
+
+void cpuid(uint32_t leaf, uint32_t* regs) NOEXCEPT {
 #if defined(_MSC_VER)
+  __cpuidex(reinterpret_cast<int*>(regs), int(leaf), 0);
+#else
+  if (!__get_cpuid_count(leaf, 0, &regs[0], &regs[1], &regs[2], &regs[3])) {
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+  }
+#endif
+}
 
-#include "bit_utils.hpp"
+// @returns the OS enabled parts of the extended processor state (XCR0)
+uint64_t xgetbv() NOEXCEPT {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile(".byte 0x0f, 0x01, 0xd0" : "=a"(eax), "=d"(edx) : "c"(0)); // xgetbv
+  return (uint64_t(edx) << 32) | eax;
+#endif
+}
+
+#endif // IRESEARCH_X86
+
+NS_END // NS_LOCAL
 
 NS_ROOT
 
 const cpuinfo cpuinfo::instance_;
 
-/*static*/ bool cpuinfo::support_popcnt() {
-  // according to https://msdn.microsoft.com/en-us/library/bb385231.aspx
-  return check_bit<23>(instance_.f1_cpuinfo_[2]);
+cpuinfo::cpuinfo() NOEXCEPT
+  : popcnt_(false), sse42_(false), avx2_(false) {
+#ifdef IRESEARCH_X86
+  uint32_t regs[4]; // eax, ebx, ecx, edx
+
+  cpuid(0, regs);
+
+  const auto max_leaf = regs[0];
+
+  if (max_leaf < 1) {
+    return;
+  }
+
+  cpuid(1, regs);
+
+  // according to https://msdn.microsoft.com/en-us/library/hskdteyh.aspx
+  popcnt_ = check_bit<23>(regs[2]);
+  sse42_ = check_bit<20>(regs[2]);
+
+  // AVX registers must be saved/restored by the OS (OSXSAVE + XCR0 SSE/AVX state)
+  const bool os_avx = check_bit<27>(regs[2]) && 6 == (xgetbv() & 6);
+
+  if (os_avx && max_leaf >= 7) {
+    cpuid(7, regs);
+    avx2_ = check_bit<5>(regs[1]);
+  }
+#endif
 }
 
 NS_END
 
-#endif
@@ -24,28 +24,47 @@
 #ifndef IRESEARCH_CPUID_ID
 #define IRESEARCH_CPUID_ID
 
+#include "shared.hpp"
+
 #if defined(_MSC_VER)
+  #include <intrin.h>
+#endif
 
-#include "shared.hpp"
-#include <intrin.h>
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+  #define IRESEARCH_X86 // x86 specific (e.g. SIMD) code paths are available
+#endif
+
+// enables the specified instruction set for a single function, required by
+// GCC/Clang to use the corresponding intrinsics without global compiler flags
+#if defined(__GNUC__)
+  #define IRESEARCH_TARGET(isa) __attribute__ ((target (isa)))
+#else
+  #define IRESEARCH_TARGET(isa)
+#endif
 
 NS_ROOT
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class cpuinfo
+/// @brief instruction set extensions supported by both the CPU and the OS,
+///        used for runtime dispatching of the optimized code paths
+////////////////////////////////////////////////////////////////////////////////
 class IRESEARCH_API cpuinfo {
  public:
-  static bool support_popcnt();
+  static bool support_popcnt() NOEXCEPT { return instance_.popcnt_; }
+  static bool support_sse42() NOEXCEPT { return instance_.sse42_; }
+  static bool support_avx2() NOEXCEPT { return instance_.avx2_; }
+
  private:
   static const cpuinfo instance_;
 
-  cpuinfo() {
-    __cpuid( f1_cpuinfo_, 1 );
-  }
+  cpuinfo() NOEXCEPT;
 
-  int f1_cpuinfo_[4];
+  bool popcnt_;
+  bool sse42_;
+  bool avx2_;
 };
 
 NS_END
 
 #endif
-
-#endif
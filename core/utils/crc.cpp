@@ -0,0 +1,203 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+
+#include "crc.hpp"
+#include "cpuinfo.hpp"
+
+#ifdef IRESEARCH_X86
+  #include <immintrin.h>
+#endif
+
+#include <cstring>
+
+NS_LOCAL
+
+using irs::byte_type;
+
+const uint32_t POLY = 0x82F63B78; // reflected Castagnoli polynomial
+
+// number of bytes processed by each of the interleaved hardware streams
+const size_t STREAM_SIZE = 512;
+
+////////////////////////////////////////////////////////////////////////////////
+/// @returns a(x)*b(x) modulo POLY, both operands are reflected, i.e. the most
+///          significant bit denotes x^0
+////////////////////////////////////////////////////////////////////////////////
+uint32_t multiply(uint32_t a, uint32_t b) NOEXCEPT {
+  uint32_t product = 0;
+
+  for (uint32_t mask = 0x80000000; mask; mask >>= 1) {
+    if (a & mask) {
+      product ^= b;
+    }
+
+    b = (b & 1) ? (b >> 1) ^ POLY : b >> 1; // b *= x
+  }
+
+  return product;
+}
+
+struct tables {
+  // slicing-by-8 lookup tables, 'slices[k][i]' is the remainder of byte 'i'
+  // followed by 'k' zero bytes
+  uint32_t slices[8][256];
+
+  // x^(8*STREAM_SIZE) modulo POLY, shifts the remainder of a stream past the
+  // bytes of the following stream
+  uint32_t stream_shift;
+
+  tables() NOEXCEPT {
+    for (uint32_t i = 0; i < 256; ++i) {
+      auto crc = i;
+
+      for (size_t j = 0; j < 8; ++j) {
+        crc = (crc & 1) ? (crc >> 1) ^ POLY : crc >> 1;
+      }
+
+      slices[0][i] = crc;
+    }
+
+    for (uint32_t i = 0; i < 256; ++i) {
+      for (size_t k = 1; k < 8; ++k) {
+        const auto prev = slices[k - 1][i];
+        slices[k][i] = (prev >> 8) ^ slices[0][prev & 0xFF];
+      }
+    }
+
+    stream_shift = 0x80000000; // x^0
+
+    for (size_t i = 0; i < 8*STREAM_SIZE; ++i) {
+      stream_shift = (stream_shift & 1)
+        ? (stream_shift >> 1) ^ POLY
+        : stream_shift >> 1; // *= x
+    }
+  }
+}; // tables
+
+const tables TABLES;
+
+uint32_t update_slicing_by_8(
+    uint32_t crc, const byte_type* begin, size_t size
+) NOEXCEPT {
+  const auto& t = TABLES.slices;
+
+  for (; size >= 8; size -= 8, begin += 8) {
+    const uint32_t lo = crc ^ (uint32_t(begin[0])
+      | uint32_t(begin[1]) << 8
+      | uint32_t(begin[2]) << 16
+      | uint32_t(begin[3]) << 24);
+
+    crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF]
+        ^ t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24]
+        ^ t[3][begin[4]] ^ t[2][begin[5]]
+        ^ t[1][begin[6]] ^ t[0][begin[7]];
+  }
+
+  for (; size; --size) {
+    crc = t[0][(crc ^ *begin++) & 0xFF] ^ (crc >> 8);
+  }
+
+  return crc;
+}
+
+#ifdef IRESEARCH_X86
+
+#if defined(_M_X64) || defined(__x86_64__)
+  typedef uint64_t word_t;
+
+  IRESEARCH_TARGET("sse4.2")
+  inline uint64_t crc_word(uint64_t crc, const byte_type* p) NOEXCEPT {
+    uint64_t word;
+    std::memcpy(&word, p, sizeof word);
+    return _mm_crc32_u64(crc, word);
+  }
+#else
+  typedef uint32_t word_t;
+
+  IRESEARCH_TARGET("sse4.2")
+  inline uint32_t crc_word(uint32_t crc, const byte_type* p) NOEXCEPT {
+    uint32_t word;
+    std::memcpy(&word, p, sizeof word);
+    return _mm_crc32_u32(crc, word);
+  }
+#endif
+
+IRESEARCH_TARGET("sse4.2")
+uint32_t update_sse42(
+    uint32_t crc, const byte_type* begin, size_t size
+) NOEXCEPT {
+  // the 'crc32' instruction has a latency of 3 cycles and a throughput of 1,
+  // hence large buffers are processed as 3 independent streams which are
+  // then combined together
+  for (; size >= 3*STREAM_SIZE; size -= 3*STREAM_SIZE) {
+    word_t crc0 = crc, crc1 = 0, crc2 = 0;
+
+    for (auto* end = begin + STREAM_SIZE; begin != end; begin += sizeof(word_t)) {
+      crc0 = crc_word(crc0, begin);
+      crc1 = crc_word(crc1, begin + STREAM_SIZE);
+      crc2 = crc_word(crc2, begin + 2*STREAM_SIZE);
+    }
+
+    begin += 2*STREAM_SIZE;
+
+    crc = multiply(uint32_t(crc0), TABLES.stream_shift) ^ uint32_t(crc1);
+    crc = multiply(crc, TABLES.stream_shift) ^ uint32_t(crc2);
+  }
+
+  word_t value = crc;
+
+  for (; size >= sizeof(word_t); size -= sizeof(word_t)) {
+    value = crc_word(value, begin);
+    begin += sizeof(word_t);
+  }
+
+  crc = uint32_t(value);
+
+  for (; size; --size) {
+    crc = _mm_crc32_u8(crc, *begin++);
+  }
+
+  return crc;
+}
+
+#endif // IRESEARCH_X86
+
+NS_END // NS_LOCAL
+
+NS_ROOT
+
+void crc32c::process_bytes(const void* buffer, size_t size) NOEXCEPT {
+  const auto* begin = static_cast<const byte_type*>(buffer);
+
+#ifdef IRESEARCH_X86
+  if (cpuinfo::support_sse42()) {
+    value_ = update_sse42(value_, begin, size);
+    return;
+  }
+#endif
+
+  value_ = update_slicing_by_8(value_, begin, size);
+}
+
+NS_END
@@ -0,0 +1,66 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef IRESEARCH_CRC_H
+#define IRESEARCH_CRC_H
+
+#include "shared.hpp"
+
+NS_ROOT
+
+////////////////////////////////////////////////////////////////////////////////
+/// @class crc32c
+/// @brief CRC-32C (Castagnoli) checksum, computed via the SSE4.2 'crc32'
+///        instruction where available and via slicing-by-8 otherwise,
+///        the interface mirrors the one of boost::crc_32_type
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API crc32c {
+ public:
+  typedef uint32_t value_type;
+
+  crc32c() NOEXCEPT : value_(INIT) { }
+
+  void process_byte(byte_type b) NOEXCEPT {
+    process_bytes(&b, 1);
+  }
+
+  void process_bytes(const void* buffer, size_t size) NOEXCEPT;
+
+  value_type checksum() const NOEXCEPT {
+    return value_ ^ INIT;
+  }
+
+  void reset() NOEXCEPT {
+    value_ = INIT;
+  }
+
+ private:
+  static const value_type INIT = 0xFFFFFFFF;
+
+  value_type value_; // current (non-finalized) remainder
+}; // crc32c
+
+NS_END
+
+#endif
@@ -80,6 +80,20 @@ uint32_t log(uint64_t x, uint64_t base) {
   return res;
 }
 
+sqrt_cache::sqrt_cache() NOEXCEPT {
+  static const struct table {
+    table() {
+      for (size_t i = 0; i < SIZE; ++i) {
+        values[i] = float_t(std::sqrt(i));
+      }
+    }
+
+    float_t values[SIZE];
+  } TABLE;
+
+  table_ = TABLE.values;
+}
+
 NS_END // math
 NS_END // root
 
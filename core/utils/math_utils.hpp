@@ -273,6 +273,25 @@ struct math_traits<uint64_t> {
   };
 #endif
 
+////////////////////////////////////////////////////////////////////////////////
+/// @class sqrt_cache
+/// @brief square roots of integers, e.g. of term frequencies, the roots of
+///        the small values are looked up in a table computed once per process
+////////////////////////////////////////////////////////////////////////////////
+class IRESEARCH_API sqrt_cache {
+ public:
+  static const size_t SIZE = 256;
+
+  sqrt_cache() NOEXCEPT;
+
+  FORCE_INLINE float_t operator()(uint64_t value) const NOEXCEPT {
+    return value < SIZE ? table_[value] : float_t(std::sqrt(value));
+  }
+
+ private:
+  const float_t* table_;
+}; // sqrt_cache
+
 NS_END // math
 NS_END // root
 
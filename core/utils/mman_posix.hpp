@@ -58,6 +58,9 @@
 
 #ifdef __linux__
 
+#undef IR_MADVISE_NORMAL
+#define IR_MADVISE_NORMAL MADV_NORMAL
+
 #undef IR_MADVISE_SEQUENTIAL
 #define IR_MADVISE_SEQUENTIAL MADV_SEQUENTIAL
 
@@ -27,6 +27,10 @@
 
 #include <cassert>
 
+#ifndef _MSC_VER
+  #include <unistd.h>
+#endif
+
 NS_ROOT
 NS_BEGIN(mmap_utils)
 
@@ -59,6 +63,28 @@ int flush(int fd, void* addr, size_t size, int flags) NOEXCEPT {
   return 0;
 }
 
+size_t page_size() NOEXCEPT {
+#ifdef _MSC_VER
+  return 4096; // madvise(...) is a stub under windows
+#else
+  static const size_t size = size_t(sysconf(_SC_PAGESIZE));
+  return size;
+#endif
+}
+
+bool mmap_handle::advise(size_t offset, size_t size, int advice) NOEXCEPT {
+  if (offset >= size_) {
+    return true; // nothing to advise
+  }
+
+  // madvise(...) requires a page aligned address
+  const auto mask = page_size() - 1;
+  const auto begin = offset & ~mask;
+  const auto end = size_ - offset > size ? offset + size : size_;
+
+  return !madvise(static_cast<char*>(addr_) + begin, end - begin, advice);
+}
+
 void mmap_handle::close() NOEXCEPT {
   if (addr_ != MAP_FAILED) {
     munmap(addr_, size_);
@@ -30,6 +30,7 @@
 /// @brief constants for madvise
 /// NOTE: It's important to define constants BEFORE the next include
 ////////////////////////////////////////////////////////////////////////////////
+#define IR_MADVISE_NORMAL 0
 #define IR_MADVISE_SEQUENTIAL 0
 #define IR_MADVISE_RANDOM 0
 #define IR_MADVISE_WILLNEED 0
@@ -50,6 +51,11 @@ NS_BEGIN(mmap_utils)
 //////////////////////////////////////////////////////////////////////////////
 int flush(int fd, void* addr, size_t size, int flags) NOEXCEPT;
 
+//////////////////////////////////////////////////////////////////////////////
+/// @returns size of the virtual memory page
+//////////////////////////////////////////////////////////////////////////////
+size_t page_size() NOEXCEPT;
+
 //////////////////////////////////////////////////////////////////////////////
 /// @class mmap_handle
 //////////////////////////////////////////////////////////////////////////////
@@ -80,6 +86,19 @@ class mmap_handle {
     );
   }
 
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief applies IR_MADVISE_* 'advice' to the whole mapped region
+  //////////////////////////////////////////////////////////////////////////////
+  bool advise(int advice) NOEXCEPT {
+    return advise(0, size_, advice);
+  }
+
+  //////////////////////////////////////////////////////////////////////////////
+  /// @brief applies IR_MADVISE_* 'advice' to the pages containing the
+  ///        specified part of the mapped region
+  //////////////////////////////////////////////////////////////////////////////
+  bool advise(size_t offset, size_t size, int advice) NOEXCEPT;
+
  private:
   void init() NOEXCEPT;
 
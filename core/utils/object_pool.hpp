@@ -27,6 +27,7 @@
 #include <algorithm>
 #include <atomic>
 #include <functional>
+#include <vector>
 
 #include "memory.hpp"
 #include "shared.hpp"
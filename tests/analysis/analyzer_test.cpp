@@ -116,3 +116,59 @@ TEST_F(analyzer_test, test_load) {
   ASSERT_EQ(nullptr, iresearch::analysis::analyzers::get("text", "{{\"locale\":\"en\", \"ignored_words\":\"abc\"}}"));
   ASSERT_EQ(nullptr, iresearch::analysis::analyzers::get("text", "{{\"locale\":\"en\", \"ignored_words\":[1, 2, 3]}}"));
 }
+
+TEST_F(analyzer_test, test_load_pooled) {
+  // released instance is reused for the same (name, args)
+  {
+    auto analyzer = irs::analysis::analyzers::get("text", "en", true);
+    ASSERT_NE(nullptr, analyzer);
+    ASSERT_TRUE(analyzer->reset("abc"));
+    auto* expected = analyzer.get();
+    analyzer.reset();
+
+    analyzer = irs::analysis::analyzers::get("text", "en", true);
+    ASSERT_EQ(expected, analyzer.get());
+    ASSERT_TRUE(analyzer->reset("def"));
+    ASSERT_TRUE(analyzer->next());
+
+    // instance in use is not handed out twice
+    auto other = irs::analysis::analyzers::get("text", "en", true);
+    ASSERT_NE(nullptr, other);
+    ASSERT_NE(analyzer.get(), other.get());
+
+    // different args produce a different instance
+    auto* in_use = other.get();
+    other.reset();
+    auto json = irs::analysis::analyzers::get("text", "{\"locale\":\"en\"}", true);
+    ASSERT_NE(nullptr, json);
+    ASSERT_NE(in_use, json.get());
+    ASSERT_NE(analyzer.get(), json.get());
+  }
+
+  // non-pooled instances are never reused
+  {
+    auto analyzer = irs::analysis::analyzers::get("delimited", ",", true);
+    ASSERT_NE(nullptr, analyzer);
+    auto unpooled = irs::analysis::analyzers::get("delimited", ",", false);
+    ASSERT_NE(nullptr, unpooled);
+    ASSERT_NE(analyzer.get(), unpooled.get());
+  }
+
+  // cleared pool does not take back instances in use
+  {
+    auto analyzer = irs::analysis::analyzers::get("delimited", ";", true);
+    ASSERT_NE(nullptr, analyzer);
+    irs::analysis::analyzers::clear_pool();
+    analyzer.reset(); // instance is destroyed instead of being pooled
+
+    auto other = irs::analysis::analyzers::get("delimited", ";", true);
+    ASSERT_NE(nullptr, other);
+    auto* expected = other.get();
+    other.reset();
+    ASSERT_EQ(expected, irs::analysis::analyzers::get("delimited", ";", true).get());
+  }
+
+  // invalid
+  ASSERT_EQ(nullptr, irs::analysis::analyzers::get("invalid_analyzer", "en", true));
+  ASSERT_EQ(nullptr, irs::analysis::analyzers::get("text", "{}", true));
+}
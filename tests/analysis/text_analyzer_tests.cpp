@@ -37,6 +37,7 @@
 
 #include <boost/locale/conversion.hpp>
 #include <boost/locale/generator.hpp>
+#include <tuple>
 #include "analysis/text_token_stream.hpp"
 #include "analysis/token_attributes.hpp"
 #include "analysis/token_stream.hpp"
@@ -259,6 +260,44 @@ TEST_F(TextAnalyzerParserTestSuite, test_text_analyzer) {
   }
 }
 
+TEST_F(TextAnalyzerParserTestSuite, test_ascii_fast_path) {
+  boost::locale::generator localeGenerator;
+  std::unordered_set<std::string> stopwordSet = { "the", "don't" };
+  std::locale locale = localeGenerator.generate("en_US.UTF-8");
+
+  typedef std::vector<std::tuple<std::string, uint32_t, uint32_t>> terms_t;
+
+  auto tokenize = [&locale, &stopwordSet](const std::string& data)->terms_t {
+    text_token_stream stream(locale, stopwordSet);
+    terms_t terms;
+
+    EXPECT_TRUE(stream.reset(data));
+
+    auto& offset = stream.attributes().get<iresearch::offset>();
+    auto& value = stream.attributes().get<iresearch::term_attribute>();
+
+    while (stream.next()) {
+      terms.emplace_back(
+        std::string((char*)(value->value().c_str()), value->value().size()),
+        offset->start,
+        offset->end
+      );
+    }
+
+    return terms;
+  };
+
+  std::string data = "\tThe QUICK brown fox's 3.14 e.g. U.S.A. 1,000;25 a'b. don't\r\nJumped \"over\" (x-ray) $100 10.5.a1 a1.5 tl;dr ..";
+
+  // a trailing non-ASCII word forces processing via ICU
+  auto expected = tokenize(data + " \xC3\xA9t\xC3\xA9");
+  ASSERT_FALSE(expected.empty());
+  expected.pop_back();
+
+  auto actual = tokenize(data);
+  ASSERT_EQ(expected, actual);
+}
+
 TEST_F(TextAnalyzerParserTestSuite, test_load_stopwords) {
   boost::locale::generator localeGenerator;
   std::unordered_set<std::string> emptySet;
@@ -30,6 +30,10 @@
 #include "formats/formats_10.hpp"
 #include "formats_test_case_base.hpp"
 #include "formats/format_utils.hpp"
+#include "utils/async_utils.hpp"
+
+#include <boost/crc.hpp>
+#include <thread>
 
 class format_10_test_case : public tests::format_test_case_base {
  protected:
@@ -564,6 +568,232 @@ class format_10_test_case : public tests::format_test_case_base {
     }
   }
 
+  // postings with the frequency depending on the document
+  class freq_postings : public irs::doc_iterator {
+   public:
+    class position : public irs::position::impl {
+     public:
+      virtual uint32_t value() const override { return begin_; }
+
+      virtual bool next() override {
+        if (begin_ == end_) {
+          begin_ = irs::position::NO_MORE;
+          return false;
+        }
+
+        ++begin_;
+        return true;
+      }
+
+      virtual void clear() override { }
+
+      uint32_t begin_{ irs::position::INVALID };
+      uint32_t end_{};
+    }; // position
+
+    static uint64_t freq(irs::doc_id_t doc) {
+      return 0 == doc % 1000 ? 500 : 1 + (doc * 7919) % 37;
+    }
+
+    freq_postings(const std::vector<irs::doc_id_t>& docs, const irs::flags& features)
+      : next_(docs.begin()), end_(docs.end()) {
+      attrs_.emplace(freq_);
+
+      if (features.check<irs::position>()) {
+        position_.reset(irs::memory::make_unique<position>());
+        attrs_.emplace(position_);
+      }
+    }
+
+    virtual bool next() override {
+      if (next_ == end_) {
+        doc_ = irs::type_limits<irs::type_t::doc_id_t>::eof();
+        return false;
+      }
+
+      doc_ = *next_++;
+      freq_.value = freq(doc_);
+
+      if (position_) {
+        auto* pos = static_cast<position*>(position_.get());
+        pos->begin_ = uint32_t(doc_);
+        pos->end_ = uint32_t(doc_ + freq_.value);
+      }
+
+      return true;
+    }
+
+    virtual irs::doc_id_t value() const override { return doc_; }
+
+    virtual irs::doc_id_t seek(irs::doc_id_t target) override {
+      irs::seek(*this, target);
+      return value();
+    }
+
+    virtual const irs::attribute_view& attributes() const NOEXCEPT override {
+      return attrs_;
+    }
+
+   private:
+    irs::attribute_view attrs_;
+    std::vector<irs::doc_id_t>::const_iterator next_;
+    std::vector<irs::doc_id_t>::const_iterator end_;
+    irs::frequency freq_;
+    irs::position position_;
+    irs::doc_id_t doc_{ irs::type_limits<irs::type_t::doc_id_t>::invalid() };
+  }; // freq_postings
+
+  void postings_block_max(const std::vector<irs::doc_id_t>& docs, const irs::flags& features) {
+    const size_t BLOCK_SIZE = irs::version10::postings_writer::BLOCK_SIZE;
+
+    irs::field_meta field;
+    field.features = features;
+
+    irs::version10::postings_writer writer(false);
+    irs::postings_writer::state term_meta; // must be destroyed before the writer
+
+    // write postings for field
+    {
+      irs::flush_state state;
+      state.dir = &dir();
+      state.doc_count = docs.back() + 1;
+      state.fields_count = 1;
+      state.name = "segment_name";
+      state.ver = IRESEARCH_VERSION;
+      state.features = &field.features;
+
+      auto out = dir().create("attributes");
+      ASSERT_FALSE(!out);
+
+      writer.prepare(*out, state);
+      writer.begin_field(field.features);
+
+      freq_postings it(docs, field.features);
+      term_meta = writer.write(it);
+      writer.encode(*out, *term_meta);
+      writer.end();
+    }
+
+    // expected max frequency of the term and of the blocks
+    uint64_t term_max_freq = 0;
+    std::vector<uint64_t> block_max_freq;
+
+    for (size_t i = 0; i < docs.size(); ++i) {
+      const auto freq = freq_postings::freq(docs[i]);
+      term_max_freq = std::max(term_max_freq, freq);
+
+      if (0 == i % BLOCK_SIZE) {
+        block_max_freq.emplace_back(freq);
+      } else {
+        block_max_freq.back() = std::max(block_max_freq.back(), freq);
+      }
+    }
+
+    // read postings
+    irs::segment_meta meta;
+    meta.name = "segment_name";
+
+    irs::reader_state state;
+    state.dir = &dir();
+    state.meta = &meta;
+
+    auto in = dir().open("attributes");
+    ASSERT_FALSE(!in);
+
+    irs::version10::postings_reader reader;
+    ASSERT_TRUE(reader.prepare(*in, state, field.features));
+
+    irs::frequency freq;
+    irs::version10::term_meta read_meta;
+    irs::attribute_view read_attrs;
+    read_attrs.emplace(freq);
+    read_attrs.emplace(read_meta);
+    reader.decode(*in, field.features, read_attrs, read_meta);
+    ASSERT_EQ(term_max_freq, read_meta.max_freq);
+
+    // frequency bounds are available on request only and require frequencies
+    ASSERT_FALSE(reader.iterator(field.features, read_attrs, field.features)->attributes().contains<irs::block_max>());
+    ASSERT_FALSE(reader.iterator(field.features, read_attrs, { irs::block_max::type() })->attributes().contains<irs::block_max>());
+
+    auto req = field.features;
+    req.add<irs::block_max>();
+
+    for (size_t step : { size_t(1), size_t(37), BLOCK_SIZE, 5*BLOCK_SIZE + 3 }) {
+      auto it = reader.iterator(field.features, read_attrs, req);
+      auto& max = it->attributes().get<irs::block_max>();
+      ASSERT_FALSE(!max);
+      ASSERT_EQ(term_max_freq, max->max_freq);
+      auto& doc_freq = it->attributes().get<irs::frequency>();
+      ASSERT_FALSE(!doc_freq);
+
+      for (size_t i = 0; i < docs.size(); i += step) {
+        const auto target = docs[i];
+        const size_t block = i / BLOCK_SIZE;
+        uint64_t max_freq = 0;
+        const auto block_end = max->shallow_seek(target, max_freq);
+
+        // every block followed by a document has its own bound
+        if ((block + 1) * BLOCK_SIZE < docs.size()) {
+          ASSERT_EQ(docs[(block + 1) * BLOCK_SIZE - 1], block_end);
+          ASSERT_EQ(block_max_freq[block], max_freq);
+        } else {
+          ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(block_end));
+          ASSERT_EQ(term_max_freq, max_freq);
+        }
+
+        // shallow seek doesn't affect the iterator
+        ASSERT_EQ(target, it->seek(target));
+        ASSERT_EQ(freq_postings::freq(target), doc_freq->value);
+        ASSERT_LE(doc_freq->value, max_freq);
+      }
+    }
+
+    // decoded blocks are available on request to the iterators without positions only
+    ASSERT_FALSE(reader.iterator(field.features, read_attrs, field.features)->attributes().contains<irs::doc_block>());
+
+    {
+      auto req = field.features;
+      req.add<irs::doc_block>();
+      auto it = reader.iterator(field.features, read_attrs, req);
+      auto& block = it->attributes().get<irs::doc_block>();
+      ASSERT_EQ(!field.features.check<irs::position>(), bool(block));
+
+      if (block) {
+        auto& doc_freq = it->attributes().get<irs::frequency>();
+        ASSERT_FALSE(!doc_freq);
+        size_t i = 0;
+        const irs::doc_id_t* block_docs;
+        const uint64_t* block_freqs;
+
+        while (auto count = block->next(BLOCK_SIZE + 1, block_docs, block_freqs)) {
+          ASSERT_GE(BLOCK_SIZE, count);
+          ASSERT_NE(nullptr, block_freqs);
+
+          for (size_t j = 0; j < count; ++j, ++i) {
+            ASSERT_EQ(docs[i], block_docs[j]);
+            ASSERT_EQ(freq_postings::freq(docs[i]), block_freqs[j]);
+          }
+
+          ASSERT_EQ(docs[i - 1], it->value());
+          ASSERT_EQ(freq_postings::freq(docs[i - 1]), doc_freq->value);
+        }
+
+        ASSERT_EQ(docs.size(), i);
+      }
+    }
+  }
+
+  void postings_block_max() {
+    for (size_t count : { size_t(1), size_t(117), size_t(128), size_t(129), size_t(10000) }) {
+      std::vector<irs::doc_id_t> docs;
+      auto i = (irs::type_limits<irs::type_t::doc_id_t>::min)();
+      std::generate_n(std::back_inserter(docs), count, [&i]() { return i += 3; });
+
+      postings_block_max(docs, { irs::frequency::type() });
+      postings_block_max(docs, { irs::frequency::type(), irs::position::type() });
+    }
+  }
+
   void postings_seek() {
     // bug: ires336
     {
@@ -717,6 +947,108 @@ class format_10_test_case : public tests::format_test_case_base {
       postings_seek(docs, { ir::frequency::type(), ir::position::type(), ir::offset::type(), ir::payload::type() });
     }
   }
+
+  void checksums() {
+    auto write = [this](const std::string& name, const irs::bytes_ref& data)->void {
+      auto out = dir().create(name);
+      ASSERT_FALSE(!out);
+      irs::format_utils::write_header(*out, "checksums", 0);
+      out->write_bytes(data.c_str(), data.size());
+      irs::format_utils::write_footer(*out);
+    };
+
+    const irs::bstring data(1000000, irs::byte_type(0xA5));
+    irs::segment_meta meta("checksums", get_codec());
+    meta.files.emplace("crc32c");
+    meta.files.emplace("crc32");
+    meta.files.emplace("crc32_output");
+    meta.files.emplace("trailer");
+
+    write("crc32c", data);
+
+    // footer of the versions computing boost::crc_32_type checksums
+    {
+      irs::bstring buf(data);
+      for (auto value : { irs::format_utils::FOOTER_MAGIC, irs::format_utils::FOOTER_CRC32 }) {
+        for (size_t i = sizeof(int32_t); i; --i) {
+          buf.push_back(irs::byte_type(uint32_t(value) >> 8*(i - 1)));
+        }
+      }
+
+      boost::crc_32_type crc;
+      crc.process_bytes(buf.c_str(), buf.size());
+
+      auto out = dir().create("crc32");
+      ASSERT_FALSE(!out);
+      out->write_bytes(buf.c_str(), buf.size());
+      out->write_long(crc.checksum());
+    }
+
+    // output computing boost::crc_32_type checksums, e.g. of a custom directory
+    {
+      irs::checksum_index_output<boost::crc_32_type> out(dir().create("crc32_output"));
+      irs::format_utils::write_header(out, "checksums", 0);
+      out.write_bytes(data.c_str(), data.size());
+      irs::format_utils::write_footer(out);
+    }
+
+    // data after the footer, the file is skipped
+    {
+      auto out = dir().create("trailer");
+      ASSERT_FALSE(!out);
+      irs::format_utils::write_footer(*out);
+      out->write_int(42);
+    }
+
+    for (auto& name : meta.files) {
+      auto in = dir().open(name);
+      ASSERT_FALSE(!in);
+      ASSERT_EQ(
+        "crc32" == name || "crc32_output" == name
+          ? irs::format_utils::FOOTER_CRC32
+          : irs::format_utils::FOOTER_CRC32C,
+        "trailer" == name ? irs::format_utils::FOOTER_CRC32C : irs::format_utils::checksum_type(*in)
+      );
+    }
+
+    irs::format_utils::check_checksums(dir(), meta);
+
+    {
+      irs::async_utils::thread_pool pool(meta.files.size(), meta.files.size());
+      irs::format_utils::check_checksums(dir(), meta, &pool);
+    }
+
+    // corrupted file, the footer is kept intact
+    {
+      int64_t checksum;
+      {
+        auto in = dir().open("crc32c");
+        ASSERT_FALSE(!in);
+        checksum = irs::format_utils::read_checksum(*in);
+      }
+
+      auto corrupted = data;
+      corrupted[data.size() / 2] ^= 1;
+
+      {
+        auto out = dir().create("crc32c");
+        ASSERT_FALSE(!out);
+        irs::format_utils::write_header(*out, "checksums", 0);
+        out->write_bytes(corrupted.c_str(), corrupted.size());
+        out->write_int(irs::format_utils::FOOTER_MAGIC);
+        out->write_int(irs::format_utils::FOOTER_CRC32C);
+        out->write_long(checksum);
+      }
+
+      auto in = dir().open("crc32c");
+      ASSERT_FALSE(!in);
+      ASSERT_EQ(checksum, irs::format_utils::read_checksum(*in));
+      ASSERT_THROW(irs::format_utils::check_checksum(*in), irs::index_error);
+
+      irs::async_utils::thread_pool pool(meta.files.size(), meta.files.size());
+      ASSERT_THROW(irs::format_utils::check_checksums(dir(), meta, &pool), irs::index_error);
+    }
+  }
 }; // format_10_test_case
 
 // ----------------------------------------------------------------------------
@@ -747,6 +1079,10 @@ TEST_F(memory_format_10_test_case, postings_seek) {
   postings_seek();
 }
 
+TEST_F(memory_format_10_test_case, postings_block_max) {
+  postings_block_max();
+}
+
 TEST_F(memory_format_10_test_case, segment_meta_rw) {
   segment_meta_read_write();
 }
@@ -769,6 +1105,146 @@ TEST_F(memory_format_10_test_case, document_mask_rw) {
   document_mask_read_write();
 }
 
+TEST_F(memory_format_10_test_case, checksums) {
+  checksums();
+}
+
+TEST_F(memory_format_10_test_case, columns_cache) {
+  const irs::doc_id_t MAX_DOC = 20000;
+  const size_t LIMIT = 1 << 16; // fits a few blocks only
+
+  irs::segment_meta segment("_1", nullptr);
+  segment.codec = codec();
+
+  irs::field_id id;
+
+  // write column spanning multiple blocks
+  {
+    auto writer = codec()->get_columnstore_writer();
+    ASSERT_TRUE(writer->prepare(dir(), segment));
+
+    auto column = writer->push_column();
+    id = column.first;
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOC; ++doc) {
+      auto& out = column.second(doc);
+      irs::write_string(out, std::to_string(doc));
+      ++segment.docs_count;
+    }
+
+    ASSERT_TRUE(writer->flush());
+  }
+
+  const auto prev_limit = irs::version10::columnstore_cache::limit();
+  auto restore_limit = irs::make_finally([prev_limit]()->void {
+    irs::version10::columnstore_cache::limit(prev_limit);
+  });
+
+  irs::version10::columnstore_cache::limit(LIMIT);
+
+  auto reader = codec()->get_columnstore_reader();
+  ASSERT_TRUE(reader->prepare(dir(), segment));
+
+  auto column = reader->column(id);
+  ASSERT_NE(nullptr, column);
+
+  const auto before = irs::version10::columnstore_cache::statistics();
+  ASSERT_EQ(LIMIT, before.limit);
+
+  // random access, 2 passes
+  for (size_t pass = 0; pass < 2; ++pass) {
+    auto values = column->values();
+    irs::bytes_ref actual;
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOC; ++doc) {
+      ASSERT_TRUE(values(doc, actual));
+      irs::bytes_ref_input in(actual);
+      ASSERT_EQ(std::to_string(doc), irs::read_string<std::string>(in));
+    }
+  }
+
+  // iterator keeps current block pinned while the cache evicts
+  {
+    auto it = column->iterator();
+    auto values = column->values();
+    irs::bytes_ref actual;
+    irs::doc_id_t doc = 0;
+
+    while (it->next()) {
+      ++doc;
+      ASSERT_EQ(doc, it->value().first);
+      ASSERT_TRUE(values(MAX_DOC + 1 - doc, actual)); // walk from the other end
+
+      irs::bytes_ref_input in(it->value().second);
+      ASSERT_EQ(std::to_string(doc), irs::read_string<std::string>(in));
+    }
+
+    ASSERT_EQ(MAX_DOC, doc);
+  }
+
+  // copies of a values reader used by the same thread don't unpin
+  // blocks of each other
+  {
+    auto head = column->values();
+    auto tail = head;
+    irs::bytes_ref head_actual, tail_actual;
+
+    for (irs::doc_id_t doc = 1; doc <= MAX_DOC; ++doc) {
+      ASSERT_TRUE(head(doc, head_actual));
+      ASSERT_TRUE(tail(MAX_DOC + 1 - doc, tail_actual)); // evicts 'head' block
+
+      irs::bytes_ref_input head_in(head_actual);
+      ASSERT_EQ(std::to_string(doc), irs::read_string<std::string>(head_in));
+      irs::bytes_ref_input tail_in(tail_actual);
+      ASSERT_EQ(std::to_string(MAX_DOC + 1 - doc), irs::read_string<std::string>(tail_in));
+    }
+  }
+
+  // copies of a values reader used by different threads, every copy pins
+  // its own block
+  {
+    const size_t THREADS = 4;
+    const auto values = column->values();
+    std::vector<std::thread> threads;
+    std::atomic<size_t> mismatches{ 0 };
+
+    for (size_t i = 0; i < THREADS; ++i) {
+      threads.emplace_back([values, &mismatches, i, THREADS, MAX_DOC]()->void {
+        irs::bytes_ref actual;
+
+        for (irs::doc_id_t doc = irs::doc_id_t(1 + i); doc <= MAX_DOC; doc += THREADS) {
+          if (!values(doc, actual)) {
+            ++mismatches;
+            continue;
+          }
+
+          irs::bytes_ref_input in(actual);
+
+          if (std::to_string(doc) != irs::read_string<std::string>(in)) {
+            ++mismatches;
+          }
+        }
+      });
+    }
+
+    for (auto& thread : threads) {
+      thread.join();
+    }
+
+    ASSERT_EQ(0, mismatches.load());
+  }
+
+  const auto after = irs::version10::columnstore_cache::statistics();
+  ASSERT_LE(after.size, LIMIT);
+  ASSERT_LT(before.misses, after.misses);
+  ASSERT_LT(before.hits, after.hits);
+  ASSERT_LT(before.evictions, after.evictions);
+
+  // shrinking the cache evicts immediately
+  irs::version10::columnstore_cache::limit(0);
+  ASSERT_EQ(0, irs::version10::columnstore_cache::statistics().size);
+}
+
 // ----------------------------------------------------------------------------
 // --SECTION--                               fs_directory + iresearch_format_10
 // ----------------------------------------------------------------------------
@@ -826,3 +1302,7 @@ TEST_F(fs_format_10_test_case, columns_meta_rw) {
 TEST_F(fs_format_10_test_case, document_mask_rw) {
   document_mask_read_write();
 }
+
+TEST_F(fs_format_10_test_case, checksums) {
+  checksums();
+}
@@ -33,6 +33,7 @@
 #include "iql/query_builder.hpp"
 
 #include "analysis/token_attributes.hpp"
+#include "formats/format_utils.hpp"
 #include "store/memory_directory.hpp"
 #include "utils/version_utils.hpp"
 
@@ -812,6 +813,7 @@ class format_test_case_base : public index_test_base {
     const std::unordered_set<iresearch::doc_id_t> mask_set = { 1, 4, 5, 7, 10, 12 };
     iresearch::segment_meta meta("_1", nullptr);
     meta.version = 42;
+    meta.docs_count = 12;
 
     // write document_mask
     {
@@ -848,6 +850,95 @@ class format_test_case_base : public index_test_base {
       EXPECT_EQ(true, expected.empty());
       reader->end();
     }
+
+    // write whole document_mask, every 3rd document and a masked range
+    iresearch::document_mask mask;
+
+    for (iresearch::doc_id_t doc = 1; doc < 1000; doc += 3) {
+      ASSERT_TRUE(mask.insert(doc));
+    }
+
+    for (iresearch::doc_id_t doc = 1000; doc < 1200; ++doc) {
+      mask.insert(doc);
+    }
+
+    ASSERT_FALSE(mask.insert(1));
+    ASSERT_EQ(333 + 200, mask.size());
+    ASSERT_EQ(2, mask.next_live(1));
+    ASSERT_EQ(998, mask.next_live(997));
+    ASSERT_EQ(1200, mask.next_live(1000));
+    ASSERT_EQ(1500, mask.next_live(1500));
+
+    meta.version = 43;
+    meta.docs_count = 1500;
+
+    {
+      auto writer = codec()->get_document_mask_writer();
+
+      writer->prepare(dir(), meta);
+      writer->begin(static_cast<uint32_t>(mask.size()));
+      writer->write(mask);
+      writer->end();
+    }
+
+    // read whole document_mask
+    {
+      auto reader = codec()->get_document_mask_reader();
+      iresearch::document_mask actual;
+
+      ASSERT_TRUE(reader->prepare(dir(), meta));
+      reader->read(actual, reader->begin());
+      reader->end();
+
+      ASSERT_EQ(mask.size(), actual.size());
+      ASSERT_TRUE(mask.visit([&actual](iresearch::doc_id_t doc)->bool {
+        return actual.contains(doc);
+      }));
+    }
+
+    // document_mask doesn't match the segment
+    {
+      auto read_meta = meta;
+      read_meta.docs_count = 100000;
+
+      auto reader = codec()->get_document_mask_reader();
+      iresearch::document_mask actual;
+
+      ASSERT_TRUE(reader->prepare(dir(), read_meta));
+      ASSERT_THROW(reader->read(actual, reader->begin()), iresearch::index_error);
+    }
+
+    // document_mask missing some words
+    {
+      auto read_meta = meta;
+      ++read_meta.version;
+
+      auto writer = codec()->get_document_mask_writer();
+      auto in = dir().open(writer->filename(meta));
+      ASSERT_NE(nullptr, in);
+      auto out = dir().create(writer->filename(read_meta));
+      ASSERT_NE(nullptr, out);
+
+      // drop the last 8 words keeping the footer
+      const size_t footer = iresearch::format_utils::FOOTER_LEN;
+      const size_t length = in->length();
+      ASSERT_LT(footer + 64, length);
+
+      for (size_t i = 0; i < length; ++i) {
+        const auto b = in->read_byte();
+
+        if (i < length - footer - 64 || i >= length - footer) {
+          out->write_byte(b);
+        }
+      }
+
+      out.reset();
+
+      auto reader = codec()->get_document_mask_reader();
+
+      ASSERT_TRUE(reader->prepare(dir(), read_meta));
+      ASSERT_THROW(reader->begin(), iresearch::index_error);
+    }
   }
 
   void column_iterator_constants() {
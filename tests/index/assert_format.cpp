@@ -290,7 +290,7 @@ void document_mask_writer::begin(uint32_t count) {
 }
 
 void document_mask_writer::write(const iresearch::doc_id_t& doc_id) {
-  EXPECT_EQ(true, data_.doc_mask().find(doc_id) != data_.doc_mask().end());
+  EXPECT_TRUE(data_.doc_mask().contains(doc_id));
 }
 
 void document_mask_writer::end() { }
@@ -33,6 +33,7 @@
 #include "store/mmap_directory.hpp"
 #include "store/memory_directory.hpp"
 #include "index/index_reader.hpp"
+#include "index/segment_reader.hpp"
 #include "utils/async_utils.hpp"
 #include "utils/index_utils.hpp"
 #include "utils/numeric_utils.hpp"
@@ -7820,6 +7821,51 @@ TEST_F(memory_index_test, concurrent_add_mt) {
   }
 }
 
+TEST_F(memory_index_test, concurrent_add_commit_mt) {
+  tests::json_doc_generator gen(resource("simple_sequential.json"), &tests::generic_json_field_factory);
+  std::vector<const tests::document*> docs;
+
+  for (const tests::document* doc; (doc = gen.next()) != nullptr; docs.emplace_back(doc)) {}
+
+  {
+    auto writer = open_writer();
+    const size_t thread_count = 8;
+    const size_t repeat = 10;
+    std::atomic<size_t> running(thread_count);
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&writer, &docs, &running, t, thread_count, repeat]()->void {
+        for (size_t r = 0; r < repeat; ++r) {
+          for (size_t i = t, count = docs.size(); i < count; i += thread_count) {
+            auto& doc = docs[i];
+            ASSERT_TRUE(insert(*writer,
+              doc->indexed.begin(), doc->indexed.end(),
+              doc->stored.begin(), doc->stored.end()
+            ));
+          }
+        }
+
+        --running;
+      });
+    }
+
+    // flush contexts are swapped while the documents are being inserted
+    while (running) {
+      writer->commit();
+    }
+
+    for (auto& thread: threads) {
+      thread.join();
+    }
+
+    writer->commit();
+
+    auto reader = iresearch::directory_reader::open(dir(), codec());
+    ASSERT_EQ(repeat * docs.size(), reader.docs_count());
+  }
+}
+
 TEST_F(memory_index_test, concurrent_add_remove_mt) {
   tests::json_doc_generator gen(
     resource("simple_sequential.json"),
@@ -7901,6 +7947,693 @@ TEST_F(memory_index_test, concurrent_add_remove_mt) {
   }
 }
 
+TEST_F(memory_index_test, parallel_commit_mt) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    [] (tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+    if (data.is_string()) {
+      doc.insert(std::make_shared<tests::templates::string_field>(
+        ir::string_ref(name),
+        data.str
+      ));
+    }
+  });
+  std::vector<const tests::document*> docs;
+
+  for (const tests::document* doc; (doc = gen.next()) != nullptr; docs.emplace_back(doc)) {}
+
+  ASSERT_LT(4, docs.size());
+
+  irs::timer_utils::init_stats(true);
+
+  irs::index_writer::options options;
+  options.commit_threads = 4;
+  auto writer = irs::index_writer::make(dir(), codec(), irs::OM_CREATE, options);
+
+  // existing segment with the first 2 documents ('A', 'B')
+  for (size_t i = 0; i < 2; ++i) {
+    auto& doc = docs[i];
+    ASSERT_TRUE(insert(*writer,
+      doc->indexed.begin(), doc->indexed.end(),
+      doc->stored.begin(), doc->stored.end()
+    ));
+  }
+
+  writer->commit();
+
+  // multiple segment writers flushed concurrently
+  {
+    std::vector<std::thread> threads;
+    const size_t thread_count = 4;
+
+    for (size_t t = 0; t < thread_count; ++t) {
+      threads.emplace_back([&writer, &docs, t, thread_count]()->void {
+        for (size_t i = 2 + t, count = docs.size(); i < count; i += thread_count) {
+          auto& doc = docs[i];
+          ASSERT_TRUE(insert(*writer,
+            doc->indexed.begin(), doc->indexed.end(),
+            doc->stored.begin(), doc->stored.end()
+          ));
+        }
+      });
+    }
+
+    for (auto& thread: threads) {
+      thread.join();
+    }
+  }
+
+  irs::by_term remove_existing; // document in existing segment
+  irs::by_term remove_flushed; // document in a flushed segment
+
+  remove_existing.field("name").term("A");
+  remove_flushed.field("name").term("D");
+  writer->remove(remove_existing);
+  writer->remove(remove_flushed);
+  writer->commit();
+
+  std::unordered_set<irs::string_ref> expected;
+
+  for (size_t i = 0, count = docs.size(); i < count; ++i) {
+    if (i != 0 && i != 3) {
+      expected.emplace(
+        static_cast<const tests::templates::string_field&>(*docs[i]->stored.get("name")).value()
+      );
+    }
+  }
+
+  auto reader = iresearch::directory_reader::open(dir(), codec());
+  ASSERT_EQ(docs.size(), reader.docs_count());
+  ASSERT_EQ(docs.size() - 2, reader.live_docs_count());
+
+  irs::bytes_ref actual_value;
+
+  for (auto& segment: reader) {
+    const auto* column = segment.column_reader("name");
+    ASSERT_NE(nullptr, column);
+    auto values = column->values();
+    auto terms = segment.field("same");
+    ASSERT_NE(nullptr, terms);
+    auto termItr = terms->iterator();
+    ASSERT_TRUE(termItr->next());
+    auto docsItr = segment.mask(termItr->postings(iresearch::flags()));
+    while(docsItr->next()) {
+      ASSERT_TRUE(values(docsItr->value(), actual_value));
+      ASSERT_EQ(1, expected.erase(irs::to_string<irs::string_ref>(actual_value.c_str())));
+    }
+  }
+
+  ASSERT_TRUE(expected.empty());
+
+  // every commit phase is reported
+  std::unordered_set<std::string> phases = {
+    irs::index_writer::COMMIT_PHASE_FLUSH,
+    irs::index_writer::COMMIT_PHASE_DOCUMENT_MASK,
+    irs::index_writer::COMMIT_PHASE_SEGMENT_META,
+    irs::index_writer::COMMIT_PHASE_CONSOLIDATE,
+    irs::index_writer::COMMIT_PHASE_SYNC
+  };
+
+  irs::timer_utils::visit([&phases](const std::string& key, size_t count, size_t)->bool {
+    if (count) {
+      phases.erase(key);
+    }
+
+    return true;
+  });
+  ASSERT_TRUE(phases.empty());
+}
+
+TEST_F(memory_index_test, parallel_commit_chained_update) {
+  irs::index_writer::options options;
+  options.commit_threads = 4;
+  auto writer = irs::index_writer::make(dir(), codec(), irs::OM_CREATE, options);
+
+  auto name = std::make_shared<tests::templates::string_field>("name");
+  auto fill = [&name](irs::index_writer::document& doc, const std::string& value) {
+    name->value(value);
+    doc.insert<irs::Action::INDEX>(*name);
+    doc.insert<irs::Action::STORE>(*name);
+  };
+
+  const size_t count = 64;
+
+  // 'A<i>' is buffered by one segment writer, its replacement 'B<i>' by
+  // another one, i.e. the update chains span the writers
+  {
+    size_t i = 0;
+
+    ASSERT_TRUE(writer->insert([&](irs::index_writer::document& doc)->bool {
+      fill(doc, "A" + std::to_string(i));
+
+      // the writer of the outer insert is busy
+      auto replaced = irs::by_term::make();
+      static_cast<irs::by_term&>(*replaced).field("name").term("A" + std::to_string(i));
+      EXPECT_TRUE(writer->update(std::move(replaced), [&](irs::index_writer::document& replacement)->bool {
+        fill(replacement, "B" + std::to_string(i));
+        return false;
+      }));
+
+      return ++i < count;
+    }));
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    auto replaced = irs::by_term::make();
+    static_cast<irs::by_term&>(*replaced).field("name").term("B" + std::to_string(i));
+    ASSERT_TRUE(writer->update(std::move(replaced), [&](irs::index_writer::document& doc)->bool {
+      fill(doc, "C" + std::to_string(i));
+      return false;
+    }));
+  }
+
+  writer->commit();
+
+  // only the last documents of the chains are live
+  std::unordered_set<std::string> expected;
+
+  for (size_t i = 0; i < count; ++i) {
+    expected.emplace("C" + std::to_string(i));
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(count, reader.live_docs_count());
+  irs::bytes_ref value;
+
+  for (auto& segment: reader) {
+    const auto* column = segment.column_reader("name");
+    ASSERT_NE(nullptr, column);
+    auto values = column->values();
+
+    for (auto it = segment.docs_iterator(); it->next();) {
+      ASSERT_TRUE(values(it->value(), value));
+      ASSERT_EQ(1, expected.erase(irs::to_string<std::string>(value.c_str())));
+    }
+  }
+
+  ASSERT_TRUE(expected.empty());
+}
+
+TEST_F(memory_index_test, memory_flush_mt) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    [] (tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+    if (data.is_string()) {
+      doc.insert(std::make_shared<tests::templates::string_field>(
+        ir::string_ref(name),
+        data.str
+      ));
+    }
+  });
+  std::vector<const tests::document*> docs;
+
+  for (const tests::document* doc; (doc = gen.next()) != nullptr; docs.emplace_back(doc)) {}
+
+  ASSERT_LT(4, docs.size());
+
+  irs::index_writer::options per_writer; // every document crosses the limit
+  per_writer.segment_memory_max = 1;
+
+  irs::index_writer::options total; // flushed on the inserting thread
+  total.memory_max = 1;
+
+  irs::index_writer::options background;
+  background.segment_memory_max = 1;
+  background.flush_threads = 2;
+
+  for (auto* options: { &per_writer, &total, &background }) {
+    irs::memory_directory dir;
+    auto writer = irs::index_writer::make(dir, codec(), irs::OM_CREATE, *options);
+
+    {
+      std::vector<std::thread> threads;
+      const size_t thread_count = 2;
+
+      for (size_t t = 0; t < thread_count; ++t) {
+        threads.emplace_back([&writer, &docs, t, thread_count]()->void {
+          for (size_t i = t, count = docs.size(); i < count; i += thread_count) {
+            auto& doc = docs[i];
+            ASSERT_TRUE(insert(*writer,
+              doc->indexed.begin(), doc->indexed.end(),
+              doc->stored.begin(), doc->stored.end()
+            ));
+          }
+        });
+      }
+
+      for (auto& thread: threads) {
+        thread.join();
+      }
+    }
+
+    // flushed segments are not committed
+    ASSERT_THROW(irs::directory_reader::open(dir, codec()), irs::index_not_found);
+
+    // removals apply to the documents inserted before, i.e. flushed ones
+    irs::by_term remove; // document in a flushed segment
+    remove.field("name").term("D");
+    writer->remove(remove);
+    writer->commit();
+
+    auto reader = iresearch::directory_reader::open(dir, codec());
+    // every document is flushed into a segment of its own, commit drops the
+    // segment of the removed document since it's fully masked
+    ASSERT_EQ(docs.size() - 1, reader.docs_count());
+    ASSERT_EQ(docs.size() - 1, reader.live_docs_count());
+    ASSERT_EQ(docs.size() - 1, reader.size()); // a segment per flush
+
+    std::unordered_set<irs::string_ref> expected;
+
+    for (size_t i = 0, count = docs.size(); i < count; ++i) {
+      if (i != 3) {
+        expected.emplace(
+          static_cast<const tests::templates::string_field&>(*docs[i]->stored.get("name")).value()
+        );
+      }
+    }
+
+    irs::bytes_ref actual_value;
+
+    for (auto& segment: reader) {
+      const auto* column = segment.column_reader("name");
+      ASSERT_NE(nullptr, column);
+      auto values = column->values();
+      auto terms = segment.field("same");
+      ASSERT_NE(nullptr, terms);
+      auto termItr = terms->iterator();
+      ASSERT_TRUE(termItr->next());
+      auto docsItr = segment.mask(termItr->postings(iresearch::flags()));
+      while(docsItr->next()) {
+        ASSERT_TRUE(values(docsItr->value(), actual_value));
+        ASSERT_EQ(1, expected.erase(irs::to_string<irs::string_ref>(actual_value.c_str())));
+      }
+    }
+
+    ASSERT_TRUE(expected.empty());
+    ASSERT_EQ(0, writer->buffered_docs());
+  }
+}
+
+TEST_F(memory_index_test, memory_flush_failure) {
+  struct failing_directory : tests::directory_mock {
+    failing_directory(ir::directory& impl) : tests::directory_mock(impl) {}
+
+    virtual ir::index_output::ptr create(
+      const std::string& name
+    ) NOEXCEPT override {
+      // postings are written by the flush only
+      if (fail && irs::string_ref(name).size() > 4
+          && ".doc" == irs::string_ref(name.c_str() + name.size() - 4)) {
+        return nullptr;
+      }
+
+      return tests::directory_mock::create(name);
+    }
+
+    bool fail{};
+  }; // failing_directory
+
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    &tests::generic_json_field_factory
+  );
+  const tests::document* doc1 = gen.next();
+  const tests::document* doc2 = gen.next();
+  const tests::document* doc3 = gen.next();
+
+  // memory is not accounted without the limits
+  {
+    auto writer = open_writer();
+    ASSERT_TRUE(insert(*writer,
+      doc1->indexed.begin(), doc1->indexed.end(),
+      doc1->stored.begin(), doc1->stored.end()
+    ));
+    ASSERT_EQ(0, writer->buffered_memory());
+  }
+
+  // memory is accounted in batches below the limit
+  {
+    irs::memory_directory dir;
+    irs::index_writer::options options;
+    options.memory_max = size_t(1) << 40; // never crossed
+    auto writer = irs::index_writer::make(dir, codec(), irs::OM_CREATE, options);
+    ASSERT_EQ(0, writer->buffered_memory());
+
+    for (size_t i = 0; i < 100000 && !writer->buffered_memory(); ++i) {
+      ASSERT_TRUE(insert(*writer,
+        doc1->indexed.begin(), doc1->indexed.end(),
+        doc1->stored.begin(), doc1->stored.end()
+      ));
+    }
+
+    const auto memory = writer->buffered_memory();
+    ASSERT_LT(0, memory);
+
+    for (size_t i = 0; i < 100000 && memory == writer->buffered_memory(); ++i) {
+      ASSERT_TRUE(insert(*writer,
+        doc2->indexed.begin(), doc2->indexed.end(),
+        doc2->stored.begin(), doc2->stored.end()
+      ));
+    }
+
+    ASSERT_LT(memory, writer->buffered_memory());
+    writer->commit();
+    ASSERT_EQ(0, writer->buffered_memory());
+  }
+
+  irs::memory_directory impl;
+  failing_directory dir(impl);
+  irs::index_writer::options options; // every document crosses the limit
+  options.segment_memory_max = 1;
+  auto writer = irs::index_writer::make(dir, codec(), irs::OM_CREATE, options);
+
+  ASSERT_TRUE(insert(*writer,
+    doc1->indexed.begin(), doc1->indexed.end(),
+    doc1->stored.begin(), doc1->stored.end()
+  ));
+  dir.fail = true;
+  ASSERT_TRUE(insert(*writer,
+    doc2->indexed.begin(), doc2->indexed.end(),
+    doc2->stored.begin(), doc2->stored.end()
+  ));
+  dir.fail = false;
+  ASSERT_TRUE(insert(*writer,
+    doc3->indexed.begin(), doc3->indexed.end(),
+    doc3->stored.begin(), doc3->stored.end()
+  ));
+  ASSERT_EQ(0, writer->buffered_memory()); // every document is flushed
+
+  // the failure is reported, segments flushed successfully are committed
+  ASSERT_THROW(writer->commit(), irs::index_error);
+
+  auto reader = irs::directory_reader::open(impl, codec());
+  ASSERT_EQ(2, reader.size());
+  ASSERT_EQ(2, reader.docs_count());
+
+  // the failure is reported once
+  writer->commit();
+
+  // a failure is reported even if there is nothing else to commit
+  dir.fail = true;
+  ASSERT_TRUE(insert(*writer,
+    doc2->indexed.begin(), doc2->indexed.end(),
+    doc2->stored.begin(), doc2->stored.end()
+  ));
+  dir.fail = false;
+  ASSERT_THROW(writer->commit(), irs::index_error);
+  writer->commit();
+
+  reader = reader.reopen();
+  ASSERT_EQ(2, reader.docs_count());
+}
+
+TEST_F(memory_index_test, masked_postings) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    &tests::generic_json_field_factory
+  );
+  std::vector<const tests::document*> docs;
+
+  for (const tests::document* doc; (doc = gen.next()) != nullptr; docs.emplace_back(doc)) {}
+
+  ASSERT_EQ(32, docs.size());
+
+  {
+    auto writer = open_writer();
+
+    for (auto* doc: docs) {
+      ASSERT_TRUE(insert(*writer,
+        doc->indexed.begin(), doc->indexed.end(),
+        doc->stored.begin(), doc->stored.end()
+      ));
+    }
+
+    writer->commit();
+  }
+
+  auto reader = iresearch::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  auto* segment = dynamic_cast<const irs::segment_reader*>(&reader[0]);
+  ASSERT_NE(nullptr, segment);
+
+  // runs of masked documents within a word and up to the last document
+  irs::document_mask mask;
+  mask.insert(1);
+  for (irs::doc_id_t doc = 3; doc <= 20; ++doc) {
+    mask.insert(doc);
+  }
+  mask.insert(22);
+  mask.insert(32);
+
+  auto masked = segment->masked(std::move(mask));
+  auto terms = masked.field("same");
+  ASSERT_NE(nullptr, terms);
+  auto term = terms->iterator();
+  ASSERT_TRUE(term->next());
+
+  // next
+  {
+    std::vector<irs::doc_id_t> expected{ 2, 21, 23, 24, 25, 26, 27, 28, 29, 30, 31 };
+    std::vector<irs::doc_id_t> actual;
+
+    for (auto it = masked.mask(term->postings(irs::flags())); it->next();) {
+      actual.emplace_back(it->value());
+    }
+
+    ASSERT_EQ(expected, actual);
+  }
+
+  // seek
+  {
+    auto it = masked.mask(term->postings(irs::flags()));
+    ASSERT_EQ(2, it->seek(1));
+    ASSERT_EQ(21, it->seek(3));
+    ASSERT_EQ(21, it->value());
+    ASSERT_EQ(23, it->seek(22));
+    ASSERT_TRUE(it->next());
+    ASSERT_EQ(24, it->value());
+    ASSERT_EQ(31, it->seek(31));
+    ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(it->seek(32)));
+    ASSERT_FALSE(it->next());
+  }
+}
+
+TEST_F(memory_index_test, nrt_reader) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    [] (tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+    if (data.is_string()) {
+      doc.insert(std::make_shared<tests::templates::string_field>(
+        ir::string_ref(name),
+        data.str
+      ));
+    }
+  });
+
+  tests::document const* doc1 = gen.next();
+  tests::document const* doc2 = gen.next();
+  tests::document const* doc3 = gen.next();
+  tests::document const* doc4 = gen.next();
+
+  // names of the live documents visible via the reader
+  auto live_names = [](const irs::index_reader& reader)->std::unordered_set<std::string> {
+    std::unordered_set<std::string> names;
+    irs::bytes_ref value;
+
+    for (auto& segment: reader) {
+      const auto* column = segment.column_reader("name");
+      EXPECT_NE(nullptr, column);
+      auto values = column->values();
+
+      for (auto it = segment.docs_iterator(); it->next();) {
+        EXPECT_TRUE(values(it->value(), value));
+        names.emplace(irs::to_string<std::string>(value.c_str()));
+      }
+    }
+
+    return names;
+  };
+
+  auto writer = open_writer();
+
+  ASSERT_TRUE(insert(*writer,
+    doc1->indexed.begin(), doc1->indexed.end(),
+    doc1->stored.begin(), doc1->stored.end()
+  ));
+  writer->commit();
+
+  // buffered documents become visible without a commit
+  ASSERT_TRUE(insert(*writer,
+    doc2->indexed.begin(), doc2->indexed.end(),
+    doc2->stored.begin(), doc2->stored.end()
+  ));
+  ASSERT_TRUE(insert(*writer,
+    doc3->indexed.begin(), doc3->indexed.end(),
+    doc3->stored.begin(), doc3->stored.end()
+  ));
+
+  auto reader = writer->reader();
+  ASSERT_EQ(2, reader.size()); // committed + flushed segments
+  ASSERT_EQ(3, reader.docs_count());
+  ASSERT_EQ(3, reader.live_docs_count());
+  ASSERT_EQ((std::unordered_set<std::string>{ "A", "B", "C" }), live_names(reader));
+  ASSERT_EQ(0, writer->buffered_docs());
+  ASSERT_EQ(1, irs::directory_reader::open(dir(), codec()).live_docs_count());
+
+  // readers of unchanged segments are reused
+  {
+    auto same = writer->reader();
+    ASSERT_EQ(2, same.size());
+    ASSERT_EQ(reader[0].column_reader("name"), same[0].column_reader("name"));
+    ASSERT_EQ(reader[1].column_reader("name"), same[1].column_reader("name"));
+  }
+
+  // removals/updates are applied via in-memory masks
+  irs::by_term remove;
+  remove.field("name").term("A"); // committed document
+  writer->remove(remove);
+
+  irs::by_term update;
+  update.field("name").term("B"); // flushed document
+  ASSERT_TRUE(tests::update(*writer, update,
+    doc4->indexed.begin(), doc4->indexed.end(),
+    doc4->stored.begin(), doc4->stored.end()
+  ));
+
+  auto updated = writer->reader();
+  ASSERT_EQ(2, updated.size()); // committed segment is fully masked
+  ASSERT_EQ(3, updated.docs_count());
+  ASSERT_EQ(2, updated.live_docs_count());
+  ASSERT_EQ((std::unordered_set<std::string>{ "C", "D" }), live_names(updated));
+  ASSERT_EQ(reader[1].column_reader("name"), updated[0].column_reader("name"));
+
+  // nothing is written to the directory, previous readers are unaffected
+  ASSERT_EQ(1, irs::directory_reader::open(dir(), codec()).live_docs_count());
+  ASSERT_EQ((std::unordered_set<std::string>{ "A", "B", "C" }), live_names(reader));
+
+  writer->commit();
+
+  auto committed = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(2, committed.live_docs_count());
+  ASSERT_EQ((std::unordered_set<std::string>{ "C", "D" }), live_names(committed));
+  ASSERT_EQ((std::unordered_set<std::string>{ "C", "D" }), live_names(updated));
+  ASSERT_EQ((std::unordered_set<std::string>{ "C", "D" }), live_names(updated.reopen(codec())));
+  ASSERT_EQ((std::unordered_set<std::string>{ "C", "D" }), live_names(writer->reader()));
+}
+
+TEST_F(memory_index_test, sorted_segments) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    [] (tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+    if (data.is_string()) {
+      doc.insert(std::make_shared<tests::templates::string_field>(
+        ir::string_ref(name),
+        data.str
+      ));
+    }
+  });
+
+  // stored names of the live documents in order of doc_ids, every term of
+  // the 'name' field must point to the document storing the same name
+  auto sorted_names = [](const irs::sub_reader& segment)->std::vector<std::string> {
+    std::vector<std::string> names;
+    const auto* column = segment.column_reader("name");
+    EXPECT_NE(nullptr, column);
+    auto values = column->values();
+    irs::bytes_ref value;
+
+    for (auto it = segment.docs_iterator(); it->next();) {
+      EXPECT_TRUE(values(it->value(), value));
+      names.emplace_back(irs::to_string<std::string>(value.c_str()));
+    }
+
+    const auto* field = segment.field("name");
+    EXPECT_NE(nullptr, field);
+
+    for (auto terms = field->iterator(); terms->next();) {
+      auto docs = terms->postings(irs::flags::empty_instance());
+
+      while (docs->next()) {
+        EXPECT_TRUE(values(docs->value(), value));
+        EXPECT_EQ(
+          irs::ref_cast<char>(terms->value()),
+          irs::to_string<irs::string_ref>(value.c_str())
+        );
+      }
+    }
+
+    return names;
+  };
+
+  irs::index_writer::options options;
+  options.sort.emplace_back(
+    "name",
+    [](const irs::bytes_ref& lhs, const irs::bytes_ref& rhs) { return rhs < lhs; }
+  );
+  auto writer = irs::index_writer::make(dir(), codec(), irs::OM_CREATE, options);
+
+  // flushed segment is ordered by descending names
+  for (size_t i = 0; i < 6; ++i) {
+    auto* doc = gen.next();
+    ASSERT_TRUE(insert(*writer,
+      doc->indexed.begin(), doc->indexed.end(),
+      doc->stored.begin(), doc->stored.end()
+    ));
+  }
+
+  writer->commit();
+
+  {
+    auto reader = irs::directory_reader::open(dir(), codec());
+    ASSERT_EQ(1, reader.size());
+    ASSERT_EQ(
+      (std::vector<std::string>{ "F", "E", "D", "C", "B", "A" }),
+      sorted_names(reader[0])
+    );
+  }
+
+  // removals are applied to the reordered doc_ids
+  irs::by_term remove;
+  remove.field("name").term("E");
+  writer->remove(remove);
+
+  for (size_t i = 0; i < 2; ++i) {
+    auto* doc = gen.next();
+    ASSERT_TRUE(insert(*writer,
+      doc->indexed.begin(), doc->indexed.end(),
+      doc->stored.begin(), doc->stored.end()
+    ));
+  }
+
+  writer->commit();
+
+  {
+    auto reader = irs::directory_reader::open(dir(), codec());
+    ASSERT_EQ(2, reader.size());
+    ASSERT_EQ(
+      (std::vector<std::string>{ "F", "D", "C", "B", "A" }),
+      sorted_names(reader[0])
+    );
+    ASSERT_EQ((std::vector<std::string>{ "H", "G" }), sorted_names(reader[1]));
+  }
+
+  // merged segment is ordered across all of the candidates
+  writer->consolidate([](const irs::directory&, const irs::index_meta&)->irs::index_writer::consolidation_acceptor_t {
+    return [](const irs::segment_meta&)->bool { return true; };
+  }, false);
+  writer->commit();
+
+  {
+    auto reader = irs::directory_reader::open(dir(), codec());
+    ASSERT_EQ(1, reader.size());
+    ASSERT_EQ(7, reader[0].docs_count());
+    ASSERT_EQ(
+      (std::vector<std::string>{ "H", "G", "F", "D", "C", "B", "A" }),
+      sorted_names(reader[0])
+    );
+  }
+}
+
 TEST_F(memory_index_test, doc_removal) {
   tests::json_doc_generator gen(
     resource("simple_sequential.json"),
@@ -10652,6 +11385,111 @@ TEST_F(memory_index_test, segment_consolidate) {
   }
 }
 
+TEST_F(memory_index_test, segment_consolidate_background_mt) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential.json"),
+    [] (tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+    if (data.is_string()) {
+      doc.insert(std::make_shared<tests::templates::string_field>(
+        ir::string_ref(name),
+        data.str
+      ));
+    }
+  });
+  std::vector<const tests::document*> docs;
+
+  for (const tests::document* doc; docs.size() < 6 && (doc = gen.next()) != nullptr; docs.emplace_back(doc)) {}
+
+  ASSERT_EQ(6, docs.size());
+
+  irs::index_writer::consolidation_policy_t always_merge = [](
+      const irs::directory&, const irs::index_meta&
+  )->irs::index_writer::consolidation_acceptor_t {
+    return [](const irs::segment_meta&)->bool { return true; };
+  };
+  irs::index_writer::options options;
+  options.merge_threads = 2;
+  options.merge_bytes_per_sec = 2048; // slow merge down to remove documents while merging
+  auto writer = irs::index_writer::make(dir(), codec(), irs::OM_CREATE, options);
+
+  // 3 segments with 2 documents each ('A'+'B', 'C'+'D', 'E'+'F')
+  for (size_t i = 0; i < docs.size(); ++i) {
+    auto& doc = docs[i];
+    ASSERT_TRUE(insert(*writer,
+      doc->indexed.begin(), doc->indexed.end(),
+      doc->stored.begin(), doc->stored.end()
+    ));
+
+    if (i % 2) {
+      writer->commit();
+    }
+  }
+
+  irs::by_term remove_a;
+  irs::by_term remove_c;
+  irs::by_term remove_e;
+
+  remove_a.field("name").term("A");
+  remove_c.field("name").term("C");
+  remove_e.field("name").term("E");
+
+  // removal committed before merge
+  writer->remove(remove_a);
+  writer->commit();
+
+  writer->consolidate(always_merge, true); // merge 3 committed segments in background
+  writer->consolidate(always_merge, true); // all segments are being merged already
+
+  // removal committed while merging, applied to the original segment
+  writer->remove(remove_c);
+  writer->commit();
+  ASSERT_EQ(3, iresearch::directory_reader::open(dir(), codec()).size());
+
+  writer->wait_for_consolidation();
+
+  // removal pending while merge result is added by the commit
+  writer->remove(remove_e);
+  writer->commit();
+
+  std::unordered_set<irs::string_ref> expected = { "B", "D", "F" };
+  auto reader = iresearch::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  ASSERT_EQ(5, reader.docs_count()); // 'A' removed before merge
+  ASSERT_EQ(3, reader.live_docs_count());
+
+  irs::bytes_ref actual_value;
+  auto& segment = reader[0];
+  const auto* column = segment.column_reader("name");
+  ASSERT_NE(nullptr, column);
+  auto values = column->values();
+  auto terms = segment.field("same");
+  ASSERT_NE(nullptr, terms);
+  auto termItr = terms->iterator();
+  ASSERT_TRUE(termItr->next());
+  auto docsItr = segment.mask(termItr->postings(iresearch::flags()));
+  while(docsItr->next()) {
+    ASSERT_TRUE(values(docsItr->value(), actual_value));
+    ASSERT_EQ(1, expected.erase(irs::to_string<irs::string_ref>(actual_value.c_str())));
+  }
+  ASSERT_TRUE(expected.empty());
+
+  // deferred policy is applied in background after the commit
+  insert(*writer,
+    docs[0]->indexed.begin(), docs[0]->indexed.end(),
+    docs[0]->stored.begin(), docs[0]->stored.end()
+  );
+  writer->consolidate(always_merge, false);
+  writer->commit();
+  ASSERT_EQ(2, iresearch::directory_reader::open(dir(), codec()).size());
+  writer->wait_for_consolidation();
+  writer->commit();
+
+  reader = iresearch::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  ASSERT_EQ(4, reader.docs_count());
+  ASSERT_EQ(4, reader.live_docs_count());
+}
+
 TEST_F(memory_index_test, segment_consolidate_policy) {
   tests::json_doc_generator gen(
     resource("simple_sequential.json"),
@@ -180,3 +180,56 @@ TEST(postings_tests, slice_alignment) {
     ASSERT_EQ(tests::detail::to_bytes_ref("string1"), bh.begin()->first);
   }
 }
+
+TEST(postings_tests, sort) {
+  const uint32_t block_size = 32768;
+  block_pool<byte_type, block_size> pool;
+  block_pool<byte_type, block_size>::inserter writer(pool.begin());
+  postings bh(writer);
+
+  std::vector<std::string> data;
+
+  // shared prefixes of different length, empty term, bytes above 0x7F
+  data.emplace_back();
+  for (size_t i = 0; i < 300; ++i) {
+    data.emplace_back(i, 'a');
+    data.emplace_back(std::to_string(i * 7919 % 1000));
+    data.emplace_back(std::string(i % 17, '\xD0') + std::to_string(i));
+  }
+
+  std::set<std::string, bool(*)(const std::string&, const std::string&)> expected(
+    [](const std::string& lhs, const std::string& rhs) {
+      return tests::detail::utf8_less(
+        tests::detail::to_bytes_ref(lhs), tests::detail::to_bytes_ref(rhs)
+      );
+  });
+
+  for (auto& s : data) {
+    const auto res = bh.emplace(tests::detail::to_bytes_ref(s));
+    ASSERT_EQ(expected.insert(s).second, res.second);
+  }
+
+  ASSERT_EQ(expected.size(), bh.size());
+
+  std::vector<const postings::value_type*> terms;
+  bh.sort(terms);
+  ASSERT_EQ(expected.size(), terms.size());
+
+  auto it = expected.begin();
+  for (auto* term : terms) {
+    ASSERT_EQ(tests::detail::to_bytes_ref(*it), term->first);
+    ++it;
+  }
+
+  // the entries survive the growth of the table
+  for (auto& s : data) {
+    const auto res = bh.emplace(tests::detail::to_bytes_ref(s));
+    ASSERT_FALSE(res.second);
+    ASSERT_EQ(tests::detail::to_bytes_ref(s), res.first->first);
+  }
+
+  bh.clear();
+  ASSERT_TRUE(bh.empty());
+  bh.sort(terms);
+  ASSERT_TRUE(terms.empty());
+}
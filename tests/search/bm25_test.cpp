@@ -30,6 +30,7 @@
 #include "search/sort.hpp"
 #include "search/score.hpp"
 #include "search/bm25.hpp"
+#include "search/boolean_filter.hpp"
 #include "search/term_filter.hpp"
 #include "utils/utf8_path.hpp"
 
@@ -529,6 +530,262 @@ TEST_F(bm25_test, test_query_norms) {
   }
 }
 
+TEST_F(bm25_test, test_query_top_k) {
+  // documents with the term frequencies and lengths depending on the document,
+  // every occurrence of a term is a separate instance of the field
+  class doc_generator : public tests::doc_generator_base {
+   public:
+    explicit doc_generator(size_t count): count_(count) { }
+
+    virtual const tests::document* next() override {
+      if (i_ >= count_) {
+        return nullptr;
+      }
+
+      const size_t freqs[] { 1 + i_ % 3, i_ % 7, 0 == i_ % 97 ? 1 + i_ % 11 : 0 };
+      const char* terms[] { "alpha", "beta", "gamma" };
+      size_t size = 0;
+
+      doc_.clear();
+
+      for (size_t t = 0; t < 3; ++t) {
+        for (size_t j = 0; j < freqs[t]; ++j) {
+          field(size++).value(terms[t]);
+        }
+      }
+
+      for (size_t j = 0, len = i_ % 13; j < len; ++j) {
+        field(size++).value("filler" + std::to_string(j));
+      }
+
+      ++i_;
+      return &doc_;
+    }
+
+    virtual void reset() override { i_ = 0; }
+
+   private:
+    templates::string_field& field(size_t i) {
+      while (fields_.size() <= i) {
+        fields_.emplace_back(std::make_shared<templates::string_field>("body"));
+      }
+
+      doc_.insert(fields_[i], true, false);
+      return *fields_[i];
+    }
+
+    std::vector<std::shared_ptr<templates::string_field>> fields_;
+    tests::document doc_;
+    size_t count_;
+    size_t i_{};
+  }; // doc_generator
+
+  {
+    doc_generator gen(10000);
+    add_segment(gen);
+  }
+
+  irs::order order;
+  order.add<irs::bm25_sort>();
+  auto prepared_order = order.prepare();
+  auto comparer = [&prepared_order](const irs::bstring& lhs, const irs::bstring& rhs)->bool {
+    return prepared_order.less(lhs.c_str(), rhs.c_str());
+  };
+
+  auto reader = iresearch::directory_reader::open(dir(), codec());
+  auto& segment = *(reader.begin());
+
+  irs::Or filter;
+  filter.add<irs::by_term>().field("body").term("alpha");
+  filter.add<irs::by_term>().field("body").term("beta");
+  filter.add<irs::by_term>().field("body").term("gamma");
+  auto prepared_filter = filter.prepare(reader, prepared_order);
+
+  for (size_t k : { 1, 10, 100 }) {
+    typedef std::multimap<irs::bstring, irs::doc_id_t, decltype(comparer)> top_t;
+
+    // collects top 'k' documents, skips non-competitive ones if 'skip' is set
+    auto collect = [&](top_t& top, bool skip)->size_t {
+      auto docs = prepared_filter->execute(segment, prepared_order);
+      auto& score = docs->attributes().get<irs::score>();
+      auto& threshold = docs->attributes().get<irs::score_threshold>();
+      EXPECT_TRUE(bool(score));
+      EXPECT_TRUE(bool(threshold));
+      size_t count = 0;
+
+      // ensure that we avoid COW for pre c++11 std::basic_string
+      const irs::bytes_ref score_value = score->value();
+
+      while (docs->next()) {
+        ++count;
+        score->evaluate();
+        top.emplace(score_value, docs->value());
+
+        if (top.size() > k) {
+          top.erase(--top.end());
+        }
+
+        if (skip && top.size() == k) {
+          threshold->value = top.rbegin()->first;
+        }
+      }
+
+      return count;
+    };
+
+    top_t expected(comparer);
+    const auto all_count = collect(expected, false);
+    ASSERT_EQ(k, expected.size());
+
+    top_t actual(comparer);
+    const auto top_count = collect(actual, true);
+    ASSERT_EQ(k, actual.size());
+    ASSERT_LT(top_count, all_count); // non-competitive documents are skipped
+
+    // documents with equal scores may be collected in a different order
+    auto expected_it = expected.begin();
+    for (auto& entry : actual) {
+      ASSERT_EQ(expected_it->first, entry.first);
+      ++expected_it;
+    }
+  }
+}
+
+TEST_F(bm25_test, test_query_quantized_norms) {
+  tests::json_doc_generator gen(
+    resource("simple_sequential_order.json"),
+    [](tests::document& doc, const std::string& name, const tests::json_doc_generator::json_value& data) {
+      static irs::flags extra_features = { irs::norm::type() };
+
+      if (data.is_string()) { // field
+        doc.insert(std::make_shared<templates::string_field>(name, data.str, extra_features), true, false);
+      }
+  });
+
+  // the same documents with exact and quantized norms
+  add_segment(gen);
+
+  {
+    irs::index_writer::options options;
+    options.norm_encoding = irs::segment_writer::norm_encoding::BYTE;
+
+    auto writer = irs::index_writer::make(dir(), codec(), irs::OM_APPEND, options);
+    gen.reset();
+    add_segment(*writer, gen);
+  }
+
+  auto reader = open_reader();
+  ASSERT_EQ(2, reader.size());
+  auto& exact = reader[0];
+  auto& quantized = reader[1];
+  ASSERT_EQ(exact.docs_count(), quantized.docs_count());
+
+  const auto exact_column = exact.field("field")->meta().norm;
+  const auto quantized_column = quantized.field("field")->meta().norm;
+  ASSERT_EQ(nullptr, exact.norms(exact_column));
+  ASSERT_NE(nullptr, quantized.norms(quantized_column));
+  ASSERT_EQ(quantized.norms(quantized_column), quantized.norms(quantized_column)); // loaded once
+
+  irs::document doc;
+  irs::norm exact_norm;
+  irs::norm quantized_norm;
+  ASSERT_TRUE(exact_norm.reset(exact, exact_column, doc));
+  ASSERT_TRUE(quantized_norm.reset(quantized, quantized_column, doc));
+
+  std::vector<float_t> expected_norms;
+  const auto docs_begin = irs::type_limits<irs::type_t::doc_id_t>::min();
+  const auto docs_end = irs::doc_id_t(docs_begin + exact.docs_count());
+
+  for (auto id = docs_begin; id < docs_end; ++id) {
+    const auto expected = exact_norm.read(id);
+    irs::byte_type code;
+    ASSERT_TRUE(irs::norm::encode(expected, code));
+    ASSERT_EQ(irs::norm::decode(code), quantized_norm.read(id));
+    ASSERT_NEAR(expected, quantized_norm.read(id), expected / 16);
+    expected_norms.push_back(expected);
+  }
+
+  // bulk read
+  {
+    std::vector<irs::doc_id_t> docs;
+    for (auto id = docs_begin; id < docs_end; ++id) {
+      docs.push_back(id);
+    }
+
+    std::vector<float_t> values(docs.size());
+    quantized_norm.read(&docs[0], docs.size(), &values[0]);
+
+    for (size_t i = 0; i < docs.size(); ++i) {
+      ASSERT_EQ(quantized_norm.read(docs[i]), values[i]);
+    }
+  }
+
+  // scores of the quantized norms are close to the exact ones
+  {
+    irs::order order;
+    order.add(irs::scorers::get("bm25", irs::string_ref::nil));
+    auto prepared_order = order.prepare();
+
+    irs::by_term filter;
+    filter.field("field").term("7");
+    auto prepared_filter = filter.prepare(reader, prepared_order);
+
+    auto exact_docs = prepared_filter->execute(exact, prepared_order);
+    auto& exact_score = exact_docs->attributes().get<irs::score>();
+    auto quantized_docs = prepared_filter->execute(quantized, prepared_order);
+    auto& quantized_score = quantized_docs->attributes().get<irs::score>();
+    size_t count = 0;
+
+    while (exact_docs->next()) {
+      ASSERT_TRUE(quantized_docs->next());
+      ASSERT_EQ(exact_docs->value(), quantized_docs->value());
+      exact_score->evaluate();
+      quantized_score->evaluate();
+
+      const auto expected = prepared_order.get<float_t>(exact_score->c_str(), 0);
+      ASSERT_NEAR(expected, prepared_order.get<float_t>(quantized_score->c_str(), 0), expected / 16);
+      ++count;
+    }
+
+    ASSERT_FALSE(quantized_docs->next());
+    ASSERT_LT(0, count);
+  }
+
+  // segments with different encodings are merged
+  {
+    auto writer = open_writer(irs::OM_APPEND);
+    writer->consolidate(
+      [](const irs::directory&, const irs::index_meta&)->irs::index_writer::consolidation_acceptor_t {
+        return [](const irs::segment_meta&)->bool { return true; };
+      },
+      false
+    );
+    writer->commit();
+  }
+
+  reader = open_reader();
+  ASSERT_EQ(1, reader.size());
+  auto& merged = reader[0];
+  ASSERT_EQ(2*expected_norms.size(), merged.docs_count());
+
+  const auto merged_column = merged.field("field")->meta().norm;
+  ASSERT_NE(nullptr, merged.norms(merged_column));
+
+  irs::norm merged_norm;
+  ASSERT_TRUE(merged_norm.reset(merged, merged_column, doc));
+
+  for (size_t i = 0; i < expected_norms.size(); ++i) {
+    const auto expected = expected_norms[i];
+    irs::byte_type code;
+    ASSERT_TRUE(irs::norm::encode(expected, code));
+    ASSERT_EQ(expected, merged_norm.read(irs::doc_id_t(docs_begin + i)));
+    ASSERT_EQ(
+      irs::norm::decode(code),
+      merged_norm.read(irs::doc_id_t(docs_begin + expected_norms.size() + i))
+    );
+  }
+}
+
 #ifndef IRESEARCH_DLL
 
 TEST_F(bm25_test, test_order) {
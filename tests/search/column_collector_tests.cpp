@@ -0,0 +1,423 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "index/index_tests.hpp"
+#include "store/memory_directory.hpp"
+#include "store/store_utils.hpp"
+#include "search/column_collector.hpp"
+#include "search/term_filter.hpp"
+#include "utils/async_utils.hpp"
+
+NS_BEGIN(tests)
+
+class column_collector_test: public index_test_base {
+ protected:
+  struct expected_entry {
+    bool has_date;
+    int64_t date;
+    std::string name;
+    size_t segment;
+    irs::doc_id_t doc;
+  };
+
+  virtual iresearch::directory* get_directory() {
+    return new iresearch::memory_directory();
+  }
+
+  virtual iresearch::format::ptr get_codec() {
+    return ir::formats::get("1_0");
+  }
+
+  // adds 'count' segments, every document matches 'body:filler' and stores
+  // a signed 'date' (missing in every 13th document) and one of 5 'name's
+  void write_segments(irs::index_writer& writer, size_t count, size_t docs_count) {
+    auto body = std::make_shared<templates::string_field>("body", "filler");
+    auto date = std::make_shared<long_field>();
+    auto name = std::make_shared<templates::string_field>("name");
+
+    date->name("date");
+
+    for (size_t i = 0; i < count; ++i) {
+      for (size_t j = 0, size = docs_count + i; j < size; ++j) {
+        const auto seed = i*docs_count + j;
+        tests::document doc;
+
+        doc.insert(body, true, false);
+
+        if (seed % 13) {
+          date->value(int64_t((seed*37) % 101) - 50);
+          doc.insert(date, false, true);
+        }
+
+        name->value(std::string(1, char('a' + seed % 5)));
+        doc.insert(name, false, true);
+
+        ASSERT_TRUE(insert(writer,
+          doc.indexed.begin(), doc.indexed.end(),
+          doc.stored.begin(), doc.stored.end()
+        ));
+      }
+
+      writer.commit();
+    }
+  }
+
+  // matched documents with their stored values
+  std::vector<expected_entry> read_entries(
+      const irs::index_reader& reader,
+      const irs::filter::prepared& filter) {
+    std::vector<expected_entry> entries;
+    size_t i = 0;
+
+    for (auto& segment : reader) {
+      auto* date_column = segment.column_reader("date");
+      auto* name_column = segment.column_reader("name");
+      EXPECT_NE(nullptr, date_column);
+      EXPECT_NE(nullptr, name_column);
+      auto dates = date_column->values();
+      auto names = name_column->values();
+      irs::bytes_ref value;
+
+      for (auto docs = filter.execute(segment); docs->next();) {
+        expected_entry entry{ false, 0, "", i, docs->value() };
+
+        if (dates(entry.doc, value)) {
+          irs::bytes_ref_input in(value);
+          entry.has_date = true;
+          entry.date = irs::read_zvlong(in);
+        }
+
+        EXPECT_TRUE(names(entry.doc, value));
+        entry.name = irs::to_string<std::string>(value.c_str());
+        entries.emplace_back(std::move(entry));
+      }
+
+      ++i;
+    }
+
+    return entries;
+  }
+}; // column_collector_test
+
+NS_END
+
+using namespace tests;
+
+TEST_F(column_collector_test, collect) {
+  {
+    auto writer = open_writer();
+    write_segments(*writer, 5, 300);
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(5, reader.size());
+
+  irs::by_term filter;
+  filter.field("body").term("filler");
+  auto prepared_filter = filter.prepare(reader);
+
+  // descending dates, the ties are ranked by ascending names, then by segment
+  // and document, documents without a date go last
+  auto expected = read_entries(reader, *prepared_filter);
+  ASSERT_EQ(reader.docs_count(), expected.size());
+
+  std::sort(
+    expected.begin(), expected.end(),
+    [](const expected_entry& lhs, const expected_entry& rhs) {
+      if (lhs.has_date != rhs.has_date) {
+        return lhs.has_date;
+      }
+
+      if (lhs.has_date && lhs.date != rhs.date) {
+        return lhs.date > rhs.date;
+      }
+
+      if (lhs.name != rhs.name) {
+        return lhs.name < rhs.name;
+      }
+
+      return lhs.segment < rhs.segment
+        || (lhs.segment == rhs.segment && lhs.doc < rhs.doc);
+  });
+
+  const irs::column_collector::keys_t keys {
+    { "date", irs::column_collector::value_type::LONG, true },
+    { "name", irs::column_collector::value_type::STRING }
+  };
+
+  const auto assert_top = [&expected](
+      size_t k, const irs::column_collector::entries_t& actual) {
+    ASSERT_EQ(std::min(k, expected.size()), actual.size());
+
+    for (size_t i = 0, size = actual.size(); i < size; ++i) {
+      ASSERT_EQ(expected[i].segment, actual[i].segment);
+      ASSERT_EQ(expected[i].doc, actual[i].doc);
+    }
+  };
+
+  irs::async_utils::thread_pool pool(4, 4);
+
+  for (size_t k : { 0, 1, 10, 100, 100000 }) {
+    // sequential
+    {
+      irs::column_collector collector(keys, k);
+      collector.collect(reader, *prepared_filter);
+      ASSERT_EQ(expected.size(), collector.hits());
+      ASSERT_EQ(std::min(k, expected.size()), collector.size());
+      auto top = collector.release();
+      ASSERT_EQ(0, collector.size());
+      assert_top(k, top);
+    }
+
+    // parallel
+    {
+      irs::column_collector collector(keys, k);
+      collector.collect(reader, *prepared_filter, &pool);
+      ASSERT_EQ(expected.size(), collector.hits());
+      assert_top(k, collector.release());
+    }
+
+    // segment by segment, merged in the reverse order
+    {
+      std::vector<irs::column_collector> collectors;
+      size_t i = 0;
+
+      for (auto& segment : reader) {
+        collectors.emplace_back(keys, k);
+        auto docs = prepared_filter->execute(segment);
+        collectors.back().collect(i++, segment, *docs);
+      }
+
+      irs::column_collector collector(keys, k);
+
+      for (auto it = collectors.rbegin(), end = collectors.rend(); it != end; ++it) {
+        collector.merge(std::move(*it));
+      }
+
+      assert_top(k, collector.release());
+    }
+  }
+
+  // missing columns rank all documents by segment and document only
+  {
+    irs::column_collector collector(
+      { { "missing", irs::column_collector::value_type::BYTES } }, 10
+    );
+    collector.collect(reader, *prepared_filter);
+    auto top = collector.release();
+    ASSERT_EQ(10, top.size());
+
+    for (size_t i = 0; i < top.size(); ++i) {
+      ASSERT_EQ(0, top[i].segment);
+      ASSERT_EQ(irs::doc_id_t(irs::type_limits<irs::type_t::doc_id_t>::min() + i), top[i].doc);
+    }
+  }
+}
+
+TEST_F(column_collector_test, sort) {
+  typedef irs::column_collector::value_type value_type;
+
+  const auto encode = [](const std::function<void(irs::data_output&)>& write) {
+    irs::bytes_output out;
+    write(out);
+    return irs::bstring(out.c_str(), out.size());
+  };
+
+  // pairs of values in ascending order
+  const std::vector<std::pair<value_type, std::pair<irs::bstring, irs::bstring>>> values {
+    { value_type::BYTES, {
+      encode([](irs::data_output& out) { out.write_byte(1); out.write_byte(2); }),
+      encode([](irs::data_output& out) { out.write_byte(2); })
+    } },
+    { value_type::STRING, {
+      encode([](irs::data_output& out) { irs::write_string(out, irs::string_ref("aa")); }),
+      encode([](irs::data_output& out) { irs::write_string(out, irs::string_ref("b")); })
+    } },
+    { value_type::INT, {
+      encode([](irs::data_output& out) { irs::write_zvint(out, -100); }),
+      encode([](irs::data_output& out) { irs::write_zvint(out, 1); })
+    } },
+    { value_type::LONG, {
+      encode([](irs::data_output& out) { irs::write_zvlong(out, -1000); }),
+      encode([](irs::data_output& out) { irs::write_zvlong(out, -1); })
+    } },
+    { value_type::FLOAT, {
+      encode([](irs::data_output& out) { irs::write_zvfloat(out, -2.5f); }),
+      encode([](irs::data_output& out) { irs::write_zvfloat(out, 0.5f); })
+    } },
+    { value_type::DOUBLE, {
+      encode([](irs::data_output& out) { irs::write_zvdouble(out, -1e10); }),
+      encode([](irs::data_output& out) { irs::write_zvdouble(out, 1.); })
+    } }
+  };
+
+  for (auto& entry : values) {
+    const irs::bytes_ref lhs = entry.second.first;
+    const irs::bytes_ref rhs = entry.second.second;
+
+    if (value_type::STRING == entry.first
+        || value_type::INT == entry.first
+        || value_type::LONG == entry.first) {
+      ASSERT_TRUE(rhs < lhs); // the byte-wise order differs
+    }
+
+    const auto ascending = irs::column_collector::sort({ { "column", entry.first } });
+    ASSERT_EQ(1, ascending.size());
+    ASSERT_EQ("column", ascending.front().name);
+    ASSERT_TRUE(ascending.front().less(lhs, rhs));
+    ASSERT_FALSE(ascending.front().less(rhs, lhs));
+    ASSERT_FALSE(ascending.front().less(lhs, lhs));
+
+    const auto descending = irs::column_collector::sort({ { "column", entry.first, true } });
+    ASSERT_TRUE(descending.front().less(rhs, lhs));
+    ASSERT_FALSE(descending.front().less(lhs, rhs));
+    ASSERT_FALSE(descending.front().less(lhs, lhs));
+  }
+}
+
+TEST_F(column_collector_test, collect_sorted) {
+  const irs::column_collector::keys_t keys {
+    { "date", irs::column_collector::value_type::LONG },
+    { "name", irs::column_collector::value_type::STRING, true }
+  };
+
+  // the same documents in order of insertion
+  irs::memory_directory unsorted_dir;
+
+  {
+    auto writer = irs::index_writer::make(unsorted_dir, codec(), irs::OM_CREATE);
+    write_segments(*writer, 3, 5000);
+  }
+
+  // ordered by the raw bytes of the dates, i.e. negative dates are
+  // interleaved with positive ones, and ordered by the keys
+  irs::index_writer::options raw_options;
+  raw_options.sort.emplace_back("date");
+  irs::index_writer::options key_options;
+  key_options.sort = irs::column_collector::sort(keys);
+
+  for (auto* options : { &raw_options, &key_options }) {
+    irs::memory_directory sorted_dir;
+
+    {
+      auto writer = irs::index_writer::make(sorted_dir, codec(), irs::OM_CREATE, *options);
+      write_segments(*writer, 3, 5000);
+    }
+
+    auto unsorted = irs::directory_reader::open(unsorted_dir, codec());
+    auto sorted = irs::directory_reader::open(sorted_dir, codec());
+    ASSERT_EQ(3, sorted.size());
+
+    irs::by_term filter;
+    filter.field("body").term("filler");
+    auto unsorted_filter = filter.prepare(unsorted);
+    auto sorted_filter = filter.prepare(sorted);
+
+    for (size_t k : { 1, 10, 100, 20000 }) {
+      irs::column_collector expected(keys, k);
+      expected.collect(unsorted, *unsorted_filter);
+
+      irs::column_collector actual(keys, k);
+      actual.collect(sorted, *sorted_filter);
+
+      // the column blocks of the segments ordered by the keys cover disjoint
+      // ranges of dates, the blocks after the collected documents are skipped
+      if (options == &key_options && k < 100) {
+        ASSERT_LT(actual.hits(), sorted.docs_count() / 2);
+      }
+
+      // the documents are reordered, the values are the same
+      auto expected_top = expected.release();
+      auto actual_top = actual.release();
+      ASSERT_EQ(expected_top.size(), actual_top.size());
+
+      for (size_t i = 0; i < expected_top.size(); ++i) {
+        ASSERT_EQ(expected_top[i].value, actual_top[i].value);
+      }
+    }
+  }
+}
+
+TEST_F(column_collector_test, collect_block_bounds) {
+  // ascending dates in order of insertion, i.e. the column blocks of
+  // the segment cover disjoint ranges of dates
+  const size_t count = 20000;
+
+  {
+    auto writer = open_writer();
+    auto body = std::make_shared<templates::string_field>("body", "filler");
+    auto date = std::make_shared<long_field>();
+
+    date->name("date");
+
+    for (size_t i = 0; i < count; ++i) {
+      tests::document doc;
+
+      doc.insert(body, true, false);
+      date->value(int64_t(i) - int64_t(count / 2));
+      doc.insert(date, false, true);
+
+      ASSERT_TRUE(insert(*writer,
+        doc.indexed.begin(), doc.indexed.end(),
+        doc.stored.begin(), doc.stored.end()
+      ));
+    }
+
+    writer->commit();
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+
+  irs::by_term filter;
+  filter.field("body").term("filler");
+  auto prepared_filter = filter.prepare(reader);
+
+  const auto min = (irs::type_limits<irs::type_t::doc_id_t>::min)();
+
+  for (bool reverse : { false, true }) {
+    const irs::column_collector::keys_t keys {
+      { "date", irs::column_collector::value_type::LONG, reverse }
+    };
+
+    irs::column_collector collector(keys, 10);
+    collector.collect(reader, *prepared_filter);
+
+    auto top = collector.release();
+    ASSERT_EQ(10, top.size());
+
+    for (size_t i = 0; i < top.size(); ++i) {
+      ASSERT_EQ(0, top[i].segment);
+      ASSERT_EQ(irs::doc_id_t(reverse ? min + count - 1 - i : min + i), top[i].doc);
+    }
+
+    if (reverse) {
+      // every next block holds dates after the collected ones
+      ASSERT_EQ(count, collector.hits());
+    } else {
+      // the first block fills the heap, the rest are skipped
+      ASSERT_LT(collector.hits(), count / 2);
+    }
+  }
+}
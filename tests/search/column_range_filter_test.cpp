@@ -0,0 +1,254 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "index/index_tests.hpp"
+#include "store/memory_directory.hpp"
+#include "store/store_utils.hpp"
+#include "search/column_range_filter.hpp"
+
+NS_BEGIN(tests)
+
+class column_range_filter_test: public index_test_base {
+ protected:
+  virtual iresearch::directory* get_directory() {
+    return new iresearch::memory_directory();
+  }
+
+  virtual iresearch::format::ptr get_codec() {
+    return ir::formats::get("1_0");
+  }
+
+  // every document stores an increasing 'date' (missing in every 7th
+  // document), a 'period' alternating between runs of the values below and
+  // above 'docs_count' and a 'name' longer than the summary value limit
+  void write_segment(irs::index_writer& writer, size_t docs_count) {
+    auto date = std::make_shared<long_field>();
+    auto period = std::make_shared<long_field>();
+    auto name = std::make_shared<templates::string_field>("name");
+
+    date->name("date");
+    period->name("period");
+
+    for (size_t i = 0; i < docs_count; ++i) {
+      tests::document doc;
+
+      if (i % 7) {
+        date->value(int64_t(i) - int64_t(docs_count / 2));
+        doc.insert(date, false, true);
+      }
+
+      period->value(int64_t((i / 2048) % 2 ? docs_count + i : i));
+      doc.insert(period, false, true);
+
+      name->value(std::string(100, char('a' + i % 5)));
+      doc.insert(name, false, true);
+
+      ASSERT_TRUE(insert(writer,
+        doc.indexed.begin(), doc.indexed.end(),
+        doc.stored.begin(), doc.stored.end()
+      ));
+    }
+
+    writer.commit();
+  }
+
+  // documents of the column having values within [min, max]
+  std::vector<irs::doc_id_t> expected_docs(
+      const irs::sub_reader& segment,
+      const std::string& field,
+      int64_t min,
+      int64_t max) {
+    std::vector<irs::doc_id_t> docs;
+    auto* column = segment.column_reader(field);
+
+    if (!column) {
+      return docs;
+    }
+
+    column->visit([&docs, min, max](irs::doc_id_t doc, const irs::bytes_ref& value) {
+      int64_t number;
+
+      if (irs::decode_zvlong(value, number) && min <= number && number <= max) {
+        docs.push_back(doc);
+      }
+
+      return true;
+    });
+
+    return docs;
+  }
+}; // column_range_filter_test
+
+NS_END
+
+using namespace tests;
+
+TEST_F(column_range_filter_test, blocks_summaries) {
+  {
+    auto writer = open_writer();
+    write_segment(*writer, 20000);
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+
+  // numeric column
+  {
+    auto* column = segment.column_reader("date");
+    ASSERT_NE(nullptr, column);
+
+    size_t blocks = 0;
+    irs::doc_id_t prev_key = irs::type_limits<irs::type_t::doc_id_t>::invalid();
+    int64_t prev_max = std::numeric_limits<int64_t>::min();
+
+    ASSERT_TRUE(column->visit_blocks(
+      [&](const irs::columnstore_reader::block_summary& block) {
+        EXPECT_LT(prev_key, block.min_key);
+        EXPECT_LE(block.min_key, block.max_key);
+        EXPECT_TRUE(block.has_long);
+        EXPECT_LE(block.min_long, block.max_long);
+        EXPECT_LT(prev_max, block.min_long);
+        EXPECT_FALSE(block.min.null());
+        EXPECT_FALSE(block.max.null());
+        prev_key = block.max_key;
+        prev_max = block.max_long;
+        ++blocks;
+        return true;
+    }));
+
+    ASSERT_LT(1, blocks);
+  }
+
+  // values longer than the summary value limit have no byte-wise bounds
+  {
+    auto* column = segment.column_reader("name");
+    ASSERT_NE(nullptr, column);
+
+    ASSERT_TRUE(column->visit_blocks(
+      [](const irs::columnstore_reader::block_summary& block) {
+        EXPECT_FALSE(block.has_long);
+        EXPECT_TRUE(block.min.null());
+        EXPECT_TRUE(block.max.null());
+        return true;
+    }));
+  }
+}
+
+TEST_F(column_range_filter_test, match) {
+  const size_t docs_count = 20000;
+
+  {
+    auto writer = open_writer();
+    write_segment(*writer, docs_count);
+  }
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(1, reader.size());
+  auto& segment = reader[0];
+
+  const int64_t half = int64_t(docs_count / 2);
+  const std::vector<std::pair<int64_t, int64_t>> ranges {
+    { std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max() },
+    { -half, -half + 10 },
+    { -100, 100 },
+    { 5000, 5300 },
+    { half - 10, half + 10 },
+    { half + 1, std::numeric_limits<int64_t>::max() },
+    { 7, 7 },
+    { 10, -10 }
+  };
+
+  // blocks within the range are separated by the blocks outside of it
+  const std::vector<std::pair<int64_t, int64_t>> period_ranges {
+    { 0, int64_t(docs_count) - 1 },
+    { 500, 4500 },
+    { int64_t(docs_count), std::numeric_limits<int64_t>::max() }
+  };
+
+  const std::vector<std::pair<std::string, const std::vector<std::pair<int64_t, int64_t>>*>> fields {
+    { "date", &ranges },
+    { "period", &period_ranges }
+  };
+
+  for (auto& field : fields)
+  for (auto& range : *field.second) {
+    irs::by_column_range filter;
+    filter.field(field.first).min(range.first).max(range.second);
+
+    auto prepared = filter.prepare(reader);
+    auto expected = expected_docs(segment, field.first, range.first, range.second);
+
+    // next
+    {
+      std::vector<irs::doc_id_t> actual;
+
+      for (auto docs = prepared->execute(segment); docs->next();) {
+        actual.push_back(docs->value());
+      }
+
+      ASSERT_EQ(expected, actual);
+    }
+
+    // seek
+    {
+      auto docs = prepared->execute(segment);
+
+      for (size_t i = 0; i < expected.size(); i += 13) {
+        ASSERT_EQ(expected[i], docs->seek(expected[i]));
+        ASSERT_EQ(expected[i], docs->seek(expected[i] - 1)); // backwards
+      }
+
+      ASSERT_TRUE(irs::type_limits<irs::type_t::doc_id_t>::eof(
+        docs->seek(irs::type_limits<irs::type_t::doc_id_t>::eof())
+      ));
+      ASSERT_FALSE(docs->next());
+    }
+  }
+
+  // missing column
+  {
+    irs::by_column_range filter;
+    filter.field("missing");
+
+    auto prepared = filter.prepare(reader);
+    ASSERT_FALSE(prepared->execute(segment)->next());
+  }
+}
+
+TEST_F(column_range_filter_test, equals) {
+  irs::by_column_range filter;
+  filter.field("date").min(1).max(2);
+
+  irs::by_column_range other;
+  other.field("date").min(1).max(2);
+  ASSERT_EQ(filter, other);
+  ASSERT_EQ(filter.hash(), other.hash());
+
+  other.max(3);
+  ASSERT_NE(filter, other);
+
+  other.max(2).field("name");
+  ASSERT_NE(filter, other);
+}
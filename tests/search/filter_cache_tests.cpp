@@ -0,0 +1,258 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "filter_test_case_base.hpp"
+#include "formats/formats_10.hpp"
+#include "search/boolean_filter.hpp"
+#include "search/filter_cache.hpp"
+#include "search/term_filter.hpp"
+#include "store/memory_directory.hpp"
+
+namespace tests {
+
+class filter_cache_test_case : public filter_test_case_base {
+ protected:
+  std::shared_ptr<irs::filter> make_term(
+      const irs::string_ref& field,
+      const irs::string_ref& term) {
+    std::shared_ptr<irs::filter> filter = irs::by_term::make();
+    static_cast<irs::by_term&>(*filter).field(field).term(term);
+    return filter;
+  }
+
+  void add_sequential(irs::OPEN_MODE mode) {
+    tests::json_doc_generator gen(
+      resource("simple_sequential.json"),
+      &tests::generic_json_field_factory
+    );
+    add_segment(gen, mode);
+  }
+
+  void cache_filters() {
+    add_sequential(irs::OM_CREATE);
+
+    auto rdr = open_reader();
+    auto cache = irs::filter_cache::make();
+    const docs_t abcd{ 1, 5, 11, 21, 27, 31 };
+
+    irs::cached_filter filter;
+    filter.cache(cache).filter(make_term("duplicated", "abcd"));
+
+    // first use, documents aren't cached yet
+    check_query(filter, abcd, costs_t{ abcd.size() }, rdr);
+    ASSERT_EQ(1, cache->size());
+    ASSERT_EQ(0, cache->docs_bytes());
+
+    // frequently used filter, documents are cached
+    check_query(filter, abcd, costs_t{ abcd.size() }, rdr);
+    ASSERT_EQ(1, cache->size());
+    const auto docs_bytes = cache->docs_bytes();
+    ASSERT_LT(0, docs_bytes);
+
+    // served from the cached documents
+    check_query(filter, abcd, costs_t{ abcd.size() }, rdr);
+    ASSERT_EQ(docs_bytes, cache->docs_bytes());
+
+    // equal filter shares the cached entry
+    {
+      irs::cached_filter other;
+      other.cache(cache).filter(make_term("duplicated", "abcd"));
+      ASSERT_EQ(filter, other);
+      ASSERT_EQ(filter.hash(), other.hash());
+
+      check_query(other, abcd, rdr);
+      ASSERT_EQ(1, cache->size());
+      ASSERT_EQ(docs_bytes, cache->docs_bytes());
+    }
+
+    // different filter
+    {
+      irs::cached_filter other;
+      other.cache(cache).filter(make_term("duplicated", "vczc"));
+      ASSERT_NE(filter, other);
+
+      check_query(other, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+      ASSERT_EQ(2, cache->size());
+    }
+
+    // restriction clause of a scored query doesn't contribute to the score
+    {
+      irs::order order;
+      order.add<sort::boost>();
+
+      irs::And root;
+      root.add<irs::by_term>().field("same").term("xyz");
+      root.add<irs::cached_filter>().cache(cache).filter(make_term("duplicated", "abcd"));
+
+      check_query(root, order, abcd, rdr);
+      check_query(root, abcd, rdr);
+    }
+
+    // filter without a cache
+    {
+      irs::cached_filter other;
+      other.filter(make_term("duplicated", "abcd"));
+      check_query(other, abcd, rdr);
+    }
+
+    cache->clear();
+    ASSERT_EQ(0, cache->size());
+    ASSERT_EQ(0, cache->docs_bytes());
+    check_query(filter, abcd, rdr);
+    ASSERT_EQ(1, cache->size());
+  }
+
+  void cache_bounds() {
+    add_sequential(irs::OM_CREATE);
+
+    auto rdr = open_reader();
+    irs::filter_cache::options opts;
+    opts.max_filters = 1;
+    opts.docs_min_hits = 1;
+    auto cache = irs::filter_cache::make(opts);
+
+    irs::cached_filter abcd;
+    abcd.cache(cache).filter(make_term("duplicated", "abcd"));
+    irs::cached_filter vczc;
+    vczc.cache(cache).filter(make_term("duplicated", "vczc"));
+
+    check_query(abcd, docs_t{ 1, 5, 11, 21, 27, 31 }, rdr);
+    ASSERT_EQ(1, cache->size());
+    const auto docs_bytes = cache->docs_bytes();
+    ASSERT_LT(0, docs_bytes);
+
+    // least recently used filter is evicted with its documents
+    check_query(vczc, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+    ASSERT_EQ(1, cache->size());
+    ASSERT_EQ(docs_bytes, cache->docs_bytes());
+
+    // documents don't fit
+    opts.max_filters = 64;
+    opts.max_docs_bytes = docs_bytes - 1;
+    cache = irs::filter_cache::make(opts);
+    abcd.cache(cache);
+    vczc.cache(cache);
+
+    check_query(abcd, docs_t{ 1, 5, 11, 21, 27, 31 }, rdr);
+    check_query(vczc, docs_t{ 2, 3, 8, 14, 17, 19, 24 }, rdr);
+    ASSERT_EQ(2, cache->size());
+    ASSERT_EQ(0, cache->docs_bytes());
+  }
+
+  void cache_reopen() {
+    add_sequential(irs::OM_CREATE);
+
+    auto rdr = open_reader();
+    irs::filter_cache::options opts;
+    opts.docs_min_hits = 1;
+    auto cache = irs::filter_cache::make(opts);
+
+    irs::cached_filter filter;
+    filter.cache(cache).filter(make_term("duplicated", "abcd"));
+
+    check_query(filter, docs_t{ 1, 5, 11, 21, 27, 31 }, rdr);
+    const auto docs_bytes = cache->docs_bytes();
+    ASSERT_LT(0, docs_bytes);
+
+    // new segment, documents of the unchanged segment are kept
+    add_sequential(irs::OM_APPEND);
+    rdr = rdr.reopen();
+    ASSERT_EQ(2, rdr.size());
+    cache->reset(rdr);
+    ASSERT_EQ(1, cache->size());
+    ASSERT_EQ(docs_bytes, cache->docs_bytes());
+
+    check_query(
+      filter,
+      docs_t{ 1, 5, 11, 21, 27, 31, 1, 5, 11, 21, 27, 31 },
+      rdr
+    );
+    ASSERT_EQ(2*docs_bytes, cache->docs_bytes());
+
+    // removals change both segments, their documents are dropped
+    // (filters don't apply documents mask, same as without the cache)
+    {
+      auto writer = open_writer(irs::OM_APPEND);
+      irs::by_term removal;
+      removal.field("name").term("A");
+      writer->remove(removal);
+      writer->commit();
+    }
+
+    rdr = rdr.reopen();
+    cache->reset(rdr);
+    ASSERT_EQ(1, cache->size());
+    ASSERT_EQ(0, cache->docs_bytes());
+
+    // the cache follows the reader passed to prepare
+    auto prev = rdr;
+    add_sequential(irs::OM_APPEND);
+    rdr = rdr.reopen();
+    ASSERT_EQ(3, rdr.size());
+
+    check_query(
+      filter,
+      docs_t{ 1, 5, 11, 21, 27, 31, 1, 5, 11, 21, 27, 31, 1, 5, 11, 21, 27, 31 },
+      rdr
+    );
+    ASSERT_EQ(3*docs_bytes, cache->docs_bytes());
+
+    check_query(
+      filter,
+      docs_t{ 1, 5, 11, 21, 27, 31, 1, 5, 11, 21, 27, 31 },
+      prev
+    );
+    ASSERT_EQ(2*docs_bytes, cache->docs_bytes());
+  }
+}; // filter_cache_test_case
+
+} // tests
+
+// ----------------------------------------------------------------------------
+// --SECTION--                           memory_directory + iresearch_format_10
+// ----------------------------------------------------------------------------
+
+class memory_filter_cache_test_case : public tests::filter_cache_test_case {
+ protected:
+  virtual irs::directory* get_directory() override {
+    return new irs::memory_directory();
+  }
+
+  virtual irs::format::ptr get_codec() override {
+    static irs::version10::format FORMAT;
+    return irs::format::ptr(&FORMAT, [](irs::format*)->void{});
+  }
+};
+
+TEST_F(memory_filter_cache_test_case, cache_filters) {
+  cache_filters();
+}
+
+TEST_F(memory_filter_cache_test_case, cache_bounds) {
+  cache_bounds();
+}
+
+TEST_F(memory_filter_cache_test_case, cache_reopen) {
+  cache_reopen();
+}
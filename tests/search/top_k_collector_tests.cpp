@@ -0,0 +1,483 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2017 ArangoDB GmbH, Cologne, Germany
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is ArangoDB GmbH, Cologne, Germany
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "index/index_tests.hpp"
+#include "store/memory_directory.hpp"
+#include "search/bm25.hpp"
+#include "search/boolean_filter.hpp"
+#include "search/score.hpp"
+#include "search/tfidf.hpp"
+#include "search/term_filter.hpp"
+#include "search/top_k_collector.hpp"
+#include "utils/async_utils.hpp"
+
+#include <set>
+
+NS_BEGIN(tests)
+
+class top_k_collector_test: public index_test_base {
+ protected:
+  virtual iresearch::directory* get_directory() {
+    return new iresearch::memory_directory();
+  }
+
+  virtual iresearch::format::ptr get_codec() {
+    return ir::formats::get("1_0");
+  }
+
+  // adds 'count' segments, the term frequencies and norms depend on the document,
+  // every 4th document is tagged as 'removed'
+  void write_segments(size_t count, size_t docs_count) {
+    auto writer = open_writer();
+    write_segments(*writer, count, docs_count);
+  }
+
+  void write_segments(irs::index_writer& writer, size_t count, size_t docs_count) {
+    class doc_generator : public tests::doc_generator_base {
+     public:
+      doc_generator(size_t seed, size_t count): seed_(seed), count_(count) { }
+
+      virtual const tests::document* next() override {
+        if (i_ >= count_) {
+          return nullptr;
+        }
+
+        const auto i = seed_ + i_++;
+        const size_t freqs[] { i % 3, i % 5 };
+        const char* terms[] { "alpha", "beta" };
+        size_t size = 0;
+
+        doc_.clear();
+
+        for (size_t t = 0; t < 2; ++t) {
+          for (size_t j = 0; j < freqs[t]; ++j) {
+            field(size++).value(terms[t]);
+          }
+        }
+
+        field(size++).value("filler");
+
+        tag_->value(i % 4 ? "kept" : "removed");
+        doc_.insert(tag_, true, false);
+
+        return &doc_;
+      }
+
+      virtual void reset() override { i_ = 0; }
+
+     private:
+      templates::string_field& field(size_t i) {
+        while (fields_.size() <= i) {
+          fields_.emplace_back(std::make_shared<templates::string_field>(
+            "body", irs::flags{ irs::norm::type() }
+          ));
+        }
+
+        doc_.insert(fields_[i], true, false);
+        return *fields_[i];
+      }
+
+      std::vector<std::shared_ptr<templates::string_field>> fields_;
+      std::shared_ptr<templates::string_field> tag_{
+        std::make_shared<templates::string_field>("tag")
+      };
+      tests::document doc_;
+      size_t seed_;
+      size_t count_;
+      size_t i_{};
+    }; // doc_generator
+
+    for (size_t i = 0; i < count; ++i) {
+      doc_generator gen(i * 7, docs_count + i);
+      add_segment(writer, gen);
+    }
+  }
+}; // top_k_collector_test
+
+NS_END
+
+using namespace tests;
+
+TEST_F(top_k_collector_test, collect) {
+  write_segments(5, 300);
+
+  irs::order order;
+  order.add<irs::bm25_sort>();
+  auto prepared_order = order.prepare();
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(5, reader.size());
+
+  irs::Or filter;
+  filter.add<irs::by_term>().field("body").term("alpha");
+  filter.add<irs::by_term>().field("body").term("beta");
+  auto prepared_filter = filter.prepare(reader, prepared_order);
+
+  // expected top documents, the ties are ranked by segment and document
+  struct expected_entry {
+    irs::bstring score;
+    size_t segment;
+    irs::doc_id_t doc;
+  };
+
+  std::vector<expected_entry> expected;
+  {
+    size_t i = 0;
+    for (auto& segment : reader) {
+      auto docs = prepared_filter->execute(segment, prepared_order);
+      auto& score = docs->attributes().get<irs::score>();
+      ASSERT_FALSE(!score);
+
+      while (docs->next()) {
+        score->evaluate();
+        expected.push_back(expected_entry{ score->value(), i, docs->value() });
+      }
+
+      ++i;
+    }
+  }
+
+  std::sort(
+    expected.begin(), expected.end(),
+    [&prepared_order](const expected_entry& lhs, const expected_entry& rhs) {
+      if (prepared_order.less(lhs.score.c_str(), rhs.score.c_str())) {
+        return true;
+      }
+
+      if (prepared_order.less(rhs.score.c_str(), lhs.score.c_str())) {
+        return false;
+      }
+
+      return lhs.segment < rhs.segment
+        || (lhs.segment == rhs.segment && lhs.doc < rhs.doc);
+  });
+
+  const auto assert_top = [&expected](
+      size_t k, const irs::top_k_collector::entries_t& actual) {
+    ASSERT_EQ(std::min(k, expected.size()), actual.size());
+
+    for (size_t i = 0, size = actual.size(); i < size; ++i) {
+      ASSERT_EQ(expected[i].score, actual[i].score);
+      ASSERT_EQ(expected[i].segment, actual[i].segment);
+      ASSERT_EQ(expected[i].doc, actual[i].doc);
+    }
+  };
+
+  irs::async_utils::thread_pool pool(4, 4);
+
+  for (size_t k : { 0, 1, 10, 100, 100000 }) {
+    // sequential
+    {
+      irs::top_k_collector collector(prepared_order, k);
+      collector.collect(reader, *prepared_filter);
+      ASSERT_EQ(std::min(k, expected.size()), collector.size());
+      auto top = collector.release();
+      ASSERT_EQ(0, collector.size());
+      assert_top(k, top);
+
+      // scores are bounded, non-competitive documents are skipped
+      if (k && k < expected.size()) {
+        ASSERT_TRUE(collector.pruned());
+        ASSERT_LT(collector.hits(), expected.size());
+      } else {
+        ASSERT_FALSE(collector.pruned());
+        ASSERT_EQ(expected.size(), collector.hits());
+      }
+    }
+
+    // parallel
+    {
+      irs::top_k_collector collector(prepared_order, k);
+      collector.collect(reader, *prepared_filter, &pool);
+      assert_top(k, collector.release());
+    }
+
+    // segment by segment, merged in the reverse order
+    {
+      std::vector<irs::top_k_collector> collectors;
+      size_t i = 0;
+
+      for (auto& segment : reader) {
+        collectors.emplace_back(prepared_order, k);
+        auto docs = prepared_filter->execute(segment, prepared_order);
+        collectors.back().collect(i++, *docs);
+      }
+
+      irs::top_k_collector collector(prepared_order, k);
+
+      for (auto it = collectors.rbegin(), end = collectors.rend(); it != end; ++it) {
+        collector.merge(std::move(*it));
+      }
+
+      // hits are exact unless the documents might have been skipped
+      ASSERT_LE(collector.hits(), expected.size());
+      if (!collector.pruned()) {
+        ASSERT_EQ(expected.size(), collector.hits());
+      }
+      assert_top(k, collector.release());
+    }
+  }
+}
+
+TEST_F(top_k_collector_test, collect_removed) {
+  irs::order order;
+  order.add<irs::bm25_sort>();
+  auto prepared_order = order.prepare();
+
+  auto writer = open_writer();
+  write_segments(*writer, 3, 300);
+
+  irs::by_term removed;
+  removed.field("tag").term("removed");
+  writer->remove(removed);
+
+  // removals are applied via in-memory masks
+  auto nrt_reader = writer->reader();
+
+  writer->commit();
+  write_segments(*writer, 1, 300); // segment without removals
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+  ASSERT_EQ(4, reader.size());
+  ASSERT_EQ(3, nrt_reader.size());
+
+  irs::async_utils::thread_pool pool(2, 2);
+
+  for (auto* index : { &nrt_reader, &reader }) {
+    irs::Or filter;
+    filter.add<irs::by_term>().field("body").term("alpha");
+    filter.add<irs::by_term>().field("body").term("beta");
+    auto prepared_filter = filter.prepare(*index, prepared_order);
+
+    irs::by_term kept;
+    kept.field("tag").term("kept");
+    auto prepared_kept = kept.prepare(*index);
+
+    // live documents matching the filter
+    std::set<std::pair<size_t, irs::doc_id_t>> expected;
+    {
+      size_t i = 0;
+      for (auto& segment : *index) {
+        auto live = segment.docs_iterator();
+        std::set<irs::doc_id_t> live_docs;
+
+        while (live->next()) {
+          live_docs.insert(live->value());
+        }
+
+        for (auto docs = prepared_filter->execute(segment); docs->next();) {
+          if (live_docs.count(docs->value())) {
+            expected.emplace(i, docs->value());
+          }
+        }
+
+        // the removed documents of the first 3 segments are masked
+        size_t kept_count = 0;
+        for (auto docs = prepared_kept->execute(segment); docs->next();) {
+          ASSERT_EQ(1, live_docs.count(docs->value()));
+          ++kept_count;
+        }
+        ASSERT_EQ(i < 3, kept_count == live_docs.size());
+
+        ++i;
+      }
+    }
+
+    for (size_t k : { 10, 100000 }) {
+      for (auto* collect_pool : { (irs::async_utils::thread_pool*)nullptr, &pool }) {
+        irs::top_k_collector collector(prepared_order, k);
+        collector.collect(*index, *prepared_filter, collect_pool);
+        auto top = collector.release();
+        ASSERT_EQ(std::min(k, expected.size()), top.size());
+
+        for (auto& entry : top) {
+          ASSERT_EQ(1, expected.count(std::make_pair(entry.segment, entry.doc)));
+        }
+      }
+    }
+  }
+}
+
+TEST_F(top_k_collector_test, collect_unordered) {
+  write_segments(3, 100);
+
+  auto& prepared_order = irs::order::prepared::unordered();
+  auto reader = irs::directory_reader::open(dir(), codec());
+
+  irs::by_term filter;
+  filter.field("body").term("filler");
+  auto prepared_filter = filter.prepare(reader, prepared_order);
+
+  irs::async_utils::thread_pool pool(2, 2);
+  irs::top_k_collector collector(prepared_order, 150);
+  collector.collect(reader, *prepared_filter, &pool);
+  ASSERT_EQ(reader.docs_count(), collector.hits());
+  ASSERT_FALSE(collector.pruned());
+
+  // without scores the documents are ranked by segment and document only
+  auto top = collector.release();
+  ASSERT_EQ(150, top.size());
+
+  for (size_t i = 0; i < 100; ++i) {
+    ASSERT_TRUE(top[i].score.empty());
+    ASSERT_EQ(0, top[i].segment);
+    ASSERT_EQ(irs::doc_id_t(irs::type_limits<irs::type_t::doc_id_t>::min() + i), top[i].doc);
+  }
+
+  for (size_t i = 100; i < 150; ++i) {
+    ASSERT_EQ(1, top[i].segment);
+    ASSERT_EQ(irs::doc_id_t(irs::type_limits<irs::type_t::doc_id_t>::min() + i - 100), top[i].doc);
+  }
+}
+
+TEST_F(top_k_collector_test, collect_score_block) {
+  write_segments(3, 1000);
+
+  irs::order order;
+  order.add<irs::bm25_sort>();
+  order.add(std::make_shared<irs::tfidf_sort>(true)); // with norms
+  auto prepared_order = order.prepare();
+  const auto score_size = prepared_order.size();
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+
+  irs::by_term filter;
+  filter.field("body").term("beta");
+  auto prepared_filter = filter.prepare(reader, prepared_order);
+
+  // scores of a block are equal to the scores of the documents one by one
+  for (auto& segment : reader) {
+    auto docs = prepared_filter->execute(segment, prepared_order);
+    auto& score = docs->attributes().get<irs::score>();
+    ASSERT_FALSE(!score);
+
+    auto block_docs = prepared_filter->execute(segment, prepared_order);
+    auto& block = block_docs->attributes().get<irs::score_block>();
+    ASSERT_FALSE(!block);
+
+    irs::doc_id_t ids[irs::score_block::SIZE];
+    irs::bstring scores(irs::score_block::SIZE*score_size, 0);
+
+    for (size_t count : { size_t(1), size_t(3), size_t(irs::score_block::SIZE), size_t(1000) }) {
+      // a block ends at the end of the decoded postings block at the latest
+      const size_t size = block->next(ids, &scores[0], count);
+      ASSERT_LT(0, size);
+      ASSERT_GE(std::min(count, size_t(irs::score_block::SIZE)), size);
+      ASSERT_EQ(ids[size - 1], block_docs->value());
+
+      for (size_t i = 0; i < size; ++i) {
+        ASSERT_TRUE(docs->next());
+        ASSERT_EQ(docs->value(), ids[i]);
+        score->evaluate();
+
+        for (size_t j = 0; j < 2; ++j) {
+          ASSERT_FLOAT_EQ(
+            prepared_order.get<float>(score->c_str(), j),
+            prepared_order.get<float>(scores.c_str() + i*score_size, j)
+          );
+        }
+      }
+    }
+
+    while (docs->next()) {
+      ASSERT_NE(0, block->next(ids, &scores[0], 1));
+      ASSERT_EQ(docs->value(), ids[0]);
+    }
+
+    ASSERT_EQ(0, block->next(ids, &scores[0], irs::score_block::SIZE));
+  }
+
+  // the collector ranks the block scores the same way as the document scores
+  std::vector<std::pair<irs::bstring, std::pair<size_t, irs::doc_id_t>>> expected;
+  size_t i = 0;
+
+  for (auto& segment : reader) {
+    auto docs = prepared_filter->execute(segment, prepared_order);
+    auto& score = docs->attributes().get<irs::score>();
+
+    while (docs->next()) {
+      score->evaluate();
+      expected.emplace_back(score->value(), std::make_pair(i, docs->value()));
+    }
+
+    ++i;
+  }
+
+  std::sort(
+    expected.begin(), expected.end(),
+    [&prepared_order](
+        const std::pair<irs::bstring, std::pair<size_t, irs::doc_id_t>>& lhs,
+        const std::pair<irs::bstring, std::pair<size_t, irs::doc_id_t>>& rhs) {
+      if (prepared_order.less(lhs.first.c_str(), rhs.first.c_str())) {
+        return true;
+      }
+
+      if (prepared_order.less(rhs.first.c_str(), lhs.first.c_str())) {
+        return false;
+      }
+
+      return lhs.second < rhs.second;
+  });
+
+  irs::top_k_collector collector(prepared_order, 50);
+  collector.collect(reader, *prepared_filter);
+  ASSERT_EQ(expected.size(), collector.hits());
+  auto top = collector.release();
+  ASSERT_EQ(50, top.size());
+
+  for (size_t i = 0; i < top.size(); ++i) {
+    ASSERT_EQ(expected[i].second.first, top[i].segment);
+    ASSERT_EQ(expected[i].second.second, top[i].doc);
+  }
+}
+
+TEST_F(top_k_collector_test, collect_exclusion) {
+  write_segments(3, 1000);
+
+  irs::order order;
+  order.add<irs::bm25_sort>();
+  auto prepared_order = order.prepare();
+
+  auto reader = irs::directory_reader::open(dir(), codec());
+
+  // exclusion exposes the attributes of the included iterator
+  irs::And filter;
+  filter.add<irs::by_term>().field("body").term("beta");
+  filter.add<irs::Not>().filter<irs::by_term>().field("body").term("alpha");
+  auto prepared_filter = filter.prepare(reader, prepared_order);
+
+  size_t expected = 0;
+
+  for (auto& segment : reader) {
+    auto docs = prepared_filter->execute(segment, prepared_order);
+
+    while (docs->next()) {
+      ++expected;
+    }
+  }
+
+  irs::top_k_collector collector(prepared_order, 10);
+  collector.collect(reader, *prepared_filter);
+  ASSERT_EQ(expected, collector.hits());
+}
@@ -28,9 +28,9 @@
 #include "store/data_input.hpp"
 #include "store/checksum_io.hpp"
 #include "utils/async_utils.hpp"
+#include "utils/crc.hpp"
 #include "utils/utf8_path.hpp"
 
-#include <boost/crc.hpp>
 #include <cstdio>
 #include <vector>
 #include <string>
@@ -268,6 +268,178 @@ void directory_test_case::read_multiple_streams() {
   }
 }
 
+void directory_test_case::vencoded_read() {
+  using namespace iresearch;
+
+  // runs of single byte values mixed with long values, crossing buffer
+  // boundaries of buffered inputs at different offsets
+  std::vector<uint64_t> values;
+  for (uint64_t i = 0; i < 10000; ++i) {
+    values.push_back(i % 100 < 50 ? i % 128 : i * UINT64_C(0x9E3779B97F4A7C15) >> (i % 64));
+  }
+
+  // write data
+  {
+    auto out = dir_->create("test");
+    ASSERT_FALSE(!out);
+    for (auto value : values) {
+      out->write_vlong(value);
+    }
+    for (auto value : values) {
+      out->write_vint(uint32_t(value));
+    }
+  }
+
+  // read data value by value
+  {
+    auto in = dir_->open("test");
+    ASSERT_FALSE(!in);
+    for (auto value : values) {
+      ASSERT_EQ(value, in->read_vlong());
+    }
+    for (auto value : values) {
+      ASSERT_EQ(uint32_t(value), in->read_vint());
+    }
+    ASSERT_TRUE(in->eof());
+  }
+
+  // read data in bulk
+  for (size_t step : { 1, 7, 128, 10000 }) {
+    auto in = dir_->open("test");
+    ASSERT_FALSE(!in);
+
+    std::vector<uint64_t> longs(values.size());
+    for (size_t i = 0; i < longs.size(); i += step) {
+      in->read_vlongs(&longs[i], std::min(step, longs.size() - i));
+    }
+    ASSERT_EQ(values, longs);
+
+    std::vector<uint32_t> ints(values.size());
+    for (size_t i = 0; i < ints.size(); i += step) {
+      in->read_vints(&ints[i], std::min(step, ints.size() - i));
+    }
+    for (size_t i = 0; i < ints.size(); ++i) {
+      ASSERT_EQ(uint32_t(values[i]), ints[i]);
+    }
+    ASSERT_TRUE(in->eof());
+  }
+}
+
+void directory_test_case::access_hints() {
+  using namespace iresearch;
+
+  const size_t count = 100000;
+
+  {
+    auto out = dir_->create("test");
+    ASSERT_FALSE(!out);
+    for (size_t i = 0; i < count; ++i) {
+      out->write_int(int32_t(i));
+    }
+  }
+
+  // hints never affect the data read
+  for (auto advice : { IOAdvice::NORMAL, IOAdvice::SEQUENTIAL, IOAdvice::RANDOM,
+                       IOAdvice::WILLNEED, IOAdvice::DONTNEED }) {
+    auto in = dir_->open("test");
+    ASSERT_FALSE(!in);
+    in->advise(advice);
+
+    auto dup = in->dup();
+    ASSERT_FALSE(!dup);
+    dup->advise(advice);
+
+    for (size_t i = 0; i < count; i += 1000) {
+      const size_t offset = (count - i - 1) * sizeof(int32_t);
+      in->prefetch(offset, sizeof(int32_t));
+      in->seek(offset);
+      ASSERT_EQ(int32_t(count - i - 1), in->read_int());
+
+      dup->prefetch(i * sizeof(int32_t), 1000 * sizeof(int32_t));
+      dup->seek(i * sizeof(int32_t));
+      ASSERT_EQ(int32_t(i), dup->read_int());
+    }
+
+    // out of bounds and empty ranges are ignored
+    in->prefetch(in->length(), 1);
+    in->prefetch(in->length() - 1, std::numeric_limits<size_t>::max() / 2);
+    in->prefetch(0, 0);
+    in->seek(0);
+    ASSERT_EQ(0, in->read_int());
+  }
+}
+
+void directory_test_case::read_batch() {
+  using namespace iresearch;
+
+  const size_t count = 100000;
+
+  {
+    auto out = dir_->create("test");
+    ASSERT_FALSE(!out);
+    for (size_t i = 0; i < count; ++i) {
+      out->write_int(int32_t(i));
+    }
+  }
+
+  auto in = dir_->open("test");
+  ASSERT_FALSE(!in);
+  in->seek(42 * sizeof(int32_t));
+
+  // more requests than fit into a single submission
+  for (size_t batch_size : { 1, 2, 17, 200 }) {
+    std::vector<read_request> requests(batch_size);
+    std::vector<bstring> bufs(batch_size);
+
+    // shuffled, overlapping ranges of different size
+    for (size_t i = 0; i < batch_size; ++i) {
+      const size_t first = (i * 7919) % (count - 1000);
+      const size_t size = 1 + (i * 31) % 1000;
+
+      bufs[i].resize(size * sizeof(int32_t));
+      requests[i].offset = first * sizeof(int32_t);
+      requests[i].buf = &bufs[i][0];
+      requests[i].size = bufs[i].size();
+    }
+
+    in->read_batch(requests.data(), requests.size());
+
+    for (size_t i = 0; i < batch_size; ++i) {
+      bytes_ref_input buf_in(bufs[i]);
+      const size_t first = requests[i].offset / sizeof(int32_t);
+
+      for (size_t j = 0, size = bufs[i].size() / sizeof(int32_t); j < size; ++j) {
+        ASSERT_EQ(int32_t(first + j), buf_in.read_int());
+      }
+    }
+
+    // stream position isn't affected
+    ASSERT_EQ(42 * sizeof(int32_t), in->file_pointer());
+    ASSERT_EQ(42, in->read_int());
+    in->seek(42 * sizeof(int32_t));
+  }
+
+  // empty batch
+  in->read_batch(nullptr, 0);
+
+  // request past the end of file
+  {
+    bstring buf(8, 0);
+    read_request requests[] = {
+      { 0, &buf[0], 4 },
+      { in->length() - 4, &buf[4], 4 },
+    };
+
+    in->read_batch(requests, 2);
+    bytes_ref_input buf_in(buf);
+    ASSERT_EQ(0, buf_in.read_int());
+    ASSERT_EQ(int32_t(count - 1), buf_in.read_int());
+
+    requests[1].offset = in->length() - 2;
+    ASSERT_THROW(in->read_batch(requests, 2), io_error);
+  }
+}
+
 void directory_test_case::string_read_write() {
   using namespace iresearch;
 
@@ -880,7 +1052,7 @@ void directory_test_case::smoke_store() {
   auto it = names.end();
   for (const auto& name : names) {
     --it;
-    boost::crc_32_type crc;
+    irs::crc32c crc;
 
     auto file = dir_->create(name);
     ASSERT_FALSE(!file);
@@ -912,7 +1084,7 @@ void directory_test_case::smoke_store() {
 
   for (const auto& name : names) {
     --it;
-    boost::crc_32_type crc;
+    irs::crc32c crc;
     bool exists;
 
     ASSERT_TRUE(dir_->exists(exists, name) && exists);
@@ -921,7 +1093,7 @@ void directory_test_case::smoke_store() {
 
     auto in = dir_->open(name);
     ASSERT_FALSE(!in);
-    checksum_index_input<boost::crc_32_type> file(std::move(in));
+    checksum_index_input<irs::crc32c> file(std::move(in));
     EXPECT_FALSE(file.eof());
     EXPECT_EQ(0, file.file_pointer());
     EXPECT_EQ(file.length(), it->size());
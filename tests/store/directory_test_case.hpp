@@ -35,6 +35,9 @@ class directory_test_case {
   void smoke_store();
   void string_read_write();
   void read_multiple_streams();
+  void vencoded_read();
+  void access_hints();
+  void read_batch();
   void lock_obtain_release();
   void directory_size();
 
@@ -121,6 +121,18 @@ TEST_F(fs_directory_test, read_multiple_streams) {
   read_multiple_streams();
 }
 
+TEST_F(fs_directory_test, vencoded_read) {
+  vencoded_read();
+}
+
+TEST_F(fs_directory_test, access_hints) {
+  access_hints();
+}
+
+TEST_F(fs_directory_test, read_batch) {
+  read_batch();
+}
+
 TEST_F(fs_directory_test, string_read_write) {
   string_read_write();
 }
@@ -25,6 +25,8 @@
 #include "store/store_utils.hpp"
 #include "utils/misc.hpp"
 
+#include <random>
+
 using namespace iresearch;
 
 namespace tests {
@@ -77,6 +79,11 @@ void delta_encode_decode_core(size_t step, size_t count) {
   auto decoded = encoded;
   irs::encode::delta::decode(decoded.begin(), decoded.end());
   ASSERT_EQ(values, decoded);
+
+  // raw buffer (possibly vectorized) decoding
+  std::vector<uint64_t> raw(encoded.begin(), encoded.end());
+  irs::encode::delta::decode(raw.data(), raw.data() + raw.size());
+  ASSERT_TRUE(std::equal(values.begin(), values.end(), raw.begin()));
 }
 
 void packed_read_write_core(const std::vector<uint32_t> &src) {
@@ -247,6 +254,54 @@ TEST(store_utils_tests, vlong_from_array) {
   tests::detail::vencode_from_array(irs::integer_traits<uint64_t>::const_max, 10);
 }
 
+TEST(store_utils_tests, vencoded_bulk_read) {
+  std::vector<uint64_t> values;
+  for (uint64_t i = 0; i < 1000; ++i) {
+    values.push_back(i % 20 < 10 ? i % 128 : UINT64_C(1) << (i % 64));
+  }
+
+  irs::bytes_output out;
+  for (auto value : values) {
+    out.write_vlong(value);
+  }
+
+  // decode directly from memory
+  {
+    std::vector<uint64_t> longs(values.size());
+    const irs::bytes_ref data = out;
+    const auto res = irs::read_vencoded(
+      data.c_str(), data.c_str() + data.size(), &longs[0], longs.size()
+    );
+
+    // values which may cross the end of data are left undecoded
+    ASSERT_LT(0, res.first);
+    ASSERT_GT(longs.size(), res.first);
+    ASSERT_LE(size_t(std::distance(res.second, data.c_str() + data.size())), 10);
+    ASSERT_TRUE(std::equal(longs.begin(), longs.begin() + res.first, values.begin()));
+  }
+
+  // bytes_input
+  {
+    irs::bytes_input in(out);
+    std::vector<uint64_t> longs(values.size());
+    in.read_vlongs(&longs[0], 3);
+    longs[3] = in.read_vlong();
+    in.read_vlongs(&longs[4], longs.size() - 4);
+    ASSERT_EQ(values, longs);
+    ASSERT_TRUE(in.eof());
+  }
+
+  // bytes_ref_input
+  {
+    irs::bytes_ref_input in(out);
+    std::vector<uint64_t> longs(values.size());
+    in.read_vlongs(&longs[0], longs.size() - 1);
+    longs.back() = in.read_vlong();
+    ASSERT_EQ(values, longs);
+    ASSERT_TRUE(in.eof());
+  }
+}
+
 TEST(store_utils_tests, zvfloat_read_write) {
   tests::detail::read_write_core<float_t>(
     {
@@ -622,6 +677,26 @@ TEST(store_utils_tests, delta_encode_decode) {
   tests::detail::delta_encode_decode_core(1, 1000); // step = 1, count = 1000
   tests::detail::delta_encode_decode_core(128, 1000); // step = 128, count = 1000
   tests::detail::delta_encode_decode_core(1000, 1); // step = 1000, count = 1
+  tests::detail::delta_encode_decode_core(7, 131); // step = 7, count = 131
+}
+
+TEST(store_utils_tests, delta_decode_matches_scalar) {
+  // decoding of a raw buffer may use vector instructions, the generic
+  // decode(...) is always scalar, both must produce the same values
+  std::mt19937_64 rnd(42);
+
+  for (size_t count = 1; count <= 2*irs::packed::BLOCK_SIZE_64 + 3; ++count) {
+    std::vector<uint64_t> encoded(count);
+    for (auto& v : encoded) { v = rnd() % 1000; }
+
+    auto expected = encoded;
+    irs::encode::delta::decode(expected.begin(), expected.end());
+
+    auto actual = encoded;
+    irs::encode::delta::decode(actual.data(), actual.data() + actual.size());
+
+    ASSERT_EQ(expected, actual);
+  }
 }
 
 TEST(store_utils_tests, avg_encode_decode) {
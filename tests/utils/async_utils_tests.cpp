@@ -26,6 +26,7 @@
 #include <mutex>
 
 #include "gtest/gtest.h"
+#include "error/error.hpp"
 #include "utils/async_utils.hpp"
 
 namespace tests {
@@ -611,6 +612,66 @@ TEST_F(async_utils_tests, test_thread_pool_stop_mt) {
   }
 }
 
+TEST_F(async_utils_tests, test_task_group_mt) {
+  // test run without pool (inline)
+  {
+    irs::async_utils::task_group tasks;
+    auto thread_id = std::this_thread::get_id();
+    size_t count = 0;
+
+    tasks.run([&count, thread_id]()->void { ASSERT_EQ(thread_id, std::this_thread::get_id()); ++count; });
+    tasks.run([&count, thread_id]()->void { ASSERT_EQ(thread_id, std::this_thread::get_id()); ++count; });
+    tasks.wait();
+    ASSERT_EQ(2, count);
+  }
+
+  // test wait for all tasks
+  {
+    irs::async_utils::thread_pool pool(3, 0);
+    irs::async_utils::task_group tasks(&pool);
+    std::atomic<size_t> count(0);
+
+    for (size_t i = 0; i < 10; ++i) {
+      tasks.run([&count]()->void { std::this_thread::sleep_for(std::chrono::milliseconds(50)); ++count; });
+    }
+
+    tasks.wait();
+    ASSERT_EQ(10, count);
+
+    // group reusable after wait
+    tasks.run([&count]()->void { ++count; });
+    tasks.wait();
+    ASSERT_EQ(11, count);
+    pool.stop();
+  }
+
+  // test exception propagated after all tasks finished
+  {
+    irs::async_utils::thread_pool pool(2, 0);
+    irs::async_utils::task_group tasks(&pool);
+    std::atomic<size_t> count(0);
+
+    tasks.run([]()->void { throw irs::illegal_state(); });
+    tasks.run([&count]()->void { std::this_thread::sleep_for(std::chrono::milliseconds(100)); ++count; });
+    ASSERT_THROW(tasks.wait(), irs::illegal_state);
+    ASSERT_EQ(1, count);
+    tasks.wait(); // error already reported
+    pool.stop();
+  }
+
+  // test stopped pool runs tasks inline
+  {
+    irs::async_utils::thread_pool pool(1, 0);
+    irs::async_utils::task_group tasks(&pool);
+    size_t count = 0;
+
+    pool.stop();
+    tasks.run([&count]()->void { ++count; });
+    ASSERT_EQ(1, count);
+    tasks.wait();
+  }
+}
+
 // -----------------------------------------------------------------------------
 // --SECTION--                                                       END-OF-FILE
 // -----------------------------------------------------------------------------
@@ -74,6 +74,15 @@ struct invalid_attribute : iresearch::stored_attribute {
 DEFINE_ATTRIBUTE_TYPE(tests::invalid_attribute);
 DEFINE_FACTORY_DEFAULT(invalid_attribute);
 
+template<size_t N>
+struct numbered_attribute : iresearch::attribute {
+  DECLARE_ATTRIBUTE_TYPE();
+};
+
+// type identity is defined by the address of the type_id
+template<size_t N>
+DEFINE_ATTRIBUTE_TYPE_NAMED(tests::numbered_attribute<N>, "numbered_attribute");
+
 } // tests
 
 TEST(attributes_tests, duplicate_register) {
@@ -325,3 +334,63 @@ TEST(attributes_tests, view_visit) {
     ASSERT_TRUE(expected.empty());
   }
 }
+
+TEST(attributes_tests, view_slots_overflow) {
+  irs::attribute_view attrs;
+  tests::numbered_attribute<0> value0;
+  tests::numbered_attribute<1> value1;
+  tests::numbered_attribute<2> value2;
+  tests::numbered_attribute<3> value3;
+  tests::numbered_attribute<4> value4;
+  tests::numbered_attribute<5> value5;
+  tests::numbered_attribute<6> value6;
+  tests::numbered_attribute<7> value7;
+  tests::numbered_attribute<8> value8;
+  tests::numbered_attribute<9> value9;
+
+  auto& ref0 = attrs.emplace(value0);
+  attrs.emplace(value1);
+  attrs.emplace(value2);
+  attrs.emplace(value3);
+  attrs.emplace(value4);
+  attrs.emplace(value5);
+  attrs.emplace(value6);
+  attrs.emplace(value7);
+  auto& ref8 = attrs.emplace(value8); // beyond inline slots
+  attrs.emplace(value9);
+  ASSERT_EQ(10, attrs.size());
+  ASSERT_EQ(10, attrs.features().size());
+  ASSERT_EQ(&value0, attrs.get<tests::numbered_attribute<0>>()->get());
+  ASSERT_EQ(&value8, attrs.get<tests::numbered_attribute<8>>()->get());
+  ASSERT_EQ(&value9, attrs.get<tests::numbered_attribute<9>>()->get());
+
+  // references remain valid after removal of other entries
+  ASSERT_TRUE(attrs.remove<tests::numbered_attribute<3>>());
+  ASSERT_FALSE(attrs.remove<tests::numbered_attribute<3>>());
+  ASSERT_TRUE(attrs.remove<tests::numbered_attribute<9>>());
+  ASSERT_EQ(8, attrs.size());
+  ASSERT_FALSE(attrs.contains<tests::numbered_attribute<3>>());
+  ASSERT_FALSE(attrs.contains<tests::numbered_attribute<9>>());
+  ASSERT_EQ(&ref0, attrs.get<tests::numbered_attribute<0>>());
+  ASSERT_EQ(&ref8, attrs.get<tests::numbered_attribute<8>>());
+
+  // removed slot is reused
+  attrs.emplace(value9);
+  ASSERT_EQ(9, attrs.size());
+  ASSERT_EQ(&value9, attrs.get<tests::numbered_attribute<9>>()->get());
+
+  size_t count = 0;
+  ASSERT_TRUE(attrs.visit([&count](const attribute::type_id&, const attribute_view::ref<attribute>::type& value) {
+    ++count;
+    return bool(value);
+  }));
+  ASSERT_EQ(9, count);
+
+  // move
+  irs::attribute_view moved(std::move(attrs));
+  ASSERT_EQ(9, moved.size());
+  ASSERT_EQ(0, attrs.size());
+  ASSERT_FALSE(attrs.contains<tests::numbered_attribute<0>>());
+  ASSERT_EQ(&value0, moved.get<tests::numbered_attribute<0>>()->get());
+  ASSERT_EQ(&value8, moved.get<tests::numbered_attribute<8>>()->get());
+}
@@ -27,6 +27,7 @@
 
 #include <vector>
 #include <algorithm>
+#include <random>
   
 using namespace iresearch;
 
@@ -261,6 +262,46 @@ TEST(bit_packing_tests, pack_unpack_64) {
   }
 }
 
+TEST(bit_packing_tests, unpack_matches_scalar) {
+  // packed::unpack(...) may use vector instructions for widths [1..32],
+  // packed::at(...) is always scalar, both must produce the same values
+  std::mt19937_64 rnd(42);
+
+  // random values and the values with all bits set
+  for (auto all_bits : { false, true }) {
+    std::vector<uint32_t> src32(3*packed::BLOCK_SIZE_32);
+    std::vector<uint64_t> src64(3*packed::BLOCK_SIZE_64);
+    for (auto& v : src32) { v = all_bits ? ~uint32_t(0) : uint32_t(rnd()); }
+    for (auto& v : src64) { v = all_bits ? ~uint64_t(0) : rnd(); }
+
+    for (uint32_t bits = 1; bits <= 32; ++bits) {
+      {
+        std::vector<uint32_t> packed(packed::blocks_required_32(uint32_t(src32.size()), bits), 0);
+        packed::pack(&src32[0], &src32[0] + src32.size(), &packed[0], bits);
+
+        std::vector<uint32_t> unpacked(src32.size());
+        packed::unpack(&unpacked[0], &unpacked[0] + unpacked.size(), &packed[0], bits);
+
+        for (size_t i = 0, end = src32.size(); i < end; ++i) {
+          ASSERT_EQ(packed::at(packed.data(), i, bits), unpacked[i]);
+        }
+      }
+
+      {
+        std::vector<uint64_t> packed(packed::blocks_required_64(src64.size(), bits), 0);
+        packed::pack(&src64[0], &src64[0] + src64.size(), &packed[0], bits);
+
+        std::vector<uint64_t> unpacked(src64.size());
+        packed::unpack(&unpacked[0], &unpacked[0] + unpacked.size(), &packed[0], bits);
+
+        for (size_t i = 0, end = src64.size(); i < end; ++i) {
+          ASSERT_EQ(packed::at(packed.data(), i, bits), unpacked[i]);
+        }
+      }
+    }
+  }
+}
+
 TEST(bit_packing_tests, iterator32) {
   std::vector<uint32_t> src{
     14410, 21766, 15994, 29493, 20819,
@@ -0,0 +1,238 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+#include "store/memory_directory.hpp"
+#include "utils/compact_fst.hpp"
+#include "utils/fst.hpp"
+
+#include <random>
+
+namespace tests {
+
+typedef std::vector<std::pair<irs::bstring, irs::byte_weight>> fst_data_t;
+
+fst_data_t generate_fst_data(size_t count, size_t max_length) {
+  std::mt19937 engine(42);
+  std::uniform_int_distribution<size_t> length(1, max_length);
+  std::uniform_int_distribution<int> label(0, 255);
+  std::set<irs::bstring> keys;
+
+  while (keys.size() < count) {
+    irs::bstring key(length(engine), 0);
+
+    for (auto& c : key) {
+      // narrow alphabet produces both contiguous and sparse arc ranges
+      c = irs::byte_type(label(engine) % 3 ? 'a' + label(engine) % 8 : label(engine));
+    }
+
+    keys.emplace(std::move(key));
+  }
+
+  fst_data_t data;
+  data.reserve(keys.size());
+
+  for (auto& key : keys) {
+    const auto value = std::to_string(data.size());
+    data.emplace_back(key, irs::byte_weight(value.begin(), value.end()));
+  }
+
+  return data;
+}
+
+void build_fst(irs::vector_byte_fst& fst, const fst_data_t& data) {
+  irs::fst_byte_builder builder(fst);
+  builder.reset();
+
+  for (auto& entry : data) {
+    builder.add(entry.first, entry.second);
+  }
+
+  builder.finish();
+}
+
+// accumulated output for the specified key, Zero() if not accepted
+irs::byte_weight lookup(
+    const irs::vector_byte_fst& fst, const irs::bytes_ref& key) {
+  irs::byte_weight output;
+  auto state = fst.Start();
+
+  for (auto c : key) {
+    fst::ArcIterator<irs::vector_byte_fst> it(fst, state);
+
+    for (; !it.Done() && it.Value().ilabel != c; it.Next()) { }
+
+    if (it.Done()) {
+      return irs::byte_weight::Zero();
+    }
+
+    output.PushBack(it.Value().weight);
+    state = it.Value().nextstate;
+  }
+
+  const auto final = fst.Final(state);
+
+  if (final == irs::byte_weight::Zero()) {
+    return final;
+  }
+
+  output.PushBack(final);
+  return output;
+}
+
+// accumulated output for the specified key, Zero() if not accepted
+irs::byte_weight lookup(
+    irs::compact_fst::cursor& cursor,
+    irs::compact_fst::stateid_t state,
+    const irs::bytes_ref& key) {
+  irs::byte_weight output;
+
+  for (auto c : key) {
+    if (!cursor.find(state, c)) {
+      return irs::byte_weight::Zero();
+    }
+
+    EXPECT_EQ(c, cursor.value().ilabel);
+    output.PushBack(cursor.value().weight);
+    state = cursor.value().nextstate;
+  }
+
+  const auto final = cursor.final(state);
+
+  if (final == irs::byte_weight::Zero()) {
+    return final;
+  }
+
+  output.PushBack(final);
+  return output;
+}
+
+void assert_fst(
+    irs::compact_fst& fst,
+    const irs::vector_byte_fst& expected,
+    const fst_data_t& data) {
+  irs::compact_fst::cursor cursor(fst);
+
+  for (auto& entry : data) {
+    const auto output = lookup(expected, entry.first);
+    ASSERT_NE(irs::byte_weight::Zero(), output);
+    ASSERT_EQ(output, lookup(cursor, fst.start(), entry.first));
+  }
+
+  // extensions and prefixes of the keys, may or may not be accepted
+  for (auto& entry : data) {
+    irs::bstring key = entry.first;
+    key.push_back(255);
+    ASSERT_EQ(lookup(expected, key), lookup(cursor, fst.start(), key));
+    key.back() = 0;
+    ASSERT_EQ(lookup(expected, key), lookup(cursor, fst.start(), key));
+
+    // proper prefixes
+    for (key.pop_back(); !key.empty(); key.pop_back()) {
+      ASSERT_EQ(lookup(expected, key), lookup(cursor, fst.start(), key));
+    }
+  }
+}
+
+}
+
+TEST(compact_fst_tests, empty) {
+  irs::vector_byte_fst fst;
+  irs::compact_fst compact;
+
+  compact.reset(fst);
+  ASSERT_EQ(0, compact.size());
+  ASSERT_EQ(0, compact.start());
+}
+
+TEST(compact_fst_tests, in_memory) {
+  const auto data = tests::generate_fst_data(5000, 12);
+  irs::vector_byte_fst fst;
+  tests::build_fst(fst, data);
+
+  irs::compact_fst compact;
+  compact.reset(fst);
+  ASSERT_LT(0, compact.size());
+  ASSERT_NE(irs::compact_fst::FINAL, compact.start());
+
+  // state 0 is the only final state without arcs
+  {
+    irs::compact_fst::cursor cursor(compact);
+    ASSERT_EQ(irs::byte_weight::One(), cursor.final(irs::compact_fst::FINAL));
+
+    for (size_t c = 0; c < 256; ++c) {
+      ASSERT_FALSE(cursor.find(irs::compact_fst::FINAL, irs::byte_type(c)));
+    }
+  }
+
+  tests::assert_fst(compact, fst, data);
+
+  // moved fst remains functional
+  irs::compact_fst moved(std::move(compact));
+  tests::assert_fst(moved, fst, data);
+}
+
+TEST(compact_fst_tests, read_write) {
+  const auto data = tests::generate_fst_data(20000, 24);
+  irs::vector_byte_fst fst;
+  tests::build_fst(fst, data);
+
+  irs::memory_directory dir;
+
+  {
+    auto out = dir.create("fst");
+    ASSERT_FALSE(!out);
+    out->write_vlong(42);
+    irs::write_compact_fst(*out, fst);
+    out->write_int(0xDEADBEEF);
+  }
+
+  auto in = dir.open("fst");
+  ASSERT_FALSE(!in);
+  ASSERT_EQ(42, in->read_vlong());
+
+  irs::compact_fst compact;
+  ASSERT_TRUE(compact.read(*in));
+  ASSERT_EQ(0xDEADBEEF, uint32_t(in->read_int())); // positioned past the fst
+  ASSERT_TRUE(in->eof());
+
+  // compact encoding is smaller than the OpenFST one
+  {
+    std::stringstream stream;
+    fst.Write(stream, fst::FstWriteOptions());
+    ASSERT_LT(compact.size(), stream.str().size());
+  }
+
+  tests::assert_fst(compact, fst, data);
+
+  // cursors are independent of each other and of the source stream
+  irs::compact_fst::cursor cursor0(compact);
+  irs::compact_fst::cursor cursor1(compact);
+  in->seek(0);
+
+  for (auto& entry : data) {
+    const auto output = tests::lookup(fst, entry.first);
+    ASSERT_EQ(output, tests::lookup(cursor0, compact.start(), entry.first));
+    ASSERT_EQ(output, tests::lookup(cursor1, compact.start(), entry.first));
+  }
+}
@@ -0,0 +1,98 @@
+////////////////////////////////////////////////////////////////////////////////
+/// DISCLAIMER
+///
+/// Copyright 2016 by EMC Corporation, All Rights Reserved
+///
+/// Licensed under the Apache License, Version 2.0 (the "License");
+/// you may not use this file except in compliance with the License.
+/// You may obtain a copy of the License at
+///
+///     http://www.apache.org/licenses/LICENSE-2.0
+///
+/// Unless required by applicable law or agreed to in writing, software
+/// distributed under the License is distributed on an "AS IS" BASIS,
+/// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+/// See the License for the specific language governing permissions and
+/// limitations under the License.
+///
+/// Copyright holder is EMC Corporation
+///
+/// @author Andrey Abramov
+/// @author Vasiliy Nabatchikov
+////////////////////////////////////////////////////////////////////////////////
+
+#include "tests_shared.hpp"
+
+#include "utils/checksum.hpp"
+#include "utils/crc.hpp"
+#include "utils/string.hpp"
+
+#include <random>
+
+NS_LOCAL
+
+// bitwise reference implementation
+uint32_t crc32c_bitwise(const irs::byte_type* begin, size_t size) {
+  uint32_t crc = 0xFFFFFFFF;
+
+  for (; size; --size) {
+    crc ^= *begin++;
+
+    for (size_t i = 0; i < 8; ++i) {
+      crc = (crc & 1) ? (crc >> 1) ^ 0x82F63B78 : crc >> 1;
+    }
+  }
+
+  return crc ^ 0xFFFFFFFF;
+}
+
+NS_END
+
+TEST(crc_test, crc32c_check_values) {
+  irs::crc32c crc;
+  ASSERT_EQ(0U, crc.checksum());
+
+  crc.process_bytes("123456789", 9);
+  ASSERT_EQ(0xE3069283, crc.checksum());
+
+  crc.reset();
+  const irs::bstring zeros(32, 0);
+  crc.process_bytes(zeros.c_str(), zeros.size());
+  ASSERT_EQ(0x8A9136AA, crc.checksum());
+
+  crc.reset();
+  const irs::bstring ones(32, 0xFF);
+  crc.process_bytes(ones.c_str(), ones.size());
+  ASSERT_EQ(0x62A8AB43, crc.checksum());
+}
+
+TEST(crc_test, crc32c_sizes) {
+  std::mt19937 engine(42);
+  irs::bstring data(64*1024, 0);
+
+  for (auto& b : data) {
+    b = irs::byte_type(engine());
+  }
+
+  // cover the tails of every stride as well as the interleaved streams
+  for (size_t size = 0; size < data.size(); size = size < 4096 ? size + 1 : size * 2 + 1) {
+    const auto expected = crc32c_bitwise(data.c_str(), size);
+
+    irs::crc32c whole;
+    whole.process_bytes(data.c_str(), size);
+    ASSERT_EQ(expected, whole.checksum());
+
+    // unaligned pieces of different sizes
+    irs::crc32c pieces;
+    for (size_t i = 0, step = 1; i < size; i += step, step = step * 3 % 1031) {
+      pieces.process_bytes(data.c_str() + i, std::min(step, size - i));
+    }
+    ASSERT_EQ(expected, pieces.checksum());
+
+    irs::buffered_checksum<irs::crc32c> buffered;
+    for (size_t i = 0; i < size; ++i) {
+      buffered.process_byte(data[i]);
+    }
+    ASSERT_EQ(expected, buffered.checksum());
+  }
+}
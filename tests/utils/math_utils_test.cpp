@@ -222,3 +222,13 @@ TEST(math_utils, clz32) {
   ASSERT_EQ(9, math::clz32(4333568));
   ASSERT_EQ(0, math::clz32(std::numeric_limits<uint32_t>::max()));
 }
+
+TEST(math_utils, sqrt_cache) {
+  const math::sqrt_cache sqrt;
+
+  for (uint64_t i = 0; i < 2*math::sqrt_cache::SIZE; ++i) {
+    ASSERT_EQ(float_t(std::sqrt(i)), sqrt(i));
+  }
+
+  ASSERT_EQ(float_t(std::sqrt(uint64_t(1) << 40)), sqrt(uint64_t(1) << 40));
+}
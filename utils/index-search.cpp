@@ -42,6 +42,7 @@
 #include "search/phrase_filter.hpp"
 #include "search/bm25.hpp"
 #include "search/score.hpp"
+#include "search/top_k_collector.hpp"
 #include "utils/async_utils.hpp"
 #include "utils/memory_pool.hpp"
 
@@ -170,38 +171,19 @@ struct SearchTask : public Task {
     virtual int query(irs::directory_reader& reader) override {
         SCOPED_TIMER("Query execution + Result processing time");
 
-        for (auto& segment : reader) { // iterate segments
-            irs::order order;
-            order.add<irs::bm25_sort>(irs::string_ref::nil);
-            auto prepared_order = order.prepare();
-            auto docs = prepared->execute(segment, prepared_order); // query segment
-            const irs::score* score = docs->attributes().get<iresearch::score>().get();
-            auto comparer = [&prepared_order](const irs::bstring& lhs, const irs::bstring& rhs)->bool {
-              return prepared_order.less(lhs.c_str(), rhs.c_str());
-            };
-            std::multimap<irs::bstring, Entry, decltype(comparer)> sorted(comparer);
+        irs::order order;
+        order.add<irs::bm25_sort>(irs::string_ref::nil);
+        auto prepared_order = order.prepare();
+        irs::top_k_collector collector(prepared_order, topN);
 
-            // ensure we avoid COW for pre c++11 std::basic_string
-            const irs::bytes_ref score_value = score->value();
+        collector.collect(reader, *prepared); // query segments
+        totalHitCount += collector.hits();
 
-            while (docs->next()) {
-              SCOPED_TIMER("Result processing time");
-              ++totalHitCount;
-              score->evaluate();
-              sorted.emplace(
-                std::piecewise_construct,
-                std::forward_as_tuple(score_value),
-                std::forward_as_tuple(docs->value(), score ? prepared_order.get<float>(score_value.c_str(), 0) : .0)
-              );
-
-              if (sorted.size() > topN) {
-                sorted.erase(--(sorted.end()));
-              }
-            }
-
-            for (auto& entry: sorted) {
-              top_docs.emplace_back(std::move(entry.second));
-            }
+        for (auto& entry : collector.release()) {
+          top_docs.emplace_back(
+            entry.doc,
+            entry.score.empty() ? .0 : prepared_order.get<float>(entry.score.c_str(), 0)
+          );
         }
         return 0;
     }
@@ -995,6 +977,13 @@ int search(
 #ifdef IRESEARCH_COMPLEX_SCORING
             // ensure we avoid COW for pre c++11 std::basic_string
             const irs::bytes_ref raw_score_value = score->value();                        
+
+            // allows the iterator to skip the documents not getting into top
+            auto& threshold = docs->attributes().get<irs::score_threshold>();
+
+            if (threshold && !sorted.empty() && sorted.size() >= limit) {
+              threshold->value = sorted.rbegin()->first;
+            }
 #endif
             const auto& score_value = score
               ? order.get<float>(score->c_str(), 0)
@@ -1018,6 +1007,12 @@ int search(
               if (sorted.size() > limit) {
                 sorted.erase(--(sorted.end()));
               }
+
+#ifdef IRESEARCH_COMPLEX_SCORING
+              if (threshold && !sorted.empty() && sorted.size() >= limit) {
+                threshold->value = sorted.rbegin()->first;
+              }
+#endif
             }
           }
         }